@@ -186,6 +186,11 @@ final class SnapClientEngine: ObservableObject {
         registerLogCallback()
         setupAudioSessionObservers()
 
+        // Per-server warm-start state (clock seed, stream format)
+        if let caches = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask).first {
+            caches.path.withCString { snapclient_set_cache_dir($0) }
+        }
+
         // Sync pause state with C++ bridge
         isPaused = snapclient_is_paused(clientRef)
 
@@ -283,8 +288,11 @@ final class SnapClientEngine: ObservableObject {
         connectedHost = nil
         connectedPort = nil
 
-        // Configure audio session on main thread (AVAudioSession requirement)
-        configureAudioSession()
+        // Configure audio session on main thread (AVAudioSession requirement).
+        // Ask for the rate this server streamed at last time, so the hardware
+        // isn't switched when the first AudioQueue starts.
+        let cachedRate = host.withCString { snapclient_cached_sample_rate($0, Int32(port)) }
+        configureAudioSession(preferredSampleRate: cachedRate > 0 ? Double(cachedRate) : nil)
 
         // Capture values for the background task
         let hostCopy = host
@@ -684,7 +692,7 @@ final class SnapClientEngine: ObservableObject {
         )
     }
 
-    private func configureAudioSession() {
+    private func configureAudioSession(preferredSampleRate: Double? = nil) {
         do {
             let session = AVAudioSession.sharedInstance()
             // Use playback category for background audio
@@ -693,6 +701,9 @@ final class SnapClientEngine: ObservableObject {
             try session.setCategory(.playback, mode: .default)
             // Request larger IO buffer for more stable playback
             try session.setPreferredIOBufferDuration(0.01) // 10ms
+            if let preferredSampleRate {
+                try session.setPreferredSampleRate(preferredSampleRate)
+            }
 
             // Force output to speaker to avoid AirPlay loop
             // (when Tidal sends to Snapserver via AirPlay, we don't want our output going back)
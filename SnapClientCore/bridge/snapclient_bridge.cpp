@@ -14,21 +14,36 @@
 #include "time_provider.hpp"
 #include "common/aixlog.hpp"
 #include "ios_player.hpp"
+#include "cache/warm_start_cache.hpp"
+#include "control/control_client.hpp"
+#include "net/stream_reader.hpp"
+#include "net/stream_relay.hpp"
+#include "probe/link_probe.hpp"
+#include "probe/reachability_prober.hpp"
+#include "realtime/thread_topology.hpp"
 
 // Standard headers
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <future>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <thread>
+#include <vector>
+#include <cmath>
 #include <cstdarg>
 #include <cstdio>
 
 // Boost.Asio
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
 
 // iOS: use os_log directly (AixLog SinkNative falls back to syslog on iOS)
 #ifdef IOS
@@ -109,6 +124,20 @@ static void bridge_log_msg(SnapClientLogLevel level, const char* fmt, ...) {
 // Type alias for work guard
 using work_guard_t = boost::asio::executor_work_guard<boost::asio::io_context::executor_type>;
 
+// Ids naming each client's player state (see player::ClientState)
+static std::atomic<int> g_next_client_id{1};
+
+// The analysis thread of one client and its latest frame (see snapclient_start_analysis)
+struct ClientAnalysis {
+    std::mutex mutex;  // thread lifecycle
+    std::thread thread;
+    std::mutex stopMutex;
+    std::condition_variable stopCv;
+    bool running{false};
+    std::mutex frameMutex;
+    dsp::AnalysisFrame frame;
+};
+
 struct SnapClient {
     std::recursive_mutex mutex;
 
@@ -127,6 +156,17 @@ struct SnapClient {
     // Worker thread for io_context
     std::thread io_thread;
 
+    // Levels and spectrum of what the client plays
+    ClientAnalysis analysis;
+
+    // Re-serves the stream downstream, on the io thread (see snapclient_start_relay)
+    std::shared_ptr<net::StreamRelay> relay;
+    std::atomic<int> relay_port{0};
+
+    // Clock seed from the warm-start cache, checked once live syncs arrive
+    std::optional<cache::Seed> warm_seed;
+    std::unique_ptr<boost::asio::steady_timer> warm_check;
+
     // Connection state
     std::string host;
     int port = 1704;
@@ -140,6 +180,10 @@ struct SnapClient {
     // Identity
     std::string name = "SnapForge iOS";
     int instance = 1;
+    // Unique in the process, unlike instance: names the client to its players
+    const int id = g_next_client_id.fetch_add(1);
+    // Counted in g_clock while started
+    bool uses_clock = false;
 
     // Callbacks
     SnapClientStateCallback state_cb = nullptr;
@@ -152,12 +196,14 @@ struct SnapClient {
     void* log_ctx = nullptr;
 };
 
-/// RAII guard for callback scope - prevents callbacks during destroy
+/// RAII guard for callback scope - prevents callbacks during destroy.
+/// Works with any handle that has the destroying/callbacksInFlight/callbacksDone trio.
+template <typename Owner>
 struct CallbackGuard {
-    SnapClient* client;
+    Owner* client;
     bool valid;
 
-    CallbackGuard(SnapClient* c) : client(c), valid(false) {
+    CallbackGuard(Owner* c) : client(c), valid(false) {
         if (!c || c->destroying.load(std::memory_order_acquire)) return;
         c->callbacksInFlight.fetch_add(1, std::memory_order_acq_rel);
         // Double-check after increment (prevents race with destroy)
@@ -246,6 +292,226 @@ static void notify_state(SnapClient* c, SnapClientState new_state) {
     }
 }
 
+/* ── Warm start ─────────────────────────────────────────────────── */
+
+static std::string g_cache_dir;
+static std::mutex g_cache_mutex;
+
+// How often, and how many times, to look for the first live sync after seeding
+static constexpr auto WARM_CHECK_INTERVAL = std::chrono::milliseconds(250);
+static constexpr int WARM_CHECK_ATTEMPTS = 40;
+
+void snapclient_set_cache_dir(const char* path) {
+    std::lock_guard<std::mutex> lock(g_cache_mutex);
+    g_cache_dir = path ? path : "";
+    BLOG_INFO("set_cache_dir: %s", g_cache_dir.empty() ? "(disabled)" : g_cache_dir.c_str());
+}
+
+static std::optional<cache::WarmStartCache> warm_start_cache() {
+    std::lock_guard<std::mutex> lock(g_cache_mutex);
+    if (g_cache_dir.empty()) return std::nullopt;
+    return cache::WarmStartCache(g_cache_dir);
+}
+
+static std::string server_key(const std::string& host, int port) {
+    return host + ":" + std::to_string(port);
+}
+
+int snapclient_cached_sample_rate(const char* host, int port) {
+    if (!host) return 0;
+    auto wsc = warm_start_cache();
+    if (!wsc) return 0;
+    auto entry = wsc->load(server_key(host, port));
+    return entry ? static_cast<int>(entry->sampleRate) : 0;
+}
+
+/// Seed TimeProvider from the cache. Call after TimeProvider::reset().
+static void seed_from_cache(SnapClient* c) {
+    c->warm_seed.reset();
+    auto wsc = warm_start_cache();
+    if (!wsc) return;
+    auto entry = wsc->load(server_key(c->host, c->port));
+    if (!entry) return;
+
+    c->warm_seed = cache::predictSeed(*entry, cache::ClockReading::now());
+    if (!c->warm_seed) {
+        BLOG_INFO("warm start: cached clock for %s:%d not usable", c->host.c_str(), c->port);
+        return;
+    }
+    TimeProvider::getInstance().seed(c->warm_seed->diff);
+    BLOG_INFO("warm start: seeded clock diff=%lldus (tolerance %lldus, %u confirmed)",
+              static_cast<long long>(c->warm_seed->diff.count()),
+              static_cast<long long>(c->warm_seed->tolerance.count()), entry->confirmed);
+}
+
+/// Compare the seed with the first live sync (runs on the io thread)
+static void check_warm_seed(SnapClient* c, int attempts) {
+    c->warm_check->expires_after(WARM_CHECK_INTERVAL);
+    c->warm_check->async_wait([c, attempts](const boost::system::error_code& ec) {
+        if (ec || !c->warm_seed) return;
+        auto& tp = TimeProvider::getInstance();
+        if (tp.isSeeded()) {
+            if (attempts > 1) check_warm_seed(c, attempts - 1);
+            return;
+        }
+        if (!tp.isSynced()) return;  // Clock was reset meanwhile
+
+        auto live = tp.getDiffToServer<std::chrono::microseconds>();
+        auto check = cache::checkSeed(*c->warm_seed, live);
+        auto wsc = warm_start_cache();
+        auto entry = wsc ? wsc->load(server_key(c->host, c->port)) : std::nullopt;
+        if (check == cache::SeedCheck::Confirmed) {
+            BLOG_INFO("warm start: seed confirmed (error %lldus)",
+                      static_cast<long long>((live - c->warm_seed->diff).count()));
+            if (entry) entry->confirmed++;
+        } else {
+            BLOG_WARN("warm start: seed rejected (error %lldus > %lldus), server clock changed",
+                      static_cast<long long>((live - c->warm_seed->diff).count()),
+                      static_cast<long long>(c->warm_seed->tolerance.count()));
+            if (entry) entry->confirmed = 0;
+        }
+        if (entry) {
+            cache::recordDiff(*entry, live, cache::ClockReading::now());
+            wsc->store(*entry);
+        }
+    });
+}
+
+/// Remember the live clock and stream format for the next start
+static void save_warm_start(SnapClient* c) {
+    auto wsc = warm_start_cache();
+    auto& tp = TimeProvider::getInstance();
+    if (!wsc || !tp.isSynced() || tp.isSeeded()) return;
+
+    std::string key = server_key(c->host, c->port);
+    cache::WarmStartEntry entry = wsc->load(key).value_or(cache::WarmStartEntry{});
+    entry.server = key;
+    cache::recordDiff(entry, tp.getDiffToServer<std::chrono::microseconds>(), cache::ClockReading::now());
+    const auto& format = player::clientState(c->id)->format;
+    if (auto rate = format.rate.load()) {
+        entry.sampleRate = rate;
+        entry.bits = format.bits.load();
+        entry.channels = format.channels.load();
+    }
+    if (!wsc->store(entry)) {
+        BLOG_WARN("warm start: could not write %s", wsc->path(key).c_str());
+    }
+}
+
+/* ── Shared server clock ────────────────────────────────────────── */
+
+/// TimeProvider is process-wide: all running clients play on one server
+/// clock, so they must be connected to the same server. The first client
+/// resets and warm-seeds it, the last one resets it when it stops; the
+/// others neither reset nor seed it.
+struct SharedClock {
+    std::mutex mutex;
+    std::string server;
+    int clients = 0;
+};
+static SharedClock g_clock;
+
+/// Join the clock for c's server; false while clients of another server run
+static bool acquire_clock(SnapClient* c) {
+    std::lock_guard<std::mutex> lock(g_clock.mutex);
+    if (c->uses_clock) {
+        // Disconnected by the server without a snapclient_stop
+        c->uses_clock = false;
+        g_clock.clients--;
+    }
+    std::string key = server_key(c->host, c->port);
+    if (g_clock.clients > 0 && g_clock.server != key) {
+        BLOG_ERROR("start: %d client(s) play on the clock of %s, can't follow %s too",
+                   g_clock.clients, g_clock.server.c_str(), key.c_str());
+        return false;
+    }
+    if (g_clock.clients == 0) {
+        // HARD RESET: Clear TimeProvider's stale clock data from previous server
+        // This prevents clock drift issues (-1.68e+08ms) when switching servers
+        TimeProvider::getInstance().reset();
+        BLOG_INFO("TimeProvider reset for new connection");
+        g_clock.server = key;
+        seed_from_cache(c);
+    } else {
+        c->warm_seed.reset();
+        BLOG_INFO("start: sharing the clock of %s with %d client(s)", key.c_str(), g_clock.clients);
+    }
+    g_clock.clients++;
+    c->uses_clock = true;
+    return true;
+}
+
+/// Leave the clock; the last client resets it (stale sync data from this server)
+static void release_clock(SnapClient* c) {
+    std::lock_guard<std::mutex> lock(g_clock.mutex);
+    if (!c->uses_clock) return;
+    c->uses_clock = false;
+    if (--g_clock.clients == 0) {
+        TimeProvider::getInstance().reset();
+        g_clock.server.clear();
+    }
+}
+
+/* ── Thread topology ────────────────────────────────────────────── */
+
+static realtime::ThreadTopology g_topology;
+static std::mutex g_topology_mutex;
+
+static SnapThreadProfile to_c_profile(const realtime::ThreadProfile& p) {
+    return SnapThreadProfile{static_cast<SnapThreadQos>(p.qos), p.relativePriority, p.cpu};
+}
+
+static realtime::ThreadProfile from_c_profile(const SnapThreadProfile& p) {
+    realtime::ThreadProfile profile;
+    int qos = std::clamp(static_cast<int>(p.qos), static_cast<int>(SNAPCLIENT_QOS_USER_INTERACTIVE),
+                         static_cast<int>(SNAPCLIENT_QOS_BACKGROUND));
+    profile.qos = static_cast<realtime::QosClass>(qos);
+    profile.relativePriority = std::clamp(p.relative_priority, -15, 0);
+    profile.cpu = p.cpu < 0 ? -1 : p.cpu;
+    return profile;
+}
+
+void snapclient_thread_config_defaults(SnapThreadConfig* config) {
+    if (!config) return;
+    realtime::ThreadTopology defaults;
+    config->enabled = defaults.enabled;
+    config->io = to_c_profile(defaults.io);
+    config->control = to_c_profile(defaults.control);
+    config->background = to_c_profile(defaults.background);
+}
+
+void snapclient_set_thread_config(const SnapThreadConfig* config) {
+    realtime::ThreadTopology topology;
+    if (config) {
+        topology.enabled = config->enabled;
+        topology.io = from_c_profile(config->io);
+        topology.control = from_c_profile(config->control);
+        topology.background = from_c_profile(config->background);
+    }
+    std::lock_guard<std::mutex> lock(g_topology_mutex);
+    g_topology = topology;
+    BLOG_INFO("set_thread_config: %s, io %s, control %s, background %s",
+              topology.enabled ? "enabled" : "disabled", realtime::toString(topology.io.qos),
+              realtime::toString(topology.control.qos), realtime::toString(topology.background.qos));
+}
+
+/// Apply a role of the configured topology to the calling thread
+static void apply_thread_role(const char* name, realtime::ThreadProfile realtime::ThreadTopology::*role) {
+    realtime::ThreadTopology topology;
+    {
+        std::lock_guard<std::mutex> lock(g_topology_mutex);
+        topology = g_topology;
+    }
+    if (!topology.enabled) return;
+    if (!realtime::applyToCurrentThread(name, topology.*role)) {
+        BLOG_WARN("%s: thread profile %s not fully applied", name, realtime::toString((topology.*role).qos));
+    }
+}
+
+void snapclient_apply_background_profile(void) {
+    apply_thread_role("", &realtime::ThreadTopology::background);
+}
+
 /* ── Lifecycle ──────────────────────────────────────────────────── */
 
 SnapClientRef snapclient_create(void) {
@@ -270,6 +536,8 @@ void snapclient_begin_destroy(SnapClientRef client) {
     BLOG_DEBUG("snapclient_begin_destroy: destroying flag set");
 }
 
+static void stop_analysis_thread(SnapClient* client);
+
 void snapclient_destroy(SnapClientRef client) {
     if (!client) return;
 
@@ -289,7 +557,10 @@ void snapclient_destroy(SnapClientRef client) {
     }
 
     // Phase 3: Stop and cleanup
+    stop_analysis_thread(client);
     snapclient_stop(client);
+    release_clock(client);
+    player::releaseClientState(client->id);
     delete client;
 }
 
@@ -304,14 +575,11 @@ bool snapclient_start(SnapClientRef client, const char* host, int port) {
         return false; // already running
     }
 
-    // HARD RESET: Clear TimeProvider's stale clock data from previous server
-    // This prevents clock drift issues (-1.68e+08ms) when switching servers
-    TimeProvider::getInstance().reset();
-    BLOG_INFO("TimeProvider reset for new connection");
-
     client->host = host;
     client->port = port;
     BLOG_INFO("start: host=%s, port=%d", host, port);
+    if (!acquire_clock(client)) return false;
+    player::clientState(client->id)->format.rate.store(0);
     notify_state(client, SNAPCLIENT_STATE_CONNECTING);
 
     try {
@@ -326,6 +594,8 @@ bool snapclient_start(SnapClientRef client, const char* host, int port) {
         settings.server.uri = StreamUri(uri_str);
         settings.player.player_name = player::IOS_PLAYER;
         settings.player.latency = client->latency_ms.load();
+        // Names the client's pause, mix and parked-stream state to its players
+        settings.player.parameter = "client=" + std::to_string(client->id);
         settings.instance = client->instance;
         settings.host_id = client->name;
         BLOG_INFO("settings: uri=%s, player=%s, host_id=%s, instance=%d",
@@ -336,6 +606,11 @@ bool snapclient_start(SnapClientRef client, const char* host, int port) {
         client->controller = std::make_unique<Controller>(*client->io_context, settings);
         BLOG_INFO("Controller created");
 
+        if (client->warm_seed) {
+            client->warm_check = std::make_unique<boost::asio::steady_timer>(*client->io_context);
+            check_warm_seed(client, WARM_CHECK_ATTEMPTS);
+        }
+
         // Start Controller — synchronous TCP connect + queues async hello/read
         BLOG_INFO("calling controller->start()...");
         client->controller->start();
@@ -343,6 +618,7 @@ bool snapclient_start(SnapClientRef client, const char* host, int port) {
 
         // Run io_context in background thread
         client->io_thread = std::thread([client]() {
+            apply_thread_role("snapclient-io", &realtime::ThreadTopology::io);
             BLOG_INFO("io_context thread started");
             try {
                 auto n = client->io_context->run();
@@ -368,14 +644,18 @@ bool snapclient_start(SnapClientRef client, const char* host, int port) {
     } catch (const std::exception& e) {
         BLOG_ERROR("failed to start: %s", e.what());
         // Cleanup on failure
+        client->warm_check.reset();
         client->controller.reset();
         client->work_guard.reset();
         client->io_context.reset();
+        release_clock(client);
         notify_state(client, SNAPCLIENT_STATE_DISCONNECTED);
         return false;
     }
 }
 
+static void stop_relay(SnapClient* client);
+
 void snapclient_stop(SnapClientRef client) {
     if (!client) return;
 
@@ -393,6 +673,8 @@ void snapclient_stop(SnapClientRef client) {
             return;
         }
 
+        stop_relay(client);
+
         // Stop io_context - this signals the worker thread to exit
         // Note: Socket cleanup happens via the destructor chain:
         // controller.reset() -> ~Controller -> ~ClientConnection -> disconnect()
@@ -413,13 +695,16 @@ void snapclient_stop(SnapClientRef client) {
     // Phase 3: Cleanup (under lock)
     {
         std::lock_guard<std::recursive_mutex> lock(client->mutex);
+        client->warm_check.reset();
+        client->relay.reset();
         client->controller.reset();
+        // The destroyed player left its stream for a successor that won't come
+        player::releaseParkedStream(client->id);
         client->io_context.reset();
+        save_warm_start(client);
+        release_clock(client);
     }
 
-    // Reset time provider to clear stale sync data from previous server
-    TimeProvider::getInstance().reset();
-
     // Notify disconnected state (notify_state handles its own locking)
     notify_state(client, SNAPCLIENT_STATE_DISCONNECTED);
 }
@@ -430,6 +715,93 @@ bool snapclient_is_connected(SnapClientRef client) {
     return s == SNAPCLIENT_STATE_CONNECTED || s == SNAPCLIENT_STATE_PLAYING;
 }
 
+/* ── Relay ──────────────────────────────────────────────────────── */
+
+/// Untap the stream and close the relay, with client->mutex held. The
+/// relay object goes with the io_context's handlers (or at snapclient_stop).
+static void stop_relay(SnapClient* client) {
+    if (!client->relay) return;
+    if (client->io_context) net::StreamReader::setTap(*client->io_context, nullptr);
+    client->relay->stop();
+    client->relay_port.store(0);
+    BLOG_INFO("relay: stopped");
+}
+
+bool snapclient_start_relay(SnapClientRef client, int port, int max_clients) {
+    if (!client || port < 0 || port > 65535 || max_clients < 1) return false;
+    // Shared with the start on the io thread, client->mutex held
+    struct Start {
+        bool cancelled{false};  // the caller gave up: don't listen
+        bool done{false};
+        bool listening{false};
+    };
+    auto state = std::make_shared<Start>();
+    std::future<void> started;
+    {
+        std::lock_guard<std::recursive_mutex> lock(client->mutex);
+        if (!client->io_context || !snapclient_is_connected(client)) return false;
+        stop_relay(client);
+        client->relay.reset();
+
+        net::RelayOptions options;
+        options.port = static_cast<uint16_t>(port);
+        options.maxClients = static_cast<size_t>(max_clients);
+        auto relay = std::make_shared<net::StreamRelay>(*client->io_context, options);
+
+        // The relay runs on the io thread, with the connection that feeds
+        // it: it starts there and is handed to the client there, so only the
+        // handler owns it until then and goes with the io_context's handlers
+        std::packaged_task<void()> start([client, relay, state, max_clients]() {
+            std::lock_guard<std::recursive_mutex> lock(client->mutex);
+            state->done = true;
+            // Given up on, or the client is stopping (snapclient_stop drops
+            // the work guard first)
+            if (state->cancelled || !client->work_guard) return;
+            boost::system::error_code ec;
+            if (!relay->start(ec)) {
+                BLOG_ERROR("relay: can't listen: %s", ec.message().c_str());
+                return;
+            }
+            // A start that ran first is replaced: the last call wins
+            stop_relay(client);
+            // Every batch the connection reads, the stream's headers first;
+            // chunk times are the server's, Time replies use the synced clock
+            net::StreamReader::setTap(*client->io_context, [relay](const std::vector<net::BatchReceiver::Message>& batch) {
+                auto& tp = TimeProvider::getInstance();
+                if (tp.isSynced()) relay->setClockOffset(tp.getDiffToServer<std::chrono::microseconds>());
+                relay->publish(batch);
+            });
+            client->relay = relay;
+            client->relay_port.store(relay->port());
+            BLOG_INFO("relay: listening on port %d, up to %d clients", static_cast<int>(relay->port()), max_clients);
+            state->listening = true;
+        });
+        started = start.get_future();
+        boost::asio::post(*client->io_context, std::move(start));
+    }
+
+    // Not under client->mutex: the io thread takes it, and snapclient_stop
+    // must not wait behind a start. Also ready if the io_context goes first.
+    started.wait_for(std::chrono::seconds(2));
+    std::lock_guard<std::recursive_mutex> lock(client->mutex);
+    if (!state->done) {
+        state->cancelled = true;
+        BLOG_WARN("relay: not started within 2 s, cancelled");
+        return false;
+    }
+    return state->listening;
+}
+
+void snapclient_stop_relay(SnapClientRef client) {
+    if (!client) return;
+    std::lock_guard<std::recursive_mutex> lock(client->mutex);
+    stop_relay(client);
+}
+
+int snapclient_relay_port(SnapClientRef client) {
+    return client ? client->relay_port.load() : 0;
+}
+
 /* ── Volume ─────────────────────────────────────────────────────── */
 
 void snapclient_set_volume(SnapClientRef client, int percent) {
@@ -460,19 +832,18 @@ bool snapclient_get_muted(SnapClientRef client) {
 void snapclient_pause(SnapClientRef client) {
     if (!client) return;
     BLOG_INFO("pause: pausing audio playback");
-    player::g_ios_player_paused.store(true);
+    player::clientState(client->id)->paused.store(true);
 }
 
 void snapclient_resume(SnapClientRef client) {
     if (!client) return;
     BLOG_INFO("resume: resuming audio playback");
-    player::g_ios_player_paused.store(false);
+    player::clientState(client->id)->paused.store(false);
 }
 
 bool snapclient_is_paused(SnapClientRef client) {
-    // Use global player state as single source of truth
-    std::ignore = client;
-    return player::g_ios_player_paused.load();
+    // The players' state is the single source of truth
+    return client ? player::clientState(client->id)->paused.load() : false;
 }
 
 /* ── Latency ────────────────────────────────────────────────────── */
@@ -487,6 +858,284 @@ int snapclient_get_latency(SnapClientRef client) {
     return client ? client->latency_ms.load() : 0;
 }
 
+/* ── Equalizer ──────────────────────────────────────────────────── */
+
+bool snapclient_set_eq(SnapClientRef client, const SnapEqBand* bands, int count) {
+    if (!client || count < 0 || count > SNAPCLIENT_EQ_MAX_BANDS || (count > 0 && !bands)) return false;
+    std::array<dsp::EqBand, SNAPCLIENT_EQ_MAX_BANDS> eq{};
+    for (int i = 0; i < count; ++i) {
+        const SnapEqBand& band = bands[i];
+        // Rate-dependent limits (Nyquist) are checked by the filter design
+        if (band.type < SNAPCLIENT_EQ_PEAKING || band.type > SNAPCLIENT_EQ_HIGH_PASS || !(band.frequency > 0.f) ||
+            !(band.q > 0.f) || !(std::fabs(band.gain_db) <= 24.f)) {
+            BLOG_WARN("set_eq: band %d out of range", i);
+            return false;
+        }
+        eq[i] = {static_cast<dsp::FilterType>(band.type), band.frequency, band.gain_db, band.q};
+    }
+    BLOG_INFO("set_eq: client %d, %d bands", client->id, count);
+    player::setEqualizer(client->id, eq.data(), static_cast<size_t>(count));
+    return true;
+}
+
+/* ── Limiter ────────────────────────────────────────────────────── */
+
+void snapclient_set_limiter(SnapClientRef client, bool enabled) {
+    if (!client) return;
+    BLOG_INFO("set_limiter: client %d %s", client->id, enabled ? "on" : "off");
+    player::setLimiter(client->id, enabled);
+}
+
+bool snapclient_get_limiter(SnapClientRef client) {
+    return client ? player::limiter(client->id) : false;
+}
+
+/* ── Channel mapping ────────────────────────────────────────────── */
+
+void snapclient_set_channel_mode(SnapClientRef client, SnapChannelMode mode) {
+    if (!client || mode < SNAPCLIENT_CHANNELS_NATIVE || mode > SNAPCLIENT_CHANNELS_RIGHT) return;
+    BLOG_INFO("set_channel_mode: client %d %s", client->id, dsp::toString(static_cast<dsp::ChannelMode>(mode)));
+    player::setChannelMapping(client->id, static_cast<dsp::ChannelMode>(mode));
+}
+
+SnapChannelMode snapclient_get_channel_mode(SnapClientRef client) {
+    return client ? static_cast<SnapChannelMode>(player::channelMapping(client->id)) : SNAPCLIENT_CHANNELS_NATIVE;
+}
+
+bool snapclient_set_channel_matrix(SnapClientRef client, const float* gains, int out_channels, int in_channels) {
+    if (!client || !gains || out_channels < 1 || out_channels > SNAPCLIENT_MAX_CHANNELS || in_channels < 1 ||
+        in_channels > SNAPCLIENT_MAX_CHANNELS)
+        return false;
+    dsp::ChannelMatrix matrix;
+    matrix.inputs = static_cast<uint16_t>(in_channels);
+    matrix.outputs = static_cast<uint16_t>(out_channels);
+    for (int o = 0; o < out_channels; ++o)
+        for (int i = 0; i < in_channels; ++i) matrix.gain[o][i] = gains[o * in_channels + i];
+    BLOG_INFO("set_channel_matrix: client %d, %d -> %d channels", client->id, in_channels, out_channels);
+    player::setChannelMapping(client->id, dsp::ChannelMode::Custom, matrix);
+    return true;
+}
+
+/* ── Bit depth ──────────────────────────────────────────────────── */
+
+bool snapclient_set_output_bits(SnapClientRef client, int bits) {
+    if (!client || (bits != 0 && bits != 16 && bits != 24)) return false;
+    BLOG_INFO("set_output_bits: client %d, %d", client->id, bits);
+    player::setOutputBits(client->id, static_cast<uint16_t>(bits));
+    return true;
+}
+
+int snapclient_get_output_bits(SnapClientRef client) {
+    return client ? player::outputBits(client->id) : 0;
+}
+
+void snapclient_set_noise_shaping(SnapClientRef client, bool enabled) {
+    if (!client) return;
+    BLOG_INFO("set_noise_shaping: client %d %s", client->id, enabled ? "on" : "off");
+    player::setNoiseShaping(client->id, enabled);
+}
+
+bool snapclient_get_noise_shaping(SnapClientRef client) {
+    return client ? player::noiseShaping(client->id) : false;
+}
+
+/* ── Mixing ─────────────────────────────────────────────────────── */
+
+void snapclient_set_mixing(SnapClientRef client, bool enabled) {
+    if (!client) return;
+    BLOG_INFO("set_mixing: client %d %s", client->id, enabled ? "on" : "off");
+    player::setMixing(client->id, enabled);
+}
+
+bool snapclient_get_mixing(SnapClientRef client) {
+    return client ? player::mixing(client->id) : false;
+}
+
+void snapclient_set_mix_level(SnapClientRef client, float level) {
+    if (!client || !std::isfinite(level)) return;
+    BLOG_INFO("set_mix_level: client %d, %.2f", client->id, level);
+    player::setMixLevel(client->id, level);
+}
+
+float snapclient_get_mix_level(SnapClientRef client) {
+    return client ? player::mixLevel(client->id) : 0.f;
+}
+
+/* ── Levels and spectrum ────────────────────────────────────────── */
+
+static_assert(SNAPCLIENT_LEVEL_CHANNELS == dsp::MAX_TAP_CHANNELS, "level channels");
+static_assert(SNAPCLIENT_SPECTRUM_BANDS == dsp::SPECTRUM_BANDS, "spectrum bands");
+
+static void analysis_loop(SnapClient* client, std::chrono::microseconds period) {
+    apply_thread_role("snapclient-analysis", &realtime::ThreadTopology::control);
+    ClientAnalysis& a = client->analysis;
+    dsp::SpectrumAnalyzer analyzer;
+    auto last = std::chrono::steady_clock::now();
+    auto next = last;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(a.stopMutex);
+            if (a.stopCv.wait_until(lock, next, [&a] { return !a.running; })) break;
+        }
+        const auto now = std::chrono::steady_clock::now();
+        auto tap = player::analysisTap(client->id);
+        analyzer.update(tap.get(), now, std::chrono::duration_cast<std::chrono::microseconds>(now - last));
+        last = now;
+        {
+            std::lock_guard<std::mutex> lock(a.frameMutex);
+            a.frame = analyzer.frame();
+        }
+        // Fixed rate; after a stall, resume from now rather than catch up
+        next += period;
+        if (next < now) next = now + period;
+    }
+}
+
+/// Stop the client's analysis thread; other clients' keep running
+static void stop_analysis_thread(SnapClient* client) {
+    ClientAnalysis& a = client->analysis;
+    std::lock_guard<std::mutex> lock(a.mutex);
+    if (!a.thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> stopLock(a.stopMutex);
+        a.running = false;
+    }
+    a.stopCv.notify_all();
+    a.thread.join();
+    player::clientState(client->id)->analysis.store(false);
+    std::lock_guard<std::mutex> frameLock(a.frameMutex);
+    a.frame = dsp::AnalysisFrame{};
+}
+
+bool snapclient_start_analysis(SnapClientRef client, int fps) {
+    if (!client || fps < 1 || fps > 60) return false;
+    stop_analysis_thread(client);
+    ClientAnalysis& a = client->analysis;
+    std::lock_guard<std::mutex> lock(a.mutex);
+    BLOG_INFO("start_analysis: client %d, %d fps", client->id, fps);
+    {
+        std::lock_guard<std::mutex> stopLock(a.stopMutex);
+        a.running = true;
+    }
+    player::clientState(client->id)->analysis.store(true);
+    a.thread = std::thread(analysis_loop, client, std::chrono::microseconds(1000000 / fps));
+    return true;
+}
+
+void snapclient_stop_analysis(SnapClientRef client) {
+    if (!client) return;
+    BLOG_INFO("stop_analysis: client %d", client->id);
+    stop_analysis_thread(client);
+}
+
+int snapclient_get_levels(SnapClientRef client, float* peak_db, float* rms_db, int max_channels) {
+    if (!client || max_channels <= 0) return 0;
+    ClientAnalysis& a = client->analysis;
+    std::lock_guard<std::mutex> lock(a.frameMutex);
+    const int channels = std::min<int>(a.frame.channels, max_channels);
+    for (int c = 0; c < channels; ++c) {
+        if (peak_db) peak_db[c] = a.frame.peakDb[c];
+        if (rms_db) rms_db[c] = a.frame.rmsDb[c];
+    }
+    return channels;
+}
+
+int snapclient_get_spectrum(SnapClientRef client, float* bands_db, int max_bands) {
+    if (!client || !bands_db || max_bands <= 0) return 0;
+    ClientAnalysis& a = client->analysis;
+    std::lock_guard<std::mutex> lock(a.frameMutex);
+    const int bands = std::min<int>(SNAPCLIENT_SPECTRUM_BANDS, max_bands);
+    std::copy(a.frame.bandsDb.begin(), a.frame.bandsDb.begin() + bands, bands_db);
+    return bands;
+}
+
+/* ── Played PCM ─────────────────────────────────────────────────── */
+
+/// A consumer reads one tap at a time; it follows the player to the next
+/// tap (a new queue) once the current one is drained
+struct SnapPcmConsumer {
+    int client{0};
+    /// Counts this consumer in pcmConsumers; kept past the client's destroy
+    std::shared_ptr<player::ClientState> state;
+    std::shared_ptr<playout::PcmTap> tap;
+    std::unique_ptr<playout::PcmTap::Reader> reader;
+    /// Of the taps read before
+    uint64_t overruns{0};
+    uint64_t lostFrames{0};
+};
+
+SnapPcmConsumerRef snapclient_pcm_open(SnapClientRef client) {
+    if (!client) return nullptr;
+    auto* consumer = new (std::nothrow) SnapPcmConsumer();
+    if (!consumer) return nullptr;
+    consumer->client = client->id;
+    consumer->state = player::clientState(client->id);
+    consumer->state->pcmConsumers.fetch_add(1);
+    consumer->tap = player::pcmTap(client->id);
+    if (consumer->tap) consumer->reader = std::make_unique<playout::PcmTap::Reader>(*consumer->tap);
+    BLOG_INFO("pcm_open: %s", consumer->tap ? "attached" : "waiting for playback");
+    return consumer;
+}
+
+bool snapclient_pcm_acquire(SnapPcmConsumerRef consumer, SnapPcmBlock* block) {
+    if (!consumer || !block) return false;
+    playout::PcmTap::Block b;
+    if (!consumer->reader || !consumer->reader->acquire(b)) {
+        auto current = player::pcmTap(consumer->client);
+        if (current == consumer->tap) return false;
+        if (consumer->reader) {
+            consumer->overruns += consumer->reader->overruns();
+            consumer->lostFrames += consumer->reader->lostFrames();
+            consumer->reader.reset();
+        }
+        consumer->tap = std::move(current);
+        if (!consumer->tap) return false;
+        consumer->reader = std::make_unique<playout::PcmTap::Reader>(*consumer->tap);
+        if (!consumer->reader->acquire(b)) return false;
+    }
+    const auto& format = consumer->tap->format();
+    block->data = b.data[0];
+    block->frames = static_cast<int>(b.frames[0]);
+    block->wrap_data = b.data[1];
+    block->wrap_frames = static_cast<int>(b.frames[1]);
+    block->play_at_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(b.playAt.time_since_epoch()).count();
+    block->first_frame = b.firstFrame;
+    block->sample_rate = static_cast<int>(format.rate);
+    block->channels = format.channels;
+    block->bits = format.bits;
+    return true;
+}
+
+bool snapclient_pcm_release(SnapPcmConsumerRef consumer, const SnapPcmBlock* block) {
+    if (!consumer || !block || !consumer->reader) return false;
+    playout::PcmTap::Block b;
+    b.data[0] = block->data;
+    b.frames[0] = static_cast<uint32_t>(block->frames);
+    b.data[1] = block->wrap_data;
+    b.frames[1] = static_cast<uint32_t>(block->wrap_frames);
+    b.firstFrame = block->first_frame;
+    return consumer->reader->release(b);
+}
+
+uint64_t snapclient_pcm_overruns(SnapPcmConsumerRef consumer, uint64_t* lost_frames) {
+    if (!consumer) return 0;
+    uint64_t overruns = consumer->overruns;
+    uint64_t lost = consumer->lostFrames;
+    if (consumer->reader) {
+        overruns += consumer->reader->overruns();
+        lost += consumer->reader->lostFrames();
+    }
+    if (lost_frames) *lost_frames = lost;
+    return overruns;
+}
+
+void snapclient_pcm_close(SnapPcmConsumerRef consumer) {
+    if (!consumer) return;
+    BLOG_INFO("pcm_close: %llu overruns", static_cast<unsigned long long>(snapclient_pcm_overruns(consumer, nullptr)));
+    consumer->state->pcmConsumers.fetch_sub(1);
+    delete consumer;
+}
+
 /* ── Identity ───────────────────────────────────────────────────── */
 
 void snapclient_set_name(SnapClientRef client, const char* name) {
@@ -642,6 +1291,339 @@ int snapclient_test_tcp(const char* host, int port) {
     return 0;
 }
 
+int snapclient_probe_servers(const char* const* hosts, const int* ports, int count,
+                             int timeout_ms, SnapProbeResult* results) {
+    if (!hosts || !ports || !results || count <= 0 || timeout_ms <= 0) return -1;
+
+    std::vector<probe::Endpoint> endpoints;
+    endpoints.reserve(static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        int port = (ports[i] > 0 && ports[i] <= 65535) ? ports[i] : probe::STREAM_TCP_PORT;
+        endpoints.push_back({hosts[i] ? hosts[i] : "", static_cast<uint16_t>(port)});
+    }
+
+    probe::ReachabilityOptions options;
+    options.deadline = std::chrono::milliseconds(timeout_ms);
+
+    // All probes share this io_context, run on the calling thread
+    boost::asio::io_context io;
+    probe::ReachabilityProber prober(io);
+    std::vector<probe::ReachabilityResult> ranked;
+    prober.probe(std::move(endpoints), options, [&ranked](std::vector<probe::ReachabilityResult> r) {
+        ranked = std::move(r);
+    });
+    io.run();
+
+    int reachable = 0;
+    for (size_t i = 0; i < ranked.size(); ++i) {
+        const auto& r = ranked[i];
+        results[i].index = static_cast<int>(r.index);
+        results[i].reachable = r.reachable();
+        results[i].connect_us = static_cast<int>(r.connectTime.count());
+        results[i].rtt_us = static_cast<int>(r.rtt.count());
+        results[i].error = r.reachable() ? 0 : r.error.value();
+        if (r.reachable()) {
+            reachable++;
+            BLOG_INFO("probe_servers: #%zu %s:%d rtt=%dus connect=%dus", i, r.endpoint.host.c_str(),
+                      r.endpoint.port, results[i].rtt_us, results[i].connect_us);
+        } else {
+            BLOG_INFO("probe_servers: %s:%d %s", r.endpoint.host.c_str(), r.endpoint.port,
+                      probe::toString(r.status));
+        }
+    }
+    return reachable;
+}
+
+int snapclient_probe_link(const char* host, int port, const char* client_id,
+                          int window_ms, SnapLinkQuality* quality) {
+    if (!host || !client_id || !quality || port <= 0 || port > 65535 || window_ms <= 0) return EINVAL;
+
+    probe::LinkProbeOptions options;
+    options.hello.id = client_id;
+    options.hello.version = VERSION;
+    options.receiveWindow = std::chrono::milliseconds(window_ms);
+
+    boost::asio::io_context io;
+    probe::LinkProbe link(io);
+    probe::LinkQuality q;
+    link.run({host, static_cast<uint16_t>(port)}, options, [&q](const probe::LinkQuality& result) { q = result; });
+    io.run();
+
+    *quality = {};
+    quality->samples = q.samples;
+    quality->rtt_min_us = static_cast<int>(q.rttMin.count());
+    quality->rtt_median_us = static_cast<int>(q.rttMedian.count());
+    quality->rtt_p95_us = static_cast<int>(q.rttP95.count());
+    quality->rtt_max_us = static_cast<int>(q.rttMax.count());
+    quality->jitter_us = static_cast<int>(q.jitter.count());
+    quality->offset_us = q.offsetMedian.count();
+    quality->offset_stddev_us = static_cast<int>(q.offsetStdDev.count());
+    quality->offset_filtered_us = q.offsetFiltered.count();
+    quality->hol_discarded = q.holDiscarded;
+    quality->kernel_timestamps = q.kernelTimestamps ? 1 : 0;
+    quality->throughput_kbps = q.throughputKbps;
+    quality->peak_kbps = q.peakThroughputKbps;
+    quality->chunks = static_cast<int>(q.chunks);
+    snprintf(quality->codec, sizeof(quality->codec), "%s", q.codec.c_str());
+
+    BLOG_INFO("probe_link: %s:%d %s, rtt median=%dus p95=%dus jitter=%dus, offset sd=%dus (%d HOL-delayed), %.0f kbps (peak %.0f)",
+              host, port, probe::toString(q.status), quality->rtt_median_us, quality->rtt_p95_us,
+              quality->jitter_us, quality->offset_stddev_us, q.holDiscarded, q.throughputKbps, q.peakThroughputKbps);
+
+    // The probe measured the same steady-clock diff TimeProvider uses:
+    // keep it, with the RTT profile and codec, for the next warm start
+    auto wsc = warm_start_cache();
+    if (wsc && q.status == probe::ProbeStatus::Ok) {
+        std::string key = server_key(host, port);
+        cache::WarmStartEntry entry = wsc->load(key).value_or(cache::WarmStartEntry{});
+        entry.server = key;
+        entry.rttMedianUs = q.rttMedian.count();
+        entry.rttP95Us = q.rttP95.count();
+        if (!q.codec.empty()) entry.codec = q.codec;
+        if (q.samples > 0) cache::recordDiff(entry, q.offsetFiltered, cache::ClockReading::now());
+        wsc->store(entry);
+    }
+
+    if (q.status == probe::ProbeStatus::Ok) return 0;
+    return q.error ? q.error.value() : ETIMEDOUT;
+}
+
+/* ── Control plane (JSON-RPC) ───────────────────────────────────── */
+
+struct SnapControl {
+    std::recursive_mutex mutex;
+
+    // Lifecycle guard for callbacks (same protocol as SnapClient)
+    std::atomic<int> callbacksInFlight{0};
+    std::atomic<bool> destroying{false};
+    std::condition_variable_any callbacksDone;
+
+    // Dedicated io_context: control traffic never competes with audio I/O
+    std::unique_ptr<boost::asio::io_context> io_context;
+    std::unique_ptr<work_guard_t> work_guard;
+    std::unique_ptr<control::ControlClient> client;
+    std::thread io_thread;
+
+    SnapControlEventCallback event_cb = nullptr;
+    void* event_ctx = nullptr;
+};
+
+static SnapControlEvent to_control_event(control::ChangeKind kind) {
+    switch (kind) {
+        case control::ChangeKind::Reset:            return SNAPCONTROL_EVENT_RESET;
+        case control::ChangeKind::ClientVolume:     return SNAPCONTROL_EVENT_CLIENT_VOLUME;
+        case control::ChangeKind::ClientLatency:    return SNAPCONTROL_EVENT_CLIENT_LATENCY;
+        case control::ChangeKind::ClientName:       return SNAPCONTROL_EVENT_CLIENT_NAME;
+        case control::ChangeKind::ClientConnection: return SNAPCONTROL_EVENT_CLIENT_CONNECTION;
+        case control::ChangeKind::GroupMute:        return SNAPCONTROL_EVENT_GROUP_MUTE;
+        case control::ChangeKind::GroupStream:      return SNAPCONTROL_EVENT_GROUP_STREAM;
+        case control::ChangeKind::GroupName:        return SNAPCONTROL_EVENT_GROUP_NAME;
+        case control::ChangeKind::StreamStatus:     return SNAPCONTROL_EVENT_STREAM_STATUS;
+        case control::ChangeKind::StreamProperties: return SNAPCONTROL_EVENT_STREAM_PROPERTIES;
+    }
+    return SNAPCONTROL_EVENT_RESET;
+}
+
+static void notify_control_event(SnapControl* c, SnapControlEvent event, const char* object_id) {
+    CallbackGuard guard(c);
+    if (!guard) return;  // Control being destroyed
+
+    SnapControlEventCallback cb = nullptr;
+    void* ctx = nullptr;
+    {
+        std::lock_guard<std::recursive_mutex> lock(c->mutex);
+        cb = c->event_cb;
+        ctx = c->event_ctx;
+    }
+    if (cb) {
+        cb(ctx, event, object_id);
+    }
+}
+
+SnapControlRef snapcontrol_create(void) {
+    BLOG_INFO("snapcontrol_create: allocating control client");
+    return new (std::nothrow) SnapControl();
+}
+
+void snapcontrol_destroy(SnapControlRef control) {
+    if (!control) return;
+
+    control->destroying.store(true, std::memory_order_release);
+    {
+        std::unique_lock<std::recursive_mutex> lock(control->mutex);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (control->callbacksInFlight.load(std::memory_order_acquire) > 0) {
+            if (control->callbacksDone.wait_until(lock, deadline) == std::cv_status::timeout) {
+                BLOG_WARN("snapcontrol_destroy: timeout waiting for callbacks, proceeding anyway");
+                break;
+            }
+        }
+    }
+
+    snapcontrol_disconnect(control);
+    delete control;
+}
+
+void snapcontrol_set_event_callback(SnapControlRef control,
+                                    SnapControlEventCallback callback,
+                                    void* ctx) {
+    if (!control) return;
+    if (control->destroying.load(std::memory_order_acquire)) return;  // Reject during destroy
+
+    std::lock_guard<std::recursive_mutex> lock(control->mutex);
+    control->event_cb = callback;
+    control->event_ctx = ctx;
+}
+
+bool snapcontrol_connect(SnapControlRef control, const char* host, int port) {
+    if (!control || !host || port <= 0 || port > 65535) return false;
+
+    std::lock_guard<std::recursive_mutex> lock(control->mutex);
+    if (control->client) {
+        return false;  // already connected, disconnect first
+    }
+
+    BLOG_INFO("snapcontrol_connect: host=%s, port=%d", host, port);
+    control->io_context = std::make_unique<boost::asio::io_context>();
+    control->work_guard = std::make_unique<work_guard_t>(control->io_context->get_executor());
+    control->client = std::make_unique<control::ControlClient>(*control->io_context);
+
+    control->client->setConnectionHandler([control](bool connected) {
+        notify_control_event(control, connected ? SNAPCONTROL_EVENT_CONNECTED : SNAPCONTROL_EVENT_DISCONNECTED, "");
+    });
+    control->client->setChangeHandler([control](const control::Change& change) {
+        notify_control_event(control, to_control_event(change.kind), change.id.c_str());
+    });
+    control->client->connect(host, static_cast<uint16_t>(port));
+
+    control->io_thread = std::thread([control]() {
+        apply_thread_role("snapcontrol-io", &realtime::ThreadTopology::control);
+        try {
+            control->io_context->run();
+        } catch (const std::exception& e) {
+            BLOG_ERROR("snapcontrol io_context exception: %s", e.what());
+        }
+    });
+    return true;
+}
+
+void snapcontrol_disconnect(SnapControlRef control) {
+    if (!control) return;
+
+    // Phase 1: Signal shutdown (under lock)
+    {
+        std::lock_guard<std::recursive_mutex> lock(control->mutex);
+        if (!control->client) return;
+        control->work_guard.reset();
+        control->io_context->stop();
+    }
+
+    // Phase 2: Join without the lock (event callbacks take it)
+    if (control->io_thread.joinable()) {
+        control->io_thread.join();
+    }
+
+    // Phase 3: Cleanup - the io_context has stopped, no handler can run
+    {
+        std::lock_guard<std::recursive_mutex> lock(control->mutex);
+        control->client.reset();
+        control->io_context.reset();
+    }
+    BLOG_INFO("snapcontrol_disconnect: done");
+}
+
+bool snapcontrol_get_client_volume(SnapControlRef control, const char* client_id,
+                                   int* percent, bool* muted) {
+    if (!control || !client_id) return false;
+    std::lock_guard<std::recursive_mutex> lock(control->mutex);
+    if (!control->client) return false;
+
+    return control->client->withModel([&](const control::ServerModel& model) {
+        const control::ClientState* c = model.client(client_id);
+        if (!c) return false;
+        if (percent) *percent = c->volume;
+        if (muted) *muted = c->muted;
+        return true;
+    });
+}
+
+bool snapcontrol_get_client_latency(SnapControlRef control, const char* client_id, int* latency_ms) {
+    if (!control || !client_id) return false;
+    std::lock_guard<std::recursive_mutex> lock(control->mutex);
+    if (!control->client) return false;
+
+    return control->client->withModel([&](const control::ServerModel& model) {
+        const control::ClientState* c = model.client(client_id);
+        if (!c) return false;
+        if (latency_ms) *latency_ms = c->latency;
+        return true;
+    });
+}
+
+bool snapcontrol_get_group_stream(SnapControlRef control, const char* group_id,
+                                  char* buf, int len) {
+    if (!control || !group_id || !buf || len <= 0) return false;
+    std::lock_guard<std::recursive_mutex> lock(control->mutex);
+    if (!control->client) return false;
+
+    return control->client->withModel([&](const control::ServerModel& model) {
+        const control::GroupState* g = model.group(group_id);
+        if (!g) return false;
+        std::string_view stream = model.str(g->stream);
+        snprintf(buf, static_cast<size_t>(len), "%.*s", static_cast<int>(stream.size()), stream.data());
+        return true;
+    });
+}
+
+bool snapcontrol_get_group_muted(SnapControlRef control, const char* group_id, bool* muted) {
+    if (!control || !group_id) return false;
+    std::lock_guard<std::recursive_mutex> lock(control->mutex);
+    if (!control->client) return false;
+
+    return control->client->withModel([&](const control::ServerModel& model) {
+        const control::GroupState* g = model.group(group_id);
+        if (!g) return false;
+        if (muted) *muted = g->muted;
+        return true;
+    });
+}
+
+bool snapcontrol_set_client_volume(SnapControlRef control, const char* client_id,
+                                   int percent, bool muted) {
+    if (!control || !client_id) return false;
+    std::lock_guard<std::recursive_mutex> lock(control->mutex);
+    if (!control->client || !control->io_thread.joinable()) return false;
+
+    control->client->setClientVolume(client_id, std::clamp(percent, 0, 100), muted);
+    return true;
+}
+
+bool snapcontrol_set_client_latency(SnapControlRef control, const char* client_id, int latency_ms) {
+    if (!control || !client_id) return false;
+    std::lock_guard<std::recursive_mutex> lock(control->mutex);
+    if (!control->client || !control->io_thread.joinable()) return false;
+
+    control->client->setClientLatency(client_id, latency_ms);
+    return true;
+}
+
+bool snapcontrol_set_group_muted(SnapControlRef control, const char* group_id, bool muted) {
+    if (!control || !group_id) return false;
+    std::lock_guard<std::recursive_mutex> lock(control->mutex);
+    if (!control->client || !control->io_thread.joinable()) return false;
+
+    control->client->setGroupMute(group_id, muted);
+    return true;
+}
+
+void snapcontrol_set_command_interval(SnapControlRef control, int interval_ms) {
+    if (!control) return;
+    std::lock_guard<std::recursive_mutex> lock(control->mutex);
+    if (!control->client) return;
+
+    control->client->setCommandInterval(std::chrono::milliseconds(std::max(0, interval_ms)));
+}
+
 /* ── Version ────────────────────────────────────────────────────── */
 
 const char* snapclient_version(void) {
@@ -43,6 +43,8 @@ void snapclient_begin_destroy(SnapClientRef client);
 /* ── Connection ─────────────────────────────────────────────────── */
 
 /// Connect to a Snapserver and start audio playback.
+/// All running clients share one server clock: while others run, a client
+/// can only start against the same server (host and port).
 /// @param host  Server hostname or IP address (UTF-8).
 /// @param port  Server audio port (typically 1704).
 /// @return true on success, false on failure.
@@ -89,6 +91,201 @@ void snapclient_set_latency(SnapClientRef client, int latency_ms);
 /// Get current client latency in milliseconds.
 int snapclient_get_latency(SnapClientRef client);
 
+/* ── Equalizer ──────────────────────────────────────────────────── */
+
+typedef enum {
+    SNAPCLIENT_EQ_PEAKING    = 0,
+    SNAPCLIENT_EQ_LOW_SHELF  = 1,
+    SNAPCLIENT_EQ_HIGH_SHELF = 2,
+    SNAPCLIENT_EQ_LOW_PASS   = 3,
+    SNAPCLIENT_EQ_HIGH_PASS  = 4,
+} SnapEqBandType;
+
+/// One biquad of the parametric EQ (RBJ cookbook shapes).
+typedef struct {
+    SnapEqBandType type;
+    float frequency;   ///< Hz: center, corner or shelf midpoint.
+    float gain_db;     ///< Peaking and shelves only.
+    float q;           ///< 0.707 for a Butterworth corner or a gentle shelf.
+} SnapEqBand;
+
+#define SNAPCLIENT_EQ_MAX_BANDS 10
+
+/// Set the EQ applied before @p client's audio output, the same bands on
+/// every channel; other clients keep theirs. Takes effect within a buffer
+/// with a 20 ms ramp, also while playing, and is kept across reconnects. @p count 0 disables it. Returns false (and
+/// leaves the EQ unchanged) for more than SNAPCLIENT_EQ_MAX_BANDS bands, an
+/// unknown type, or a frequency, Q or gain out of range.
+bool snapclient_set_eq(SnapClientRef client, const SnapEqBand* bands, int count);
+
+/* ── Limiter ────────────────────────────────────────────────────── */
+
+/// Enable @p client's look-ahead peak limiter, the last stage before its
+/// output (on by default). It keeps EQ boosts and hot masters from clipping at the cost
+/// of 2 ms latency, which is included in the sync. Takes effect when the
+/// audio output next opens (connect or stream change).
+void snapclient_set_limiter(SnapClientRef client, bool enabled);
+
+/// Returns true if the limiter is enabled.
+bool snapclient_get_limiter(SnapClientRef client);
+
+/* ── Channel mapping ────────────────────────────────────────────── */
+
+typedef enum {
+    SNAPCLIENT_CHANNELS_NATIVE = 0,  ///< The stream's channels (the OS downmixes).
+    SNAPCLIENT_CHANNELS_STEREO = 1,  ///< 5.1 / 7.1 downmixed to stereo, mono duplicated.
+    SNAPCLIENT_CHANNELS_MONO   = 2,  ///< One channel: the sum of the stereo downmix.
+    SNAPCLIENT_CHANNELS_LEFT   = 3,  ///< One channel: the left side (stereo pair, left speaker).
+    SNAPCLIENT_CHANNELS_RIGHT  = 4,  ///< One channel: the right side.
+    SNAPCLIENT_CHANNELS_CUSTOM = 5,  ///< The matrix from snapclient_set_channel_matrix.
+} SnapChannelMode;
+
+#define SNAPCLIENT_MAX_CHANNELS 8
+
+/// Map the stream's channels before @p client's output. Downmixes follow
+/// ITU-R BS.775 (center and surrounds at -3 dB, LFE dropped) for the WAVE
+/// channel order. Takes effect within a buffer: the audio output reopens
+/// with the new channel count, a short gap.
+void snapclient_set_channel_mode(SnapClientRef client, SnapChannelMode mode);
+
+/// Get the channel mapping mode.
+SnapChannelMode snapclient_get_channel_mode(SnapClientRef client);
+
+/// Set a custom mapping and switch to SNAPCLIENT_CHANNELS_CUSTOM: output
+/// channel o is the sum of gains[o * in_channels + i] * input channel i. It
+/// applies to streams with @p in_channels channels; others play unmapped.
+/// Returns false for channel counts outside 1..SNAPCLIENT_MAX_CHANNELS.
+bool snapclient_set_channel_matrix(SnapClientRef client, const float* gains, int out_channels, int in_channels);
+
+/* ── Bit depth ──────────────────────────────────────────────────── */
+
+/// Play @p client's streams deeper than @p bits (16 or 24) at that depth,
+/// with TPDF dither so quiet passages keep a plain noise floor instead of
+/// distortion; 0 plays every stream at its own depth (default). The audio
+/// output reopens with the new format, a short gap. Returns false for
+/// other values.
+bool snapclient_set_output_bits(SnapClientRef client, int bits);
+
+/// Get the output bit depth (0 = the stream's).
+int snapclient_get_output_bits(SnapClientRef client);
+
+/// Noise shape the dither (off by default): about 16 dB less noise below
+/// 4 kHz, more above 10 kHz. Takes effect when the audio output next opens.
+void snapclient_set_noise_shaping(SnapClientRef client, bool enabled);
+
+/// Returns true if the dither is noise shaped.
+bool snapclient_get_noise_shaping(SnapClientRef client);
+
+/* ── Mixing ─────────────────────────────────────────────────────── */
+
+/// Play this client's stream through the one audio output shared by the
+/// clients that enable mixing (off by default), e.g. music plus
+/// announcements: the first of them to play hosts the output, the others
+/// are mixed in, each kept in sync with its stream. Clients that don't
+/// enable it play on their own output. A stream at another sample rate
+/// than the host's plays on an output of its own. The outputs reopen with
+/// the change, a short gap.
+void snapclient_set_mixing(SnapClientRef client, bool enabled);
+
+/// Returns true if this client's stream is mixed into the shared output.
+bool snapclient_get_mixing(SnapClientRef client);
+
+/// Level of this client's stream in the mix (1.0 = as the server sets it,
+/// 0 = silent), ramped over 20 ms. Takes effect at once, also for clients
+/// not yet playing.
+void snapclient_set_mix_level(SnapClientRef client, float level);
+
+/// Get this client's level in the mix.
+float snapclient_get_mix_level(SnapClientRef client);
+
+/* ── Relay ──────────────────────────────────────────────────────── */
+
+/// Re-serve this client's stream to Snapcast clients nearby: listen on
+/// @p port (0 = any, 1704 as a server would) for up to @p max_clients
+/// downstream clients and forward the CodecHeader and audio chunks as
+/// received, answering their Time requests from this client's clock. The
+/// client must be connected; the relay stops with it. Downstream clients
+/// play at this client's volume and latency and are not announced to the
+/// server. Returns false if the port can't be bound.
+bool snapclient_start_relay(SnapClientRef client, int port, int max_clients);
+
+/// Stop relaying and disconnect the downstream clients.
+void snapclient_stop_relay(SnapClientRef client);
+
+/// Returns the port the relay listens on, 0 if it isn't running.
+int snapclient_relay_port(SnapClientRef client);
+
+/* ── Levels and spectrum ────────────────────────────────────────── */
+
+#define SNAPCLIENT_LEVEL_CHANNELS 8
+#define SNAPCLIENT_SPECTRUM_BANDS 32
+/// Level of silence, dBFS
+#define SNAPCLIENT_SILENCE_DB (-120.0f)
+
+/// Start analyzing what @p client plays, @p fps times a second (1..60), on a
+/// background thread; the audio thread only copies a window per buffer.
+/// Values follow the playout time, so they match what is heard. Restarts
+/// with the new rate if already running. Returns false for a bad rate.
+bool snapclient_start_analysis(SnapClientRef client, int fps);
+
+/// Stop the client's analysis thread (its values fall back to silence).
+void snapclient_stop_analysis(SnapClientRef client);
+
+/// Peak and RMS per channel in dBFS (a full-scale sine: peak 0, RMS -3),
+/// falling at 24 dB/s. Either array may be NULL. Returns the number of
+/// channels written, at most @p max_channels; 0 while nothing plays.
+int snapclient_get_levels(SnapClientRef client, float* peak_db, float* rms_db, int max_channels);
+
+/// Spectrum of the channel sum in SNAPCLIENT_SPECTRUM_BANDS log-spaced
+/// bands from 20 Hz to 20 kHz, dB relative to a full-scale sine. Returns
+/// the number of bands written, at most @p max_bands.
+int snapclient_get_spectrum(SnapClientRef client, float* bands_db, int max_bands);
+
+/* ── Played PCM ─────────────────────────────────────────────────── */
+
+typedef struct SnapPcmConsumer* SnapPcmConsumerRef;
+
+/// A block of played audio, read in place from the player's ring: valid
+/// until snapclient_pcm_release(). Interleaved, 16-bit, or 24/32-bit in
+/// 32-bit containers.
+typedef struct {
+    const void* data;
+    int frames;
+    /// Continuation where the ring wraps, NULL (0 frames) if it does not
+    const void* wrap_data;
+    int wrap_frames;
+    /// When the first frame plays, ns on the monotonic clock
+    /// (clock_gettime_nsec_np(CLOCK_UPTIME_RAW) on Apple)
+    int64_t play_at_ns;
+    /// Position in the ring's frames: consecutive blocks continue it, a
+    /// jump is a gap. Restarts at a format change.
+    uint64_t first_frame;
+    int sample_rate;
+    int channels;
+    int bits;
+} SnapPcmBlock;
+
+/// Register a consumer of the audio @p client plays, after all processing
+/// and synchronization. The audio thread copies each buffer once into a
+/// ring of 2 s shared by the client's consumers; nothing is copied while
+/// none is open.
+/// Returns NULL on failure. Close with snapclient_pcm_close().
+SnapPcmConsumerRef snapclient_pcm_open(SnapClientRef client);
+
+/// Next block, false if there is none yet. Blocks follow each other
+/// without gaps unless the consumer was overrun, or the format changed.
+bool snapclient_pcm_acquire(SnapPcmConsumerRef consumer, SnapPcmBlock* block);
+
+/// Done reading @p block. False if playback overwrote it meanwhile (the
+/// consumer was too slow): discard what was read, it is counted as lost.
+bool snapclient_pcm_release(SnapPcmConsumerRef consumer, const SnapPcmBlock* block);
+
+/// Times playback lapped the consumer; @p lost_frames (may be NULL) gets
+/// the frames it missed through them.
+uint64_t snapclient_pcm_overruns(SnapPcmConsumerRef consumer, uint64_t* lost_frames);
+
+void snapclient_pcm_close(SnapPcmConsumerRef consumer);
+
 /* ── Client identity ────────────────────────────────────────────── */
 
 /// Set the client's display name (UTF-8).
@@ -173,15 +370,194 @@ bool snapclient_configure_audio_session(void);
 
 /// Reset the TimeProvider clock synchronization state.
 /// Call this when the app returns to foreground after being suspended
-/// to prevent clock skew issues (e.g., -46 hour drift).
+/// to prevent clock skew issues (e.g., -46 hour drift). The clock is
+/// shared: every running client re-syncs.
 void snapclient_reset_clock(void);
 
+/* ── Warm start ─────────────────────────────────────────────────── */
+
+/// Directory for the per-server warm-start cache (clock diff and drift, RTT,
+/// stream format). With a cache, snapclient_start() seeds the clock from the
+/// last session instead of playing silence until the first Time reply; the
+/// seed is checked against the first live sync. Pass NULL to disable.
+void snapclient_set_cache_dir(const char* path);
+
+/// Sample rate the server streamed at last time (0 if unknown), e.g. to set
+/// the audio session's preferred rate before snapclient_start().
+int snapclient_cached_sample_rate(const char* host, int port);
+
+/* ── Thread topology ────────────────────────────────────────────── */
+
+/// Scheduling class of an engine thread (Apple QoS classes; on Linux a nice
+/// range from -10 for USER_INTERACTIVE to 19 for BACKGROUND).
+typedef enum {
+    SNAPCLIENT_QOS_USER_INTERACTIVE = 0,
+    SNAPCLIENT_QOS_USER_INITIATED   = 1,
+    SNAPCLIENT_QOS_DEFAULT          = 2,
+    SNAPCLIENT_QOS_UTILITY          = 3,
+    SNAPCLIENT_QOS_BACKGROUND       = 4,
+} SnapThreadQos;
+
+typedef struct {
+    SnapThreadQos qos;
+    int relative_priority;    ///< 0 (highest) to -15 within the class.
+    int cpu;                  ///< Pin to this CPU (Linux only), -1 for any.
+} SnapThreadProfile;
+
+/// Priorities of the engine threads. The audio thread is not listed: its
+/// real-time policy follows the audio buffer geometry.
+typedef struct {
+    bool enabled;                  ///< false leaves every thread at the default.
+    SnapThreadProfile io;          ///< Stream io thread: receive, decode, clock sync.
+    SnapThreadProfile control;     ///< Control plane (snapcontrol_*) io thread.
+    SnapThreadProfile background;  ///< Diagnostics, telemetry, cache writes.
+} SnapThreadConfig;
+
+/// Fill @p config with the defaults: io USER_INTERACTIVE, control UTILITY,
+/// background BACKGROUND, no CPU pinning.
+void snapclient_thread_config_defaults(SnapThreadConfig* config);
+
+/// Set the thread topology for threads started afterwards (snapclient_start,
+/// snapcontrol_connect). NULL restores the defaults.
+void snapclient_set_thread_config(const SnapThreadConfig* config);
+
+/// Apply the background profile to the calling thread, e.g. a thread that
+/// writes logs or uploads telemetry, so it only uses idle CPU time.
+void snapclient_apply_background_profile(void);
+
 /* ── Diagnostics ────────────────────────────────────────────────── */
 
 /// Test raw TCP connection to host:port (bypasses Snapcast protocol).
 /// Returns 0 on success, or errno on failure. Logs details via log callback.
 int snapclient_test_tcp(const char* host, int port);
 
+/// Outcome of probing one server (see snapclient_probe_servers).
+typedef struct {
+    int index;          ///< Position of the server in the input arrays.
+    bool reachable;     ///< Connected and answered a Time request.
+    int connect_us;     ///< Time until TCP connected (0 if it never did).
+    int rtt_us;         ///< Protocol round trip (Time request/reply).
+    int error;          ///< System error code if unreachable, else 0.
+} SnapProbeResult;
+
+/// Probe several servers (stream port, usually 1704) concurrently with a
+/// Time request. Blocks for at most @p timeout_ms; returns early once every
+/// probe finished, or 100 ms after the first server answered.
+/// @param results  Array of @p count entries, filled ranked: reachable servers
+///                 by RTT first, then unreachable ones in input order.
+/// @return number of reachable servers, or -1 on invalid arguments.
+int snapclient_probe_servers(const char* const* hosts, const int* ports, int count,
+                             int timeout_ms, SnapProbeResult* results);
+
+/// Link quality measured while the server streams (see snapclient_probe_link).
+typedef struct {
+    int samples;              ///< Time exchanges completed.
+    int rtt_min_us;
+    int rtt_median_us;
+    int rtt_p95_us;
+    int rtt_max_us;
+    int jitter_us;            ///< Mean difference of consecutive RTTs.
+    int64_t offset_us;        ///< Server clock minus client clock (median).
+    int offset_stddev_us;     ///< Offset stability across samples.
+    int64_t offset_filtered_us; ///< Offset without replies queued behind audio.
+    int hol_discarded;        ///< Time replies discarded as head-of-line delayed.
+    int kernel_timestamps;    ///< 1 if receive times came from the kernel.
+    double throughput_kbps;   ///< Average over the receive window.
+    double peak_kbps;         ///< Best 100 ms (the server's buffer burst).
+    int chunks;               ///< Audio chunks received.
+    char codec[16];           ///< Stream codec ("flac", "pcm", ...), "" if unknown.
+} SnapLinkQuality;
+
+/// Diagnose the link to a server's stream port with a real Hello, a burst of
+/// Time exchanges and a receive window of @p window_ms. Blocks for about
+/// @p window_ms (plus connect time, at most 2 s).
+/// @param client_id  Hello ID; pass the player's own ID (the server records it).
+/// @return 0 on success, errno-style code if the server could not be measured.
+int snapclient_probe_link(const char* host, int port, const char* client_id,
+                          int window_ms, SnapLinkQuality* quality);
+
+/* ── Control plane (JSON-RPC) ───────────────────────────────────── */
+
+/// Opaque pointer to a control API connection (Snapcast TCP JSON-RPC, port 1705).
+/// Independent of SnapClientRef: the app can control a server it isn't playing from.
+typedef struct SnapControl* SnapControlRef;
+
+/// Kind of change reported by the control client.
+typedef enum {
+    SNAPCONTROL_EVENT_CONNECTED         = 0,   ///< Control connection established
+    SNAPCONTROL_EVENT_DISCONNECTED      = 1,   ///< Control connection lost or closed
+    SNAPCONTROL_EVENT_RESET             = 2,   ///< Whole server model reloaded
+    SNAPCONTROL_EVENT_CLIENT_VOLUME     = 3,
+    SNAPCONTROL_EVENT_CLIENT_LATENCY    = 4,
+    SNAPCONTROL_EVENT_CLIENT_NAME       = 5,
+    SNAPCONTROL_EVENT_CLIENT_CONNECTION = 6,
+    SNAPCONTROL_EVENT_GROUP_MUTE        = 7,
+    SNAPCONTROL_EVENT_GROUP_STREAM      = 8,
+    SNAPCONTROL_EVENT_GROUP_NAME        = 9,
+    SNAPCONTROL_EVENT_STREAM_STATUS     = 10,
+    SNAPCONTROL_EVENT_STREAM_PROPERTIES = 11,
+} SnapControlEvent;
+
+/// Callback invoked for each model change, on the control I/O thread.
+/// @param ctx        User-provided context pointer.
+/// @param event      What changed.
+/// @param object_id  ID of the changed client/group/stream ("" for connection and reset events).
+typedef void (*SnapControlEventCallback)(void* ctx, SnapControlEvent event, const char* object_id);
+
+/// Create a control client. Returns NULL on failure.
+SnapControlRef snapcontrol_create(void);
+
+/// Disconnect and free all resources. Safe to call with NULL.
+void snapcontrol_destroy(SnapControlRef control);
+
+/// Register the change callback. Pass NULL to unregister.
+void snapcontrol_set_event_callback(SnapControlRef control,
+                                    SnapControlEventCallback callback,
+                                    void* ctx);
+
+/// Connect asynchronously to the control API (typically port 1705).
+/// The full status is loaded once; notifications are then applied incrementally.
+/// @return false if already connected or on invalid arguments.
+bool snapcontrol_connect(SnapControlRef control, const char* host, int port);
+
+/// Close the control connection.
+void snapcontrol_disconnect(SnapControlRef control);
+
+/// Read a client's volume from the local model.
+/// @return false if the client is unknown.
+bool snapcontrol_get_client_volume(SnapControlRef control, const char* client_id,
+                                   int* percent, bool* muted);
+
+/// Read a client's latency (ms) from the local model.
+/// @return false if the client is unknown.
+bool snapcontrol_get_client_latency(SnapControlRef control, const char* client_id, int* latency_ms);
+
+/// Copy a group's stream ID into @p buf (NUL-terminated, truncated to @p len).
+/// @return false if the group is unknown.
+bool snapcontrol_get_group_stream(SnapControlRef control, const char* group_id,
+                                  char* buf, int len);
+
+/// Read a group's mute state from the local model.
+/// @return false if the group is unknown.
+bool snapcontrol_get_group_muted(SnapControlRef control, const char* group_id, bool* muted);
+
+/// Set a client's volume (0-100). Safe to call for every slider event:
+/// the local model changes at once (CLIENT_VOLUME event), requests are
+/// coalesced so only the latest value per client is sent.
+/// @return false if not connected or on invalid arguments.
+bool snapcontrol_set_client_volume(SnapControlRef control, const char* client_id,
+                                   int percent, bool muted);
+
+/// Set a client's latency (ms), coalesced like snapcontrol_set_client_volume().
+bool snapcontrol_set_client_latency(SnapControlRef control, const char* client_id, int latency_ms);
+
+/// Mute or unmute a group, coalesced like snapcontrol_set_client_volume().
+bool snapcontrol_set_group_muted(SnapControlRef control, const char* group_id, bool muted);
+
+/// Minimum spacing between two coalesced commands in ms (default 0: one
+/// request per server round trip and target).
+void snapcontrol_set_command_interval(SnapControlRef control, int interval_ms);
+
 /* ── Version info ───────────────────────────────────────────────── */
 
 /// Returns the snapclient core version string (e.g. "0.34.0").
@@ -0,0 +1,366 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "warm_start_cache.hpp"
+
+// Standard headers
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace cache
+{
+
+namespace
+{
+
+constexpr uint8_t MAGIC[4] = {'S', 'F', 'W', 'S'};
+constexpr uint16_t FORMAT_VERSION = 1;
+constexpr size_t MAX_FILE_SIZE = 4096;
+
+/// Wall minus steady elapsed time below this is clock noise, not sleep
+constexpr int64_t SLEEP_THRESHOLD_US = 250'000;
+/// Syncs closer than this say little about drift
+constexpr int64_t MIN_DRIFT_INTERVAL_US = 10LL * 60 * 1'000'000;
+/// Anything beyond this is a clock step, not drift
+constexpr double MAX_DRIFT_PPM = 500.0;
+
+uint32_t fnv1a(const uint8_t* data, size_t size)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+
+class Writer
+{
+public:
+    void u16(uint16_t v)
+    {
+        put(v, 2);
+    }
+
+    void u32(uint32_t v)
+    {
+        put(v, 4);
+    }
+
+    void i64(int64_t v)
+    {
+        put(static_cast<uint64_t>(v), 8);
+    }
+
+    void f64(double v)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        put(bits, 8);
+    }
+
+    void str(const std::string& s)
+    {
+        u16(static_cast<uint16_t>(s.size()));
+        out.insert(out.end(), s.begin(), s.end());
+    }
+
+    std::vector<uint8_t> out;
+
+private:
+    void put(uint64_t v, int bytes)
+    {
+        for (int i = 0; i < bytes; ++i)
+            out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+};
+
+
+class Reader
+{
+public:
+    Reader(const uint8_t* data, size_t size) : p_(data), end_(data + size)
+    {
+    }
+
+    bool u16(uint16_t& v)
+    {
+        uint64_t raw;
+        if (!get(raw, 2))
+            return false;
+        v = static_cast<uint16_t>(raw);
+        return true;
+    }
+
+    bool u32(uint32_t& v)
+    {
+        uint64_t raw;
+        if (!get(raw, 4))
+            return false;
+        v = static_cast<uint32_t>(raw);
+        return true;
+    }
+
+    bool i64(int64_t& v)
+    {
+        uint64_t raw;
+        if (!get(raw, 8))
+            return false;
+        v = static_cast<int64_t>(raw);
+        return true;
+    }
+
+    bool f64(double& v)
+    {
+        uint64_t raw;
+        if (!get(raw, 8))
+            return false;
+        std::memcpy(&v, &raw, sizeof(v));
+        return std::isfinite(v);
+    }
+
+    bool str(std::string& s)
+    {
+        uint16_t size;
+        if (!u16(size) || static_cast<size_t>(end_ - p_) < size)
+            return false;
+        s.assign(reinterpret_cast<const char*>(p_), size);
+        p_ += size;
+        return true;
+    }
+
+    bool atEnd() const
+    {
+        return p_ == end_;
+    }
+
+private:
+    bool get(uint64_t& v, int bytes)
+    {
+        if (end_ - p_ < bytes)
+            return false;
+        v = 0;
+        for (int i = 0; i < bytes; ++i)
+            v |= static_cast<uint64_t>(p_[i]) << (8 * i);
+        p_ += bytes;
+        return true;
+    }
+
+    const uint8_t* p_;
+    const uint8_t* end_;
+};
+
+
+int64_t toMicros(std::chrono::system_clock::time_point t)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(t.time_since_epoch()).count();
+}
+
+
+int64_t toMicros(std::chrono::steady_clock::time_point t)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(t.time_since_epoch()).count();
+}
+
+} // namespace
+
+
+ClockReading ClockReading::now()
+{
+    return {toMicros(std::chrono::system_clock::now()), toMicros(std::chrono::steady_clock::now())};
+}
+
+
+std::vector<uint8_t> encode(const WarmStartEntry& entry)
+{
+    Writer w;
+    w.out.assign(std::begin(MAGIC), std::end(MAGIC));
+    w.u16(FORMAT_VERSION);
+    w.str(entry.server);
+    w.i64(entry.diffToServerUs);
+    w.i64(entry.measured.systemUs);
+    w.i64(entry.measured.steadyUs);
+    w.f64(entry.driftPpm);
+    w.i64(entry.rttMedianUs);
+    w.i64(entry.rttP95Us);
+    w.u32(entry.sampleRate);
+    w.u16(entry.bits);
+    w.u16(entry.channels);
+    w.str(entry.codec);
+    w.u32(entry.confirmed);
+    w.u32(fnv1a(w.out.data(), w.out.size()));
+    return std::move(w.out);
+}
+
+
+std::optional<WarmStartEntry> decode(const uint8_t* data, size_t size)
+{
+    if (size < sizeof(MAGIC) + 2 + 4 || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0)
+        return std::nullopt;
+
+    Reader checksum(data + size - 4, 4);
+    uint32_t expected;
+    if (!checksum.u32(expected) || expected != fnv1a(data, size - 4))
+        return std::nullopt;
+
+    Reader r(data + sizeof(MAGIC), size - sizeof(MAGIC) - 4);
+    uint16_t version;
+    if (!r.u16(version) || version != FORMAT_VERSION)
+        return std::nullopt;
+
+    WarmStartEntry e;
+    bool ok = r.str(e.server) && r.i64(e.diffToServerUs) && r.i64(e.measured.systemUs) && r.i64(e.measured.steadyUs) &&
+              r.f64(e.driftPpm) && r.i64(e.rttMedianUs) && r.i64(e.rttP95Us) && r.u32(e.sampleRate) && r.u16(e.bits) &&
+              r.u16(e.channels) && r.str(e.codec) && r.u32(e.confirmed) && r.atEnd();
+    if (!ok)
+        return std::nullopt;
+    return e;
+}
+
+
+std::optional<Seed> predictSeed(const WarmStartEntry& entry, const ClockReading& now, const SeedPolicy& policy)
+{
+    if (!entry.hasDiff())
+        return std::nullopt;
+
+    int64_t wallElapsed = now.systemUs - entry.measured.systemUs;
+    int64_t steadyElapsed = now.steadyUs - entry.measured.steadyUs;
+
+    // Steady clock went backwards: we rebooted, the old diff means nothing
+    if (steadyElapsed < 0)
+        return std::nullopt;
+    // Wall clock stepped back further than noise: cannot tell how long we slept
+    if (wallElapsed < steadyElapsed - SLEEP_THRESHOLD_US)
+        return std::nullopt;
+    if (wallElapsed > std::chrono::duration_cast<std::chrono::microseconds>(policy.maxAge).count())
+        return std::nullopt;
+
+    // The server clock ran on while ours was stopped by sleep
+    int64_t sleep = wallElapsed - steadyElapsed;
+    int64_t diff = entry.diffToServerUs + std::llround(entry.driftPpm * static_cast<double>(wallElapsed) / 1e6);
+    int64_t tolerance = policy.baseTolerance.count() + entry.rttP95Us / 2 +
+                        std::llround(policy.driftUncertaintyPpm * static_cast<double>(wallElapsed) / 1e6);
+    if (sleep > SLEEP_THRESHOLD_US)
+    {
+        diff += sleep;
+        tolerance += policy.sleepTolerance.count();
+    }
+    return Seed{std::chrono::microseconds(diff), std::chrono::microseconds(tolerance)};
+}
+
+
+SeedCheck checkSeed(const Seed& seed, std::chrono::microseconds liveDiff)
+{
+    auto error = liveDiff - seed.diff;
+    if (error < error.zero())
+        error = -error;
+    return (error <= seed.tolerance) ? SeedCheck::Confirmed : SeedCheck::Rejected;
+}
+
+
+void recordDiff(WarmStartEntry& entry, std::chrono::microseconds diff, const ClockReading& now)
+{
+    if (entry.hasDiff())
+    {
+        int64_t steadyElapsed = now.steadyUs - entry.measured.steadyUs;
+        int64_t wallElapsed = now.systemUs - entry.measured.systemUs;
+        bool awake = std::llabs(wallElapsed - steadyElapsed) < SLEEP_THRESHOLD_US;
+        if (awake && steadyElapsed >= MIN_DRIFT_INTERVAL_US)
+        {
+            double ppm = static_cast<double>(diff.count() - entry.diffToServerUs) * 1e6 / static_cast<double>(steadyElapsed);
+            if (std::fabs(ppm) <= MAX_DRIFT_PPM)
+                entry.driftPpm = (entry.driftPpm == 0.0) ? ppm : (entry.driftPpm + ppm) / 2;
+        }
+    }
+    entry.diffToServerUs = diff.count();
+    entry.measured = now;
+}
+
+
+WarmStartCache::WarmStartCache(std::string directory) : directory_(std::move(directory))
+{
+}
+
+
+std::string WarmStartCache::path(const std::string& server) const
+{
+    std::string name;
+    name.reserve(server.size());
+    for (char c : server)
+    {
+        bool safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '.' || c == '-';
+        name.push_back(safe ? c : '_');
+    }
+    return directory_ + "/" + name + ".warmstart";
+}
+
+
+std::optional<WarmStartEntry> WarmStartCache::load(const std::string& server) const
+{
+    std::ifstream in(path(server), std::ios::binary);
+    if (!in)
+        return std::nullopt;
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (data.size() > MAX_FILE_SIZE)
+        return std::nullopt;
+
+    auto entry = decode(data.data(), data.size());
+    // A file renamed or copied from another server is not ours
+    if (!entry || entry->server != server)
+        return std::nullopt;
+    return entry;
+}
+
+
+bool WarmStartCache::store(const WarmStartEntry& entry) const
+{
+    auto data = encode(entry);
+    std::string target = path(entry.server);
+    std::string temp = target + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+        out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!out)
+        {
+            out.close();
+            std::remove(temp.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temp.c_str(), target.c_str()) != 0)
+    {
+        std::remove(temp.c_str());
+        return false;
+    }
+    return true;
+}
+
+
+bool WarmStartCache::remove(const std::string& server) const
+{
+    return std::remove(path(server).c_str()) == 0;
+}
+
+} // namespace cache
@@ -0,0 +1,145 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// Standard headers
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+/// Per-server warm-start state, persisted between launches.
+///
+/// A cold start resets TimeProvider and plays silence until the first Time
+/// reply arrives, which on a busy link sits behind the server's buffer burst.
+/// The cache remembers what the last session learned about a server (clock
+/// diff and its drift, RTT, stream format) so the next start can seed the
+/// clock immediately and check the seed against the first live sync.
+///
+/// Clock diffs are server steady clock minus our steady clock, as in
+/// TimeProvider. Our steady clock stops while the device sleeps and restarts
+/// at boot, so every entry also records the wall clock: the difference
+/// between wall and steady elapsed time is the sleep to compensate for.
+namespace cache
+{
+
+/// Wall and steady clock read together
+struct ClockReading
+{
+    int64_t systemUs{0};
+    int64_t steadyUs{0};
+
+    static ClockReading now();
+};
+
+struct WarmStartEntry
+{
+    /// "host:port" of the stream server
+    std::string server;
+
+    /// Last clock diff to the server and when it was measured (0: never)
+    int64_t diffToServerUs{0};
+    ClockReading measured;
+    /// Drift of the server clock against ours, from two syncs far enough apart
+    double driftPpm{0.0};
+
+    /// Round trip profile (0: unknown)
+    int64_t rttMedianUs{0};
+    int64_t rttP95Us{0};
+
+    /// Stream format (0: unknown) and codec name
+    uint32_t sampleRate{0};
+    uint16_t bits{0};
+    uint16_t channels{0};
+    std::string codec;
+
+    /// Seeds confirmed by a live sync in a row (reset by a rejection)
+    uint32_t confirmed{0};
+
+    bool hasDiff() const
+    {
+        return measured.steadyUs != 0;
+    }
+};
+
+/// Serialize an entry (versioned, checksummed, little-endian)
+std::vector<uint8_t> encode(const WarmStartEntry& entry);
+/// @return the entry, or nullopt for a truncated, corrupt or foreign blob
+std::optional<WarmStartEntry> decode(const uint8_t* data, size_t size);
+
+struct SeedPolicy
+{
+    /// Entries older than this are not used to seed the clock
+    std::chrono::hours maxAge{std::chrono::hours(24 * 7)};
+    /// Accuracy assumed for a seed on top of the RTT and drift terms
+    std::chrono::microseconds baseTolerance{std::chrono::milliseconds(2)};
+    /// Extra tolerance when sleep had to be compensated through the wall
+    /// clock (NTP adjustments land in the same term)
+    std::chrono::microseconds sleepTolerance{std::chrono::milliseconds(20)};
+    /// Assumed error of the drift estimate
+    double driftUncertaintyPpm{5.0};
+};
+
+struct Seed
+{
+    /// Predicted diff to the server now
+    std::chrono::microseconds diff{0};
+    /// How far the first live sync may deviate before the seed is rejected
+    std::chrono::microseconds tolerance{0};
+};
+
+/// Predict the current diff to the server from a cached entry.
+/// @return nullopt if the entry has no diff, is too old, or the clocks show a
+///         reboot or a wall clock step backwards
+std::optional<Seed> predictSeed(const WarmStartEntry& entry, const ClockReading& now, const SeedPolicy& policy = {});
+
+enum class SeedCheck
+{
+    Confirmed,
+    Rejected,
+};
+
+/// Compare a seed with the diff measured by live syncs
+SeedCheck checkSeed(const Seed& seed, std::chrono::microseconds liveDiff);
+
+/// Store a live diff in the entry, updating the drift estimate when the
+/// previous measurement is far enough away and no sleep happened in between
+void recordDiff(WarmStartEntry& entry, std::chrono::microseconds diff, const ClockReading& now);
+
+/// One file per server in a directory owned by the app (e.g. Caches/)
+class WarmStartCache
+{
+public:
+    explicit WarmStartCache(std::string directory);
+
+    std::optional<WarmStartEntry> load(const std::string& server) const;
+    /// Written to a temporary file and renamed, so readers never see half an entry
+    bool store(const WarmStartEntry& entry) const;
+    bool remove(const std::string& server) const;
+
+    /// File that holds @p server's entry
+    std::string path(const std::string& server) const;
+
+private:
+    std::string directory_;
+};
+
+} // namespace cache
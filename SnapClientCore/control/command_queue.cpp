@@ -0,0 +1,107 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "command_queue.hpp"
+
+// Standard headers
+#include <algorithm>
+
+namespace control
+{
+
+CommandQueue::CommandQueue(boost::asio::io_context& io_context, SendFunction send) : send_(std::move(send)), timer_(io_context)
+{
+}
+
+
+void CommandQueue::setInterval(std::chrono::milliseconds interval)
+{
+    interval_ = std::max(interval, std::chrono::milliseconds(0));
+}
+
+
+void CommandQueue::push(const std::string& method, const std::string& target, json params)
+{
+    stats_.pushed++;
+    auto it = std::find_if(queue_.begin(), queue_.end(),
+                           [&](const Command& c) { return (c.target == target) && (c.method == method); });
+    if (it != queue_.end())
+    {
+        it->params = std::move(params);
+        stats_.coalesced++;
+        return;
+    }
+    queue_.push_back({method, target, std::move(params)});
+    pump();
+}
+
+
+bool CommandQueue::isQueued(const std::string& method, const std::string& target) const
+{
+    return std::any_of(queue_.begin(), queue_.end(),
+                       [&](const Command& c) { return (c.target == target) && (c.method == method); });
+}
+
+
+void CommandQueue::clear()
+{
+    queue_.clear();
+    timer_.cancel();
+    timerArmed_ = false;
+}
+
+
+void CommandQueue::pump()
+{
+    while (!timerArmed_)
+    {
+        // Oldest command whose target is idle
+        auto it = std::find_if(queue_.begin(), queue_.end(), [this](const Command& c) { return inFlight_.count(c.target) == 0; });
+        if (it == queue_.end())
+            return;
+
+        auto now = std::chrono::steady_clock::now();
+        if ((interval_.count() > 0) && (now < lastSend_ + interval_))
+        {
+            timerArmed_ = true;
+            timer_.expires_at(lastSend_ + interval_);
+            timer_.async_wait([this](const boost::system::error_code& ec)
+            {
+                if (ec)
+                    return;
+                timerArmed_ = false;
+                pump();
+            });
+            return;
+        }
+
+        Command cmd = std::move(*it);
+        queue_.erase(it);
+        inFlight_.insert(cmd.target);
+        lastSend_ = now;
+        stats_.sent++;
+
+        send_(cmd.method, cmd.target, cmd.params, [this, target = cmd.target]()
+        {
+            inFlight_.erase(target);
+            pump();
+        });
+    }
+}
+
+} // namespace control
@@ -0,0 +1,107 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// local headers
+#include "common/json.hpp"
+
+// 3rd party headers
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+// Standard headers
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <unordered_set>
+
+namespace control
+{
+
+using json = nlohmann::json;
+
+/// Coalescing queue for state-setting commands (Client.SetVolume, Group.SetMute, ...).
+///
+/// Commands are keyed by (method, target), where the target is the client or
+/// group ID. A command pushed while another with the same key is still queued
+/// replaces it (last write wins) and keeps its place in the queue. At most one
+/// command per target is in flight: the next one for that target is only sent
+/// once the server has answered. Sends are spaced at least interval() apart.
+///
+/// Dragging a volume slider therefore costs one request per round trip (or
+/// per interval) instead of one per slider event, and the last value always
+/// reaches the server.
+///
+/// io thread only.
+class CommandQueue
+{
+public:
+    using DoneHandler = std::function<void()>;
+    /// Sends one request; @p done must be called exactly once when it completes or fails
+    using SendFunction = std::function<void(const std::string& method, const std::string& target, const json& params, DoneHandler done)>;
+
+    struct Stats
+    {
+        uint64_t pushed{0};     ///< Commands pushed
+        uint64_t coalesced{0};  ///< Pushes that replaced a queued command
+        uint64_t sent{0};       ///< Requests sent
+    };
+
+    CommandQueue(boost::asio::io_context& io_context, SendFunction send);
+
+    /// Minimum time between two sends (0: send as soon as the target is free)
+    void setInterval(std::chrono::milliseconds interval);
+    std::chrono::milliseconds interval() const { return interval_; }
+
+    /// Queue a command, replacing a queued one with the same method and target
+    void push(const std::string& method, const std::string& target, json params);
+
+    /// @return true if a command with this method and target waits to be sent
+    bool isQueued(const std::string& method, const std::string& target) const;
+
+    /// Drop all queued commands. In-flight ones still complete via their handler.
+    void clear();
+
+    size_t size() const { return queue_.size(); }
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Command
+    {
+        std::string method;
+        std::string target;
+        json params;
+    };
+
+    void pump();
+
+    SendFunction send_;
+    boost::asio::steady_timer timer_;
+    std::chrono::milliseconds interval_{0};
+    std::chrono::steady_clock::time_point lastSend_;
+    bool timerArmed_{false};
+
+    std::deque<Command> queue_;
+    std::unordered_set<std::string> inFlight_;
+    Stats stats_;
+};
+
+} // namespace control
@@ -0,0 +1,555 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "control_client.hpp"
+
+// local headers
+#include "common/aixlog.hpp"
+#include "status_parser.hpp"
+
+// 3rd party headers
+#include <boost/asio/connect.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/write.hpp>
+
+// Standard headers
+#include <istream>
+#include <vector>
+
+namespace control
+{
+
+static constexpr auto LOG_TAG = "ControlClient";
+
+using boost::asio::ip::tcp;
+
+namespace
+{
+
+/// Commands whose effect the server reports with a notification of the same
+/// params shape (and whose reply carries the new value without the ID)
+struct CommandEcho
+{
+    const char* command;
+    const char* notification;
+};
+
+constexpr CommandEcho COMMAND_ECHOES[] = {
+    {"Client.SetVolume", "Client.OnVolumeChanged"},
+    {"Client.SetLatency", "Client.OnLatencyChanged"},
+    {"Group.SetMute", "Group.OnMute"},
+};
+
+const char* notificationFor(const std::string& command)
+{
+    for (const auto& echo : COMMAND_ECHOES)
+        if (command == echo.command)
+            return echo.notification;
+    return nullptr;
+}
+
+const char* commandFor(const std::string& notification)
+{
+    for (const auto& echo : COMMAND_ECHOES)
+        if (notification == echo.notification)
+            return echo.command;
+    return nullptr;
+}
+
+} // namespace
+
+
+ControlClient::ControlClient(boost::asio::io_context& io_context)
+    : io_context_(io_context), resolver_(io_context), socket_(io_context),
+      commands_(io_context, [this](const std::string& method, const std::string& target, const json& params, CommandQueue::DoneHandler done)
+                { sendCommand(method, target, params, std::move(done)); })
+{
+}
+
+
+ControlClient::~ControlClient()
+{
+    boost::system::error_code ec;
+    socket_.close(ec);
+}
+
+
+void ControlClient::setChangeHandler(ChangeHandler handler)
+{
+    changeHandler_ = std::move(handler);
+}
+
+
+void ControlClient::setConnectionHandler(ConnectionHandler handler)
+{
+    connectionHandler_ = std::move(handler);
+}
+
+
+void ControlClient::connect(const std::string& host, uint16_t port)
+{
+    boost::asio::post(io_context_, [this, host, port]() { doConnect(host, port); });
+}
+
+
+void ControlClient::disconnect()
+{
+    boost::asio::post(io_context_, [this]() { closeSocket(boost::asio::error::operation_aborted); });
+}
+
+
+void ControlClient::request(const std::string& method, json params, ResponseHandler handler)
+{
+    boost::asio::post(io_context_, [this, method, params = std::move(params), handler = std::move(handler)]() mutable
+    { sendRequest(method, std::move(params), std::move(handler)); });
+}
+
+
+void ControlClient::setClientVolume(const std::string& clientId, int percent, bool muted)
+{
+    json params = {{"id", clientId}, {"volume", {{"muted", muted}, {"percent", percent}}}};
+    boost::asio::post(io_context_, [this, clientId, params = std::move(params)]() mutable
+    { pushCommand("Client.SetVolume", clientId, std::move(params)); });
+}
+
+
+void ControlClient::setClientLatency(const std::string& clientId, int latency)
+{
+    json params = {{"id", clientId}, {"latency", latency}};
+    boost::asio::post(io_context_, [this, clientId, params = std::move(params)]() mutable
+    { pushCommand("Client.SetLatency", clientId, std::move(params)); });
+}
+
+
+void ControlClient::setGroupMute(const std::string& groupId, bool muted)
+{
+    json params = {{"id", groupId}, {"mute", muted}};
+    boost::asio::post(io_context_, [this, groupId, params = std::move(params)]() mutable
+    { pushCommand("Group.SetMute", groupId, std::move(params)); });
+}
+
+
+void ControlClient::setCommandInterval(std::chrono::milliseconds interval)
+{
+    boost::asio::post(io_context_, [this, interval]() { commands_.setInterval(interval); });
+}
+
+
+ControlClient::Stats ControlClient::stats() const
+{
+    Stats s;
+    s.notifications = notifications_.load(std::memory_order_relaxed);
+    s.incremental = incremental_.load(std::memory_order_relaxed);
+    s.stale = stale_.load(std::memory_order_relaxed);
+    s.fullRefreshes = fullRefreshes_.load(std::memory_order_relaxed);
+    s.bytesReceived = bytesReceived_.load(std::memory_order_relaxed);
+    s.commandsPushed = commandsPushed_.load(std::memory_order_relaxed);
+    s.commandsSent = commandsSent_.load(std::memory_order_relaxed);
+    return s;
+}
+
+
+void ControlClient::doConnect(const std::string& host, uint16_t port)
+{
+    closeSocket(boost::asio::error::operation_aborted);
+    LOG(INFO, LOG_TAG) << "Connecting to " << host << ":" << port << "\n";
+
+    resolver_.async_resolve(host, std::to_string(port), [this](const boost::system::error_code& ec, const tcp::resolver::results_type& results)
+    {
+        if (ec)
+        {
+            LOG(ERROR, LOG_TAG) << "Resolve failed: " << ec.message() << "\n";
+            closeSocket(ec);
+            return;
+        }
+        boost::asio::async_connect(socket_, results, [this](const boost::system::error_code& ec, const tcp::endpoint& endpoint)
+        {
+            if (ec)
+            {
+                LOG(ERROR, LOG_TAG) << "Connect failed: " << ec.message() << "\n";
+                closeSocket(ec);
+                return;
+            }
+            LOG(INFO, LOG_TAG) << "Connected to " << endpoint << "\n";
+            onConnected();
+        });
+    });
+}
+
+
+void ControlClient::onConnected()
+{
+    connected_ = true;
+    boost::system::error_code ec;
+    socket_.set_option(tcp::no_delay(true), ec);
+
+    if (connectionHandler_)
+        connectionHandler_(true);
+
+    readNext();
+    refreshStatus();
+}
+
+
+void ControlClient::closeSocket(const boost::system::error_code& reason)
+{
+    boost::system::error_code ec;
+    resolver_.cancel();
+    socket_.close(ec);
+    writeQueue_.clear();
+    ++connection_;
+    readBuffer_.consume(readBuffer_.size());
+    refreshInFlight_ = false;
+    refreshPending_ = false;
+    commands_.clear();
+
+    // Fail outstanding requests (move out first: handlers may issue new requests)
+    auto pending = std::move(pending_);
+    pending_.clear();
+    for (auto& [id, handler] : pending)
+        handler(boost::asio::error::operation_aborted, json());
+
+    bool wasConnected = connected_;
+    connected_ = false;
+    if (wasConnected || reason != boost::asio::error::operation_aborted)
+    {
+        if (connectionHandler_)
+            connectionHandler_(false);
+    }
+}
+
+
+void ControlClient::readNext()
+{
+    boost::asio::async_read_until(socket_, readBuffer_, '\n', [this](const boost::system::error_code& ec, std::size_t length)
+    {
+        if (ec)
+        {
+            if (ec != boost::asio::error::operation_aborted)
+            {
+                LOG(ERROR, LOG_TAG) << "Read failed: " << ec.message() << "\n";
+                closeSocket(ec);
+            }
+            return;
+        }
+
+        bytesReceived_.fetch_add(length, std::memory_order_relaxed);
+        std::string line(boost::asio::buffers_begin(readBuffer_.data()), boost::asio::buffers_begin(readBuffer_.data()) + length);
+        readBuffer_.consume(length);
+        handleLine(line);
+
+        if (connected_)
+            readNext();
+    });
+}
+
+
+void ControlClient::handleLine(const std::string& line)
+{
+    // Messages are terminated with "\r\n", and may be padded with whitespace
+    auto first = line.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos)
+        return;
+
+    if (handleStatusMessage(std::string_view(line).substr(first)))
+        return;
+
+    json msg = json::parse(line.begin() + first, line.end(), nullptr, false);
+    if (msg.is_discarded())
+    {
+        LOG(WARNING, LOG_TAG) << "Ignoring malformed message (" << line.size() << " bytes)\n";
+        return;
+    }
+
+    // JSON-RPC batch
+    if (msg.is_array())
+    {
+        for (const auto& m : msg)
+            handleMessage(m);
+        return;
+    }
+    handleMessage(msg);
+}
+
+
+void ControlClient::handleMessage(const json& msg)
+{
+    if (!msg.is_object())
+        return;
+
+    // Notification: has a method but no id
+    auto method = msg.find("method");
+    if ((method != msg.end()) && method->is_string() && !msg.contains("id"))
+    {
+        auto params = msg.find("params");
+        handleNotification(method->get<std::string>(), (params != msg.end()) ? *params : json::object());
+        return;
+    }
+
+    auto id = msg.find("id");
+    if ((id == msg.end()) || !id->is_number_integer())
+        return;
+
+    auto it = pending_.find(id->get<int>());
+    if (it == pending_.end())
+        return;
+    ResponseHandler handler = std::move(it->second);
+    pending_.erase(it);
+
+    if (auto error = msg.find("error"); error != msg.end())
+    {
+        LOG(WARNING, LOG_TAG) << "Request " << id->get<int>() << " failed: " << error->dump() << "\n";
+        handler(boost::system::errc::make_error_code(boost::system::errc::protocol_error), *error);
+        return;
+    }
+    auto result = msg.find("result");
+    handler({}, (result != msg.end()) ? *result : json());
+}
+
+
+void ControlClient::handleNotification(const std::string& method, const json& params)
+{
+    notifications_.fetch_add(1, std::memory_order_relaxed);
+
+    // Our newer value for this target is queued: the notification is stale,
+    // and applying it would make the UI jump back until the command lands
+    if (const char* command = commandFor(method))
+    {
+        auto id = params.find("id");
+        if ((id != params.end()) && id->is_string() && commands_.isQueued(command, id->get<std::string>()))
+        {
+            stale_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    std::vector<Change> changes;
+    bool applied;
+    {
+        std::lock_guard<std::mutex> lock(modelMutex_);
+        applied = applyNotification(model_, method, params, changes);
+    }
+
+    if (!applied)
+    {
+        LOG(DEBUG, LOG_TAG) << "Notification " << method << " needs a full refresh\n";
+        refreshStatus();
+        return;
+    }
+
+    incremental_.fetch_add(1, std::memory_order_relaxed);
+    for (const auto& change : changes)
+        emit(change);
+}
+
+
+void ControlClient::sendRequest(const std::string& method, json params, ResponseHandler handler)
+{
+    if (!connected_)
+    {
+        if (handler)
+            handler(boost::asio::error::not_connected, json());
+        return;
+    }
+    int id = nextId_++;
+    json req = {{"jsonrpc", "2.0"}, {"id", id}, {"method", method}};
+    if (!params.is_null())
+        req["params"] = std::move(params);
+    if (handler)
+        pending_.emplace(id, std::move(handler));
+    send(req.dump() + "\r\n");
+}
+
+
+void ControlClient::pushCommand(const std::string& method, const std::string& target, json params)
+{
+    if (!connected_)
+        return;
+    commandsPushed_.fetch_add(1, std::memory_order_relaxed);
+
+    // Optimistic update: commands share their params shape with the notification
+    std::vector<Change> changes;
+    {
+        std::lock_guard<std::mutex> lock(modelMutex_);
+        applyNotification(model_, notificationFor(method), params, changes);
+    }
+    for (const auto& change : changes)
+        emit(change);
+
+    commands_.push(method, target, std::move(params));
+}
+
+
+void ControlClient::sendCommand(const std::string& method, const std::string& target, const json& params, CommandQueue::DoneHandler done)
+{
+    commandsSent_.fetch_add(1, std::memory_order_relaxed);
+    sendRequest(method, params, [this, method, target, done = std::move(done)](const boost::system::error_code& ec, const json& result)
+    {
+        if (ec == boost::asio::error::operation_aborted || ec == boost::asio::error::not_connected)
+        {
+            done();
+            return;
+        }
+        if (ec)
+        {
+            // The optimistic value was rejected, the server state is unknown
+            done();
+            refreshStatus();
+            return;
+        }
+
+        // Reconcile with the value the server actually applied (e.g. clamped),
+        // unless a newer command for the target supersedes it
+        if (!commands_.isQueued(method, target) && result.is_object())
+        {
+            json params = result;
+            params["id"] = target;
+            std::vector<Change> changes;
+            {
+                std::lock_guard<std::mutex> lock(modelMutex_);
+                applyNotification(model_, notificationFor(method), params, changes);
+            }
+            for (const auto& change : changes)
+                emit(change);
+        }
+        done();
+    });
+}
+
+
+void ControlClient::refreshStatus()
+{
+    // Collapse refresh storms: at most one GetStatus in flight, plus one queued
+    if (refreshInFlight_)
+    {
+        refreshPending_ = true;
+        return;
+    }
+    refreshInFlight_ = true;
+    fullRefreshes_.fetch_add(1, std::memory_order_relaxed);
+
+    int id = nextId_++;
+    refreshId_ = id;
+    // Normally the response is taken by handleStatusMessage(), this handler is
+    // the DOM fallback for responses the streaming parser rejects
+    pending_.emplace(id, [this](const boost::system::error_code& ec, const json& result)
+    {
+        refreshInFlight_ = false;
+        if (ec)
+            return;
+
+        try
+        {
+            std::lock_guard<std::mutex> lock(modelMutex_);
+            loadServerStatus(model_, result.at("server"));
+        }
+        catch (const json::exception& e)
+        {
+            LOG(ERROR, LOG_TAG) << "Invalid Server.GetStatus result: " << e.what() << "\n";
+            return;
+        }
+        onStatusLoaded();
+    });
+    json req = {{"jsonrpc", "2.0"}, {"id", id}, {"method", "Server.GetStatus"}};
+    send(req.dump() + "\r\n");
+}
+
+
+bool ControlClient::handleStatusMessage(std::string_view text)
+{
+    int id = -1;
+    if (!parseStatusMessage(text, staging_, id))
+        return false;
+
+    const bool notification = (id < 0);
+    if (!notification)
+    {
+        // A GetStatus sent through request() expects its JSON result
+        if (!refreshInFlight_ || (id != refreshId_))
+            return false;
+        pending_.erase(id);
+        refreshInFlight_ = false;
+    }
+    else
+    {
+        // Server.OnUpdate: the whole status, not an incremental patch
+        notifications_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(modelMutex_);
+        std::swap(model_, staging_);
+    }
+    onStatusLoaded();
+    return true;
+}
+
+
+void ControlClient::onStatusLoaded()
+{
+    emit({ChangeKind::Reset, {}});
+
+    if (!refreshInFlight_ && refreshPending_)
+    {
+        refreshPending_ = false;
+        refreshStatus();
+    }
+}
+
+
+void ControlClient::send(std::string payload)
+{
+    writeQueue_.push_back(std::move(payload));
+    if (writeQueue_.size() == 1)
+        writeNext();
+}
+
+
+void ControlClient::writeNext()
+{
+    boost::asio::async_write(socket_, boost::asio::buffer(writeQueue_.front()),
+                             [this, connection = connection_](const boost::system::error_code& ec, std::size_t)
+    {
+        // The socket was closed meanwhile, its queue cleared: what is
+        // queued now belongs to the next connection
+        if (connection != connection_)
+            return;
+        if (ec)
+        {
+            if (ec != boost::asio::error::operation_aborted)
+            {
+                LOG(ERROR, LOG_TAG) << "Write failed: " << ec.message() << "\n";
+                closeSocket(ec);
+            }
+            return;
+        }
+        writeQueue_.pop_front();
+        if (!writeQueue_.empty())
+            writeNext();
+    });
+}
+
+
+void ControlClient::emit(const Change& change)
+{
+    if (changeHandler_)
+        changeHandler_(change);
+}
+
+} // namespace control
@@ -0,0 +1,175 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// local headers
+#include "command_queue.hpp"
+#include "model_update.hpp"
+#include "server_model.hpp"
+
+// 3rd party headers
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/streambuf.hpp>
+
+// Standard headers
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace control
+{
+
+/// Default port of the Snapcast TCP control API (newline-delimited JSON-RPC)
+static constexpr uint16_t CONTROL_TCP_PORT = 1705;
+
+/// JSON-RPC control client for the Snapcast TCP control API.
+///
+/// Keeps a ServerModel in sync with the server: the full status is fetched
+/// once on connect, then notifications are applied as incremental patches.
+/// A Server.GetStatus refresh only happens for notifications that cannot be
+/// patched (unknown client, membership change), and concurrent refresh
+/// requests are collapsed into one.
+///
+/// Status messages (the GetStatus response, Server.OnUpdate) are parsed in a
+/// single pass straight into a staging model that is then swapped in, so a
+/// large server never materializes a JSON DOM. Other messages go through
+/// nlohmann::json.
+///
+/// State-setting commands (volume, latency, mute) go through a CommandQueue:
+/// they are applied to the model optimistically, coalesced per target, and
+/// reconciled with the server's reply. While a newer command for the same
+/// target is queued, notifications for it are stale and are not applied.
+///
+/// All network I/O runs on the given io_context. Public methods may be called
+/// from any thread; handlers are invoked on the io_context thread.
+/// Destroy only after the io_context has stopped running.
+class ControlClient
+{
+public:
+    using ChangeHandler = std::function<void(const Change& change)>;
+    using ConnectionHandler = std::function<void(bool connected)>;
+    using ResponseHandler = std::function<void(const boost::system::error_code& ec, const json& result)>;
+
+    /// Counters for diagnostics and benchmarks
+    struct Stats
+    {
+        uint64_t notifications{0};
+        uint64_t incremental{0};  ///< Notifications applied as patches
+        uint64_t stale{0};        ///< Notifications ignored for a queued command
+        uint64_t fullRefreshes{0};
+        uint64_t bytesReceived{0};
+        uint64_t commandsPushed{0};
+        uint64_t commandsSent{0};
+    };
+
+    explicit ControlClient(boost::asio::io_context& io_context);
+    ~ControlClient();
+
+    /// Handlers must be set before connect()
+    void setChangeHandler(ChangeHandler handler);
+    void setConnectionHandler(ConnectionHandler handler);
+
+    /// Resolve and connect asynchronously, then load the initial status
+    void connect(const std::string& host, uint16_t port = CONTROL_TCP_PORT);
+
+    /// Close the connection, pending requests fail with operation_aborted
+    void disconnect();
+
+    /// Send a JSON-RPC request. The handler (optional) runs on the io thread.
+    void request(const std::string& method, json params, ResponseHandler handler = nullptr);
+
+    /// Coalesced commands: the model is updated (and the change emitted) at
+    /// once, the request follows as soon as the target is idle
+    void setClientVolume(const std::string& clientId, int percent, bool muted);
+    void setClientLatency(const std::string& clientId, int latency);
+    void setGroupMute(const std::string& groupId, bool muted);
+
+    /// Minimum time between two coalesced commands (default: no limit)
+    void setCommandInterval(std::chrono::milliseconds interval);
+
+    /// Run @p f with the model locked and return its result
+    template <typename F>
+    auto withModel(F&& f) const
+    {
+        std::lock_guard<std::mutex> lock(modelMutex_);
+        return f(model_);
+    }
+
+    Stats stats() const;
+
+private:
+    void doConnect(const std::string& host, uint16_t port);
+    void onConnected();
+    void closeSocket(const boost::system::error_code& reason);
+    void readNext();
+    void handleLine(const std::string& line);
+    void handleMessage(const json& msg);
+    void handleNotification(const std::string& method, const json& params);
+    void sendRequest(const std::string& method, json params, ResponseHandler handler);
+    void pushCommand(const std::string& method, const std::string& target, json params);
+    void sendCommand(const std::string& method, const std::string& target, const json& params, CommandQueue::DoneHandler done);
+    void refreshStatus();
+    bool handleStatusMessage(std::string_view text);
+    void onStatusLoaded();
+    void send(std::string payload);
+    void writeNext();
+    void emit(const Change& change);
+
+    boost::asio::io_context& io_context_;
+    boost::asio::ip::tcp::resolver resolver_;
+    boost::asio::ip::tcp::socket socket_;
+    boost::asio::streambuf readBuffer_;
+
+    // io thread only
+    std::deque<std::string> writeQueue_;
+    /// Bumped by closeSocket(): a write completing for an earlier connection
+    /// leaves the queue alone
+    uint32_t connection_{0};
+    std::map<int, ResponseHandler> pending_;
+    int nextId_{1};
+    bool connected_{false};
+    bool refreshInFlight_{false};
+    bool refreshPending_{false};
+    int refreshId_{0};
+    ServerModel staging_;  ///< Parse target for status messages, swapped with model_
+    CommandQueue commands_;
+
+    ChangeHandler changeHandler_;
+    ConnectionHandler connectionHandler_;
+
+    mutable std::mutex modelMutex_;
+    ServerModel model_;
+
+    std::atomic<uint64_t> notifications_{0};
+    std::atomic<uint64_t> incremental_{0};
+    std::atomic<uint64_t> stale_{0};
+    std::atomic<uint64_t> fullRefreshes_{0};
+    std::atomic<uint64_t> bytesReceived_{0};
+    std::atomic<uint64_t> commandsPushed_{0};
+    std::atomic<uint64_t> commandsSent_{0};
+};
+
+} // namespace control
@@ -0,0 +1,452 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "json_reader.hpp"
+
+// Standard headers
+#include <cstring>
+
+namespace control
+{
+
+namespace
+{
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+void appendUtf8(std::string& out, uint32_t cp)
+{
+    if (cp < 0x80)
+    {
+        out += static_cast<char>(cp);
+    }
+    else if (cp < 0x800)
+    {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+    else if (cp < 0x10000)
+    {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+    else
+    {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+} // namespace
+
+
+void JsonReader::skipWhitespace()
+{
+    while (pos_ < text_.size())
+    {
+        char c = text_[pos_];
+        if (c != ' ' && c != '\t' && c != '\r' && c != '\n')
+            return;
+        ++pos_;
+    }
+}
+
+
+bool JsonReader::fail()
+{
+    ok_ = false;
+    return false;
+}
+
+
+bool JsonReader::expect(char c)
+{
+    skipWhitespace();
+    if (!ok_ || pos_ >= text_.size() || text_[pos_] != c)
+        return fail();
+    ++pos_;
+    return true;
+}
+
+
+JsonReader::Type JsonReader::peek()
+{
+    skipWhitespace();
+    if (!ok_ || pos_ >= text_.size())
+        return Type::Invalid;
+
+    switch (text_[pos_])
+    {
+        case '{':
+            return Type::Object;
+        case '[':
+            return Type::Array;
+        case '"':
+            return Type::String;
+        case 't':
+        case 'f':
+            return Type::Bool;
+        case 'n':
+            return Type::Null;
+        default:
+            char c = text_[pos_];
+            return ((c == '-') || (c >= '0' && c <= '9')) ? Type::Number : Type::Invalid;
+    }
+}
+
+
+bool JsonReader::beginObject()
+{
+    return expect('{');
+}
+
+
+bool JsonReader::nextMember(std::string_view& key)
+{
+    skipWhitespace();
+    if (!ok_ || pos_ >= text_.size())
+        return fail();
+    if (!separator('{', '}'))
+        return false;
+    return readString(key) && expect(':');
+}
+
+
+bool JsonReader::beginArray()
+{
+    return expect('[');
+}
+
+
+bool JsonReader::nextElement()
+{
+    skipWhitespace();
+    if (!ok_ || pos_ >= text_.size())
+        return fail();
+    return separator('[', ']');
+}
+
+
+bool JsonReader::separator(char open, char close)
+{
+    // What precedes: the opening bracket before the first entry, the end of
+    // a value after it
+    size_t prev = pos_;
+    while (prev > 0 && (text_[prev - 1] == ' ' || text_[prev - 1] == '\t' || text_[prev - 1] == '\r' || text_[prev - 1] == '\n'))
+        --prev;
+    const bool first = (prev > 0) && (text_[prev - 1] == open);
+
+    if (text_[pos_] == close)
+    {
+        ++pos_;
+        return false;
+    }
+    // Entries are separated by exactly one ',': none before the first, none
+    // doubled, none before the closing bracket
+    if (first)
+        return ok_;
+    if (text_[pos_] != ',')
+        return fail();
+    ++pos_;
+    skipWhitespace();
+    if (pos_ >= text_.size() || text_[pos_] == ',' || text_[pos_] == close)
+        return fail();
+    return ok_;
+}
+
+
+bool JsonReader::readString(std::string_view& out)
+{
+    if (!expect('"'))
+        return false;
+
+    // Fast path: find the closing quote with memchr, then make sure no escape
+    // precedes it. Large values (cover art) are crossed at memchr speed.
+    const size_t start = pos_;
+    const char* begin = text_.data() + start;
+    const char* end = text_.data() + text_.size();
+    const auto* quote = static_cast<const char*>(std::memchr(begin, '"', static_cast<size_t>(end - begin)));
+    if (!quote)
+        return fail();
+    const auto* escape = static_cast<const char*>(std::memchr(begin, '\\', static_cast<size_t>(quote - begin)));
+    if (escape)
+    {
+        pos_ = static_cast<size_t>(escape - text_.data());
+        if (!decodeEscaped(start))
+            return false;
+        out = scratch_;
+        return true;
+    }
+    out = text_.substr(start, static_cast<size_t>(quote - begin));
+    pos_ = static_cast<size_t>(quote - text_.data()) + 1;
+    return true;
+}
+
+
+bool JsonReader::decodeEscaped(size_t start)
+{
+    // Slow path: copy what we have so far and decode the rest into scratch_
+    scratch_.assign(text_.data() + start, pos_ - start);
+    while (pos_ < text_.size())
+    {
+        char c = text_[pos_++];
+        if (c == '"')
+            return true;
+        if (c != '\\')
+        {
+            scratch_ += c;
+            continue;
+        }
+        if (pos_ >= text_.size())
+            return fail();
+
+        char e = text_[pos_++];
+        switch (e)
+        {
+            case '"':
+            case '\\':
+            case '/':
+                scratch_ += e;
+                break;
+            case 'b':
+                scratch_ += '\b';
+                break;
+            case 'f':
+                scratch_ += '\f';
+                break;
+            case 'n':
+                scratch_ += '\n';
+                break;
+            case 'r':
+                scratch_ += '\r';
+                break;
+            case 't':
+                scratch_ += '\t';
+                break;
+            case 'u':
+            {
+                auto readHex4 = [this](uint32_t& cp)
+                {
+                    if (pos_ + 4 > text_.size())
+                        return false;
+                    cp = 0;
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        int v = hexValue(text_[pos_++]);
+                        if (v < 0)
+                            return false;
+                        cp = (cp << 4) | static_cast<uint32_t>(v);
+                    }
+                    return true;
+                };
+                uint32_t cp;
+                if (!readHex4(cp))
+                    return fail();
+                // A high surrogate must be followed by a low one; a lone
+                // surrogate of either half is invalid, as for nlohmann
+                if (cp >= 0xDC00 && cp <= 0xDFFF)
+                    return fail();
+                if (cp >= 0xD800 && cp <= 0xDBFF)
+                {
+                    if (pos_ + 1 >= text_.size() || text_[pos_] != '\\' || text_[pos_ + 1] != 'u')
+                        return fail();
+                    pos_ += 2;
+                    uint32_t low;
+                    if (!readHex4(low) || low < 0xDC00 || low > 0xDFFF)
+                        return fail();
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                }
+                appendUtf8(scratch_, cp);
+                break;
+            }
+            default:
+                return fail();
+        }
+    }
+    return fail();
+}
+
+
+bool JsonReader::readInt(int64_t& out)
+{
+    skipWhitespace();
+    if (!ok_ || pos_ >= text_.size())
+        return fail();
+
+    bool negative = false;
+    if (text_[pos_] == '-')
+    {
+        negative = true;
+        ++pos_;
+    }
+    if (pos_ >= text_.size() || text_[pos_] < '0' || text_[pos_] > '9')
+        return fail();
+
+    int64_t value = 0;
+    while (pos_ < text_.size() && text_[pos_] >= '0' && text_[pos_] <= '9')
+        value = value * 10 + (text_[pos_++] - '0');
+
+    // Tolerate a fraction/exponent (e.g. "50.0"), truncating to the integer part
+    if (pos_ < text_.size() && (text_[pos_] == '.' || text_[pos_] == 'e' || text_[pos_] == 'E'))
+        skipNumber();
+
+    out = negative ? -value : value;
+    return ok_;
+}
+
+
+bool JsonReader::readBool(bool& out)
+{
+    skipWhitespace();
+    if (!ok_)
+        return false;
+    if (text_.substr(pos_, 4) == "true")
+    {
+        pos_ += 4;
+        out = true;
+        return ok_;
+    }
+    if (text_.substr(pos_, 5) == "false")
+    {
+        pos_ += 5;
+        out = false;
+        return ok_;
+    }
+    return fail();
+}
+
+
+bool JsonReader::readInto(int& out)
+{
+    if (peek() != Type::Number)
+        return skipValue();
+    int64_t v;
+    if (!readInt(v))
+        return false;
+    out = static_cast<int>(v);
+    return true;
+}
+
+
+bool JsonReader::readInto(bool& out)
+{
+    if (peek() != Type::Bool)
+        return skipValue();
+    return readBool(out);
+}
+
+
+bool JsonReader::readInto(std::string& out)
+{
+    if (peek() != Type::String)
+        return skipValue();
+    std::string_view v;
+    if (!readString(v))
+        return false;
+    out.assign(v.data(), v.size());
+    return true;
+}
+
+
+bool JsonReader::skipNumber()
+{
+    while (pos_ < text_.size())
+    {
+        char c = text_[pos_];
+        if (!((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E'))
+            break;
+        ++pos_;
+    }
+    return ok_;
+}
+
+
+bool JsonReader::skipLiteral(std::string_view literal)
+{
+    if (text_.substr(pos_, literal.size()) != literal)
+        return fail();
+    pos_ += literal.size();
+    return true;
+}
+
+
+bool JsonReader::skipValue()
+{
+    switch (peek())
+    {
+        case Type::String:
+        {
+            std::string_view ignored;
+            return readString(ignored);
+        }
+        case Type::Number:
+            return skipNumber();
+        case Type::Bool:
+            return skipLiteral(text_[pos_] == 't' ? "true" : "false");
+        case Type::Null:
+            return skipLiteral("null");
+        case Type::Invalid:
+            return fail();
+        case Type::Object:
+        case Type::Array:
+            break;
+    }
+
+    // Containers: walk the entries without recursion, checking the
+    // separators as for a value that is read; scalars are skipped above
+    nesting_.clear();
+    for (;;)
+    {
+        const Type type = peek();
+        if (type == Type::Object || type == Type::Array)
+        {
+            nesting_ += (text_[pos_++] == '{') ? '}' : ']';
+        }
+        else if (!skipValue())
+        {
+            return false;
+        }
+
+        // Close the containers that ended; stop at the next entry
+        for (;;)
+        {
+            if (nesting_.empty())
+                return true;
+            std::string_view key;
+            if ((nesting_.back() == '}') ? nextMember(key) : nextElement())
+                break;
+            if (!ok_)
+                return false;
+            nesting_.pop_back();
+        }
+    }
+}
+
+} // namespace control
@@ -0,0 +1,113 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// Standard headers
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace control
+{
+
+/// Single-pass pull parser for JSON text.
+///
+/// Values are consumed in document order without building a DOM: the caller
+/// walks objects with nextMember(), reads the values it cares about and
+/// skipValue()s the rest. Strings without escapes are returned as views into
+/// the input (zero-copy); escaped strings are decoded into one reused scratch
+/// buffer, so a view is only valid until the next read.
+///
+/// The parser is lenient about commas (the server is trusted), but any
+/// structural error puts it into a sticky failed state: ok() returns false
+/// and every further call fails.
+///
+/// Usage:
+/// @code
+/// JsonReader r(text);
+/// std::string_view key;
+/// if (r.beginObject())
+///     while (r.nextMember(key))
+///         if (key == "id") r.readInt(id); else r.skipValue();
+/// @endcode
+class JsonReader
+{
+public:
+    enum class Type
+    {
+        Object,
+        Array,
+        String,
+        Number,
+        Bool,
+        Null,
+        Invalid,
+    };
+
+    explicit JsonReader(std::string_view text) : text_(text) {}
+
+    /// @return false after any parse error
+    bool ok() const { return ok_; }
+
+    /// @return the type of the next value without consuming it
+    Type peek();
+
+    /// Consume '{'. Then call nextMember() until it returns false.
+    bool beginObject();
+    /// Read the next member key and the ':' separator.
+    /// @return false at the closing '}' (which is consumed) or on error
+    bool nextMember(std::string_view& key);
+
+    /// Consume '['. Then call nextElement() until it returns false.
+    bool beginArray();
+    /// @return true if another element follows, false at ']' (consumed) or on error
+    bool nextElement();
+
+    bool readString(std::string_view& out);
+    bool readInt(int64_t& out);
+    bool readBool(bool& out);
+
+    /// Read an int, bool or string; any other type is skipped and leaves @p out untouched
+    bool readInto(int& out);
+    bool readInto(bool& out);
+    bool readInto(std::string& out);
+
+    /// Skip the next value, including nested objects and arrays
+    bool skipValue();
+
+private:
+    void skipWhitespace();
+    bool fail();
+    bool expect(char c);
+    /// Consume the ',' before the next entry or the @p close bracket
+    /// @return false at @p close or on a misplaced comma
+    bool separator(char open, char close);
+    bool decodeEscaped(size_t start);
+    bool skipNumber();
+    bool skipLiteral(std::string_view literal);
+
+    std::string_view text_;
+    size_t pos_{0};
+    bool ok_{true};
+    std::string scratch_;
+    /// Closing brackets of the containers skipValue() is in
+    std::string nesting_;
+};
+
+} // namespace control
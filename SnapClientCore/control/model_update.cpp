@@ -0,0 +1,244 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "model_update.hpp"
+
+namespace control
+{
+
+namespace
+{
+
+/// Metadata fields can be a string or an array of strings (e.g. multiple artists)
+std::string stringOrArray(const json& obj, const char* key)
+{
+    auto it = obj.find(key);
+    if (it == obj.end())
+        return {};
+    if (it->is_string())
+        return it->get<std::string>();
+    if (it->is_array())
+    {
+        std::string joined;
+        for (const auto& v : *it)
+        {
+            if (!v.is_string())
+                continue;
+            if (!joined.empty())
+                joined += ", ";
+            joined += v.get<std::string>();
+        }
+        return joined;
+    }
+    return {};
+}
+
+
+/// Fill a client's fields from its JSON object (the ID is set by the caller)
+void parseClient(const json& j, ClientState& c)
+{
+    c.connected = j.value("connected", false);
+
+    const json& config = j.at("config");
+    c.name = config.value("name", "");
+    c.latency = config.value("latency", 0);
+    c.instance = config.value("instance", 1);
+    if (auto vol = config.find("volume"); vol != config.end())
+    {
+        c.volume = vol->value("percent", 100);
+        c.muted = vol->value("muted", false);
+    }
+
+    if (auto host = j.find("host"); host != j.end())
+    {
+        c.hostName = host->value("name", "");
+        c.ip = host->value("ip", "");
+    }
+}
+
+
+/// Fill a stream's metadata from its "properties" object
+void parseProperties(const json& props, StreamState& s)
+{
+    if (auto meta = props.find("metadata"); meta != props.end())
+    {
+        s.artist = stringOrArray(*meta, "artist");
+        s.title = stringOrArray(*meta, "title");
+        s.album = stringOrArray(*meta, "album");
+        s.artUrl = meta->value("artUrl", "");
+    }
+}
+
+} // namespace
+
+
+void loadServerStatus(ServerModel& model, const json& server)
+{
+    model.clear();
+
+    for (const auto& g : server.at("groups"))
+    {
+        GroupState& group = model.addGroup();
+        model.setId(group, g.at("id").get<std::string>());
+        group.name = g.value("name", "");
+        group.stream = model.intern(g.value("stream_id", ""));
+        group.muted = g.value("muted", false);
+
+        for (const auto& c : g.at("clients"))
+        {
+            ClientState& client = model.addClient();
+            model.setId(client, c.at("id").get<std::string>());
+            parseClient(c, client);
+        }
+    }
+
+    for (const auto& s : server.at("streams"))
+    {
+        StreamState& stream = model.addStream();
+        model.setId(stream, s.at("id").get<std::string>());
+        stream.status = model.intern(s.value("status", ""));
+        if (auto props = s.find("properties"); props != s.end())
+            parseProperties(*props, stream);
+    }
+}
+
+
+bool applyNotification(ServerModel& model, const std::string& method, const json& params, std::vector<Change>& changes)
+{
+    try
+    {
+        if (method == "Server.OnUpdate")
+        {
+            // The notification carries the complete status, no need to ask for it
+            loadServerStatus(model, params.at("server"));
+            changes.push_back({ChangeKind::Reset, {}});
+            return true;
+        }
+
+        const std::string id = params.at("id").get<std::string>();
+
+        if (method == "Client.OnVolumeChanged")
+        {
+            if (!model.client(id))
+                return false;
+            const json& vol = params.at("volume");
+            if (model.setClientVolume(id, vol.at("percent").get<int>(), vol.at("muted").get<bool>()))
+                changes.push_back({ChangeKind::ClientVolume, id});
+            return true;
+        }
+
+        if (method == "Client.OnLatencyChanged")
+        {
+            if (!model.client(id))
+                return false;
+            if (model.setClientLatency(id, params.at("latency").get<int>()))
+                changes.push_back({ChangeKind::ClientLatency, id});
+            return true;
+        }
+
+        if (method == "Client.OnNameChanged")
+        {
+            if (!model.client(id))
+                return false;
+            if (model.setClientName(id, params.at("name").get<std::string>()))
+                changes.push_back({ChangeKind::ClientName, id});
+            return true;
+        }
+
+        if (method == "Client.OnConnect" || method == "Client.OnDisconnect")
+        {
+            // A client we have never seen must be placed in a group, and the
+            // notification doesn't say which one: that needs a full refresh.
+            if (!model.client(id))
+                return false;
+            ClientState updated;
+            parseClient(params.at("client"), updated);
+            updated.connected = (method == "Client.OnConnect");
+            bool changed = model.setClientConnected(id, updated.connected);
+            changed |= model.setClientName(id, updated.name);
+            changed |= model.setClientVolume(id, updated.volume, updated.muted);
+            changed |= model.setClientLatency(id, updated.latency);
+            if (changed)
+                changes.push_back({ChangeKind::ClientConnection, id});
+            return true;
+        }
+
+        if (method == "Group.OnMute")
+        {
+            if (!model.group(id))
+                return false;
+            if (model.setGroupMute(id, params.at("mute").get<bool>()))
+                changes.push_back({ChangeKind::GroupMute, id});
+            return true;
+        }
+
+        if (method == "Group.OnStreamChanged")
+        {
+            if (!model.group(id))
+                return false;
+            if (model.setGroupStream(id, params.at("stream_id").get<std::string>()))
+                changes.push_back({ChangeKind::GroupStream, id});
+            return true;
+        }
+
+        if (method == "Group.OnNameChanged")
+        {
+            if (!model.group(id))
+                return false;
+            if (model.setGroupName(id, params.at("name").get<std::string>()))
+                changes.push_back({ChangeKind::GroupName, id});
+            return true;
+        }
+
+        if (method == "Stream.OnUpdate")
+        {
+            if (!model.stream(id))
+                return false;
+            const json& stream = params.at("stream");
+            StreamState s;
+            if (auto props = stream.find("properties"); props != stream.end())
+                parseProperties(*props, s);
+            if (model.setStreamStatus(id, stream.value("status", "")))
+                changes.push_back({ChangeKind::StreamStatus, id});
+            if (model.setStreamMetadata(id, s.artist, s.title, s.album, s.artUrl))
+                changes.push_back({ChangeKind::StreamProperties, id});
+            return true;
+        }
+
+        if (method == "Stream.OnProperties")
+        {
+            if (!model.stream(id))
+                return false;
+            // Properties are sent as a complete set, so missing fields are cleared
+            StreamState s;
+            parseProperties(params.at("properties"), s);
+            if (model.setStreamMetadata(id, s.artist, s.title, s.album, s.artUrl))
+                changes.push_back({ChangeKind::StreamProperties, id});
+            return true;
+        }
+    }
+    catch (const json::exception&)
+    {
+        // Malformed or unexpected params: let the caller resync with a full refresh
+        return false;
+    }
+
+    return false;
+}
+
+} // namespace control
@@ -0,0 +1,47 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// local headers
+#include "common/json.hpp"
+#include "server_model.hpp"
+
+// Standard headers
+#include <string>
+#include <vector>
+
+namespace control
+{
+
+using json = nlohmann::json;
+
+/// Replace the model with the "server" object of a Server.GetStatus result
+/// (or of a Server.OnUpdate notification).
+/// @throw json::exception if the status is malformed
+void loadServerStatus(ServerModel& model, const json& server);
+
+/// Apply a JSON-RPC notification to the model as an incremental patch.
+///
+/// Changes that actually modified the model are appended to @p changes.
+/// @return false if the notification cannot be applied incrementally
+///         (unknown method, unknown object, membership change) and the
+///         caller must fall back to a full Server.GetStatus refresh.
+bool applyNotification(ServerModel& model, const std::string& method, const json& params, std::vector<Change>& changes);
+
+} // namespace control
@@ -0,0 +1,269 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "server_model.hpp"
+
+// Standard headers
+#include <algorithm>
+
+namespace control
+{
+
+namespace
+{
+
+constexpr uint32_t NOT_INDEXED = UINT32_MAX;
+
+template <typename T>
+T* lookup(std::vector<T>& items, const std::vector<uint32_t>& index, Id id)
+{
+    if ((id >= index.size()) || (index[id] == NOT_INDEXED))
+        return nullptr;
+    return &items[index[id]];
+}
+
+template <typename T>
+const T* lookup(const std::vector<T>& items, const std::vector<uint32_t>& index, Id id)
+{
+    if ((id >= index.size()) || (index[id] == NOT_INDEXED))
+        return nullptr;
+    return &items[index[id]];
+}
+
+/// Assign only if different, so callers can tell real changes from echoes
+template <typename T, typename V>
+bool assign(T& field, const V& value)
+{
+    if (field == value)
+        return false;
+    field = value;
+    return true;
+}
+
+} // namespace
+
+
+/* ── IdPool ─────────────────────────────────────────────────────── */
+
+Id IdPool::intern(std::string_view s)
+{
+    auto it = index_.find(s);
+    if (it != index_.end())
+        return it->second;
+
+    Id id = static_cast<Id>(strings_.size());
+    strings_.emplace_back(s);
+    index_.emplace(std::string_view(strings_.back()), id);
+    return id;
+}
+
+
+Id IdPool::find(std::string_view s) const
+{
+    auto it = index_.find(s);
+    return (it != index_.end()) ? it->second : NO_ID;
+}
+
+
+void IdPool::clear()
+{
+    index_.clear();
+    strings_.clear();
+}
+
+
+/* ── ServerModel ────────────────────────────────────────────────── */
+
+void ServerModel::clear()
+{
+    ids_.clear();
+    clients_.clear();
+    groups_.clear();
+    streams_.clear();
+    clientIndex_.clear();
+    groupIndex_.clear();
+    streamIndex_.clear();
+}
+
+
+void ServerModel::indexAs(std::vector<uint32_t>& index, Id id, size_t pos)
+{
+    if (index.size() <= id)
+        index.resize(std::max<size_t>(id + 1, ids_.size()), NOT_INDEXED);
+    index[id] = static_cast<uint32_t>(pos);
+}
+
+
+GroupState& ServerModel::addGroup()
+{
+    GroupState& group = groups_.emplace_back();
+    group.firstClient = static_cast<uint32_t>(clients_.size());
+    return group;
+}
+
+
+ClientState& ServerModel::addClient()
+{
+    ClientState& client = clients_.emplace_back();
+    if (!groups_.empty())
+    {
+        client.group = static_cast<uint32_t>(groups_.size() - 1);
+        groups_.back().clientCount++;
+    }
+    return client;
+}
+
+
+StreamState& ServerModel::addStream()
+{
+    return streams_.emplace_back();
+}
+
+
+void ServerModel::setId(GroupState& group, std::string_view id)
+{
+    group.id = ids_.intern(id);
+    indexAs(groupIndex_, group.id, static_cast<size_t>(&group - groups_.data()));
+}
+
+
+void ServerModel::setId(ClientState& client, std::string_view id)
+{
+    client.id = ids_.intern(id);
+    indexAs(clientIndex_, client.id, static_cast<size_t>(&client - clients_.data()));
+}
+
+
+void ServerModel::setId(StreamState& stream, std::string_view id)
+{
+    stream.id = ids_.intern(id);
+    indexAs(streamIndex_, stream.id, static_cast<size_t>(&stream - streams_.data()));
+}
+
+
+bool ServerModel::setClientVolume(std::string_view id, int percent, bool muted)
+{
+    ClientState* c = findClient(id);
+    if (!c)
+        return false;
+    percent = std::clamp(percent, 0, 100);
+    bool changed = assign(c->volume, percent);
+    changed |= assign(c->muted, muted);
+    return changed;
+}
+
+
+bool ServerModel::setClientLatency(std::string_view id, int latency)
+{
+    ClientState* c = findClient(id);
+    return c && assign(c->latency, latency);
+}
+
+
+bool ServerModel::setClientName(std::string_view id, std::string_view name)
+{
+    ClientState* c = findClient(id);
+    return c && assign(c->name, name);
+}
+
+
+bool ServerModel::setClientConnected(std::string_view id, bool connected)
+{
+    ClientState* c = findClient(id);
+    return c && assign(c->connected, connected);
+}
+
+
+bool ServerModel::setGroupMute(std::string_view id, bool muted)
+{
+    GroupState* g = findGroup(id);
+    return g && assign(g->muted, muted);
+}
+
+
+bool ServerModel::setGroupStream(std::string_view id, std::string_view streamId)
+{
+    GroupState* g = findGroup(id);
+    return g && assign(g->stream, ids_.intern(streamId));
+}
+
+
+bool ServerModel::setGroupName(std::string_view id, std::string_view name)
+{
+    GroupState* g = findGroup(id);
+    return g && assign(g->name, name);
+}
+
+
+bool ServerModel::setStreamStatus(std::string_view id, std::string_view status)
+{
+    StreamState* s = findStream(id);
+    return s && assign(s->status, ids_.intern(status));
+}
+
+
+bool ServerModel::setStreamMetadata(std::string_view id, std::string_view artist, std::string_view title, std::string_view album,
+                                    std::string_view artUrl)
+{
+    StreamState* s = findStream(id);
+    if (!s)
+        return false;
+    bool changed = assign(s->artist, artist);
+    changed |= assign(s->title, title);
+    changed |= assign(s->album, album);
+    changed |= assign(s->artUrl, artUrl);
+    return changed;
+}
+
+
+const ClientState* ServerModel::client(std::string_view id) const
+{
+    return lookup(clients_, clientIndex_, ids_.find(id));
+}
+
+
+const GroupState* ServerModel::group(std::string_view id) const
+{
+    return lookup(groups_, groupIndex_, ids_.find(id));
+}
+
+
+const StreamState* ServerModel::stream(std::string_view id) const
+{
+    return lookup(streams_, streamIndex_, ids_.find(id));
+}
+
+
+ClientState* ServerModel::findClient(std::string_view id)
+{
+    return lookup(clients_, clientIndex_, ids_.find(id));
+}
+
+
+GroupState* ServerModel::findGroup(std::string_view id)
+{
+    return lookup(groups_, groupIndex_, ids_.find(id));
+}
+
+
+StreamState* ServerModel::findStream(std::string_view id)
+{
+    return lookup(streams_, streamIndex_, ids_.find(id));
+}
+
+} // namespace control
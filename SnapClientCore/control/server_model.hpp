@@ -0,0 +1,198 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// Standard headers
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace control
+{
+
+/// Interned string handle (client/group/stream IDs, stream status)
+using Id = uint32_t;
+static constexpr Id NO_ID = UINT32_MAX;
+
+/// String interning pool.
+///
+/// Each distinct string is stored once and referred to by a dense Id, so the
+/// model compares and indexes IDs as integers. Lookups by string_view don't
+/// allocate. Storage is a deque, so views handed out stay valid until clear().
+class IdPool
+{
+public:
+    /// @return the Id of @p s, adding it if new
+    Id intern(std::string_view s);
+
+    /// @return the Id of @p s, or NO_ID if it was never interned
+    Id find(std::string_view s) const;
+
+    /// @return the string for @p id ("" for NO_ID)
+    std::string_view str(Id id) const
+    {
+        return (id < strings_.size()) ? std::string_view(strings_[id]) : std::string_view();
+    }
+
+    size_t size() const { return strings_.size(); }
+    void clear();
+
+private:
+    std::deque<std::string> strings_;
+    std::unordered_map<std::string_view, Id> index_;
+};
+
+/// A Snapcast client as seen by the control API
+struct ClientState
+{
+    Id id{NO_ID};
+    uint32_t group{0};  ///< Index into ServerModel::groups()
+    std::string name;
+    std::string hostName;
+    std::string ip;
+    int volume{100};
+    bool muted{false};
+    int latency{0};
+    int instance{1};
+    bool connected{false};
+};
+
+/// A Snapcast group (a set of clients playing the same stream).
+/// Its clients are the contiguous range [firstClient, firstClient + clientCount)
+/// of ServerModel::clients().
+struct GroupState
+{
+    Id id{NO_ID};
+    Id stream{NO_ID};
+    std::string name;
+    bool muted{false};
+    uint32_t firstClient{0};
+    uint32_t clientCount{0};
+};
+
+/// A Snapcast stream with the metadata the UI displays
+struct StreamState
+{
+    Id id{NO_ID};
+    Id status{NO_ID};
+    std::string artist;
+    std::string title;
+    std::string album;
+    std::string artUrl;
+};
+
+/// What changed in the model after applying a status or notification
+enum class ChangeKind
+{
+    Reset,              ///< Whole model replaced (initial status, Server.OnUpdate)
+    ClientVolume,
+    ClientLatency,
+    ClientName,
+    ClientConnection,
+    GroupMute,
+    GroupStream,
+    GroupName,
+    StreamStatus,
+    StreamProperties,
+};
+
+/// A single model change, identified by the kind and the object ID
+struct Change
+{
+    ChangeKind kind;
+    std::string id;
+};
+
+/// In-memory mirror of the server state (groups, clients, streams).
+///
+/// The model is flat: groups, clients and streams live in contiguous vectors,
+/// clients are stored group by group, and all IDs are interned. A lookup is
+/// one hash of the ID string followed by an array access, and reloading a
+/// status reuses the vectors' capacity.
+///
+/// The model is built in order: addGroup(), then addClient() for each of its
+/// clients, then the next group. Streams can be added at any time. IDs are
+/// assigned with setId() once known, since the server serializes object keys
+/// alphabetically ("clients" comes before a group's "id").
+/// Every setter returns true only if the value actually changed, which lets
+/// the caller suppress no-op events (e.g. echoes of our own requests).
+///
+/// Not thread-safe: callers serialize access (ControlClient uses a mutex).
+class ServerModel
+{
+public:
+    /// Remove all groups, clients and streams (keeps allocated capacity)
+    void clear();
+
+    /// Build a model (see class description for the ordering).
+    /// A returned reference is valid until the next add of the same kind.
+    GroupState& addGroup();
+    ClientState& addClient();
+    StreamState& addStream();
+    void setId(GroupState& group, std::string_view id);
+    void setId(ClientState& client, std::string_view id);
+    void setId(StreamState& stream, std::string_view id);
+    Id intern(std::string_view s) { return ids_.intern(s); }
+
+    /// Incremental patches, return true if the model changed
+    bool setClientVolume(std::string_view id, int percent, bool muted);
+    bool setClientLatency(std::string_view id, int latency);
+    bool setClientName(std::string_view id, std::string_view name);
+    bool setClientConnected(std::string_view id, bool connected);
+    bool setGroupMute(std::string_view id, bool muted);
+    bool setGroupStream(std::string_view id, std::string_view streamId);
+    bool setGroupName(std::string_view id, std::string_view name);
+    bool setStreamStatus(std::string_view id, std::string_view status);
+    bool setStreamMetadata(std::string_view id, std::string_view artist, std::string_view title, std::string_view album,
+                           std::string_view artUrl);
+
+    /// Lookups, nullptr if unknown
+    const ClientState* client(std::string_view id) const;
+    const GroupState* group(std::string_view id) const;
+    const StreamState* stream(std::string_view id) const;
+
+    /// @return the string of an interned Id
+    std::string_view str(Id id) const { return ids_.str(id); }
+
+    const std::vector<ClientState>& clients() const { return clients_; }
+    const std::vector<GroupState>& groups() const { return groups_; }
+    const std::vector<StreamState>& streams() const { return streams_; }
+
+private:
+    ClientState* findClient(std::string_view id);
+    GroupState* findGroup(std::string_view id);
+    StreamState* findStream(std::string_view id);
+    void indexAs(std::vector<uint32_t>& index, Id id, size_t pos);
+
+    IdPool ids_;
+    std::vector<ClientState> clients_;
+    std::vector<GroupState> groups_;
+    std::vector<StreamState> streams_;
+
+    // Id -> position in the vectors above (UINT32_MAX if the Id is not of that kind)
+    std::vector<uint32_t> clientIndex_;
+    std::vector<uint32_t> groupIndex_;
+    std::vector<uint32_t> streamIndex_;
+};
+
+} // namespace control
@@ -0,0 +1,310 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "status_parser.hpp"
+
+namespace control
+{
+
+namespace
+{
+
+/// Metadata fields can be a string or an array of strings (e.g. multiple artists)
+bool readStringOrArray(JsonReader& r, std::string& out)
+{
+    if (r.peek() != JsonReader::Type::Array)
+        return r.readInto(out);
+
+    out.clear();
+    if (!r.beginArray())
+        return false;
+    while (r.nextElement())
+    {
+        std::string_view v;
+        if (r.peek() != JsonReader::Type::String)
+        {
+            r.skipValue();
+            continue;
+        }
+        if (!r.readString(v))
+            return false;
+        if (!out.empty())
+            out += ", ";
+        out.append(v.data(), v.size());
+    }
+    return r.ok();
+}
+
+
+bool parseVolume(JsonReader& r, ClientState& c)
+{
+    std::string_view key;
+    if (!r.beginObject())
+        return false;
+    while (r.nextMember(key))
+    {
+        if (key == "percent")
+            r.readInto(c.volume);
+        else if (key == "muted")
+            r.readInto(c.muted);
+        else
+            r.skipValue();
+    }
+    return r.ok();
+}
+
+
+bool parseClientConfig(JsonReader& r, ClientState& c)
+{
+    std::string_view key;
+    if (!r.beginObject())
+        return false;
+    while (r.nextMember(key))
+    {
+        if (key == "name")
+            r.readInto(c.name);
+        else if (key == "latency")
+            r.readInto(c.latency);
+        else if (key == "instance")
+            r.readInto(c.instance);
+        else if (key == "volume")
+            parseVolume(r, c);
+        else
+            r.skipValue();
+    }
+    return r.ok();
+}
+
+
+bool parseHost(JsonReader& r, ClientState& c)
+{
+    std::string_view key;
+    if (!r.beginObject())
+        return false;
+    while (r.nextMember(key))
+    {
+        if (key == "name")
+            r.readInto(c.hostName);
+        else if (key == "ip")
+            r.readInto(c.ip);
+        else
+            r.skipValue();
+    }
+    return r.ok();
+}
+
+
+bool parseClient(JsonReader& r, ServerModel& model)
+{
+    ClientState& c = model.addClient();
+    std::string_view key;
+    if (!r.beginObject())
+        return false;
+    while (r.nextMember(key))
+    {
+        if (key == "id")
+        {
+            std::string_view id;
+            if (r.readString(id))
+                model.setId(c, id);
+        }
+        else if (key == "connected")
+            r.readInto(c.connected);
+        else if (key == "config")
+            parseClientConfig(r, c);
+        else if (key == "host")
+            parseHost(r, c);
+        else
+            r.skipValue();
+    }
+    return r.ok();
+}
+
+
+bool parseGroup(JsonReader& r, ServerModel& model)
+{
+    GroupState& g = model.addGroup();
+    std::string_view key;
+    if (!r.beginObject())
+        return false;
+    while (r.nextMember(key))
+    {
+        if (key == "id")
+        {
+            std::string_view id;
+            if (r.readString(id))
+                model.setId(g, id);
+        }
+        else if (key == "stream_id")
+        {
+            std::string_view stream;
+            if (r.readString(stream))
+                g.stream = model.intern(stream);
+        }
+        else if (key == "name")
+            r.readInto(g.name);
+        else if (key == "muted")
+            r.readInto(g.muted);
+        else if (key == "clients")
+        {
+            if (!r.beginArray())
+                return false;
+            while (r.nextElement())
+                parseClient(r, model);
+        }
+        else
+            r.skipValue();
+    }
+    return r.ok();
+}
+
+
+bool parseMetadata(JsonReader& r, StreamState& s)
+{
+    std::string_view key;
+    if (!r.beginObject())
+        return false;
+    while (r.nextMember(key))
+    {
+        if (key == "artist")
+            readStringOrArray(r, s.artist);
+        else if (key == "title")
+            readStringOrArray(r, s.title);
+        else if (key == "album")
+            readStringOrArray(r, s.album);
+        else if (key == "artUrl")
+            r.readInto(s.artUrl);
+        else
+            r.skipValue();  // artData can be hundreds of KB: skipped without copying
+    }
+    return r.ok();
+}
+
+
+bool parseStream(JsonReader& r, ServerModel& model)
+{
+    StreamState& s = model.addStream();
+    std::string_view key;
+    if (!r.beginObject())
+        return false;
+    while (r.nextMember(key))
+    {
+        if (key == "id")
+        {
+            std::string_view id;
+            if (r.readString(id))
+                model.setId(s, id);
+        }
+        else if (key == "status")
+        {
+            std::string_view status;
+            if (r.readString(status))
+                s.status = model.intern(status);
+        }
+        else if (key == "properties")
+        {
+            if (!r.beginObject())
+                return false;
+            while (r.nextMember(key))
+            {
+                if (key == "metadata")
+                    parseMetadata(r, s);
+                else
+                    r.skipValue();
+            }
+        }
+        else
+            r.skipValue();
+    }
+    return r.ok();
+}
+
+} // namespace
+
+
+bool parseServerStatus(JsonReader& r, ServerModel& model)
+{
+    model.clear();
+
+    std::string_view key;
+    if (!r.beginObject())
+        return false;
+    while (r.nextMember(key))
+    {
+        if (key == "groups")
+        {
+            if (!r.beginArray())
+                return false;
+            while (r.nextElement())
+                parseGroup(r, model);
+        }
+        else if (key == "streams")
+        {
+            if (!r.beginArray())
+                return false;
+            while (r.nextElement())
+                parseStream(r, model);
+        }
+        else
+            r.skipValue();
+    }
+    return r.ok();
+}
+
+
+bool parseStatusMessage(std::string_view text, ServerModel& model, int& id)
+{
+    JsonReader r(text);
+    bool loaded = false;
+    bool onUpdate = false;
+
+    std::string_view key;
+    if (r.peek() != JsonReader::Type::Object || !r.beginObject())
+        return false;
+    while (r.nextMember(key))
+    {
+        if (key == "id")
+        {
+            r.readInto(id);
+        }
+        else if (key == "method")
+        {
+            std::string_view method;
+            if (r.peek() == JsonReader::Type::String && r.readString(method))
+                onUpdate = (method == "Server.OnUpdate");
+            else
+                r.skipValue();
+        }
+        else if ((key == "result" || (key == "params" && onUpdate)) && r.peek() == JsonReader::Type::Object)
+        {
+            r.beginObject();
+            while (r.nextMember(key))
+            {
+                if (key == "server")
+                    loaded = parseServerStatus(r, model);
+                else
+                    r.skipValue();
+            }
+        }
+        else
+            r.skipValue();
+    }
+    return loaded && r.ok();
+}
+
+} // namespace control
@@ -0,0 +1,45 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// local headers
+#include "json_reader.hpp"
+#include "server_model.hpp"
+
+// Standard headers
+#include <string_view>
+
+namespace control
+{
+
+/// Parse a "server" status object (the result of Server.GetStatus, or the
+/// params of Server.OnUpdate) straight into @p model, without a DOM.
+/// The model is cleared first; unknown keys are skipped.
+/// @return false on malformed input (the model is then incomplete)
+bool parseServerStatus(JsonReader& reader, ServerModel& model);
+
+/// Parse a complete JSON-RPC message line carrying a server status: either a
+/// response {"id": n, "result": {"server": ...}} or a Server.OnUpdate
+/// notification {"method": "Server.OnUpdate", "params": {"server": ...}}.
+/// The status is loaded into @p model; any other message returns false.
+/// @param id  set to the response ID, untouched for a notification
+/// @return true if a status was loaded
+bool parseStatusMessage(std::string_view text, ServerModel& model, int& id);
+
+} // namespace control
@@ -0,0 +1,256 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "analysis_tap.hpp"
+
+// Standard headers
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace dsp
+{
+
+namespace
+{
+
+static constexpr double PI = 3.14159265358979323846;
+
+/// Lowest and highest band edge, Hz
+static constexpr double SPECTRUM_LOW = 20.;
+static constexpr double SPECTRUM_HIGH = 20000.;
+
+
+float toDb(double power)
+{
+    // 10 log10 of a power; SILENCE_DB is a power of 1e-12
+    return std::max(static_cast<float>(10. * std::log10(std::max(power, 1e-12))), SILENCE_DB);
+}
+
+} // namespace
+
+
+AnalysisTap::AnalysisTap(const TapFormat& format)
+    : format_(format), frameBytes_(static_cast<size_t>(format.channels) * ((format.bits == 16) ? 2 : 4)),
+      toFloat_(playout::selectKernel({format.bits, format.channels, playout::OutputFormat::Float32})),
+      data_(TAP_SLOTS * TAP_WINDOW * frameBytes_)
+{
+}
+
+
+void AnalysisTap::push(const void* pcm, uint32_t frames, Clock::time_point playAt)
+{
+    const uint32_t copy = std::min(frames, TAP_WINDOW);
+    // The window is the end of the buffer: it starts playing this much later
+    const auto offset = std::chrono::nanoseconds(static_cast<int64_t>(frames - copy) * 1000000000 / std::max<uint32_t>(format_.rate, 1));
+
+    const uint64_t n = written_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[n % TAP_SLOTS];
+    slot.version.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.start.store(std::chrono::duration_cast<Clock::duration>((playAt + offset).time_since_epoch()).count(), std::memory_order_relaxed);
+    slot.frames.store(copy, std::memory_order_relaxed);
+    std::memcpy(data_.data() + (n % TAP_SLOTS) * TAP_WINDOW * frameBytes_, static_cast<const char*>(pcm) + (frames - copy) * frameBytes_,
+                copy * frameBytes_);
+    slot.version.store(2 * n + 2, std::memory_order_release);
+    written_.store(n + 1, std::memory_order_release);
+}
+
+
+bool AnalysisTap::read(Clock::time_point now, Window& window) const
+{
+    if (!toFloat_)
+        return false;
+    const uint64_t written = written_.load(std::memory_order_acquire);
+    const int64_t nowTicks = now.time_since_epoch().count();
+    // Newest first; the writer may lap a slow reader, the versions tell
+    for (uint64_t k = written; (k > 0) && (written - k < TAP_SLOTS); --k)
+    {
+        const uint64_t n = k - 1;
+        const Slot& slot = slots_[n % TAP_SLOTS];
+        const uint64_t version = slot.version.load(std::memory_order_acquire);
+        if (version != 2 * n + 2)
+            continue;
+        const int64_t start = slot.start.load(std::memory_order_relaxed);
+        const uint32_t frames = slot.frames.load(std::memory_order_relaxed);
+        if (start > nowTicks)
+            continue;  // Still ahead in the queue
+
+        raw_.resize(TAP_WINDOW * frameBytes_);
+        std::memcpy(raw_.data(), data_.data() + (n % TAP_SLOTS) * TAP_WINDOW * frameBytes_, frames * frameBytes_);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.version.load(std::memory_order_relaxed) != version)
+            continue;  // Overwritten while copying
+
+        std::array<float, playout::MAX_RENDER_CHANNELS> unity;
+        unity.fill(1.f);
+        window.samples.resize(static_cast<size_t>(TAP_WINDOW) * format_.channels);
+        toFloat_(raw_.data(), window.samples.data(), frames, unity.data());
+        window.frames = frames;
+        window.sequence = k;
+        window.start = Clock::time_point(Clock::duration(start));
+        return true;
+    }
+    return false;
+}
+
+
+SpectrumAnalyzer::SpectrumAnalyzer(float fallDbPerSecond)
+    : fallDbPerSecond_(fallDbPerSecond), hann_(TAP_WINDOW), twiddles_(TAP_WINDOW / 2), bitReverse_(TAP_WINDOW), spectrum_(TAP_WINDOW)
+{
+    const double n = TAP_WINDOW;
+    for (uint32_t i = 0; i < TAP_WINDOW; ++i)
+        hann_[i] = static_cast<float>(0.5 - 0.5 * std::cos(2. * PI * i / n));
+    for (uint32_t k = 0; k < TAP_WINDOW / 2; ++k)
+        twiddles_[k] = std::polar(1.f, static_cast<float>(-2. * PI * k / n));
+    uint32_t bits = 0;
+    while ((1u << bits) < TAP_WINDOW)
+        ++bits;
+    for (uint32_t i = 0; i < TAP_WINDOW; ++i)
+    {
+        uint32_t r = 0;
+        for (uint32_t b = 0; b < bits; ++b)
+            r |= ((i >> b) & 1u) << (bits - 1 - b);
+        bitReverse_[i] = r;
+    }
+}
+
+
+void SpectrumAnalyzer::update(const AnalysisTap* tap, Clock::time_point now, std::chrono::microseconds elapsed)
+{
+    AnalysisFrame measured;
+    bool fresh = false;
+    if (tap && tap->read(now, window_) && ((tap != lastTap_) || (window_.sequence != lastSequence_)))
+    {
+        analyze(window_, tap->format(), measured);
+        lastTap_ = tap;
+        lastSequence_ = window_.sequence;
+        fresh = true;
+    }
+
+    // Rise at once, fall at the meter rate; without a new window
+    // everything falls towards silence
+    const float fall = fallDbPerSecond_ * static_cast<float>(elapsed.count()) / 1e6f;
+    auto ballistics = [fall](float& shown, float value) { shown = std::max(value, std::max(shown - fall, SILENCE_DB)); };
+    for (size_t c = 0; c < MAX_TAP_CHANNELS; ++c)
+    {
+        ballistics(frame_.peakDb[c], measured.peakDb[c]);
+        ballistics(frame_.rmsDb[c], measured.rmsDb[c]);
+    }
+    for (size_t b = 0; b < SPECTRUM_BANDS; ++b)
+        ballistics(frame_.bandsDb[b], measured.bandsDb[b]);
+    if (fresh)
+    {
+        frame_.channels = measured.channels;
+        ++frame_.windows;
+    }
+    else if (!tap)
+    {
+        frame_.channels = 0;
+    }
+}
+
+
+void SpectrumAnalyzer::analyze(const AnalysisTap::Window& window, const TapFormat& format, AnalysisFrame& measured)
+{
+    const size_t channels = format.channels;
+    measured.channels = static_cast<uint16_t>(std::min<size_t>(channels, MAX_TAP_CHANNELS));
+
+    // Levels per channel
+    for (size_t c = 0; c < measured.channels; ++c)
+    {
+        float peak = 0.f;
+        double sum = 0.;
+        for (uint32_t f = 0; f < window.frames; ++f)
+        {
+            const float x = window.samples[f * channels + c];
+            peak = std::max(peak, std::fabs(x));
+            sum += static_cast<double>(x) * x;
+        }
+        measured.peakDb[c] = toDb(static_cast<double>(peak) * peak);
+        measured.rmsDb[c] = toDb((window.frames > 0) ? sum / window.frames : 0.);
+    }
+
+    // Spectrum of the channel sum; a short window is zero padded
+    const float mix = 1.f / static_cast<float>(std::max<size_t>(channels, 1));
+    for (uint32_t f = 0; f < TAP_WINDOW; ++f)
+    {
+        float x = 0.f;
+        if (f < window.frames)
+        {
+            for (size_t c = 0; c < channels; ++c)
+                x += window.samples[f * channels + c];
+        }
+        spectrum_[bitReverse_[f]] = std::complex<float>(x * mix * hann_[f], 0.f);
+    }
+    fft();
+
+    if (bandRate_ != format.rate)
+    {
+        bandRate_ = format.rate;
+        const double high = std::min(SPECTRUM_HIGH, format.rate / 2.);
+        auto bin = [&](size_t edge) {
+            const double hz = SPECTRUM_LOW * std::pow(high / SPECTRUM_LOW, static_cast<double>(edge) / SPECTRUM_BANDS);
+            return std::clamp(static_cast<uint32_t>(hz * TAP_WINDOW / format.rate), 1u, TAP_WINDOW / 2 - 1);
+        };
+        for (size_t b = 0; b < SPECTRUM_BANDS; ++b)
+        {
+            bandFirst_[b] = bin(b);
+            bandLast_[b] = std::max(bandFirst_[b] + 1, bin(b + 1));
+        }
+    }
+    // A full-scale sine puts (N/4)^2 into its bin through the Hann window,
+    // 1.5 times that into its main lobe
+    const double reference = 1.5 * (TAP_WINDOW / 4.) * (TAP_WINDOW / 4.);
+    for (size_t b = 0; b < SPECTRUM_BANDS; ++b)
+    {
+        double power = 0.;
+        for (uint32_t k = bandFirst_[b]; k < bandLast_[b]; ++k)
+            power += std::norm(spectrum_[k]);
+        measured.bandsDb[b] = toDb(power / reference);
+    }
+}
+
+
+void SpectrumAnalyzer::fft()
+{
+    // Radix 2, in place on the bit-reversed input. Local pointers: through
+    // the members every store would reload them.
+    std::complex<float>* x = spectrum_.data();
+    const std::complex<float>* twiddles = twiddles_.data();
+    for (uint32_t len = 2; len <= TAP_WINDOW; len <<= 1)
+    {
+        const uint32_t half = len / 2;
+        const uint32_t step = TAP_WINDOW / len;
+        for (uint32_t i = 0; i < TAP_WINDOW; i += len)
+        {
+            for (uint32_t k = 0; k < half; ++k)
+            {
+                // Spelled out: std::complex's operator* checks for NaN
+                const std::complex<float> w = twiddles[k * step];
+                const std::complex<float> b = x[i + k + half];
+                const std::complex<float> v(b.real() * w.real() - b.imag() * w.imag(), b.real() * w.imag() + b.imag() * w.real());
+                const std::complex<float> u = x[i + k];
+                x[i + k] = u + v;
+                x[i + k + half] = u - v;
+            }
+        }
+    }
+}
+
+} // namespace dsp
@@ -0,0 +1,181 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// local headers
+#include "playout/render_kernels.hpp"
+
+// Standard headers
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dsp
+{
+
+/// Frames per analysis window (43 ms at 48 kHz), also the FFT size
+static constexpr uint32_t TAP_WINDOW = 2048;
+/// Windows kept: more than the AudioQueue holds, so the one playing now is there
+static constexpr uint32_t TAP_SLOTS = 8;
+/// Channels with levels
+static constexpr uint16_t MAX_TAP_CHANNELS = 8;
+/// Log-spaced bands from 20 Hz to 20 kHz (or the Nyquist frequency)
+static constexpr size_t SPECTRUM_BANDS = 32;
+/// Floor of levels and bands, dBFS
+static constexpr float SILENCE_DB = -120.f;
+
+/// Format of the tapped buffers: the AudioQueue's
+struct TapFormat
+{
+    uint32_t rate{48000};
+    uint16_t channels{2};
+    /// 16, 24 (in a 32-bit container) or 32
+    uint16_t bits{16};
+};
+
+/// Copies of the played audio for analysis off the audio thread.
+///
+/// Per buffer the audio thread copies the last TAP_WINDOW frames, as they
+/// are (one memcpy), into the next of TAP_SLOTS slots together with the
+/// time they start playing; the rest of the buffer is skipped, so the tap
+/// costs the same at any buffer size. push() is wait-free: each slot is a
+/// seqlock, the writer never waits for a reader, and a reader that raced
+/// with the writer sees the version change and takes an older slot.
+///
+/// One writer (the audio thread) and any number of readers.
+class AnalysisTap
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// A window read back, normalized float, interleaved
+    struct Window
+    {
+        std::vector<float> samples;
+        uint32_t frames{0};
+        uint64_t sequence{0};
+        Clock::time_point start;
+    };
+
+    explicit AnalysisTap(const TapFormat& format);
+
+    /// Audio thread: @p pcm is a buffer of @p frames whose first frame
+    /// plays at @p playAt. No lock, no allocation.
+    void push(const void* pcm, uint32_t frames, Clock::time_point playAt);
+
+    /// The newest window that started playing by @p now, false if there is
+    /// none (nothing pushed, or all still ahead in the queue)
+    bool read(Clock::time_point now, Window& window) const;
+
+    const TapFormat& format() const
+    {
+        return format_;
+    }
+    /// Windows pushed so far
+    uint64_t pushed() const
+    {
+        return written_.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Slot
+    {
+        /// Odd while written: 2 n + 1 for push n, 2 n + 2 once done
+        std::atomic<uint64_t> version{0};
+        std::atomic<int64_t> start{0};  ///< Clock ticks
+        std::atomic<uint32_t> frames{0};
+    };
+
+    TapFormat format_;
+    size_t frameBytes_;
+    playout::RenderKernel toFloat_;
+    std::array<Slot, TAP_SLOTS> slots_;
+    std::vector<char> data_;
+    std::atomic<uint64_t> written_{0};
+    /// Reader scratch: the raw copy, checked before it is converted
+    mutable std::vector<char> raw_;
+};
+
+/// Levels and spectrum for the UI
+struct AnalysisFrame
+{
+    uint16_t channels{0};
+    std::array<float, MAX_TAP_CHANNELS> peakDb;  ///< Sample peak, dBFS
+    std::array<float, MAX_TAP_CHANNELS> rmsDb;   ///< dBFS, a full-scale sine is -3
+    /// Sum of the channels, a full-scale sine reads 0 dB in its band
+    std::array<float, SPECTRUM_BANDS> bandsDb;
+    /// Windows analyzed
+    uint64_t windows{0};
+
+    AnalysisFrame()
+    {
+        peakDb.fill(SILENCE_DB);
+        rmsDb.fill(SILENCE_DB);
+        bandsDb.fill(SILENCE_DB);
+    }
+};
+
+/// Turns tapped windows into AnalysisFrames, on a thread of its own.
+///
+/// Each update() analyzes the window playing now: peak and RMS per channel
+/// and a Hann-windowed TAP_WINDOW point FFT of the channel sum, summed into
+/// SPECTRUM_BANDS log-spaced bands. Values rise at once and fall at most
+/// @p fallDbPerSecond, the usual meter ballistics, so the display stays
+/// readable between windows and falls to silence when playback stops.
+class SpectrumAnalyzer
+{
+public:
+    using Clock = AnalysisTap::Clock;
+
+    explicit SpectrumAnalyzer(float fallDbPerSecond = 24.f);
+
+    /// Analyze @p tap at @p now; @p elapsed since the last update sets the
+    /// fall. A null @p tap (no queue) lets everything fall.
+    void update(const AnalysisTap* tap, Clock::time_point now, std::chrono::microseconds elapsed);
+
+    const AnalysisFrame& frame() const
+    {
+        return frame_;
+    }
+
+private:
+    void analyze(const AnalysisTap::Window& window, const TapFormat& format, AnalysisFrame& measured);
+    void fft();
+
+    float fallDbPerSecond_;
+    const AnalysisTap* lastTap_{nullptr};
+    uint64_t lastSequence_{0};
+    /// FFT bins [first, last) of each band at bandRate_; at low frequencies
+    /// a bin is wider than a band, neighbouring bands then share it
+    uint32_t bandRate_{0};
+    std::array<uint32_t, SPECTRUM_BANDS> bandFirst_{};
+    std::array<uint32_t, SPECTRUM_BANDS> bandLast_{};
+    std::vector<float> hann_;
+    std::vector<std::complex<float>> twiddles_;
+    std::vector<uint32_t> bitReverse_;
+    std::vector<std::complex<float>> spectrum_;
+    AnalysisTap::Window window_;
+    AnalysisFrame frame_;
+};
+
+} // namespace dsp
@@ -0,0 +1,288 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "channel_mixer.hpp"
+
+// Standard headers
+#include <algorithm>
+
+namespace dsp
+{
+
+namespace
+{
+
+/// -3 dB
+static constexpr float MINUS_3DB = 0.70710678f;
+
+enum class Speaker
+{
+    FL,
+    FR,
+    FC,
+    LFE,
+    BL,
+    BR,
+    BC,
+    SL,
+    SR,
+};
+
+/// WAVE default layouts (the FLAC / Snapcast channel order), by count
+bool layout(uint16_t channels, std::array<Speaker, MAX_MIX_CHANNELS>& speakers)
+{
+    using S = Speaker;
+    switch (channels)
+    {
+        case 2:
+            speakers = {S::FL, S::FR};
+            return true;
+        case 3:
+            speakers = {S::FL, S::FR, S::FC};
+            return true;
+        case 4:
+            speakers = {S::FL, S::FR, S::BL, S::BR};
+            return true;
+        case 5:
+            speakers = {S::FL, S::FR, S::FC, S::BL, S::BR};
+            return true;
+        case 6:
+            speakers = {S::FL, S::FR, S::FC, S::LFE, S::BL, S::BR};
+            return true;
+        case 7:
+            speakers = {S::FL, S::FR, S::FC, S::LFE, S::BC, S::SL, S::SR};
+            return true;
+        case 8:
+            speakers = {S::FL, S::FR, S::FC, S::LFE, S::BL, S::BR, S::SL, S::SR};
+            return true;
+        default:
+            return false;
+    }
+}
+
+
+/// Left and right gains of @p speaker in the stereo downmix
+std::array<float, 2> stereoGains(Speaker speaker)
+{
+    switch (speaker)
+    {
+        case Speaker::FL:
+            return {1.f, 0.f};
+        case Speaker::FR:
+            return {0.f, 1.f};
+        case Speaker::FC:
+            return {MINUS_3DB, MINUS_3DB};
+        case Speaker::LFE:
+            return {0.f, 0.f};
+        case Speaker::BL:
+        case Speaker::SL:
+            return {MINUS_3DB, 0.f};
+        case Speaker::BR:
+        case Speaker::SR:
+            return {0.f, MINUS_3DB};
+        case Speaker::BC:
+            return {0.5f, 0.5f};
+    }
+    return {0.f, 0.f};
+}
+
+
+/// In / Out == 0: generic instance, channel counts from the matrix
+template <int In, int Out>
+void mix(const ChannelMatrix& matrix, const float* in, float* out, uint32_t frames)
+{
+    constexpr size_t BLOCK = ChannelMixer::BLOCK_FRAMES;
+    constexpr size_t MAX_IN = (In > 0) ? In : MAX_MIX_CHANNELS;
+    constexpr size_t MAX_OUT = (Out > 0) ? Out : MAX_MIX_CHANNELS;
+    const size_t n = (In > 0) ? static_cast<size_t>(In) : matrix.inputs;
+    const size_t m = (Out > 0) ? static_cast<size_t>(Out) : matrix.outputs;
+
+    alignas(16) float x[MAX_IN][BLOCK];
+    alignas(16) float y[MAX_OUT][BLOCK];
+    for (uint32_t done = 0; done < frames; done += BLOCK)
+    {
+        const size_t len = std::min<size_t>(BLOCK, frames - done);
+        const float* src = in + done * n;
+        float* dst = out + done * m;
+
+        for (size_t f = 0; f < len; ++f)
+        {
+            for (size_t i = 0; i < n; ++i)
+                x[i][f] = src[f * n + i];
+        }
+        // The last block is short: keep the full-length loops on defined data
+        for (size_t i = 0; (len < BLOCK) && (i < n); ++i)
+            std::fill(x[i] + len, x[i] + BLOCK, 0.f);
+
+        for (size_t o = 0; o < m; ++o)
+        {
+            std::fill(y[o], y[o] + BLOCK, 0.f);
+            for (size_t i = 0; i < n; ++i)
+            {
+                const float g = matrix.gain[o][i];
+                if (g == 0.f)
+                    continue;
+                // Fixed length: one vector multiply-add per step
+                for (size_t f = 0; f < BLOCK; ++f)
+                    y[o][f] += g * x[i][f];
+            }
+        }
+
+        for (size_t f = 0; f < len; ++f)
+        {
+            for (size_t o = 0; o < m; ++o)
+                dst[f * m + o] = y[o][f];
+        }
+    }
+}
+
+} // namespace
+
+
+const char* toString(ChannelMode mode)
+{
+    switch (mode)
+    {
+        case ChannelMode::Native:
+            return "native";
+        case ChannelMode::Stereo:
+            return "stereo";
+        case ChannelMode::Mono:
+            return "mono";
+        case ChannelMode::Left:
+            return "left";
+        case ChannelMode::Right:
+            return "right";
+        case ChannelMode::Custom:
+            return "custom";
+    }
+    return "unknown";
+}
+
+
+bool ChannelMatrix::identity() const
+{
+    if (inputs != outputs)
+        return false;
+    for (uint16_t o = 0; o < outputs; ++o)
+    {
+        for (uint16_t i = 0; i < inputs; ++i)
+        {
+            if (gain[o][i] != ((o == i) ? 1.f : 0.f))
+                return false;
+        }
+    }
+    return true;
+}
+
+
+ChannelMatrix downmixMatrix(ChannelMode mode, uint16_t inputs)
+{
+    ChannelMatrix matrix;
+    if ((mode == ChannelMode::Native) || (mode == ChannelMode::Custom) || (inputs == 0) || (inputs > MAX_MIX_CHANNELS))
+        return matrix;
+
+    // Left and right rows of the stereo downmix
+    std::array<std::array<float, MAX_MIX_CHANNELS>, 2> stereo{};
+    if (inputs == 1)
+    {
+        stereo[0][0] = 1.f;
+        stereo[1][0] = 1.f;
+    }
+    else
+    {
+        std::array<Speaker, MAX_MIX_CHANNELS> speakers{};
+        if (!layout(inputs, speakers))
+            return matrix;
+        for (uint16_t i = 0; i < inputs; ++i)
+        {
+            auto lr = stereoGains(speakers[i]);
+            stereo[0][i] = lr[0];
+            stereo[1][i] = lr[1];
+        }
+    }
+
+    matrix.inputs = inputs;
+    switch (mode)
+    {
+        case ChannelMode::Stereo:
+            matrix.outputs = 2;
+            matrix.gain[0] = stereo[0];
+            matrix.gain[1] = stereo[1];
+            break;
+        case ChannelMode::Mono:
+            matrix.outputs = 1;
+            // A mono source stays as it is
+            for (uint16_t i = 0; i < inputs; ++i)
+                matrix.gain[0][i] = (inputs == 1) ? 1.f : 0.5f * (stereo[0][i] + stereo[1][i]);
+            break;
+        case ChannelMode::Left:
+        case ChannelMode::Right:
+            matrix.outputs = 1;
+            matrix.gain[0] = stereo[(mode == ChannelMode::Left) ? 0 : 1];
+            break;
+        default:
+            break;
+    }
+    return matrix;
+}
+
+
+ChannelMixer::ChannelMixer(const ChannelMatrix& matrix) : matrix_(matrix)
+{
+    if (!matrix_.valid())
+        matrix_ = ChannelMatrix{};
+    specialized_ = true;
+    // inputs and outputs are at most 8: one decimal digit each
+    const int shape = matrix_.inputs * 10 + matrix_.outputs;
+    switch (shape)
+    {
+        case 62:  // 5.1 -> stereo
+            fn_ = &mix<6, 2>;
+            break;
+        case 61:  // 5.1 -> mono or one side
+            fn_ = &mix<6, 1>;
+            break;
+        case 82:  // 7.1 -> stereo
+            fn_ = &mix<8, 2>;
+            break;
+        case 21:  // stereo -> mono or one side
+            fn_ = &mix<2, 1>;
+            break;
+        case 12:  // mono -> stereo
+            fn_ = &mix<1, 2>;
+            break;
+        case 22:  // custom stereo (swap, cross-feed)
+            fn_ = &mix<2, 2>;
+            break;
+        default:
+            specialized_ = false;
+            fn_ = &mix<0, 0>;
+            break;
+    }
+}
+
+
+void ChannelMixer::process(const float* in, float* out, uint32_t frames) const
+{
+    if (matrix_.outputs == 0)
+        return;
+    fn_(matrix_, in, out, frames);
+}
+
+} // namespace dsp
@@ -0,0 +1,110 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// Standard headers
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace dsp
+{
+
+static constexpr uint16_t MAX_MIX_CHANNELS = 8;
+
+/// What the output carries
+enum class ChannelMode
+{
+    Native,  ///< The stream's channels, unchanged
+    Stereo,  ///< Downmixed (or mono duplicated) to two channels
+    Mono,    ///< One channel, the sum of the stereo downmix
+    Left,    ///< One channel, the left of the stereo downmix (a stereo pair's left speaker)
+    Right,   ///< One channel, the right of the stereo downmix
+    Custom,  ///< A caller-supplied matrix
+};
+
+const char* toString(ChannelMode mode);
+
+/// Output channel o = sum over i of gain[o][i] * input channel i
+struct ChannelMatrix
+{
+    uint16_t inputs{0};
+    uint16_t outputs{0};
+    std::array<std::array<float, MAX_MIX_CHANNELS>, MAX_MIX_CHANNELS> gain{};
+
+    bool valid() const
+    {
+        return (inputs > 0) && (inputs <= MAX_MIX_CHANNELS) && (outputs > 0) && (outputs <= MAX_MIX_CHANNELS);
+    }
+    /// Output equals input: no mixing needed
+    bool identity() const;
+};
+
+/// Matrix for @p mode from @p inputs channels in WAVE order (FL FR FC LFE
+/// BL BR, 7.1 adding SL SR; 4 channels are quad, 5 drop the LFE). The
+/// downmix is ITU-R BS.775: center and surrounds at -3 dB, LFE dropped, not
+/// normalized (the limiter catches the rare overs); a mono input is copied
+/// to both sides. Native, Custom or an unsupported channel count give an
+/// invalid matrix.
+ChannelMatrix downmixMatrix(ChannelMode mode, uint16_t inputs);
+
+/// Applies a ChannelMatrix to interleaved float.
+///
+/// Frames are deinterleaved into planar blocks so each output channel is a
+/// sum of scaled input rows, vectorized over the frames (one broadcast
+/// multiply-add per input channel), then interleaved again. Zero gains (the
+/// LFE in a downmix, the other side in a channel selection) are skipped
+/// per block. The common shapes (6 -> 2, 6 -> 1, 8 -> 2, 2 -> 1, 1 -> 2,
+/// 2 -> 2) are compile-time specialized like the render kernels; others
+/// take a generic kernel at about scalar speed.
+///
+/// process() is real-time safe.
+class ChannelMixer
+{
+public:
+    static constexpr uint32_t BLOCK_FRAMES = 32;
+
+    explicit ChannelMixer(const ChannelMatrix& matrix);
+
+    /// @p in has inputs() channels, @p out outputs(); they must not overlap
+    void process(const float* in, float* out, uint32_t frames) const;
+
+    uint16_t inputs() const
+    {
+        return matrix_.inputs;
+    }
+    uint16_t outputs() const
+    {
+        return matrix_.outputs;
+    }
+    /// true for a compile-time specialized kernel
+    bool specialized() const
+    {
+        return specialized_;
+    }
+
+    using Fn = void (*)(const ChannelMatrix& matrix, const float* in, float* out, uint32_t frames);
+
+private:
+    ChannelMatrix matrix_;
+    Fn fn_{nullptr};
+    bool specialized_{false};
+};
+
+} // namespace dsp
@@ -0,0 +1,199 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "dither.hpp"
+
+// Standard headers
+#include <algorithm>
+
+namespace dsp
+{
+
+namespace
+{
+
+struct Out16
+{
+    using Sample = int16_t;
+    using Math = float;
+    static constexpr Math FULL_SCALE = 32768.f;
+};
+
+struct Out24
+{
+    using Sample = int32_t;
+    using Math = double;  // The dither is below the float resolution of 24-bit values
+    static constexpr Math FULL_SCALE = 8388608.;
+};
+
+
+/// Samples per block: LANES values of dither per fill
+static constexpr uint32_t BLOCK = 4 * Dither::LANES;
+
+/// Lipshitz, Vanderkooy & Wannamaker's E-weighted filter: the noise transfer
+/// is 1 - sum of SHAPING[k] z^-(k + 1)
+static constexpr std::array<float, Dither::TAPS> SHAPING = {2.033f, -2.165f, 1.959f, -1.590f, 0.6149f};
+
+/// Bound of the fed back error, in LSB: at full scale the clamp makes the
+/// error large, which must not wind the filter up
+static constexpr float MAX_ERROR = 2.f;
+
+
+/// Round to nearest, clamped to full scale. Offset to positive values, the
+/// truncating conversion (one vector instruction) rounds down.
+template <typename Out>
+typename Out::Sample quantize(typename Out::Math value)
+{
+    using Math = typename Out::Math;
+    constexpr Math LOW = Math(0.5);
+    constexpr Math HIGH = 2 * Out::FULL_SCALE - Math(0.5);
+    value = std::min(std::max(value + Out::FULL_SCALE + Math(0.5), LOW), HIGH);
+    return static_cast<typename Out::Sample>(static_cast<int32_t>(value) - static_cast<int32_t>(Out::FULL_SCALE));
+}
+
+
+/// A full block is two loops of constant length through a local buffer,
+/// which the compiler vectorizes at -O2 (as in the render kernels); a short
+/// last block takes the same steps per sample.
+template <typename Out>
+void quantizeFlat(const float* in, typename Out::Sample* out, const float* tpdf, size_t count)
+{
+    using Math = typename Out::Math;
+    if (count < BLOCK)
+    {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = quantize<Out>(static_cast<Math>(in[i]) * Out::FULL_SCALE + static_cast<Math>(tpdf[i]));
+        return;
+    }
+    Math block[BLOCK];
+    for (size_t i = 0; i < BLOCK; ++i)
+        block[i] = static_cast<Math>(in[i]) * Out::FULL_SCALE + static_cast<Math>(tpdf[i]);
+    for (size_t i = 0; i < BLOCK; ++i)
+        out[i] = quantize<Out>(block[i]);
+}
+
+
+/// Error feedback: the error of each sample is subtracted, filtered, from
+/// the next ones of its channel. @p channel is the channel of in[0].
+template <typename Out>
+void quantizeShaped(const float* in, typename Out::Sample* out, const float* tpdf, size_t count, size_t& channel, size_t channels,
+                    std::array<float, Dither::TAPS>* error)
+{
+    using Math = typename Out::Math;
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto& e = error[channel];
+        float feedback = 0.f;
+        for (size_t k = 0; k < Dither::TAPS; ++k)
+            feedback += SHAPING[k] * e[k];
+        const Math target = static_cast<Math>(in[i]) * Out::FULL_SCALE - static_cast<Math>(feedback);
+        out[i] = quantize<Out>(target + static_cast<Math>(tpdf[i]));
+        for (size_t k = Dither::TAPS - 1; k > 0; --k)
+            e[k] = e[k - 1];
+        e[0] = std::clamp(static_cast<float>(static_cast<Math>(out[i]) - target), -MAX_ERROR, MAX_ERROR);
+        if (++channel == channels)
+            channel = 0;
+    }
+}
+
+
+} // namespace
+
+
+Dither::Dither(uint16_t channels, uint16_t bits, DitherOptions options)
+    : channels_(std::max<uint16_t>(channels, 1)), bits_(bits), noiseShaping_(options.noiseShaping), error_(channels_)
+{
+    // splitmix32 spreads one seed over the lanes; xorshift must not start at 0
+    uint32_t seed = options.seed;
+    for (auto& state : state_)
+    {
+        seed += 0x9E3779B9;
+        uint32_t z = seed;
+        z = (z ^ (z >> 16)) * 0x85EBCA6B;
+        z = (z ^ (z >> 13)) * 0xC2B2AE35;
+        z ^= z >> 16;
+        state = (z != 0) ? z : 1;
+    }
+    reset();
+}
+
+
+void Dither::process(const float* in, void* out, uint32_t frames)
+{
+    const size_t samples = static_cast<size_t>(frames) * channels_;
+    switch (bits_)
+    {
+        case 16:
+            run<Out16>(in, out, samples);
+            break;
+        case 24:
+            run<Out24>(in, out, samples);
+            break;
+        default:
+            break;
+    }
+}
+
+
+template <typename Out>
+void Dither::run(const float* in, void* out, size_t samples)
+{
+    auto* dst = static_cast<typename Out::Sample*>(out);
+    alignas(16) float tpdf[BLOCK];
+    size_t channel = 0;
+    for (size_t done = 0; done < samples; done += BLOCK)
+    {
+        const size_t len = std::min<size_t>(BLOCK, samples - done);
+        for (size_t i = 0; i < len; i += LANES)
+            fill(tpdf + i);
+        if (noiseShaping_)
+            quantizeShaped<Out>(in + done, dst + done, tpdf, len, channel, channels_, error_.data());
+        else
+            quantizeFlat<Out>(in + done, dst + done, tpdf, len);
+    }
+}
+
+
+void Dither::reset()
+{
+    for (auto& e : error_)
+        e.fill(0.f);
+}
+
+
+void Dither::fill(float* tpdf)
+{
+    // Each lane is an xorshift32 generator; the two 16-bit halves of a draw
+    // are two uniform values, their sum is triangular over +-1 LSB. Local
+    // copies keep the loop free of aliasing, so it is one vector loop.
+    std::array<uint32_t, LANES> state = state_;
+    std::array<float, LANES> values;
+    for (uint32_t i = 0; i < LANES; ++i)
+    {
+        uint32_t s = state[i];
+        s ^= s << 13;
+        s ^= s >> 17;
+        s ^= s << 5;
+        state[i] = s;
+        values[i] = static_cast<float>(static_cast<int32_t>((s & 0xFFFF) + (s >> 16)) - 65535) * (1.f / 65536.f);
+    }
+    state_ = state;
+    std::copy(values.begin(), values.end(), tpdf);
+}
+
+} // namespace dsp
@@ -0,0 +1,95 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// Standard headers
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dsp
+{
+
+struct DitherOptions
+{
+    /// Push the noise above ~10 kHz, where the ear is least sensitive
+    bool noiseShaping{false};
+    uint32_t seed{0x9E3779B9};
+};
+
+/// Quantizes normalized float to integer PCM of fewer bits than the source
+/// with TPDF dither, so the quantization error becomes a steady noise floor
+/// instead of distortion that follows the signal (audible on quiet passages
+/// and at low volume).
+///
+/// The dither is the sum of two uniform values of one LSB each, from one
+/// xorshift32 draw split in halves; LANES generators step side by side, so
+/// a block of dither is one vector loop. Without noise shaping the
+/// quantization is vectorized as well. With noise shaping the error is fed
+/// back through Lipshitz's 5-tap E-weighted filter (per channel, a
+/// recursion over the frames, so scalar): about 16 dB less noise below
+/// 4 kHz for 12 dB more in total, above 10 kHz.
+///
+/// Targets are 16 bits and 24 bits (in a 32-bit container, as Snapcast
+/// stores it). Everything but the constructor is real-time safe.
+class Dither
+{
+public:
+    static constexpr uint32_t LANES = 16;
+    static constexpr size_t TAPS = 5;
+
+    Dither(uint16_t channels, uint16_t bits, DitherOptions options = {});
+
+    /// @p in has frames * channels samples; @p out gets bits() PCM
+    void process(const float* in, void* out, uint32_t frames);
+
+    /// Clear the noise shaping history
+    void reset();
+
+    /// false for an unsupported bit depth: process() writes nothing
+    explicit operator bool() const
+    {
+        return (bits_ == 16) || (bits_ == 24);
+    }
+    uint16_t bits() const
+    {
+        return bits_;
+    }
+    bool noiseShaping() const
+    {
+        return noiseShaping_;
+    }
+
+private:
+    template <typename Out>
+    void run(const float* in, void* out, size_t samples);
+
+    /// Next LANES TPDF values in LSB, in (-1, 1)
+    void fill(float* tpdf);
+
+    uint16_t channels_;
+    uint16_t bits_;
+    bool noiseShaping_;
+    std::array<uint32_t, LANES> state_;
+    /// Last TAPS errors per channel, newest first
+    std::vector<std::array<float, TAPS>> error_;
+};
+
+} // namespace dsp
@@ -0,0 +1,312 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "parametric_eq.hpp"
+
+// Standard headers
+#include <algorithm>
+#include <cmath>
+
+namespace dsp
+{
+
+static constexpr float DENORMAL_FLOOR = 1e-20f;
+
+
+const char* toString(FilterType type)
+{
+    switch (type)
+    {
+        case FilterType::Peaking:
+            return "peaking";
+        case FilterType::LowShelf:
+            return "low-shelf";
+        case FilterType::HighShelf:
+            return "high-shelf";
+        case FilterType::LowPass:
+            return "low-pass";
+        case FilterType::HighPass:
+            return "high-pass";
+    }
+    return "unknown";
+}
+
+
+BiquadCoefficients designBiquad(const EqBand& band, uint32_t rate)
+{
+    if ((rate == 0) || !(band.frequency > 0.f) || (band.frequency >= rate / 2.f) || !(band.q > 0.f))
+        return {};
+
+    const double pi = std::acos(-1.);
+    const double A = std::pow(10., band.gainDb / 40.);
+    const double w0 = 2. * pi * band.frequency / rate;
+    const double cosw = std::cos(w0);
+    const double alpha = std::sin(w0) / (2. * band.q);
+    const double shelf = 2. * std::sqrt(A) * alpha;
+
+    double b0 = 1, b1 = 0, b2 = 0, a0 = 1, a1 = 0, a2 = 0;
+    switch (band.type)
+    {
+        case FilterType::Peaking:
+            b0 = 1 + alpha * A;
+            b1 = -2 * cosw;
+            b2 = 1 - alpha * A;
+            a0 = 1 + alpha / A;
+            a1 = -2 * cosw;
+            a2 = 1 - alpha / A;
+            break;
+        case FilterType::LowShelf:
+            b0 = A * ((A + 1) - (A - 1) * cosw + shelf);
+            b1 = 2 * A * ((A - 1) - (A + 1) * cosw);
+            b2 = A * ((A + 1) - (A - 1) * cosw - shelf);
+            a0 = (A + 1) + (A - 1) * cosw + shelf;
+            a1 = -2 * ((A - 1) + (A + 1) * cosw);
+            a2 = (A + 1) + (A - 1) * cosw - shelf;
+            break;
+        case FilterType::HighShelf:
+            b0 = A * ((A + 1) + (A - 1) * cosw + shelf);
+            b1 = -2 * A * ((A - 1) + (A + 1) * cosw);
+            b2 = A * ((A + 1) + (A - 1) * cosw - shelf);
+            a0 = (A + 1) - (A - 1) * cosw + shelf;
+            a1 = 2 * ((A - 1) - (A + 1) * cosw);
+            a2 = (A + 1) - (A - 1) * cosw - shelf;
+            break;
+        case FilterType::LowPass:
+            b0 = (1 - cosw) / 2;
+            b1 = 1 - cosw;
+            b2 = (1 - cosw) / 2;
+            a0 = 1 + alpha;
+            a1 = -2 * cosw;
+            a2 = 1 - alpha;
+            break;
+        case FilterType::HighPass:
+            b0 = (1 + cosw) / 2;
+            b1 = -(1 + cosw);
+            b2 = (1 + cosw) / 2;
+            a0 = 1 + alpha;
+            a1 = -2 * cosw;
+            a2 = 1 - alpha;
+            break;
+    }
+    return {static_cast<float>(b0 / a0), static_cast<float>(b1 / a0), static_cast<float>(b2 / a0), static_cast<float>(a1 / a0),
+            static_cast<float>(a2 / a0)};
+}
+
+
+EqDesign designEq(const EqBand* bands, size_t count, uint32_t rate)
+{
+    EqDesign design;
+    design.rate = rate;
+    design.sections = std::min(count, MAX_EQ_BANDS);
+    for (size_t s = 0; s < design.sections; ++s)
+        design.coeffs[s] = designBiquad(bands[s], rate);
+    return design;
+}
+
+
+ParametricEq::ParametricEq(uint32_t rate, uint16_t channels, std::chrono::milliseconds ramp)
+    : rate_(rate), channels_(std::max<uint16_t>(channels, 1))
+{
+    groups_ = (channels_ + LANES - 1) / LANES;
+    rampFrames_ = static_cast<uint32_t>(static_cast<uint64_t>(std::max<int64_t>(ramp.count(), 0)) * rate_ / 1000);
+    state_.resize(groups_ * MAX_EQ_BANDS);
+    previousState_.resize(state_.size());
+    reset();
+}
+
+
+void ParametricEq::reset()
+{
+    for (auto* states : {&state_, &previousState_})
+    {
+        for (auto& state : *states)
+        {
+            std::fill(std::begin(state.z1), std::end(state.z1), 0.f);
+            std::fill(std::begin(state.z2), std::end(state.z2), 0.f);
+        }
+    }
+}
+
+
+void ParametricEq::configure(const EqBand* bands, size_t count)
+{
+    configure(designEq(bands, count, rate_));
+}
+
+
+bool ParametricEq::configure(const EqDesign& design)
+{
+    if (design.rate != rate_)
+        return false;
+    if (fadeLeft_ > 0)
+    {
+        // Restarting the fade from the mixed output would step: queue it
+        pending_ = design.coeffs;
+        pendingSections_ = design.sections;
+        hasPending_ = true;
+        return true;
+    }
+    apply(design.coeffs, design.sections);
+    return true;
+}
+
+
+void ParametricEq::apply(const Cascade& coeffs, size_t sections)
+{
+    if (rampFrames_ > 0)
+    {
+        previous_ = coeffs_;
+        previousSections_ = sections_;
+        previousState_ = state_;
+        fadeLeft_ = rampFrames_;
+    }
+    // The new cascade starts from the old state: same-index bands that
+    // barely changed continue seamlessly, and whatever transient the others
+    // have is under the fade-in. Sections that weren't running start clear.
+    for (size_t s = sections_; s < sections; ++s)
+    {
+        for (size_t g = 0; g < groups_; ++g)
+        {
+            auto& state = state_[g * MAX_EQ_BANDS + s];
+            std::fill(std::begin(state.z1), std::end(state.z1), 0.f);
+            std::fill(std::begin(state.z2), std::end(state.z2), 0.f);
+        }
+    }
+    coeffs_ = coeffs;
+    sections_ = sections;
+}
+
+
+template <size_t Width>
+void ParametricEq::cascade(float (*x)[Width], uint32_t frames, const Cascade& coeffs, size_t sections, State* state)
+{
+    // State in locals for the block; sections inner, so the out-of-order
+    // core overlaps the sections' recurrences
+    const BiquadCoefficients* c = coeffs.data();
+    alignas(16) float z1[MAX_EQ_BANDS][Width];
+    alignas(16) float z2[MAX_EQ_BANDS][Width];
+    for (size_t s = 0; s < sections; ++s)
+    {
+        std::copy(state[s].z1, state[s].z1 + Width, z1[s]);
+        std::copy(state[s].z2, state[s].z2 + Width, z2[s]);
+    }
+
+    for (uint32_t f = 0; f < frames; ++f)
+    {
+        alignas(16) float v[Width];
+        std::copy(x[f], x[f] + Width, v);
+        for (size_t s = 0; s < sections; ++s)
+        {
+            // One channel per lane: Width independent filters in lockstep
+            for (size_t l = 0; l < Width; ++l)
+            {
+                const float in = v[l];
+                const float y = c[s].b0 * in + z1[s][l];
+                z1[s][l] = c[s].b1 * in - c[s].a1 * y + z2[s][l];
+                z2[s][l] = c[s].b2 * in - c[s].a2 * y;
+                v[l] = y;
+            }
+        }
+        std::copy(v, v + Width, x[f]);
+    }
+
+    // A decaying state would go denormal in silence, which is slow on most
+    // FPUs: flush it once per block
+    for (size_t s = 0; s < sections; ++s)
+    {
+        for (size_t l = 0; l < Width; ++l)
+        {
+            state[s].z1[l] = (std::fabs(z1[s][l]) < DENORMAL_FLOOR) ? 0.f : z1[s][l];
+            state[s].z2[l] = (std::fabs(z2[s][l]) < DENORMAL_FLOOR) ? 0.f : z2[s][l];
+        }
+    }
+}
+
+
+template <size_t Width>
+void ParametricEq::processGroup(float* pcm, uint32_t frames, size_t group)
+{
+    const size_t n = channels_;
+    const size_t base = group * LANES;
+    const size_t lanes = std::min(Width, n - base);
+
+    alignas(16) float x[BLOCK_FRAMES][Width];
+    for (uint32_t f = 0; f < frames; ++f)
+    {
+        for (size_t l = 0; l < Width; ++l)
+            x[f][l] = (l < lanes) ? pcm[f * n + base + l] : 0.f;
+    }
+
+    if (fadeLeft_ == 0)
+    {
+        cascade<Width>(x, frames, coeffs_, sections_, &state_[group * MAX_EQ_BANDS]);
+    }
+    else
+    {
+        alignas(16) float old[BLOCK_FRAMES][Width];
+        std::copy(&x[0][0], &x[0][0] + frames * Width, &old[0][0]);
+        cascade<Width>(old, frames, previous_, previousSections_, &previousState_[group * MAX_EQ_BANDS]);
+        cascade<Width>(x, frames, coeffs_, sections_, &state_[group * MAX_EQ_BANDS]);
+        // Linear: both outputs are the same signal, mostly in phase
+        const float inv = 1.f / static_cast<float>(rampFrames_);
+        for (uint32_t f = 0; f < frames; ++f)
+        {
+            const float g = (f < fadeLeft_) ? static_cast<float>(rampFrames_ - fadeLeft_ + f + 1) * inv : 1.f;
+            for (size_t l = 0; l < Width; ++l)
+                x[f][l] = old[f][l] + (x[f][l] - old[f][l]) * g;
+        }
+    }
+
+    for (uint32_t f = 0; f < frames; ++f)
+    {
+        for (size_t l = 0; l < lanes; ++l)
+            pcm[f * n + base + l] = x[f][l];
+    }
+}
+
+
+void ParametricEq::process(float* pcm, uint32_t frames)
+{
+    for (uint32_t done = 0; done < frames; done += BLOCK_FRAMES)
+    {
+        if ((sections_ == 0) && (fadeLeft_ == 0))
+            return;
+        const uint32_t len = std::min(BLOCK_FRAMES, frames - done);
+        float* block = pcm + static_cast<size_t>(done) * channels_;
+        for (size_t g = 0; g < groups_; ++g)
+        {
+            // A group of one or two channels (stereo, the rest of 5.1) runs
+            // on half-width vectors instead of idle lanes
+            if (channels_ - g * LANES <= 2)
+                processGroup<2>(block, len, g);
+            else
+                processGroup<LANES>(block, len, g);
+        }
+        if (fadeLeft_ > 0)
+        {
+            fadeLeft_ -= std::min(fadeLeft_, len);
+            if ((fadeLeft_ == 0) && hasPending_)
+            {
+                hasPending_ = false;
+                apply(pending_, pendingSections_);
+            }
+        }
+    }
+}
+
+} // namespace dsp
@@ -0,0 +1,180 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// Standard headers
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dsp
+{
+
+enum class FilterType
+{
+    Peaking,
+    LowShelf,
+    HighShelf,
+    LowPass,
+    HighPass,
+};
+
+const char* toString(FilterType type);
+
+struct EqBand
+{
+    FilterType type{FilterType::Peaking};
+    float frequency{1000.f};  ///< Hz: center, corner or shelf midpoint
+    float gainDb{0.f};        ///< Peaking and shelves only
+    float q{0.707f};
+};
+
+/// Biquad with a0 normalized to 1
+struct BiquadCoefficients
+{
+    float b0{1.f};
+    float b1{0.f};
+    float b2{0.f};
+    float a1{0.f};
+    float a2{0.f};
+};
+
+/// RBJ audio-EQ-cookbook coefficients for @p band at @p rate. A band with
+/// a frequency outside (0, rate / 2) or a non-positive Q is a pass-through.
+BiquadCoefficients designBiquad(const EqBand& band, uint32_t rate);
+
+/// Sections per channel
+static constexpr size_t MAX_EQ_BANDS = 10;
+
+/// Bands designed for one rate. Designing is the trigonometry; applying a
+/// design is a copy, so the audio thread can apply one made elsewhere.
+struct EqDesign
+{
+    uint32_t rate{0};
+    size_t sections{0};
+    std::array<BiquadCoefficients, MAX_EQ_BANDS> coeffs{};
+};
+
+/// At most MAX_EQ_BANDS of @p bands, at @p rate
+EqDesign designEq(const EqBand* bands, size_t count, uint32_t rate);
+
+/// Parametric EQ: a cascade of up to MAX_EQ_BANDS biquads (transposed
+/// direct form II), the same bands on every channel, in place on
+/// interleaved float.
+///
+/// Channels are processed in groups of LANES: each section runs over a
+/// block of frames with one channel per lane, a fixed-length inner loop the
+/// compiler turns into one SIMD operation per step (SSE / NEON). A group of
+/// one or two channels uses half-width vectors; a group of three leaves a
+/// lane idle.
+///
+/// configure() doesn't switch coefficients at once, which clicks on loud
+/// material. Interpolating the coefficients isn't safe either: between two
+/// stable filters the path can pass close to a pole. Instead the old and
+/// the new cascade both run for the ramp and the output crossfades from one
+/// to the other. A configure() during a ramp is applied when it ends (only
+/// the latest one). With no bands and no ramp in progress process() returns
+/// immediately.
+///
+/// Everything but the constructor is real-time safe (no allocation);
+/// configure(const EqDesign&) doesn't design either.
+class ParametricEq
+{
+public:
+    static constexpr size_t LANES = 4;
+    static constexpr uint32_t BLOCK_FRAMES = 32;
+
+    ParametricEq(uint32_t rate, uint16_t channels, std::chrono::milliseconds ramp = std::chrono::milliseconds(20));
+
+    /// New bands (at most MAX_EQ_BANDS are used); an empty list bypasses
+    /// the EQ once the ramp to flat is done
+    void configure(const EqBand* bands, size_t count);
+    void configure(const std::vector<EqBand>& bands)
+    {
+        configure(bands.data(), bands.size());
+    }
+    /// Same with a design made beforehand; false (and nothing changes) if
+    /// it's for another rate
+    bool configure(const EqDesign& design);
+
+    void process(float* pcm, uint32_t frames);
+
+    /// Clear the filter state (e.g. after a discontinuity)
+    void reset();
+
+    bool active() const
+    {
+        return (sections_ > 0) || (fadeLeft_ > 0);
+    }
+    /// Sections per channel, not counting the cascade ramping out
+    size_t sections() const
+    {
+        return sections_;
+    }
+    bool ramping() const
+    {
+        return fadeLeft_ > 0;
+    }
+    uint32_t rate() const
+    {
+        return rate_;
+    }
+    uint16_t channels() const
+    {
+        return channels_;
+    }
+
+private:
+    struct State
+    {
+        alignas(16) float z1[LANES];
+        alignas(16) float z2[LANES];
+    };
+    using Cascade = std::array<BiquadCoefficients, MAX_EQ_BANDS>;
+
+    template <size_t Width>
+    static void cascade(float (*x)[Width], uint32_t frames, const Cascade& coeffs, size_t sections, State* state);
+    template <size_t Width>
+    void processGroup(float* pcm, uint32_t frames, size_t group);
+    void apply(const Cascade& coeffs, size_t sections);
+
+    uint32_t rate_;
+    uint16_t channels_;
+    size_t groups_;
+    uint32_t rampFrames_;
+
+    Cascade coeffs_{};
+    size_t sections_{0};
+    /// The cascade fading out, with its own state
+    Cascade previous_{};
+    size_t previousSections_{0};
+    uint32_t fadeLeft_{0};
+    /// Set by a configure() during a fade
+    Cascade pending_{};
+    size_t pendingSections_{0};
+    bool hasPending_{false};
+
+    /// [group][section]
+    std::vector<State> state_;
+    std::vector<State> previousState_;
+};
+
+} // namespace dsp
@@ -0,0 +1,198 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "peak_limiter.hpp"
+
+// Standard headers
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace dsp
+{
+
+// A recovering gain this close to 1 (0.001 dB) is 1: the exponential never
+// gets there
+static constexpr float UNITY_SNAP = 1e-4f;
+
+namespace
+{
+
+/// Gain each frame needs (ceiling / peak, capped at 1) into @p need;
+/// returns the block's peak. Channels == 0: generic instance, channel count
+/// from the argument.
+template <int Channels>
+float envelope(const float* in, float* need, uint32_t frames, uint16_t channels, float ceiling)
+{
+    const size_t n = (Channels > 0) ? static_cast<size_t>(Channels) : channels;
+    float blockPeak = 0.f;
+    for (uint32_t f = 0; f < frames; ++f)
+    {
+        float peak = 0.f;
+        for (size_t c = 0; c < n; ++c)
+            peak = std::max(peak, std::fabs(in[f * n + c]));
+        need[f] = ceiling / std::max(peak, ceiling);
+        blockPeak = std::max(blockPeak, peak);
+    }
+    return blockPeak;
+}
+
+
+template <int Channels>
+void applyGain(const float* in, float* out, const float* gain, uint32_t frames, uint16_t channels, float ceiling)
+{
+    const size_t n = (Channels > 0) ? static_cast<size_t>(Channels) : channels;
+    for (uint32_t f = 0; f < frames; ++f)
+    {
+        const float g = gain[f];
+        for (size_t c = 0; c < n; ++c)
+            out[f * n + c] = std::min(std::max(in[f * n + c] * g, -ceiling), ceiling);
+    }
+}
+
+
+template <int Channels>
+void pick(PeakLimiter::EnvelopeFn& envelopeFn, PeakLimiter::ApplyFn& applyFn)
+{
+    envelopeFn = &envelope<Channels>;
+    applyFn = &applyGain<Channels>;
+}
+
+} // namespace
+
+
+PeakLimiter::PeakLimiter(uint32_t rate, uint16_t channels, LimiterOptions options)
+    : rate_(std::max<uint32_t>(rate, 1)), channels_(std::max<uint16_t>(channels, 1)), ceiling_(options.ceiling > 0.f ? options.ceiling : 1.f)
+{
+    auto frames = static_cast<uint64_t>(std::max<int64_t>(options.lookahead.count(), 0)) * rate_ / 1000;
+    lookahead_ = std::max<uint32_t>(static_cast<uint32_t>(frames), 1);
+    double releaseFrames = std::max(static_cast<double>(options.release.count()) * rate_ / 1000., 1.);
+    releaseMul_ = static_cast<float>(std::exp(-1. / releaseFrames));
+
+    delay_.resize(static_cast<size_t>(lookahead_ + BLOCK_FRAMES) * channels_);
+    need_.resize(BLOCK_FRAMES);
+    gain_.resize(BLOCK_FRAMES);
+    window_.resize(lookahead_ + 1);
+    held_.resize(lookahead_);
+    switch (channels_)
+    {
+        case 1:
+            pick<1>(envelope_, apply_);
+            break;
+        case 2:
+            pick<2>(envelope_, apply_);
+            break;
+        case 6:
+            pick<6>(envelope_, apply_);
+            break;
+        default:
+            pick<0>(envelope_, apply_);
+            break;
+    }
+    reset();
+}
+
+
+void PeakLimiter::reset()
+{
+    std::fill(delay_.begin(), delay_.end(), 0.f);
+    std::fill(held_.begin(), held_.end(), 1.f);
+    head_ = 0;
+    size_ = 0;
+    heldPos_ = 0;
+    heldSum_ = lookahead_;
+    lastHeld_ = 1.f;
+    unityRun_ = lookahead_;
+}
+
+
+void PeakLimiter::process(float* pcm, uint32_t frames)
+{
+    for (uint32_t done = 0; done < frames; done += BLOCK_FRAMES)
+    {
+        const uint32_t len = std::min(BLOCK_FRAMES, frames - done);
+        processBlock(pcm + static_cast<size_t>(done) * channels_, len);
+    }
+}
+
+
+void PeakLimiter::processBlock(float* pcm, uint32_t frames)
+{
+    const size_t n = channels_;
+    const size_t history = static_cast<size_t>(lookahead_) * n;
+    float* in = delay_.data() + history;
+    std::copy(pcm, pcm + frames * n, in);
+
+    const float blockPeak = envelope_(in, need_.data(), frames, channels_, ceiling_);
+    stats_.frames += frames;
+    if ((blockPeak <= ceiling_) && (unityRun_ >= lookahead_))
+    {
+        // Nothing to limit in the window: a plain delay. Every gain in the
+        // window is 1, so the queue can start over empty.
+        size_ = 0;
+        unityRun_ += frames;
+        frame_ += frames;
+        std::copy(delay_.data(), delay_.data() + frames * n, pcm);
+        std::memmove(delay_.data(), delay_.data() + frames * n, history * sizeof(float));
+        return;
+    }
+
+    const size_t capacity = window_.size();
+    const float inv = 1.f / static_cast<float>(lookahead_);
+    for (uint32_t f = 0; f < frames; ++f, ++frame_)
+    {
+        // Sliding minimum over the last lookahead_ + 1 frames
+        while ((size_ > 0) && (window_[head_].frame + lookahead_ < frame_))
+        {
+            head_ = (head_ + 1) % capacity;
+            --size_;
+        }
+        const float need = need_[f];
+        while ((size_ > 0) && (window_[(head_ + size_ - 1) % capacity].gain >= need))
+            --size_;
+        window_[(head_ + size_) % capacity] = {frame_, need};
+        ++size_;
+
+        float held = std::min(window_[head_].gain, 1.f - (1.f - lastHeld_) * releaseMul_);
+        if (held > 1.f - UNITY_SNAP)
+            held = 1.f;
+        unityRun_ = (held == 1.f) ? unityRun_ + 1 : 0;
+        lastHeld_ = held;
+
+        heldSum_ += static_cast<double>(held) - held_[heldPos_];
+        held_[heldPos_] = held;
+        heldPos_ = (heldPos_ + 1 == lookahead_) ? 0 : heldPos_ + 1;
+        gain_[f] = static_cast<float>(heldSum_) * inv;
+    }
+    if (unityRun_ >= lookahead_)
+        heldSum_ = lookahead_;  // no drift across limiting episodes
+
+    for (uint32_t f = 0; f < frames; ++f)
+    {
+        if (gain_[f] < 1.f)
+        {
+            ++stats_.limitedFrames;
+            stats_.minGain = std::min(stats_.minGain, gain_[f]);
+        }
+    }
+
+    apply_(delay_.data(), pcm, gain_.data(), frames, channels_, ceiling_);
+    std::memmove(delay_.data(), delay_.data() + frames * n, history * sizeof(float));
+}
+
+} // namespace dsp
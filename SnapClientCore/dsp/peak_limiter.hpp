@@ -0,0 +1,130 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// Standard headers
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dsp
+{
+
+struct LimiterOptions
+{
+    std::chrono::milliseconds lookahead{2};
+    std::chrono::milliseconds release{50};
+    float ceiling{1.f};  ///< Linear, 1 = full scale
+};
+
+struct LimiterStats
+{
+    uint64_t frames{0};
+    uint64_t limitedFrames{0};  ///< Frames with a gain below 1
+    float minGain{1.f};
+};
+
+/// Look-ahead peak limiter, in place on interleaved float. One gain for all
+/// channels, so the image doesn't shift.
+///
+/// Output is the input delayed by the look-ahead (latency()), times a gain
+/// that is down to ceiling / peak by the time a peak comes out: the gain
+/// each frame needs is held over the look-ahead window (sliding minimum),
+/// recovers with the release time, and is averaged over the window, so it
+/// ramps down over the look-ahead instead of stepping. The average of
+/// values that are all at most a peak's gain can't exceed it; a final clamp
+/// only catches float rounding.
+///
+/// Per block, the per-frame peaks and the gain application with its clamp
+/// are loops specialized per channel count (mono, stereo, 5.1) like the
+/// render kernels, which the compiler vectorizes. While the input stays
+/// below the ceiling and no reduction is left in the window, the gain pass
+/// is skipped and the limiter is a delay line.
+///
+/// Everything but the constructor is real-time safe (no allocation).
+class PeakLimiter
+{
+public:
+    static constexpr uint32_t BLOCK_FRAMES = 64;
+
+    using EnvelopeFn = float (*)(const float* in, float* need, uint32_t frames, uint16_t channels, float ceiling);
+    using ApplyFn = void (*)(const float* in, float* out, const float* gain, uint32_t frames, uint16_t channels, float ceiling);
+
+    PeakLimiter(uint32_t rate, uint16_t channels, LimiterOptions options = {});
+
+    void process(float* pcm, uint32_t frames);
+
+    /// Clear the delay line and the gain history
+    void reset();
+
+    /// Delay of the output: add it to the playout delay
+    std::chrono::microseconds latency() const
+    {
+        return std::chrono::microseconds(static_cast<int64_t>(lookahead_) * 1000000 / rate_);
+    }
+    uint32_t latencyFrames() const
+    {
+        return lookahead_;
+    }
+    const LimiterStats& stats() const
+    {
+        return stats_;
+    }
+
+private:
+    struct Entry
+    {
+        uint64_t frame;
+        float gain;
+    };
+
+    void processBlock(float* pcm, uint32_t frames);
+
+    uint32_t rate_;
+    uint16_t channels_;
+    uint32_t lookahead_;
+    float ceiling_;
+    float releaseMul_;
+    EnvelopeFn envelope_{nullptr};
+    ApplyFn apply_{nullptr};
+
+    /// lookahead_ frames of history followed by the current block
+    std::vector<float> delay_;
+    std::vector<float> need_;
+    std::vector<float> gain_;
+
+    /// Sliding minimum of the needed gain: a monotonic queue over a ring
+    std::vector<Entry> window_;
+    size_t head_{0};
+    size_t size_{0};
+
+    /// Held gain over the look-ahead, for the moving average
+    std::vector<float> held_;
+    size_t heldPos_{0};
+    double heldSum_{0};
+    float lastHeld_{1.f};
+    /// Consecutive frames held at exactly 1; the window is idle past lookahead_
+    uint64_t unityRun_{0};
+    uint64_t frame_{0};
+
+    LimiterStats stats_;
+};
+
+} // namespace dsp
@@ -24,52 +24,326 @@
 #include "common/aixlog.hpp"
 #include "ios_audio_latency.h"
 
-// Thread priority for real-time audio
-#include <pthread.h>
-#include <mach/mach.h>
-#include <mach/thread_policy.h>
+// Standard headers
+#include <algorithm>
+#include <cstdlib>
+#include <map>
 #include <thread>
 
 namespace player
 {
 
-// Global pause state for bridge control
-std::atomic<bool> g_ios_player_paused{false};
+#define NUM_BUFFERS 4
+
+static constexpr auto LOG_TAG = "IOSPlayer";
+
+// A stream whose player is destroyed while shutting down is kept this long
+// for the next player. The Controller rebuilds Stream and Player on every
+// CodecHeader, so a stream switch otherwise drops the audio the old stream
+// still buffers for the next second.
+static constexpr auto PARK_TIMEOUT = std::chrono::seconds(2);
+
+// A player feeding a mix renders this much at a time and keeps this much
+// queued ahead of the host's output
+static constexpr uint32_t FEED_BLOCK_MS = 10;
+static constexpr uint32_t FEED_AHEAD_MS = 200;
 
-/// Set real-time thread priority for audio work
-static void setRealtimeThreadPriority()
+namespace
 {
-    // Get current thread
-    mach_port_t thread = mach_thread_self();
 
-    // Set thread to time-constraint (real-time) policy
-    thread_time_constraint_policy_data_t policy;
-    policy.period = 0;        // Default period
-    policy.computation = 10000000;  // 10ms computation time
-    policy.constraint = 20000000;   // 20ms constraint
-    policy.preemptible = TRUE;
+/// Client state by the id in the player parameter
+struct ClientRegistry
+{
+    std::mutex mutex;
+    std::map<int, std::shared_ptr<ClientState>> clients;
+};
+ClientRegistry g_clients;
+
+
+/// Designs the bands for every rate into the spare slot and publishes it,
+/// with eq.mutex held
+void publishEqLocked(EqSettings& eq)
+{
+    const uint32_t next = eq.generation.load(std::memory_order_relaxed) + 1;
+    // Orders the slot's writes after the previous publication for readers
+    // still copying that slot
+    std::atomic_thread_fence(std::memory_order_release);
+    EqDesigns& slot = eq.slots[next & 1];
+    slot.count = eq.rateCount;
+    for (size_t r = 0; r < eq.rateCount; ++r)
+        slot.designs[r] = dsp::designEq(eq.bands.data(), eq.count, eq.rates[r]);
+    eq.generation.store(next, std::memory_order_release);
+}
 
-    kern_return_t result = thread_policy_set(
-        thread,
-        THREAD_TIME_CONSTRAINT_POLICY,
-        (thread_policy_t)&policy,
-        THREAD_TIME_CONSTRAINT_POLICY_COUNT
-    );
 
-    if (result != KERN_SUCCESS)
+/// The current design of @p eq for @p rate into @p design, without a lock
+/// @return the generation it belongs to, or @p known if there's nothing newer
+uint32_t loadEqDesign(const EqSettings& eq, uint32_t rate, uint32_t known, dsp::EqDesign& design)
+{
+    const uint32_t generation = eq.generation.load(std::memory_order_acquire);
+    if (generation == known)
+        return known;
+    const EqDesigns& slot = eq.slots[generation & 1];
+    bool found = false;
+    for (size_t r = 0; (r < slot.count) && (r < MAX_EQ_RATES); ++r)
     {
-        // Fall back to high priority via pthread
-        struct sched_param param;
-        param.sched_priority = sched_get_priority_max(SCHED_FIFO);
-        pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (slot.designs[r].rate == rate)
+        {
+            design = slot.designs[r];
+            found = true;
+            break;
+        }
     }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!found || (eq.generation.load(std::memory_order_relaxed) != generation))
+        return known;
+    return generation;
+}
+
 
-    mach_port_deallocate(mach_task_self(), thread);
+/// Clients mixed into one queue (see setMixing)
+struct MixMember
+{
+    int id;
+    std::weak_ptr<playout::SourceMixer::Source> source;
+};
+struct MixBus
+{
+    std::mutex mutex;
+    /// The player whose queue plays the mix, bus once the queue is open
+    const IOSPlayer* host{nullptr};
+    std::shared_ptr<playout::SourceMixer> bus;
+    std::vector<MixMember> members;
+    std::map<int, float> levels;
+    /// Bumped when the host goes: its sources leave and rejoin
+    std::atomic<uint32_t> generation{0};
+};
+MixBus g_mix;
+
+
+/// Level of client @p id, with g_mix.mutex held
+float mixLevelLocked(int id)
+{
+    const auto it = g_mix.levels.find(id);
+    return (it == g_mix.levels.end()) ? 1.f : it->second;
 }
 
-#define NUM_BUFFERS 4
 
-static constexpr auto LOG_TAG = "IOSPlayer";
+void parkStream(ClientState& client, std::shared_ptr<Stream> stream)
+{
+    std::lock_guard<std::mutex> lock(client.parkedMutex);
+    client.parked = std::move(stream);
+    client.parkedSince = std::chrono::steady_clock::now();
+}
+
+
+std::shared_ptr<Stream> takeParkedStream(ClientState& client)
+{
+    std::lock_guard<std::mutex> lock(client.parkedMutex);
+    auto stream = std::move(client.parked);
+    client.parked = nullptr;
+    if (stream && (std::chrono::steady_clock::now() - client.parkedSince > PARK_TIMEOUT))
+        return nullptr;
+    return stream;
+}
+
+
+/// State of client @p id if it exists: a consumer may outlive its client
+std::shared_ptr<ClientState> findClientState(int id)
+{
+    std::lock_guard<std::mutex> lock(g_clients.mutex);
+    const auto it = g_clients.clients.find(id);
+    return (it == g_clients.clients.end()) ? nullptr : it->second;
+}
+
+
+playout::PcmFormat toPcmFormat(const SampleFormat& format)
+{
+    return {format.rate(), static_cast<uint16_t>(format.bits()), static_cast<uint16_t>(format.channels())};
+}
+
+
+/// Snapcast Stream as a handoff source
+class StreamSource : public playout::PcmSource
+{
+public:
+    explicit StreamSource(std::shared_ptr<Stream> stream) : stream_(std::move(stream))
+    {
+    }
+
+    playout::PcmFormat format() const override
+    {
+        return toPcmFormat(stream_->getFormat());
+    }
+
+    bool read(void* out, uint32_t frames, std::chrono::microseconds delay) override
+    {
+        return stream_->getPlayerChunkOrSilence(out, delay, frames);
+    }
+
+private:
+    std::shared_ptr<Stream> stream_;
+};
+
+} // namespace
+
+
+std::shared_ptr<ClientState> clientState(int id)
+{
+    std::lock_guard<std::mutex> lock(g_clients.mutex);
+    auto& state = g_clients.clients[id];
+    if (!state)
+        state = std::make_shared<ClientState>();
+    return state;
+}
+
+
+void releaseClientState(int id)
+{
+    {
+        std::lock_guard<std::mutex> lock(g_clients.mutex);
+        g_clients.clients.erase(id);
+    }
+    std::lock_guard<std::mutex> lock(g_mix.mutex);
+    g_mix.levels.erase(id);
+}
+
+
+void releaseParkedStream(int id)
+{
+    auto client = clientState(id);
+    std::lock_guard<std::mutex> lock(client->parkedMutex);
+    client->parked = nullptr;
+}
+
+
+void setEqualizer(int id, const dsp::EqBand* bands, size_t count)
+{
+    count = bands ? std::min(count, dsp::MAX_EQ_BANDS) : 0;
+    auto client = clientState(id);
+    std::lock_guard<std::mutex> lock(client->eq.mutex);
+    std::copy(bands, bands + count, client->eq.bands.begin());
+    client->eq.count = count;
+    publishEqLocked(client->eq);
+}
+
+
+void setLimiter(int id, bool enabled)
+{
+    clientState(id)->limiter.store(enabled);
+}
+
+
+bool limiter(int id)
+{
+    return clientState(id)->limiter.load();
+}
+
+
+void setChannelMapping(int id, dsp::ChannelMode mode, const dsp::ChannelMatrix& custom)
+{
+    auto client = clientState(id);
+    std::lock_guard<std::mutex> lock(client->outputMutex);
+    client->channelMode = mode;
+    client->channelMatrix = custom;
+    client->outputGeneration.fetch_add(1, std::memory_order_release);
+}
+
+
+dsp::ChannelMode channelMapping(int id)
+{
+    auto client = clientState(id);
+    std::lock_guard<std::mutex> lock(client->outputMutex);
+    return client->channelMode;
+}
+
+
+void setOutputBits(int id, uint16_t bits)
+{
+    auto client = clientState(id);
+    std::lock_guard<std::mutex> lock(client->outputMutex);
+    client->outputBits = bits;
+    client->outputGeneration.fetch_add(1, std::memory_order_release);
+}
+
+
+uint16_t outputBits(int id)
+{
+    auto client = clientState(id);
+    std::lock_guard<std::mutex> lock(client->outputMutex);
+    return client->outputBits;
+}
+
+
+void setNoiseShaping(int id, bool enabled)
+{
+    clientState(id)->noiseShaping.store(enabled);
+}
+
+
+bool noiseShaping(int id)
+{
+    return clientState(id)->noiseShaping.load();
+}
+
+
+std::shared_ptr<dsp::AnalysisTap> analysisTap(int id)
+{
+    auto client = findClientState(id);
+    if (!client)
+        return nullptr;
+    std::lock_guard<std::mutex> lock(client->tapMutex);
+    return client->tap;
+}
+
+
+std::shared_ptr<playout::PcmTap> pcmTap(int id)
+{
+    auto client = findClientState(id);
+    if (!client)
+        return nullptr;
+    std::lock_guard<std::mutex> lock(client->tapMutex);
+    return client->pcm;
+}
+
+
+void setMixing(int id, bool enabled)
+{
+    auto client = clientState(id);
+    if (client->mixing.exchange(enabled) == enabled)
+        return;
+    // The client's queue reopens as host, source or alone; a host leaving
+    // moves the others' sources on (see leaveMix)
+    client->outputGeneration.fetch_add(1, std::memory_order_release);
+}
+
+
+bool mixing(int id)
+{
+    return clientState(id)->mixing.load();
+}
+
+
+void setMixLevel(int id, float level)
+{
+    level = std::max(level, 0.f);
+    std::lock_guard<std::mutex> lock(g_mix.mutex);
+    g_mix.levels[id] = level;
+    for (const auto& member : g_mix.members)
+    {
+        if (member.id != id)
+            continue;
+        if (auto source = member.source.lock())
+            source->setGain(level);
+    }
+}
+
+
+float mixLevel(int id)
+{
+    std::lock_guard<std::mutex> lock(g_mix.mutex);
+    return mixLevelLocked(id);
+}
 
 // AudioQueue callback
 void ios_callback(void* custom_data, AudioQueueRef queue, AudioQueueBufferRef buffer)
@@ -82,6 +356,12 @@ void ios_callback(void* custom_data, AudioQueueRef queue, AudioQueueBufferRef bu
 IOSPlayer::IOSPlayer(boost::asio::io_context& io_context, const ClientSettings::Player& settings, std::shared_ptr<Stream> stream)
     : Player(io_context, settings, stream), ms_(100), pubStream_(stream)  // 100ms buffer (400ms total with 4 buffers)
 {
+    // "client=<id>" names the client whose pause state, parked stream and
+    // mix settings apply
+    const auto pos = settings.parameter.find("client=");
+    if (pos != std::string::npos)
+        clientId_ = std::atoi(settings.parameter.c_str() + pos + 7);
+    client_ = clientState(clientId_);
 }
 
 
@@ -124,22 +404,30 @@ std::vector<PcmDevice> IOSPlayer::pcm_list()
 void IOSPlayer::pause()
 {
     LOG(INFO, LOG_TAG) << "Pausing audio playback\n";
-    g_ios_player_paused.store(true, std::memory_order_release);
+    client_->paused.store(true, std::memory_order_release);
 
     // AudioQueue APIs are thread-safe, no mutex needed here.
     // queueMutex_ is only for protecting queue_ lifecycle (create/destroy).
+    // The queue hosting the mix plays on for the other clients.
     std::lock_guard<std::mutex> lock(queueMutex_);
-    if (queue_)
+    if (queue_ && !hostsMix())
     {
         AudioQueuePause(queue_);
     }
 }
 
 
+bool IOSPlayer::hostsMix() const
+{
+    std::lock_guard<std::mutex> lock(g_mix.mutex);
+    return (g_mix.host == this) && g_mix.bus;
+}
+
+
 void IOSPlayer::resume()
 {
     LOG(INFO, LOG_TAG) << "Resuming audio playback\n";
-    g_ios_player_paused.store(false, std::memory_order_release);
+    client_->paused.store(false, std::memory_order_release);
 
     // AudioQueue APIs are thread-safe, no mutex needed here.
     std::lock_guard<std::mutex> lock(queueMutex_);
@@ -165,14 +453,17 @@ void IOSPlayer::playerCallback(AudioQueueRef queue, AudioQueueBufferRef bufferRe
             player->callbackDone_.notify_all();
         }
     } activeGuard(this);
+    realtime::DeadlineMonitor::Scope deadlineScope(rtScheduler_.monitor());
 
     // Capture generation to detect queue invalidation
     const uint32_t myGeneration = callbackGeneration_.load(std::memory_order_acquire);
 
     char* buffer = (char*)bufferRef->mAudioData;
 
-    // Fast path: paused - fill silence, no blocking
-    if (g_ios_player_paused.load(std::memory_order_relaxed))
+    // Fast path: paused - fill silence, no blocking. A queue hosting the mix
+    // keeps playing the other clients' streams, with silence for its own.
+    const bool paused = client_->paused.load(std::memory_order_relaxed);
+    if (paused && !bus_)
     {
         memset(buffer, 0, bufferRef->mAudioDataByteSize);
         AudioQueueEnqueueBuffer(queue, bufferRef, 0, NULL);
@@ -196,6 +487,17 @@ void IOSPlayer::playerCallback(AudioQueueRef queue, AudioQueueBufferRef bufferRe
         return;
     }
 
+    // A new channel mapping or bit depth changes the queue's format: reopen it
+    if (outputGeneration_ != client_->outputGeneration.load(std::memory_order_acquire))
+    {
+        // Logged by the worker: no logging on the audio thread
+        outputChanged_.store(true, std::memory_order_relaxed);
+        needsReinit_.store(true, std::memory_order_relaxed);
+        CFRunLoopRef rl = workerRunLoop_.load(std::memory_order_acquire);
+        if (rl) CFRunLoopStop(rl);
+        return;  // Don't enqueue buffer
+    }
+
     // Estimate the playout delay by checking the number of frames left in the buffer
     // and add ms_ (= complete buffer size). Based on trying.
     size_t bufferedMs = ms_ * (NUM_BUFFERS - 1);  // Default if no timeline
@@ -224,7 +526,21 @@ void IOSPlayer::playerCallback(AudioQueueRef queue, AudioQueueBufferRef bufferRe
     }
 
     chronos::usec delay(bufferedMs * 1000);
-    if (!pubStream_->getPlayerChunkOrSilence(buffer, delay, frames_))
+    // The limiter plays every sample its look-ahead later
+    if (limiter_)
+        delay += limiter_->latency();
+    // With a channel mapping or fewer output bits the stream's frames go to
+    // a scratch buffer first
+    char* source = (mixer_ || dither_) ? sourcePcm_.data() : buffer;
+    // The handoff renders (gain included) until the previous stream is faded out
+    const bool handingOff = handoff_ && !handoff_->passthrough();
+    if (paused)
+    {
+        memset(source, 0, frames_ * pubStream_->getFormat().frameSize());
+        lastChunkTick = chronos::getTickCount();
+    }
+    else if (!(handingOff ? handoff_->render(source, static_cast<uint32_t>(frames_), delay, gain_.load(std::memory_order_relaxed))
+                          : pubStream_->getPlayerChunkOrSilence(source, delay, frames_)))
     {
         if (chronos::getTickCount() - lastChunkTick > 5000)
         {
@@ -240,14 +556,118 @@ void IOSPlayer::playerCallback(AudioQueueRef queue, AudioQueueBufferRef bufferRe
     else
     {
         lastChunkTick = chronos::getTickCount();
-        adjustVolume(buffer, frames_);
+        if (!handingOff)
+            render(source);
     }
+    const auto playAt = std::chrono::steady_clock::now() + delay;
+    if (eq_)
+        applyDsp(source, buffer, playAt);
+    // The taps copy the buffer (a window of it) with the time it plays
+    if (tap_ && client_->analysis.load(std::memory_order_relaxed))
+        tap_->push(buffer, static_cast<uint32_t>(frames_), playAt);
+    if (pcmTap_ && (client_->pcmConsumers.load(std::memory_order_relaxed) > 0))
+        pcmTap_->push(buffer, static_cast<uint32_t>(frames_), playAt);
 
     AudioQueueEnqueueBuffer(queue, bufferRef, 0, NULL);
     // activeGuard destructor signals callbackDone_
 }
 
 
+void IOSPlayer::render(char* buffer)
+{
+    if (!renderKernel_)
+    {
+        adjustVolume(buffer, frames_);
+        return;
+    }
+    gains_.fill(gain_.load(std::memory_order_relaxed));
+    renderKernel_(buffer, buffer, frames_, gains_.data());
+}
+
+
+void IOSPlayer::setVolume(const Volume& volume)
+{
+    Player::setVolume(volume);
+    gain_.store(probeGain(), std::memory_order_relaxed);
+}
+
+
+float IOSPlayer::probeGain()
+{
+    // Volume, volume curve and mute are Player's: run its adjustVolume on one
+    // full-scale frame of the stream's format and read the gain back, instead
+    // of mirroring them. The callback only loads the result.
+    const auto& format = pubStream_->getFormat();
+    auto probe = [this, &format](auto fullScale)
+    {
+        std::vector<decltype(fullScale)> frame(format.channels(), fullScale);
+        adjustVolume(reinterpret_cast<char*>(frame.data()), 1);
+        return static_cast<float>(static_cast<double>(frame[0]) / fullScale);
+    };
+    switch (format.sampleSize())
+    {
+        case 1:
+            return probe(int8_t{127});
+        case 2:
+            return probe(int16_t{32767});
+        default:
+            return probe((format.bits() == 24) ? int32_t{8388607} : int32_t{2147483647});
+    }
+}
+
+
+void IOSPlayer::toFloat(const char* source)
+{
+    // Gain is already applied
+    std::array<float, playout::MAX_RENDER_CHANNELS> unity;
+    unity.fill(1.f);
+    if (mixer_)
+    {
+        toFloat_(source, mixPcm_.data(), frames_, unity.data());
+        mixer_->process(mixPcm_.data(), floatPcm_.data(), static_cast<uint32_t>(frames_));
+    }
+    else
+    {
+        toFloat_(source, floatPcm_.data(), frames_, unity.data());
+    }
+}
+
+
+void IOSPlayer::applyDsp(const char* source, char* buffer, std::chrono::steady_clock::time_point playAt)
+{
+    // The coefficients are designed by the bridge: apply them, nothing else
+    const uint32_t generation = loadEqDesign(client_->eq, eq_->rate(), eqGeneration_, eqDesign_);
+    if (generation != eqGeneration_)
+    {
+        eq_->configure(eqDesign_);
+        eqGeneration_ = generation;
+    }
+    const bool eqActive = eq_->active();
+    if (!mixer_ && !eqActive && !limiter_ && !dither_ && !bus_)
+        return;
+
+    // A boost, a downmix or the mix may take the float past full scale,
+    // which the limiter brings back (toNative only clamps)
+    toFloat(source);
+    if (bus_)
+    {
+        // The own stream goes through its source like the others' (one
+        // level ramp for all), then the sum replaces it
+        mixSource_->write(floatPcm_.data(), static_cast<uint32_t>(frames_));
+        std::fill(floatPcm_.begin(), floatPcm_.end(), 0.f);
+        bus_->mix(floatPcm_.data(), static_cast<uint32_t>(frames_), playAt);
+    }
+    if (eqActive)
+        eq_->process(floatPcm_.data(), static_cast<uint32_t>(frames_));
+    if (limiter_)
+        limiter_->process(floatPcm_.data(), static_cast<uint32_t>(frames_));
+    if (dither_)
+        dither_->process(floatPcm_.data(), buffer, static_cast<uint32_t>(frames_));
+    else
+        playout::toNative(floatPcm_.data(), buffer, frames_ * eq_->channels(), toFloat_.format().bits);
+}
+
+
 bool IOSPlayer::needsThread() const
 {
     return true;
@@ -256,10 +676,11 @@ bool IOSPlayer::needsThread() const
 
 void IOSPlayer::worker()
 {
-    // Boost thread priority for real-time audio
-    setRealtimeThreadPriority();
+    // Real-time policy for the default geometry until the first queue is
+    // opened; initAudioQueue() re-derives it from the actual buffers
+    rtScheduler_.update({48000, static_cast<uint32_t>(48000 * ms_ / 1000), NUM_BUFFERS});
     workerRunLoop_.store(CFRunLoopGetCurrent(), std::memory_order_release);
-    LOG(INFO, LOG_TAG) << "Audio worker thread started with real-time priority\n";
+    LOG(INFO, LOG_TAG) << "Audio worker thread started, scheduling: " << realtime::toString(rtScheduler_.backend()) << "\n";
 
     while (active_ && !shutdownRequested_.load(std::memory_order_acquire))
     {
@@ -269,10 +690,22 @@ void IOSPlayer::worker()
         {
             try
             {
-                if (initAudioQueue())
+                const MixRole role = mixRole();
+                if (role == MixRole::Source)
+                {
+                    // Returns when the host goes or the output changes
+                    feedMix();
+                }
+                else if (role == MixRole::Wait)
+                {
+                    LOG(DEBUG, LOG_TAG) << "Waiting for the mix's queue\n";
+                }
+                else if (initAudioQueue())
                 {
                     // CFRunLoopRun blocks until CFRunLoopStop is called
                     CFRunLoopRun();
+                    if (outputChanged_.exchange(false, std::memory_order_relaxed))
+                        LOG(INFO, LOG_TAG) << "Output format changed, reopening the queue\n";
 
                     // After runloop exits, cleanup in THIS thread context (safe)
                     // This is the critical fix - cleanup happens here, not in callback
@@ -280,6 +713,7 @@ void IOSPlayer::worker()
                 }
                 else
                 {
+                    leaveMix();
                     LOG(WARNING, LOG_TAG) << "Audio queue init failed, retrying...\n";
                 }
             }
@@ -299,6 +733,145 @@ void IOSPlayer::worker()
 }
 
 
+IOSPlayer::MixRole IOSPlayer::mixRole()
+{
+    if (!client_->mixing.load(std::memory_order_acquire))
+        return MixRole::Alone;
+    {
+        std::lock_guard<std::mutex> lock(g_mix.mutex);
+        if (!g_mix.host || (g_mix.host == this))
+        {
+            // Claimed before the queue opens, so no other player opens one
+            g_mix.host = this;
+            return MixRole::Host;
+        }
+        if (!g_mix.bus)
+            return MixRole::Wait;
+    }
+    return joinMix() ? MixRole::Source : MixRole::Alone;
+}
+
+
+bool IOSPlayer::joinMix()
+{
+    const SampleFormat& sampleFormat = pubStream_->getFormat();
+    std::lock_guard<std::mutex> lock(g_mix.mutex);
+    if (!g_mix.bus)
+        return false;
+    // No resampler: the stream must be at the host's rate
+    const auto busFormat = g_mix.bus->format();
+    if (busFormat.rate != sampleFormat.rate())
+    {
+        LOG(WARNING, LOG_TAG) << "Mix at " << busFormat.rate << " Hz, stream at " << sampleFormat.rate() << " Hz: playing it on its own queue\n";
+        return false;
+    }
+    const uint16_t bits = static_cast<uint16_t>(sampleFormat.bits());
+    const uint16_t channels = static_cast<uint16_t>(sampleFormat.channels());
+    toFloat_ = playout::selectKernel({bits, channels, playout::OutputFormat::Float32});
+    if (!toFloat_)
+        return false;
+    renderKernel_ = playout::selectKernel({bits, channels, playout::OutputFormat::Native});
+
+    // The stream's channels as the host plays them: downmixed, or mono to both sides
+    mixer_.reset();
+    if (channels != busFormat.channels)
+    {
+        const dsp::ChannelMatrix matrix = dsp::downmixMatrix((busFormat.channels == 1) ? dsp::ChannelMode::Mono : dsp::ChannelMode::Stereo, channels);
+        if ((busFormat.channels > 2) || !matrix.valid())
+        {
+            LOG(WARNING, LOG_TAG) << "Mix of " << busFormat.channels << " ch, stream of " << channels << " ch: playing it on its own queue\n";
+            return false;
+        }
+        mixer_ = std::make_unique<dsp::ChannelMixer>(matrix);
+    }
+
+    frames_ = sampleFormat.rate() * FEED_BLOCK_MS / 1000;
+    sourcePcm_.resize(frames_ * sampleFormat.frameSize());
+    if (mixer_)
+        mixPcm_.resize(frames_ * channels);
+    floatPcm_.resize(frames_ * busFormat.channels);
+
+    mixSource_ = g_mix.bus->add(mixLevelLocked(clientId_));
+    if (!mixSource_)
+    {
+        LOG(WARNING, LOG_TAG) << "Mix is full (" << playout::MAX_MIX_SOURCES << " sources): playing on its own queue\n";
+        return false;
+    }
+    bus_ = g_mix.bus;
+    g_mix.members.push_back({clientId_, mixSource_});
+    mixGeneration_ = g_mix.generation.load(std::memory_order_acquire);
+    outputGeneration_ = client_->outputGeneration.load(std::memory_order_acquire);
+    LOG(INFO, LOG_TAG) << "Feeding the mix: " << sampleFormat.toString() << (mixer_ ? ", channels mapped" : "") << ", level "
+                       << mixSource_->gain() << "\n";
+    return true;
+}
+
+
+void IOSPlayer::feedMix()
+{
+    const uint32_t ahead = pubStream_->getFormat().rate() * FEED_AHEAD_MS / 1000;
+    lastChunkTick = chronos::getTickCount();
+    while (active_ && !shutdownRequested_.load(std::memory_order_acquire) && (mixGeneration_ == g_mix.generation.load(std::memory_order_acquire)) &&
+           (outputGeneration_ == client_->outputGeneration.load(std::memory_order_acquire)))
+    {
+        // Ask the stream for the frames that play next in the host's queue,
+        // as the host's callback does for its own
+        const auto playAt = mixSource_->nextPlayAt();
+        if ((playAt == std::chrono::steady_clock::time_point()) || (mixSource_->queued() + frames_ > ahead))
+        {
+            chronos::sleep(FEED_BLOCK_MS / 2);
+            continue;
+        }
+        // Paused: the client's share of the mix is silence, the others play on
+        if (client_->paused.load(std::memory_order_relaxed))
+        {
+            lastChunkTick = chronos::getTickCount();
+            std::fill(floatPcm_.begin(), floatPcm_.end(), 0.f);
+            mixSource_->write(floatPcm_.data(), static_cast<uint32_t>(frames_));
+            continue;
+        }
+        const auto delay = std::chrono::duration_cast<chronos::usec>(playAt - std::chrono::steady_clock::now());
+        if (pubStream_->getPlayerChunkOrSilence(sourcePcm_.data(), delay, frames_))
+        {
+            lastChunkTick = chronos::getTickCount();
+            render(sourcePcm_.data());
+        }
+        else if (chronos::getTickCount() - lastChunkTick > 5000)
+        {
+            LOG(NOTICE, LOG_TAG) << "No chunk received for 5000ms. Leaving the mix.\n";
+            break;
+        }
+        toFloat(sourcePcm_.data());
+        mixSource_->write(floatPcm_.data(), static_cast<uint32_t>(frames_));
+    }
+    if (mixSource_->underrunFrames() > 0)
+        LOG(INFO, LOG_TAG) << "Mix source: " << mixSource_->underrunFrames() << " frames underrun\n";
+    leaveMix();
+}
+
+
+void IOSPlayer::leaveMix()
+{
+    std::lock_guard<std::mutex> lock(g_mix.mutex);
+    if (bus_ && mixSource_)
+        bus_->remove(mixSource_);
+    g_mix.members.erase(std::remove_if(g_mix.members.begin(), g_mix.members.end(),
+                                       [this](const MixMember& member) {
+                                           auto source = member.source.lock();
+                                           return !source || (source == mixSource_);
+                                       }),
+                        g_mix.members.end());
+    mixSource_.reset();
+    bus_.reset();
+    if (g_mix.host == this)
+    {
+        g_mix.host = nullptr;
+        g_mix.bus.reset();
+        g_mix.generation.fetch_add(1, std::memory_order_release);
+    }
+}
+
+
 bool IOSPlayer::initAudioQueue()
 {
     // Guard against double initialization (would leak AudioQueue)
@@ -312,14 +885,74 @@ bool IOSPlayer::initAudioQueue()
     callbackGeneration_.fetch_add(1, std::memory_order_acq_rel);
 
     const SampleFormat& sampleFormat = pubStream_->getFormat();
+    client_->format.rate.store(sampleFormat.rate(), std::memory_order_relaxed);
+    client_->format.bits.store(static_cast<uint16_t>(sampleFormat.bits()), std::memory_order_relaxed);
+    client_->format.channels.store(static_cast<uint16_t>(sampleFormat.channels()), std::memory_order_relaxed);
+
+    // The float stage (channel mapping, EQ, limiter, dither) needs a float
+    // kernel for the stream's format
+    toFloat_ = playout::selectKernel({static_cast<uint16_t>(sampleFormat.bits()), static_cast<uint16_t>(sampleFormat.channels()),
+                                      playout::OutputFormat::Float32});
+
+    // Channel mapping: the queue opens with the mapped channel count, so the
+    // OS doesn't downmix and the buffers only carry what is played
+    mixer_.reset();
+    uint16_t channels = static_cast<uint16_t>(sampleFormat.channels());
+    uint16_t bits = static_cast<uint16_t>(sampleFormat.bits());
+    {
+        std::lock_guard<std::mutex> lock(client_->outputMutex);
+        outputGeneration_ = client_->outputGeneration.load(std::memory_order_acquire);
+        if ((client_->outputBits != 0) && (client_->outputBits < bits) && toFloat_)
+            bits = client_->outputBits;
+        const dsp::ChannelMode mode = client_->channelMode;
+        const dsp::ChannelMatrix matrix = (mode == dsp::ChannelMode::Custom) ? client_->channelMatrix : dsp::downmixMatrix(mode, channels);
+        if (matrix.valid() && (matrix.inputs == channels) && toFloat_)
+        {
+            if (!matrix.identity())
+            {
+                mixer_ = std::make_unique<dsp::ChannelMixer>(matrix);
+                LOG(INFO, LOG_TAG) << "Channel mapping " << dsp::toString(mode) << ": " << channels << " -> " << matrix.outputs << " ch"
+                                   << (mixer_->specialized() ? "" : " (generic)") << "\n";
+                channels = matrix.outputs;
+            }
+        }
+        else if (mode != dsp::ChannelMode::Native)
+        {
+            LOG(WARNING, LOG_TAG) << "Channel mapping " << dsp::toString(mode) << " not available for " << channels
+                                  << " ch, playing the stream's channels\n";
+        }
+    }
+
+    // Fewer bits than the stream: dithered down, so the lost bits become a
+    // noise floor instead of distortion
+    dither_.reset();
+    if (bits < sampleFormat.bits())
+    {
+        dsp::DitherOptions options;
+        options.noiseShaping = client_->noiseShaping.load(std::memory_order_relaxed);
+        dither_ = std::make_unique<dsp::Dither>(channels, bits, options);
+        if (*dither_)
+        {
+            LOG(INFO, LOG_TAG) << "Dither " << sampleFormat.bits() << " -> " << bits << " bit" << (options.noiseShaping ? ", noise shaped" : "")
+                               << "\n";
+        }
+        else
+        {
+            LOG(WARNING, LOG_TAG) << "No dither to " << bits << " bit, playing " << sampleFormat.bits() << " bit\n";
+            dither_.reset();
+            bits = static_cast<uint16_t>(sampleFormat.bits());
+        }
+    }
+    // 16 bit in two bytes, 24 in a 32-bit container as Snapcast stores it
+    const uint16_t sampleBytes = (bits < sampleFormat.bits()) ? ((bits == 16) ? 2 : 4) : sampleFormat.sampleSize();
 
     AudioStreamBasicDescription format;
     format.mSampleRate = sampleFormat.rate();
     format.mFormatID = kAudioFormatLinearPCM;
     format.mFormatFlags = kLinearPCMFormatFlagIsSignedInteger;
-    format.mBitsPerChannel = sampleFormat.bits();
-    format.mChannelsPerFrame = sampleFormat.channels();
-    format.mBytesPerFrame = sampleFormat.frameSize();
+    format.mBitsPerChannel = bits;
+    format.mChannelsPerFrame = channels;
+    format.mBytesPerFrame = channels * sampleBytes;
     format.mFramesPerPacket = 1;
     format.mBytesPerPacket = format.mBytesPerFrame * format.mFramesPerPacket;
     format.mReserved = 0;
@@ -329,6 +962,8 @@ bool IOSPlayer::initAudioQueue()
     if (status != noErr)
     {
         LOG(ERROR, LOG_TAG) << "AudioQueueNewOutput failed: " << status << "\n";
+        // Mix hosting was claimed for this queue: let another player host
+        leaveMix();
         return false;
     }
 
@@ -354,9 +989,112 @@ bool IOSPlayer::initAudioQueue()
     // Calculate buffer size for ~100ms
     frames_ = (sampleFormat.rate() * ms_) / 1000;
     ms_ = frames_ * 1000 / sampleFormat.rate();
-    buff_size_ = frames_ * sampleFormat.frameSize();
+    buff_size_ = frames_ * format.mBytesPerFrame;
+    if (mixer_ || dither_)
+        sourcePcm_.resize(frames_ * sampleFormat.frameSize());
+    if (mixer_)
+        mixPcm_.resize(frames_ * sampleFormat.channels());
+
+    tap_ = std::make_shared<dsp::AnalysisTap>(dsp::TapFormat{sampleFormat.rate(), channels, bits});
+    pcmTap_ = std::make_shared<playout::PcmTap>(playout::PcmTap::Format{sampleFormat.rate(), channels, bits});
+    {
+        std::lock_guard<std::mutex> tapLock(client_->tapMutex);
+        client_->tap = tap_;
+        client_->pcm = pcmTap_;
+    }
     LOG(INFO, LOG_TAG) << "frames: " << frames_ << ", ms: " << ms_ << ", buffer size: " << buff_size_ << "\n";
 
+    // Pick the gain stage once, not per buffer
+    renderKernel_ = playout::selectKernel({static_cast<uint16_t>(sampleFormat.bits()), static_cast<uint16_t>(sampleFormat.channels()),
+                                           playout::OutputFormat::Native});
+    if (renderKernel_)
+        LOG(INFO, LOG_TAG) << "Render kernel: " << sampleFormat.bits() << " bit, " << sampleFormat.channels() << " ch"
+                           << (renderKernel_.specialized() ? "" : " (generic)") << "\n";
+    else
+        LOG(WARNING, LOG_TAG) << "No render kernel for " << sampleFormat.bits() << " bit, " << sampleFormat.channels() << " ch, using adjustVolume\n";
+
+    eq_.reset();
+    limiter_.reset();
+    if (toFloat_)
+    {
+        eq_ = std::make_unique<dsp::ParametricEq>(sampleFormat.rate(), channels);
+        floatPcm_.resize(frames_ * channels);
+        {
+            // From now on the bridge designs the client's bands for this rate too
+            EqSettings& eq = client_->eq;
+            std::lock_guard<std::mutex> lock(eq.mutex);
+            const auto rates = eq.rates.begin();
+            if (std::find(rates, rates + eq.rateCount, sampleFormat.rate()) == rates + eq.rateCount)
+            {
+                if (eq.rateCount == MAX_EQ_RATES)
+                {
+                    // Drop the oldest rate
+                    std::rotate(rates, rates + 1, rates + MAX_EQ_RATES);
+                    --eq.rateCount;
+                }
+                eq.rates[eq.rateCount++] = sampleFormat.rate();
+                publishEqLocked(eq);
+            }
+            // No writer while the lock is held: the current slot is stable
+            eqGeneration_ = eq.generation.load(std::memory_order_relaxed);
+            const EqDesigns& slot = eq.slots[eqGeneration_ & 1];
+            for (size_t r = 0; r < slot.count; ++r)
+            {
+                if (eq_->configure(slot.designs[r]))
+                    break;
+            }
+            if (eq.count > 0)
+                LOG(INFO, LOG_TAG) << "Parametric EQ: " << eq.count << " bands\n";
+        }
+        if (client_->limiter.load(std::memory_order_relaxed))
+        {
+            limiter_ = std::make_unique<dsp::PeakLimiter>(sampleFormat.rate(), channels);
+            LOG(INFO, LOG_TAG) << "Limiter: look-ahead " << limiter_->latency().count() << " us\n";
+        }
+    }
+
+    // Hosting the mix: the other clients' streams are added to this queue's
+    // ahead of EQ and limiter. Without the float stage there is no mix.
+    {
+        std::lock_guard<std::mutex> lock(g_mix.mutex);
+        if ((g_mix.host == this) && toFloat_)
+        {
+            g_mix.bus = std::make_shared<playout::SourceMixer>(playout::SourceMixer::Format{sampleFormat.rate(), channels});
+            bus_ = g_mix.bus;
+            mixSource_ = bus_->add(mixLevelLocked(clientId_));
+            g_mix.members.push_back({clientId_, mixSource_});
+            LOG(INFO, LOG_TAG) << "Hosting the mix: " << sampleFormat.rate() << " Hz, " << channels << " ch\n";
+        }
+        else if (g_mix.host == this)
+        {
+            g_mix.host = nullptr;
+            g_mix.generation.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    // After a codec change, play out what the previous player's stream still
+    // buffers and crossfade into this one. Sample size and channels are
+    // converted; a rate change can't be bridged without a resampler.
+    if (auto parked = takeParkedStream(*client_); parked && (parked != pubStream_))
+    {
+        auto handoff = std::make_unique<playout::StreamHandoff>(toPcmFormat(sampleFormat), static_cast<uint32_t>(frames_));
+        if (handoff->setOutgoing(std::make_shared<StreamSource>(parked)) && handoff->setIncoming(std::make_shared<StreamSource>(pubStream_)))
+        {
+            LOG(INFO, LOG_TAG) << "Handing over from the previous stream (" << parked->getFormat().toString() << ", conversion "
+                               << playout::toString(playout::conversionFor(toPcmFormat(parked->getFormat()), handoff->output())) << ")\n";
+            handoff_ = std::move(handoff);
+        }
+        else
+        {
+            LOG(INFO, LOG_TAG) << "Previous stream " << parked->getFormat().toString() << " can't be handed over to "
+                               << sampleFormat.toString() << ", dropping it\n";
+        }
+    }
+
+    // Callbacks run on this thread: match its policy to the buffer period
+    rtScheduler_.update({sampleFormat.rate(), static_cast<uint32_t>(frames_), NUM_BUFFERS});
+    rtScheduler_.monitor().reset();
+
     AudioQueueBufferRef buffers[NUM_BUFFERS];
     for (int i = 0; i < NUM_BUFFERS; i++)
     {
@@ -366,8 +1104,9 @@ bool IOSPlayer::initAudioQueue()
     }
 
     LOG(DEBUG, LOG_TAG) << "IOSPlayer::initAudioQueue starting\n";
-    // Start in paused state if already paused (use global as source of truth)
-    if (!g_ios_player_paused.load(std::memory_order_relaxed))
+    // Start in paused state if already paused (use global as source of truth),
+    // unless the queue plays the mix
+    if (!client_->paused.load(std::memory_order_relaxed) || bus_)
     {
         status = AudioQueueStart(queue, NULL);
         if (status != noErr)
@@ -379,6 +1118,7 @@ bool IOSPlayer::initAudioQueue()
                 queue_ = nullptr;
             }
             AudioQueueDispose(queue, true);
+            releaseQueueState();
             return false;
         }
     }
@@ -437,9 +1177,52 @@ void IOSPlayer::cleanupAudioQueue()
     }
 
     AudioQueueDispose(q, true);
-    pubStream_->clearChunks();
+
+    if (handoff_)
+    {
+        const auto& stats = handoff_->stats();
+        LOG(INFO, LOG_TAG) << "Stream handoff: " << stats.outgoingFrames << " frames of the previous stream, gap " << stats.gapFrames
+                           << " frames, crossfade " << stats.crossfadeFrames << " frames, converted " << stats.convertedFrames << "\n";
+    }
+    releaseQueueState();
+
+    if (limiter_ && (limiter_->stats().limitedFrames > 0))
+    {
+        const auto& stats = limiter_->stats();
+        LOG(INFO, LOG_TAG) << "Limiter: " << stats.limitedFrames << " of " << stats.frames << " frames limited, lowest gain "
+                           << stats.minGain << "\n";
+    }
+
+    // Shutting down: likely a codec change, the next player takes over what
+    // is buffered. Otherwise the queue reopens on the same stream.
+    if (shutdownRequested_.load(std::memory_order_acquire))
+        parkStream(*client_, pubStream_);
+    else
+        pubStream_->clearChunks();
+
+    const auto& monitor = rtScheduler_.monitor();
+    if (monitor.fills() > 0)
+        LOG(INFO, LOG_TAG) << "Deadline misses: " << monitor.misses() << " of " << monitor.fills() << " fills, worst response "
+                           << monitor.worstResponseUs() << " us (constraint "
+                           << std::chrono::duration_cast<std::chrono::microseconds>(rtScheduler_.policy().constraint).count() << " us)\n";
 
     LOG(DEBUG, LOG_TAG) << "Audio queue cleaned up safely\n";
 }
 
+
+void IOSPlayer::releaseQueueState()
+{
+    {
+        std::lock_guard<std::mutex> tapLock(client_->tapMutex);
+        if (client_->tap == tap_)
+            client_->tap.reset();
+        if (client_->pcm == pcmTap_)
+            client_->pcm.reset();
+    }
+    tap_.reset();
+    pcmTap_.reset();
+    leaveMix();
+    handoff_.reset();
+}
+
 } // namespace player
@@ -22,16 +22,30 @@
 
 // local headers
 #include "client_settings.hpp"
+#include "dsp/analysis_tap.hpp"
+#include "dsp/channel_mixer.hpp"
+#include "dsp/dither.hpp"
+#include "dsp/parametric_eq.hpp"
+#include "dsp/peak_limiter.hpp"
 #include "player/player.hpp"
+#include "playout/pcm_tap.hpp"
+#include "playout/render_kernels.hpp"
+#include "playout/source_mixer.hpp"
+#include "playout/stream_handoff.hpp"
+#include "realtime/deadline_scheduler.hpp"
 #include "stream.hpp"
 
 // iOS AudioToolbox
 #include <AudioToolbox/AudioToolbox.h>
 
 // Standard headers
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 namespace player
 {
@@ -39,9 +53,148 @@ namespace player
 /// Player name constant for iOS
 static constexpr auto IOS_PLAYER = "ios";
 
-/// Global pause state (shared across all IOSPlayer instances)
-/// Used by the bridge to control playback without accessing Controller internals
-extern std::atomic<bool> g_ios_player_paused;
+/// Stream format of the last AudioQueue a client's player opened (0 until
+/// then). Read by the bridge to remember a server's format for the next
+/// warm start.
+struct PlayerFormat
+{
+    std::atomic<uint32_t> rate{0};
+    std::atomic<uint16_t> bits{0};
+    std::atomic<uint16_t> channels{0};
+};
+
+/// Queue rates a client's EQ is designed for
+static constexpr size_t MAX_EQ_RATES = 4;
+
+/// The bands designed for each queue rate
+struct EqDesigns
+{
+    std::array<dsp::EqDesign, MAX_EQ_RATES> designs{};
+    size_t count{0};
+};
+
+/// A client's EQ, written by the bridge and by queue setup (mutex held),
+/// which design the coefficients, read by the callback without a lock: the
+/// writer fills the slot the generation doesn't point at, then bumps it. A
+/// reader that sees the generation move while it copies drops the copy (the
+/// slot was being rewritten) and takes the next one.
+struct EqSettings
+{
+    std::mutex mutex;
+    std::array<dsp::EqBand, dsp::MAX_EQ_BANDS> bands{};
+    size_t count{0};
+    std::array<uint32_t, MAX_EQ_RATES> rates{};
+    size_t rateCount{0};
+    /// Slot generation & 1 is the current one
+    std::array<EqDesigns, 2> slots;
+    std::atomic<uint32_t> generation{0};
+};
+
+/// What outlives one client's players: the Controller rebuilds its player
+/// on every codec change. The bridge names the client in the player
+/// parameter, "client=<id>"; players of different clients share none of it.
+struct ClientState
+{
+    /// Set by the bridge to pause without reaching into the Controller
+    std::atomic<bool> paused{false};
+    PlayerFormat format;
+    /// The client's stream joins the mix (see setMixing)
+    std::atomic<bool> mixing{false};
+    /// Parametric EQ (see setEqualizer)
+    EqSettings eq;
+    /// Look-ahead limiter (see setLimiter)
+    std::atomic<bool> limiter{true};
+
+    /// Channel mapping and bit depth (see setChannelMapping and
+    /// setOutputBits), read when a queue opens
+    std::mutex outputMutex;
+    dsp::ChannelMode channelMode{dsp::ChannelMode::Native};
+    dsp::ChannelMatrix channelMatrix;
+    uint16_t outputBits{0};
+    /// Bumped by a change of the queue's format or mix role: the client's
+    /// queue reopens
+    std::atomic<uint32_t> outputGeneration{0};
+    /// Noise shaping of the dither (see setNoiseShaping)
+    std::atomic<bool> noiseShaping{false};
+
+    /// The callback pushes to the analysis tap while set
+    std::atomic<bool> analysis{false};
+    /// Taps of the client's playing queue (see analysisTap and pcmTap)
+    std::mutex tapMutex;
+    std::shared_ptr<dsp::AnalysisTap> tap;
+    std::shared_ptr<playout::PcmTap> pcm;
+    /// Consumers of the PCM tap open; the callback pushes to it while any is
+    std::atomic<int> pcmConsumers{0};
+
+    /// Stream of a player destroyed while shutting down, for its successor
+    /// (see IOSPlayer::initAudioQueue)
+    std::mutex parkedMutex;
+    std::shared_ptr<Stream> parked;
+    std::chrono::steady_clock::time_point parkedSince;
+};
+
+/// State of client @p id, created on first use
+std::shared_ptr<ClientState> clientState(int id);
+
+/// Forget client @p id (its players keep their reference). Call when the
+/// client is destroyed.
+void releaseClientState(int id);
+
+/// Drop the stream a destroyed player of client @p id left for its
+/// successor. Call when the client stops.
+void releaseParkedStream(int id);
+
+/// Parametric EQ of client @p id, like the pause state kept across its
+/// players so it survives codec changes. Its players pick up a change at
+/// their next buffer, ramping to it. No bands bypasses the EQ. Designs the
+/// coefficients for the queues' rates here, in the caller's thread.
+void setEqualizer(int id, const dsp::EqBand* bands, size_t count);
+
+/// Look-ahead limiter of client @p id as the last stage before the
+/// AudioQueue buffer (on by default). Read when a queue opens: it changes
+/// the output latency, which must stay fixed while a queue plays.
+void setLimiter(int id, bool enabled);
+bool limiter(int id);
+
+/// Channel mapping of client @p id's output (downmix or one side of a
+/// stereo pair), kept across its players. A change reopens the AudioQueue
+/// with the mapped channel count. @p custom is used for ChannelMode::Custom,
+/// for streams with its number of inputs.
+void setChannelMapping(int id, dsp::ChannelMode mode, const dsp::ChannelMatrix& custom = {});
+dsp::ChannelMode channelMapping(int id);
+
+/// Bit depth of client @p id's output: 0 plays the stream's, 16 or 24
+/// reduce deeper streams to it, TPDF dithered. Kept like the channel
+/// mapping; a change reopens the AudioQueue.
+void setOutputBits(int id, uint16_t bits);
+uint16_t outputBits(int id);
+
+/// Noise shaping of that dither (off by default), read when a queue opens
+void setNoiseShaping(int id, bool enabled);
+bool noiseShaping(int id);
+
+/// Copy of the played audio for the UI's levels and spectrum (off by
+/// default, see ClientState::analysis; while off the audio thread skips
+/// it). analysisTap() is the tap of client @p id's playing queue, or
+/// nullptr.
+std::shared_ptr<dsp::AnalysisTap> analysisTap(int id);
+
+/// Ring of the PCM client @p id plays, for consumers outside the player:
+/// its playing queue's or nullptr. A new queue (format change) brings a new
+/// tap. Filled only while ClientState::pcmConsumers counts an open consumer.
+std::shared_ptr<playout::PcmTap> pcmTap(int id);
+
+/// Several clients in one output, for the clients that opt in: the first
+/// of their players to open a queue hosts the mix, the others feed it their
+/// streams, each in sync on its own. Off by default; a change reopens the
+/// queues. A stream at another rate than the host's plays on a queue of its
+/// own.
+void setMixing(int id, bool enabled);
+bool mixing(int id);
+
+/// Level of client @p id in the mix, ramped
+void setMixLevel(int id, float level);
+float mixLevel(int id);
 
 /// iOS audio player using AudioQueue Services
 class IOSPlayer : public Player
@@ -62,15 +215,41 @@ public:
     void resume();
 
     /// @return true if audio is paused
-    bool isPaused() const { return g_ios_player_paused.load(); }
+    bool isPaused() const { return client_->paused.load(); }
+
+    /// Player's volume, then the gain the render stage applies for it
+    void setVolume(const Volume& volume) override;
 
 protected:
     void worker() override;
     bool needsThread() const override;
 
 private:
+    /// What the worker does with the stream while mixing is on
+    enum class MixRole
+    {
+        Alone,   ///< Own queue, not mixed
+        Host,    ///< Own queue, mixing the others in
+        Source,  ///< Feeding the host's mix
+        Wait,    ///< The host is still opening its queue
+    };
+
+    MixRole mixRole();
+    /// This player's queue plays the mix
+    bool hostsMix() const;
+    bool joinMix();
+    void feedMix();
+    void leaveMix();
     bool initAudioQueue();
     void cleanupAudioQueue();  // Safe cleanup from worker thread
+    /// Taps, mix membership and handoff of the closed (or never started) queue
+    void releaseQueueState();
+    void render(char* buffer);
+    /// Gain of Player's volume, curve and mute, off the audio thread
+    float probeGain();
+    void applyDsp(const char* source, char* buffer, std::chrono::steady_clock::time_point playAt);
+    /// Stream frames in sourcePcm_ (or @p source) to floatPcm_, channel mapped
+    void toFloat(const char* source);
 
     size_t ms_;
     size_t frames_;
@@ -82,6 +261,7 @@ private:
     // Thread-safe signaling for callback -> worker communication
     std::atomic<bool> needsReinit_{false};      // Signal worker to reinit audio queue
     std::atomic<bool> shutdownRequested_{false}; // Signal clean shutdown
+    std::atomic<bool> outputChanged_{false};     // Reinit due to a new output format, logged by the worker
     std::mutex queueMutex_;                     // Protect queue_ lifecycle (create/destroy)
 
     // Real-time safety: atomic pointers and state for lock-free callback
@@ -93,6 +273,46 @@ private:
     // Synchronization for callback completion - used by cleanup to wait for callback exit
     std::mutex callbackMutex_;
     std::condition_variable callbackDone_;
+
+    // Worker thread's real-time policy, derived from the buffer period
+    realtime::DeadlineScheduler rtScheduler_;
+
+    // Gain stage specialized for the queue's format (picked in initAudioQueue)
+    playout::RenderKernel renderKernel_;
+    std::array<float, playout::MAX_RENDER_CHANNELS> gains_{};
+    std::atomic<float> gain_{1.f};
+
+    // Crossfade from the previous player's stream after a codec change
+    std::unique_ptr<playout::StreamHandoff> handoff_;
+
+    // DSP after the gain stage, on the buffer as float: channel mapping
+    // (from the stream's frames in sourcePcm_), optional EQ, then the
+    // limiter, whose look-ahead is added to the playout delay, and the
+    // dither when the queue has fewer bits than the stream
+    std::unique_ptr<dsp::ChannelMixer> mixer_;
+    uint32_t outputGeneration_{0};
+    std::vector<char> sourcePcm_;
+    std::vector<float> mixPcm_;
+    std::unique_ptr<dsp::ParametricEq> eq_;
+    uint32_t eqGeneration_{0};
+    dsp::EqDesign eqDesign_;
+    std::unique_ptr<dsp::PeakLimiter> limiter_;
+    std::unique_ptr<dsp::Dither> dither_;
+
+    // What the queue plays, for the analysis thread
+    std::shared_ptr<dsp::AnalysisTap> tap_;
+    std::shared_ptr<playout::PcmTap> pcmTap_;
+    playout::RenderKernel toFloat_;
+    std::vector<float> floatPcm_;
+
+    // The client this player plays for, named in the parameter
+    int clientId_{0};
+    std::shared_ptr<ClientState> client_;
+
+    // Mixing: the bus this player hosts or feeds, and its source in it
+    std::shared_ptr<playout::SourceMixer> bus_;
+    std::shared_ptr<playout::SourceMixer::Source> mixSource_;
+    uint32_t mixGeneration_{0};
 };
 
 } // namespace player
@@ -0,0 +1,282 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "batch_receiver.hpp"
+
+// local headers
+#include "common/aixlog.hpp"
+#include "timesync/rx_timestamp.hpp"
+
+// 3rd party headers
+#include <boost/asio/error.hpp>
+#include <boost/asio/socket_base.hpp>
+
+// Standard headers
+#include <algorithm>
+#include <cstring>
+
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+namespace wire = probe::wire;
+
+namespace net
+{
+
+static constexpr auto LOG_TAG = "BatchReceiver";
+
+namespace
+{
+
+constexpr milliseconds MIN_BUDGET{20};
+constexpr milliseconds MAX_BUDGET{250};
+
+} // namespace
+
+
+milliseconds latencyBudget(milliseconds bufferDepth)
+{
+    return std::clamp(bufferDepth / 4, MIN_BUDGET, MAX_BUDGET);
+}
+
+
+BatchReceiver::BatchReceiver(boost::asio::ip::tcp::socket& socket, BatchOptions options)
+    : socket_(socket), budgetTimer_(socket.get_executor()), options_(options), buffer_(std::max(options.readSize, wire::HEADER_SIZE))
+{
+}
+
+
+void BatchReceiver::start(Handler handler, ErrorHandler onError)
+{
+    handler_ = std::move(handler);
+    onError_ = std::move(onError);
+    if (!timesync::enableRxTimestamps(socket_.native_handle()))
+        LOG(DEBUG, LOG_TAG) << "No kernel receive timestamps, stamping in user space\n";
+    applyLowWatermark();
+    wait();
+}
+
+
+void BatchReceiver::stop()
+{
+    stopped_ = true;
+    budgetTimer_.cancel();
+    applyLowWatermark();
+}
+
+
+void BatchReceiver::setLowPower(bool lowPower, milliseconds latencyBudget)
+{
+    options_.lowPower = lowPower;
+    options_.latencyBudget = latencyBudget;
+    applyLowWatermark();
+    if (socketWait_)
+        armTimer();
+}
+
+
+void BatchReceiver::expectReply()
+{
+    if (replyPending_)
+        return;
+    replyPending_ = true;
+    applyLowWatermark();
+}
+
+
+void BatchReceiver::wait()
+{
+    if (stopped_)
+        return;
+    if (!socketWait_)
+    {
+        socketWait_ = true;
+        socket_.async_wait(boost::asio::ip::tcp::socket::wait_read, recycled(memory_, [self = shared_from_this()](const boost::system::error_code& ec)
+        {
+            self->socketWait_ = false;
+            if (self->stopped_)
+                return;
+            // Aborted by the owner cancelling its own operations: keep waiting
+            if (ec == boost::asio::error::operation_aborted)
+            {
+                self->wait();
+                return;
+            }
+            if (ec)
+            {
+                self->fail(ec);
+                return;
+            }
+            self->stats_.wakeups++;
+            self->onReady();
+        }));
+    }
+    armTimer();
+}
+
+
+void BatchReceiver::armTimer()
+{
+    if (!options_.lowPower || replyPending_)
+    {
+        budgetTimer_.cancel();
+        return;
+    }
+    // Bounds the hold when the stream is slower than the low-water mark
+    // assumes (silence, a lossy codec below its ceiling, a stalled server)
+    budgetTimer_.expires_after(options_.latencyBudget);
+    budgetTimer_.async_wait(recycled(memory_, [self = shared_from_this()](const boost::system::error_code& ec)
+    {
+        if (ec || self->stopped_)
+            return;
+        self->stats_.wakeups++;
+        self->onReady();
+    }));
+}
+
+
+void BatchReceiver::onReady()
+{
+    const int fd = socket_.native_handle();
+    while (!stopped_)
+    {
+        size_t want = wanted();
+        if (want == 0)
+        {
+            if (!deliver())
+                return;
+            continue;
+        }
+        boost::system::error_code ec;
+        auto received = timesync::receive(fd, buffer_.data() + used_, want, ec);
+        if (ec == boost::asio::error::would_block)
+            break;
+        if (ec)
+        {
+            if (deliver())
+                fail(ec);
+            return;
+        }
+        stats_.reads++;
+        stats_.bytes += received.bytes;
+        used_ += received.bytes;
+        if (!parse(received.stamp.value_or(wire::now())))
+            return;
+    }
+    if (deliver())
+        wait();
+}
+
+
+size_t BatchReceiver::wanted()
+{
+    size_t need = wire::HEADER_SIZE;
+    if (used_ - parsed_ >= wire::HEADER_SIZE)
+        need += wire::decodeHeader(buffer_.data() + parsed_).size;
+
+    if (parsed_ + need > buffer_.size())
+    {
+        if (parsed_ > 0)
+            return 0;
+        buffer_.resize(need);
+    }
+    // While a Time reply is due, never read past the end of the current
+    // message: the kernel stamp is then the arrival of the packet that
+    // completed it, not of audio queued behind it
+    if (replyPending_)
+        return parsed_ + need - used_;
+    return buffer_.size() - used_;
+}
+
+
+bool BatchReceiver::parse(microseconds received)
+{
+    while (used_ - parsed_ >= wire::HEADER_SIZE)
+    {
+        auto header = wire::decodeHeader(buffer_.data() + parsed_);
+        if (header.size > wire::MAX_MESSAGE_SIZE)
+        {
+            fail(boost::asio::error::message_size);
+            return false;
+        }
+        if (used_ - parsed_ < wire::HEADER_SIZE + header.size)
+            break;
+        pending_.push_back({header, parsed_ + wire::HEADER_SIZE, received});
+        parsed_ += wire::HEADER_SIZE + header.size;
+    }
+    return true;
+}
+
+
+bool BatchReceiver::deliver()
+{
+    if (!pending_.empty())
+    {
+        batch_.clear();
+        for (const auto& p : pending_)
+        {
+            batch_.push_back({p.header, buffer_.data() + p.offset, p.received});
+            // Cleared before the handler, which may already send the next request
+            if (p.header.type == wire::kTime)
+                replyPending_ = false;
+        }
+        pending_.clear();
+        applyLowWatermark();
+        stats_.batches++;
+        stats_.messages += batch_.size();
+        handler_(batch_);
+    }
+    if (parsed_ > 0)
+    {
+        std::memmove(buffer_.data(), buffer_.data() + parsed_, used_ - parsed_);
+        used_ -= parsed_;
+        parsed_ = 0;
+    }
+    return !stopped_;
+}
+
+
+void BatchReceiver::fail(const boost::system::error_code& ec)
+{
+    stop();
+    if (onError_)
+        onError_(ec);
+}
+
+
+void BatchReceiver::applyLowWatermark()
+{
+    int bytes = lowWatermark();
+    if (bytes == appliedLowWatermark_)
+        return;
+    boost::system::error_code ec;
+    socket_.set_option(boost::asio::socket_base::receive_low_watermark(bytes), ec);
+    appliedLowWatermark_ = ec ? 0 : bytes;
+    if (ec)
+        LOG(DEBUG, LOG_TAG) << "SO_RCVLOWAT: " << ec.message() << "\n";
+}
+
+
+int BatchReceiver::lowWatermark() const
+{
+    if (!options_.lowPower || replyPending_ || stopped_)
+        return 1;
+    uint64_t bytes = options_.bitsPerSecond / 8 * static_cast<uint64_t>(options_.latencyBudget.count()) / 1000;
+    return static_cast<int>(std::clamp<uint64_t>(bytes, 1, options_.readSize / 2));
+}
+
+} // namespace net
@@ -0,0 +1,164 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// local headers
+#include "net/handler_memory.hpp"
+#include "probe/stream_wire.hpp"
+
+// 3rd party headers
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/system/error_code.hpp>
+
+// Standard headers
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace net
+{
+
+/// How long received audio may wait before it is processed, for a playout
+/// buffer of @p bufferDepth: a quarter of it, 20 - 250 ms
+std::chrono::milliseconds latencyBudget(std::chrono::milliseconds bufferDepth);
+
+struct BatchOptions
+{
+    /// Coalesce wakeups: wait for a budget's worth of audio (receive
+    /// low-water mark), or the budget to expire, before reading
+    bool lowPower{false};
+    std::chrono::milliseconds latencyBudget{100};
+    /// Stream bitrate, sizes the low-water mark
+    uint64_t bitsPerSecond{0};
+    /// Bytes read per recvmsg(); also caps the low-water mark at half of it
+    size_t readSize{256 * 1024};
+};
+
+/// Stream-connection receive loop that processes messages in batches.
+///
+/// The one-message-per-read loop (read the header, then the payload, then
+/// handle it) wakes the io thread for every WireChunk. BatchReceiver reads
+/// everything buffered in large reads on each wakeup and hands all complete
+/// messages to the handler in a single call.
+///
+/// In low-power mode it also lets data accumulate in the kernel: the
+/// socket's low-water mark is set to a budget's worth of audio, and a timer
+/// bounds the wait at the budget when the stream is slower. A Time reply
+/// must not be held back (its receive time is a clock sample), so
+/// expectReply() drops the mark to one byte until the reply is in.
+///
+/// Receive times come from the kernel where available (see
+/// timesync::receive), else from the time of the read. Once the buffer has
+/// grown to the largest message the loop does not touch the heap: batches
+/// reuse their vectors and the wait operations come from HandlerMemory.
+///
+/// Single io thread. Destroy after stop() and once the io_context ran the
+/// cancelled handlers, or after it stopped.
+class BatchReceiver : public std::enable_shared_from_this<BatchReceiver>
+{
+public:
+    struct Message
+    {
+        probe::wire::Header header;
+        const uint8_t* payload;  ///< header.size bytes, valid during the handler
+        /// Kernel (or read) time of the read that completed the message,
+        /// steady µs. Exact for Time replies, see expectReply().
+        std::chrono::microseconds received;
+    };
+
+    struct Stats
+    {
+        uint64_t wakeups{0};   ///< Readiness or budget timer completions
+        uint64_t reads{0};     ///< recvmsg() calls that returned data
+        uint64_t batches{0};   ///< Handler calls
+        uint64_t messages{0};
+        uint64_t bytes{0};
+    };
+
+    /// Every complete message from one wakeup, oldest first
+    using Handler = std::function<void(const std::vector<Message>& batch)>;
+    using ErrorHandler = std::function<void(const boost::system::error_code& ec)>;
+
+    BatchReceiver(boost::asio::ip::tcp::socket& socket, BatchOptions options);
+
+    void start(Handler handler, ErrorHandler onError);
+    /// Stop delivering and reset the low-water mark. A pending readiness
+    /// wait completes when the owner closes or cancels the socket.
+    void stop();
+
+    /// Switch mode (e.g. when the app goes to the background)
+    void setLowPower(bool lowPower, std::chrono::milliseconds latencyBudget);
+    /// A Time request went out: process its reply as soon as it arrives
+    void expectReply();
+
+    const Stats& stats() const
+    {
+        return stats_;
+    }
+
+    const HandlerMemory& memory() const
+    {
+        return memory_;
+    }
+
+private:
+    void wait();
+    void armTimer();
+    void onReady();
+    /// Bytes to ask for in the next read, 0 if the buffer must be emptied first
+    size_t wanted();
+    /// Queue the messages completed by a read; false on a malformed header
+    bool parse(std::chrono::microseconds received);
+    /// Hand queued messages to the handler and compact the buffer; false if
+    /// stopped meanwhile
+    bool deliver();
+    void fail(const boost::system::error_code& ec);
+    void applyLowWatermark();
+    int lowWatermark() const;
+
+    struct Pending
+    {
+        probe::wire::Header header;
+        size_t offset;  ///< Payload offset in buffer_
+        std::chrono::microseconds received;
+    };
+
+    boost::asio::ip::tcp::socket& socket_;
+    boost::asio::steady_timer budgetTimer_;
+    BatchOptions options_;
+    Handler handler_;
+    ErrorHandler onError_;
+    HandlerMemory memory_;
+
+    std::vector<uint8_t> buffer_;
+    size_t used_{0};    ///< Bytes read into buffer_
+    size_t parsed_{0};  ///< Bytes of complete messages in buffer_
+    std::vector<Pending> pending_;
+    std::vector<Message> batch_;
+    bool replyPending_{false};
+    bool socketWait_{false};
+    int appliedLowWatermark_{0};  ///< 0: unknown
+    bool stopped_{false};
+    Stats stats_;
+};
+
+} // namespace net
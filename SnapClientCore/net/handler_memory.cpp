@@ -0,0 +1,61 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "handler_memory.hpp"
+
+// Standard headers
+#include <functional>
+#include <new>
+
+namespace net
+{
+
+void* HandlerMemory::allocate(size_t size)
+{
+    if (size <= SLOT_SIZE)
+    {
+        for (size_t i = 0; i < SLOTS; ++i)
+        {
+            if (!used_[i])
+            {
+                used_[i] = true;
+                stats_.recycled++;
+                return slots_[i].bytes;
+            }
+        }
+    }
+    stats_.fallbacks++;
+    return ::operator new(size);
+}
+
+
+void HandlerMemory::deallocate(void* pointer)
+{
+    // std::less gives a total order over unrelated pointers; the built-in
+    // operators are unspecified for a heap block outside the array
+    auto* slot = static_cast<Slot*>(pointer);
+    const std::less<const Slot*> before;
+    if (!before(slot, slots_.data()) && before(slot, slots_.data() + SLOTS))
+    {
+        used_[static_cast<size_t>(slot - slots_.data())] = false;
+        return;
+    }
+    ::operator delete(pointer);
+}
+
+} // namespace net
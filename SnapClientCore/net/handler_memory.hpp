@@ -0,0 +1,158 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// Standard headers
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+/// Recycling storage for the asio operations of one connection.
+///
+/// Every async_wait, async_write and timer wait allocates an operation
+/// object holding the completion handler. asio caches a block or two per
+/// thread, which a connection with a read wait, a budget timer, a Time
+/// timer and a write outstanding at once overruns. Handlers wrapped with
+/// recycled() take their operation from a fixed set of slots owned by the
+/// connection instead, and only fall back to the heap for an operation
+/// larger than a slot or when all slots are taken (counted in stats()).
+///
+/// Single thread: use from the connection's io thread only. The memory
+/// must outlive every handler bound to it; owning it in the object the
+/// handlers keep alive (shared_from_this) does that.
+namespace net
+{
+
+class HandlerMemory
+{
+public:
+    static constexpr size_t SLOT_SIZE = 256;
+    static constexpr size_t SLOTS = 8;
+
+    struct Stats
+    {
+        uint64_t recycled{0};   ///< Allocations served from a slot
+        uint64_t fallbacks{0};  ///< Allocations that went to the heap
+    };
+
+    HandlerMemory() = default;
+    HandlerMemory(const HandlerMemory&) = delete;
+    HandlerMemory& operator=(const HandlerMemory&) = delete;
+
+    void* allocate(size_t size);
+    void deallocate(void* pointer);
+
+    const Stats& stats() const
+    {
+        return stats_;
+    }
+
+private:
+    struct alignas(std::max_align_t) Slot
+    {
+        unsigned char bytes[SLOT_SIZE];
+    };
+
+    std::array<Slot, SLOTS> slots_;
+    std::array<bool, SLOTS> used_{};
+    Stats stats_;
+};
+
+
+/// Standard allocator over a HandlerMemory, the handlers' associated allocator
+template <typename T>
+class HandlerAllocator
+{
+public:
+    using value_type = T;
+
+    explicit HandlerAllocator(HandlerMemory& memory) : memory_(&memory)
+    {
+    }
+
+    template <typename U>
+    HandlerAllocator(const HandlerAllocator<U>& other) noexcept : memory_(other.memory_)
+    {
+    }
+
+    T* allocate(size_t n) const
+    {
+        return static_cast<T*>(memory_->allocate(sizeof(T) * n));
+    }
+
+    void deallocate(T* pointer, size_t /*n*/) const
+    {
+        memory_->deallocate(pointer);
+    }
+
+    bool operator==(const HandlerAllocator& other) const noexcept
+    {
+        return memory_ == other.memory_;
+    }
+
+    bool operator!=(const HandlerAllocator& other) const noexcept
+    {
+        return memory_ != other.memory_;
+    }
+
+private:
+    template <typename>
+    friend class HandlerAllocator;
+
+    HandlerMemory* memory_;
+};
+
+
+/// Completion handler whose operation is allocated from a HandlerMemory
+template <typename Handler>
+class RecycledHandler
+{
+public:
+    using allocator_type = HandlerAllocator<Handler>;
+
+    RecycledHandler(HandlerMemory& memory, Handler handler) : memory_(memory), handler_(std::move(handler))
+    {
+    }
+
+    allocator_type get_allocator() const noexcept
+    {
+        return allocator_type(memory_);
+    }
+
+    template <typename... Args>
+    void operator()(Args&&... args)
+    {
+        handler_(std::forward<Args>(args)...);
+    }
+
+private:
+    HandlerMemory& memory_;
+    Handler handler_;
+};
+
+
+template <typename Handler>
+RecycledHandler<std::decay_t<Handler>> recycled(HandlerMemory& memory, Handler&& handler)
+{
+    return RecycledHandler<std::decay_t<Handler>>(memory, std::forward<Handler>(handler));
+}
+
+} // namespace net
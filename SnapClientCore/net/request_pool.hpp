@@ -0,0 +1,103 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// Standard headers
+#include <array>
+#include <cstddef>
+
+namespace net
+{
+
+/// Fixed set of request objects reused for the life of a connection, in
+/// place of a make_shared per request and a map node per pending entry.
+///
+/// acquire() returns nullptr when all are in use: a connection with that
+/// many requests unanswered has bigger problems than one more request.
+/// Single thread.
+template <typename T, size_t Capacity>
+class RequestPool
+{
+public:
+    T* acquire()
+    {
+        for (size_t i = 0; i < Capacity; ++i)
+        {
+            if (!used_[i])
+            {
+                used_[i] = true;
+                items_[i] = T{};
+                return &items_[i];
+            }
+        }
+        return nullptr;
+    }
+
+    void release(T* item)
+    {
+        used_[static_cast<size_t>(item - items_.data())] = false;
+    }
+
+    /// First request in use matching @p pred, or nullptr
+    template <typename Pred>
+    T* find(Pred pred)
+    {
+        for (size_t i = 0; i < Capacity; ++i)
+        {
+            if (used_[i] && pred(items_[i]))
+                return &items_[i];
+        }
+        return nullptr;
+    }
+
+    /// Release every request in use matching @p pred
+    template <typename Pred>
+    size_t releaseIf(Pred pred)
+    {
+        size_t released = 0;
+        for (size_t i = 0; i < Capacity; ++i)
+        {
+            if (used_[i] && pred(items_[i]))
+            {
+                used_[i] = false;
+                released++;
+            }
+        }
+        return released;
+    }
+
+    void clear()
+    {
+        used_.fill(false);
+    }
+
+    size_t inUse() const
+    {
+        size_t n = 0;
+        for (bool used : used_)
+            n += used ? 1 : 0;
+        return n;
+    }
+
+private:
+    std::array<T, Capacity> items_{};
+    std::array<bool, Capacity> used_{};
+};
+
+} // namespace net
@@ -0,0 +1,94 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "socket_profile.hpp"
+
+// Standard headers
+#include <algorithm>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+namespace net
+{
+
+namespace
+{
+
+template <typename T>
+bool setOption(int fd, int level, int name, T value)
+{
+    return setsockopt(fd, level, name, &value, sizeof(value)) == 0;
+}
+
+} // namespace
+
+
+SocketProfile profileFor(const ProfileOptions& options)
+{
+    SocketProfile p;
+    auto budgetMs = static_cast<uint64_t>(std::max<int64_t>(options.jitterBudget.count(), 1));
+    p.noDelay = true;
+    // Quiet for twice the budget is already an underrun: start probing then,
+    // and keep probing until the dead-peer timeout
+    p.keepIdle = std::chrono::seconds(std::max<uint64_t>(1, (2 * budgetMs + 999) / 1000));
+    p.keepInterval = std::chrono::seconds(1);
+    auto probing = std::chrono::duration_cast<std::chrono::milliseconds>(options.deadPeerTimeout - p.keepIdle);
+    p.keepCount = static_cast<int>(std::max<int64_t>(1, (probing.count() + 999) / 1000));
+    p.userTimeout = options.deadPeerTimeout;
+    return p;
+}
+
+
+Applied apply(int fd, const SocketProfile& profile)
+{
+    Applied a;
+    a.noDelay = setOption(fd, IPPROTO_TCP, TCP_NODELAY, profile.noDelay ? 1 : 0);
+
+    if (profile.keepIdle.count() > 0)
+    {
+        auto idle = static_cast<int>(profile.keepIdle.count());
+        auto interval = static_cast<int>(profile.keepInterval.count());
+        a.keepAlive = setOption(fd, SOL_SOCKET, SO_KEEPALIVE, 1);
+#if defined(TCP_KEEPIDLE)
+        a.keepAlive = a.keepAlive && setOption(fd, IPPROTO_TCP, TCP_KEEPIDLE, idle);
+#elif defined(TCP_KEEPALIVE)
+        a.keepAlive = a.keepAlive && setOption(fd, IPPROTO_TCP, TCP_KEEPALIVE, idle);
+#endif
+#if defined(TCP_KEEPINTVL) && defined(TCP_KEEPCNT)
+        a.keepAlive = a.keepAlive && setOption(fd, IPPROTO_TCP, TCP_KEEPINTVL, interval) &&
+                      setOption(fd, IPPROTO_TCP, TCP_KEEPCNT, profile.keepCount);
+#else
+        (void)interval;
+#endif
+    }
+
+    if (profile.userTimeout.count() > 0)
+    {
+#if defined(TCP_USER_TIMEOUT)
+        a.userTimeout = setOption(fd, IPPROTO_TCP, TCP_USER_TIMEOUT, static_cast<unsigned int>(profile.userTimeout.count()));
+#elif defined(TCP_RXT_CONNDROPTIME)
+        auto seconds = static_cast<int>((profile.userTimeout.count() + 999) / 1000);
+        a.userTimeout = setOption(fd, IPPROTO_TCP, TCP_RXT_CONNDROPTIME, seconds);
+#endif
+    }
+    return a;
+}
+
+} // namespace net
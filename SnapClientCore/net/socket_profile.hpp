@@ -0,0 +1,77 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// Standard headers
+#include <chrono>
+#include <cstdint>
+
+/// Socket options for the stream connection.
+///
+/// With default options small Time requests can sit behind Nagle, and a
+/// peer that vanished is only noticed by the client's own checks, since
+/// keepalive waits two hours and unacknowledged data is retried for many
+/// minutes. net::StreamReader applies profileFor() to the connection's
+/// socket every time it starts on one:
+/// - TCP_NODELAY;
+/// - keepalive and TCP_USER_TIMEOUT (Linux) / TCP_RXT_CONNDROPTIME (Darwin)
+///   giving up after deadPeerTimeout, the Controller's 10 s time sync
+///   timeout, so the kernel drops a dead peer no sooner and no later than
+///   the client would.
+/// SO_RCVBUF is left alone: setting it turns off the kernel's receive
+/// buffer autotuning, and on a connected socket the window scale is fixed
+/// already, so sizing it for the stream's bitrate (known only once the
+/// codec header arrives) would not help.
+namespace net
+{
+
+struct ProfileOptions
+{
+    /// How long the reader may stall before keepalive starts probing
+    std::chrono::milliseconds jitterBudget{500};
+    /// A peer silent or not acknowledging this long is dead: the time sync
+    /// timeout (patches/ios-time-sync-timeout.patch, net::ReaderOptions),
+    /// long enough for iOS throttling a backgrounded app's TCP
+    std::chrono::milliseconds deadPeerTimeout{10000};
+};
+
+struct SocketProfile
+{
+    bool noDelay{true};
+    std::chrono::seconds keepIdle{0};  ///< 0 leaves keepalive alone
+    std::chrono::seconds keepInterval{1};
+    int keepCount{2};
+    /// Unacknowledged data or keepalive silence after which the connection
+    /// is dropped; 0 leaves it alone
+    std::chrono::milliseconds userTimeout{0};
+};
+
+SocketProfile profileFor(const ProfileOptions& options = {});
+
+/// What the kernel accepted
+struct Applied
+{
+    bool noDelay{false};
+    bool keepAlive{false};
+    bool userTimeout{false};
+};
+
+Applied apply(int fd, const SocketProfile& profile);
+
+} // namespace net
@@ -0,0 +1,253 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "stream_reader.hpp"
+
+// local headers
+#include "common/aixlog.hpp"
+
+// 3rd party headers
+#include <boost/asio/error.hpp>
+
+// Standard headers
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+
+namespace net
+{
+
+namespace wire = probe::wire;
+
+static constexpr auto LOG_TAG = "StreamReader";
+
+namespace
+{
+
+/// Taps by io_context; the generation tells readers to look again
+struct TapRegistry
+{
+    std::mutex mutex;
+    std::map<const boost::asio::execution_context*, std::shared_ptr<const StreamReader::Tap>> taps;
+    std::atomic<uint32_t> generation{0};
+};
+
+
+TapRegistry& tapRegistry()
+{
+    static TapRegistry registry;
+    return registry;
+}
+
+} // namespace
+
+
+StreamReader::StreamReader(boost::asio::ip::tcp::socket& socket, ReaderOptions options)
+    : socket_(socket), options_(std::move(options)), receiver_(std::make_shared<BatchReceiver>(socket, options_.receive))
+{
+}
+
+
+void StreamReader::setTap(boost::asio::io_context& io_context, Tap tap)
+{
+    auto& registry = tapRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    if (tap)
+        registry.taps[&io_context] = std::make_shared<const Tap>(std::move(tap));
+    else
+        registry.taps.erase(&io_context);
+    registry.generation.fetch_add(1, std::memory_order_release);
+}
+
+
+void StreamReader::start(Callbacks callbacks)
+{
+    callbacks_ = std::move(callbacks);
+    stopped_ = false;
+    if (options_.tuneSocket)
+        tuneSocket();
+
+    std::weak_ptr<StreamReader> weak = weak_from_this();
+    receiver_->start(
+        [weak](const std::vector<BatchReceiver::Message>& batch)
+        {
+            if (auto self = weak.lock())
+                self->onBatch(batch);
+        },
+        [weak](const boost::system::error_code& ec)
+        {
+            if (auto self = weak.lock())
+                self->fail(ec);
+        });
+    if (callbacks_.onExchange)
+        startTimeSync();
+}
+
+
+void StreamReader::stop()
+{
+    stopped_ = true;
+    receiver_->stop();
+    if (requester_)
+        requester_->stop();
+}
+
+
+void StreamReader::tuneSocket()
+{
+    auto profile = profileFor(options_.socket);
+    applied_ = apply(socket_.native_handle(), profile);
+    LOG(DEBUG, LOG_TAG) << "Socket profile: nodelay " << applied_.noDelay << ", keepalive "
+                        << applied_.keepAlive << " (" << profile.keepIdle.count() << " s + " << profile.keepCount << " x "
+                        << profile.keepInterval.count() << " s), user timeout " << applied_.userTimeout << " ("
+                        << profile.userTimeout.count() << " ms)\n";
+}
+
+
+void StreamReader::startTimeSync()
+{
+    timesync::TimeRequesterOptions time = options_.time;
+    if (options_.quickSyncs > 0)
+        time.interval = options_.quickInterval;
+    // A new requester per connection: the old one's cancelled handlers may still be queued
+    requester_ = std::make_shared<timesync::TimeRequester>(socket_, time);
+    if (callbacks_.writeRequest)
+        requester_->setWriter(callbacks_.writeRequest);
+    tracker_ = {};
+    samples_ = 0;
+    lastReply_ = std::chrono::steady_clock::now();
+
+    std::weak_ptr<StreamReader> weak = weak_from_this();
+    requester_->start(
+        [weak](const wire::TimeSample& sample)
+        {
+            if (auto self = weak.lock())
+                self->onTimeSample(sample);
+        },
+        [weak]()
+        {
+            auto self = weak.lock();
+            if (!self)
+                return;
+            // Checked on every request, i.e. at least once per interval
+            if (std::chrono::steady_clock::now() - self->lastReply_ > self->options_.syncTimeout)
+            {
+                self->fail(boost::asio::error::timed_out);
+                return;
+            }
+            self->tracker_.requestSent();
+            self->receiver_->expectReply();
+        });
+}
+
+
+void StreamReader::onBatch(const std::vector<BatchReceiver::Message>& batch)
+{
+    // Hold on: the connection may stop and drop the reader from a handler
+    auto self = shared_from_this();
+    updateTap();
+    for (const auto& message : batch)
+        remember(message);
+    if (tap_ && !stopped_)
+        (*tap_)(batch);
+    for (const auto& message : batch)
+    {
+        if (stopped_)
+            return;
+        if (requester_)
+        {
+            // Replies to the reader's own requests become samples, not messages
+            replyReceived_ = message.received;
+            if ((message.header.type == wire::kTime) && requester_->onReply(message.header, message.payload, message.received))
+                continue;
+            tracker_.received(message.received, wire::HEADER_SIZE + message.header.size);
+        }
+        callbacks_.onMessage(message);
+    }
+}
+
+
+void StreamReader::updateTap()
+{
+    auto& registry = tapRegistry();
+    const uint32_t generation = registry.generation.load(std::memory_order_acquire);
+    if (generation == tapGeneration_)
+        return;
+    tapGeneration_ = generation;
+    std::shared_ptr<const Tap> tap;
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        const auto it = registry.taps.find(&socket_.get_executor().context());
+        if (it != registry.taps.end())
+            tap = it->second;
+    }
+    if (tap == tap_)
+        return;
+    tap_ = std::move(tap);
+    if (!tap_)
+        return;
+
+    std::vector<BatchReceiver::Message> headers;
+    for (const auto* bytes : {&serverSettings_, &codecHeader_})
+    {
+        if (!bytes->empty())
+            headers.push_back({wire::decodeHeader(bytes->data()), bytes->data() + wire::HEADER_SIZE, std::chrono::microseconds(0)});
+    }
+    LOG(DEBUG, LOG_TAG) << "New tap, replaying " << headers.size() << " stream header(s)\n";
+    if (!headers.empty())
+        (*tap_)(headers);
+}
+
+
+void StreamReader::remember(const BatchReceiver::Message& message)
+{
+    std::vector<uint8_t>* bytes = nullptr;
+    if (message.header.type == wire::kServerSettings)
+        bytes = &serverSettings_;
+    else if (message.header.type == wire::kCodecHeader)
+        bytes = &codecHeader_;
+    else
+        return;
+    bytes->resize(wire::HEADER_SIZE + message.header.size);
+    wire::encodeHeader(message.header, bytes->data());
+    std::copy(message.payload, message.payload + message.header.size, bytes->data() + wire::HEADER_SIZE);
+}
+
+
+void StreamReader::onTimeSample(const wire::TimeSample& sample)
+{
+    lastReply_ = std::chrono::steady_clock::now();
+    if (++samples_ == options_.quickSyncs)
+        requester_->setInterval(options_.time.interval);
+    if (!stopped_)
+        callbacks_.onExchange(tracker_.reply(replyReceived_, sample.rtt, sample.offset));
+}
+
+
+void StreamReader::fail(const boost::system::error_code& ec)
+{
+    if (stopped_)
+        return;
+    // One error per connection, and no more requests on it
+    stop();
+    if (callbacks_.onError)
+        callbacks_.onError(ec);
+}
+
+} // namespace net
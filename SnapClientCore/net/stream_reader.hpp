@@ -0,0 +1,169 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// local headers
+#include "net/batch_receiver.hpp"
+#include "net/socket_profile.hpp"
+#include "timesync/hol_filter.hpp"
+#include "timesync/time_requester.hpp"
+
+// 3rd party headers
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/system/error_code.hpp>
+
+// Standard headers
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace net
+{
+
+struct ReaderOptions
+{
+    BatchOptions receive;
+    /// Apply profileFor(socket) to the socket on start()
+    bool tuneSocket{true};
+    ProfileOptions socket;
+    /// Time sync on the connection, see StreamReader::Callbacks::onExchange
+    timesync::TimeRequesterOptions time;
+    /// Requests at quickInterval right after connecting, then time.interval
+    int quickSyncs{50};
+    std::chrono::milliseconds quickInterval{100};
+    /// No Time reply for this long fails the connection (as the
+    /// Controller's TIME_SYNC_TIMEOUT does)
+    std::chrono::milliseconds syncTimeout{10000};
+};
+
+/// The read side of Snapcast's stream connection.
+///
+/// patches/ios-stream-reader.patch makes ClientConnectionTcp take its
+/// messages from a StreamReader on its socket, started by the first
+/// getNextMessage() after a connect and stopped by disconnect(). Instead of
+/// an async_read for the header and another for the payload of every
+/// message, a BatchReceiver reads whatever is buffered on each wakeup; the
+/// connection gets the messages one at a time, in order, as its
+/// getNextMessage() loop expects them. Each message carries the kernel
+/// receive time of the read that completed it (see timesync::receive); the
+/// connection stamps Time replies with it instead of the time its handler
+/// ran. start() also applies the stream socket profile (net::profileFor), so
+/// every connection, reconnects included, is tuned.
+///
+/// Given an onExchange callback, the reader also runs the connection's
+/// time sync: a timesync::TimeRequester sends the Time requests, with the
+/// receiver told to expect each reply, and the replies it matches are
+/// turned into clock samples instead of being delivered as messages. Each
+/// sample comes with the traffic that arrived around its reply
+/// (timesync::InboundTracker), for a timesync::HolFilter to judge. The
+/// requests are written through writeRequest, behind the connection's
+/// other writes.
+///
+/// setTap() hands every batch of the readers on one io_context to an
+/// observer as well (the bridge's net::StreamRelay), without a change to
+/// the connection. A reader picks a new tap up at its next batch and first
+/// gives it the last ServerSettings and CodecHeader it received, so a tap
+/// set mid-stream can still serve the stream from its start.
+///
+/// Single io thread, the one running the connection. Destroy after stop()
+/// and once the io_context ran the cancelled handlers, or after it stopped.
+class StreamReader : public std::enable_shared_from_this<StreamReader>
+{
+public:
+    struct Callbacks
+    {
+        /// Every received message, oldest first; the payload is valid
+        /// during the call. May call stop().
+        std::function<void(const BatchReceiver::Message& message)> onMessage;
+        /// The connection failed (closed, reset, malformed header, no
+        /// Time reply within syncTimeout)
+        std::function<void(const boost::system::error_code& ec)> onError;
+        /// Clock samples of the reader's Time requests and the inbound
+        /// traffic around them; null: no time sync
+        std::function<void(const timesync::Exchange& exchange)> onExchange;
+        /// Queue an encoded Time request behind the connection's other
+        /// writes; null: written to the socket directly
+        timesync::TimeRequester::Writer writeRequest;
+    };
+
+    /// Every batch as received, Time replies included, before its messages
+    /// are delivered; the payloads are valid during the call
+    using Tap = std::function<void(const std::vector<BatchReceiver::Message>& batch)>;
+
+    StreamReader(boost::asio::ip::tcp::socket& socket, ReaderOptions options = {});
+
+    /// Tap the readers on @p io_context, called on its thread; null removes
+    /// the tap. Any thread.
+    static void setTap(boost::asio::io_context& io_context, Tap tap);
+
+    void start(Callbacks callbacks);
+    /// Stop delivering. The pending read completes when the owner closes
+    /// the socket.
+    void stop();
+
+    const BatchReceiver::Stats& stats() const
+    {
+        return receiver_->stats();
+    }
+
+    /// What the kernel accepted of the socket profile
+    const Applied& socketProfile() const
+    {
+        return applied_;
+    }
+
+    /// The time sync's requester, null without onExchange
+    const timesync::TimeRequester* requester() const
+    {
+        return requester_.get();
+    }
+
+private:
+    void tuneSocket();
+    void startTimeSync();
+    void onBatch(const std::vector<BatchReceiver::Message>& batch);
+    /// Look the tap up again if any changed, and replay the stream's headers to a new one
+    void updateTap();
+    /// Keep a copy of the last ServerSettings and CodecHeader
+    void remember(const BatchReceiver::Message& message);
+    void onTimeSample(const probe::wire::TimeSample& sample);
+    void fail(const boost::system::error_code& ec);
+
+    boost::asio::ip::tcp::socket& socket_;
+    ReaderOptions options_;
+    Callbacks callbacks_;
+    std::shared_ptr<BatchReceiver> receiver_;
+    Applied applied_;
+    std::shared_ptr<timesync::TimeRequester> requester_;
+    timesync::InboundTracker tracker_;
+    std::chrono::microseconds replyReceived_{0};
+    int samples_{0};
+    std::chrono::steady_clock::time_point lastReply_;
+    bool stopped_{false};
+
+    std::shared_ptr<const Tap> tap_;
+    uint32_t tapGeneration_{0};
+    /// Header and payload of the last ServerSettings and CodecHeader
+    std::vector<uint8_t> serverSettings_;
+    std::vector<uint8_t> codecHeader_;
+};
+
+} // namespace net
@@ -0,0 +1,373 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "stream_relay.hpp"
+
+// local headers
+#include "common/aixlog.hpp"
+
+// 3rd party headers
+#include <boost/asio/post.hpp>
+#include <boost/asio/write.hpp>
+
+// Standard headers
+#include <algorithm>
+#include <cstring>
+
+namespace net
+{
+
+static constexpr auto LOG_TAG = "StreamRelay";
+
+using boost::asio::ip::tcp;
+namespace wire = probe::wire;
+
+namespace
+{
+
+/// Frames kept for reuse; beyond that a frame is freed with its last queue
+constexpr size_t MAX_POOL_FRAMES = 256;
+/// Downstream clients only send Hello and Time requests
+constexpr size_t CLIENT_READ_SIZE = 4096;
+
+/// The first frames of a client's queue as one buffer sequence: the write
+/// operation copies this view, not a vector of buffers
+struct GatherView
+{
+    const boost::asio::const_buffer* first;
+    const boost::asio::const_buffer* last;
+
+    const boost::asio::const_buffer* begin() const
+    {
+        return first;
+    }
+    const boost::asio::const_buffer* end() const
+    {
+        return last;
+    }
+};
+
+} // namespace
+
+
+StreamRelay::StreamRelay(boost::asio::io_context& io_context, RelayOptions options)
+    : io_context_(io_context), acceptor_(io_context), options_(std::move(options))
+{
+}
+
+
+bool StreamRelay::start(boost::system::error_code& ec)
+{
+    const auto address = boost::asio::ip::make_address(options_.address, ec);
+    if (ec)
+        return false;
+    const tcp::endpoint endpoint(address, options_.port);
+    acceptor_.open(endpoint.protocol(), ec);
+    if (!ec)
+        acceptor_.set_option(tcp::acceptor::reuse_address(true), ec);
+    if (!ec)
+        acceptor_.bind(endpoint, ec);
+    if (!ec)
+        acceptor_.listen(boost::asio::socket_base::max_listen_connections, ec);
+    if (ec)
+    {
+        boost::system::error_code ignored;
+        acceptor_.close(ignored);
+        return false;
+    }
+    stopped_ = false;
+    LOG(INFO, LOG_TAG) << "Relaying on " << options_.address << ":" << port() << ", up to " << options_.maxClients << " clients\n";
+    accept();
+    return true;
+}
+
+
+void StreamRelay::stop()
+{
+    boost::asio::post(io_context_, [self = shared_from_this()]()
+    {
+        if (self->stopped_)
+            return;
+        self->stopped_ = true;
+        boost::system::error_code ignored;
+        self->acceptor_.close(ignored);
+        while (!self->clients_.empty())
+            self->close(self->clients_.back());
+        self->serverSettings_.reset();
+        self->codecHeader_.reset();
+    });
+}
+
+
+uint16_t StreamRelay::port() const
+{
+    boost::system::error_code ec;
+    const auto endpoint = acceptor_.local_endpoint(ec);
+    return ec ? 0 : endpoint.port();
+}
+
+
+void StreamRelay::setClockOffset(std::chrono::microseconds offset)
+{
+    offset_ = offset;
+    synced_ = true;
+}
+
+
+void StreamRelay::accept()
+{
+    acceptor_.async_accept([self = shared_from_this()](const boost::system::error_code& ec, tcp::socket socket)
+    {
+        if (self->stopped_ || (ec == boost::asio::error::operation_aborted))
+            return;
+        if (ec)
+        {
+            LOG(WARNING, LOG_TAG) << "Accept failed: " << ec.message() << "\n";
+            self->accept();
+            return;
+        }
+
+        boost::system::error_code ignored;
+        if (self->clients_.size() >= self->options_.maxClients)
+        {
+            self->stats_.rejected++;
+            socket.close(ignored);
+            self->accept();
+            return;
+        }
+        socket.set_option(tcp::no_delay(true), ignored);
+
+        auto client = std::make_shared<Client>(std::move(socket));
+        client->gather.reserve(self->options_.maxGather);
+        BatchOptions receive;
+        receive.readSize = CLIENT_READ_SIZE;
+        client->receiver = std::make_shared<BatchReceiver>(client->socket, receive);
+
+        std::weak_ptr<StreamRelay> weak = self;
+        std::weak_ptr<Client> weakClient = client;
+        client->receiver->start(
+            [weak, weakClient](const std::vector<BatchReceiver::Message>& batch)
+            {
+                auto relay = weak.lock();
+                auto c = weakClient.lock();
+                if (relay && c)
+                    relay->onClientMessages(c, batch);
+            },
+            [weak, weakClient](const boost::system::error_code&)
+            {
+                auto relay = weak.lock();
+                auto c = weakClient.lock();
+                if (relay && c)
+                    relay->close(c);
+            });
+        self->clients_.push_back(client);
+        self->stats_.accepted++;
+        LOG(INFO, LOG_TAG) << "Client " << client->socket.remote_endpoint(ignored).address().to_string() << " connected, "
+                           << self->clients_.size() << " now\n";
+        self->accept();
+    });
+}
+
+
+void StreamRelay::publish(const std::vector<BatchReceiver::Message>& batch)
+{
+    if (stopped_)
+        return;
+    for (const auto& message : batch)
+    {
+        if (message.header.type == wire::kTime)
+            continue;
+        FramePtr f = encode(message);
+        stats_.published++;
+        if (message.header.type == wire::kServerSettings)
+            serverSettings_ = f;
+        else if (message.header.type == wire::kCodecHeader)
+            codecHeader_ = f;
+
+        // Backwards: a client dropped on the way only takes itself out
+        for (size_t i = clients_.size(); i-- > 0;)
+        {
+            ClientPtr client = clients_[i];
+            if (client->helloed)
+                enqueue(client, f);
+        }
+    }
+}
+
+
+void StreamRelay::onClientMessages(const ClientPtr& client, const std::vector<BatchReceiver::Message>& batch)
+{
+    for (const auto& message : batch)
+    {
+        if (client->closed)
+            return;
+        if (message.header.type == wire::kTime)
+        {
+            answerTime(client, message);
+        }
+        else if ((message.header.type == wire::kHello) && !client->helloed)
+        {
+            // What a server sends after Hello; chunks follow with publish()
+            client->helloed = true;
+            if (serverSettings_)
+                enqueue(client, serverSettings_);
+            if (codecHeader_)
+                enqueue(client, codecHeader_);
+        }
+    }
+}
+
+
+void StreamRelay::answerTime(const ClientPtr& client, const BatchReceiver::Message& request)
+{
+    if (!synced_)
+        return;
+    // As the server would answer: its receive time - the client's send
+    // time, and its send time, both on the upstream clock
+    const auto latency = request.received + offset_ - wire::fromTimeval(request.header.sent);
+    FramePtr reply = frame(wire::TIME_MESSAGE_SIZE);
+    wire::encodeTimeReply(0, request.header.id, latency, wire::now() + offset_, reply->bytes.data());
+    stats_.timeReplies++;
+    enqueue(client, reply, true);
+}
+
+
+void StreamRelay::enqueue(const ClientPtr& client, const FramePtr& frame, bool urgent)
+{
+    if (client->closed)
+        return;
+    const size_t size = frame->bytes.size();
+    if (!urgent && (client->queuedBytes + size > options_.maxQueuedBytes))
+    {
+        stats_.dropped++;
+        boost::system::error_code ignored;
+        LOG(WARNING, LOG_TAG) << "Client " << client->socket.remote_endpoint(ignored).address().to_string() << " fell "
+                              << client->queuedBytes << " bytes behind, dropping it\n";
+        close(client);
+        return;
+    }
+    if (urgent)
+        client->queue.insert(client->queue.begin() + static_cast<std::ptrdiff_t>(client->inFlight), frame);
+    else
+        client->queue.push_back(frame);
+    client->queuedBytes += size;
+    if (client->inFlight == 0)
+        write(client);
+}
+
+
+void StreamRelay::write(const ClientPtr& client)
+{
+    client->gather.clear();
+    const size_t n = std::min(client->queue.size(), options_.maxGather);
+    for (size_t i = 0; i < n; ++i)
+        client->gather.push_back(boost::asio::buffer(client->queue[i]->bytes) + ((i == 0) ? client->sentBytes : 0));
+    client->inFlight = n;
+    stats_.writes++;
+
+    // async_write_some, not async_write: the composed write prepares its
+    // buffers in an operation too large for a HandlerMemory slot
+    const GatherView view{client->gather.data(), client->gather.data() + n};
+    client->socket.async_write_some(view, recycled(client->memory, [self = shared_from_this(), client](const boost::system::error_code& ec, size_t bytes)
+    {
+        if (client->closed)
+        {
+            // The frames stayed queued until the aborted write was done with them
+            client->queue.clear();
+            return;
+        }
+        if (ec)
+        {
+            self->close(client);
+            return;
+        }
+        self->stats_.bytesSent += bytes;
+        // Drop the frames written out; a partly written one stays in front
+        size_t done = 0;
+        while ((done < client->inFlight) && (bytes > 0))
+        {
+            const size_t size = client->queue[done]->bytes.size();
+            const size_t left = size - client->sentBytes;
+            if (bytes < left)
+            {
+                client->sentBytes += bytes;
+                break;
+            }
+            bytes -= left;
+            client->sentBytes = 0;
+            client->queuedBytes -= size;
+            ++done;
+        }
+        client->queue.erase(client->queue.begin(), client->queue.begin() + static_cast<std::ptrdiff_t>(done));
+        client->inFlight = 0;
+        if (!client->queue.empty())
+            self->write(client);
+    }));
+}
+
+
+void StreamRelay::close(const ClientPtr& client)
+{
+    if (client->closed)
+        return;
+    client->closed = true;
+    client->receiver->stop();
+    boost::system::error_code ignored;
+    client->socket.close(ignored);
+    // Frames in the pending write go with its completion, the rest now
+    client->queue.erase(client->queue.begin() + static_cast<std::ptrdiff_t>(client->inFlight), client->queue.end());
+    client->queuedBytes = 0;
+    client->sentBytes = 0;
+    clients_.erase(std::remove(clients_.begin(), clients_.end(), client), clients_.end());
+    LOG(INFO, LOG_TAG) << "Client disconnected, " << clients_.size() << " left\n";
+}
+
+
+StreamRelay::FramePtr StreamRelay::frame(size_t size)
+{
+    // Only the pool holds it: no queue, and not the cached headers
+    for (size_t n = 0; n < pool_.size(); ++n)
+    {
+        const size_t i = (poolCursor_ + n) % pool_.size();
+        if (pool_[i].use_count() != 1)
+            continue;
+        poolCursor_ = (i + 1) % pool_.size();
+        if (pool_[i]->bytes.capacity() < size)
+            stats_.framesAllocated++;
+        pool_[i]->bytes.resize(size);
+        return pool_[i];
+    }
+    auto f = std::make_shared<Frame>();
+    f->bytes.resize(size);
+    stats_.framesAllocated++;
+    if (pool_.size() < MAX_POOL_FRAMES)
+        pool_.push_back(f);
+    return f;
+}
+
+
+StreamRelay::FramePtr StreamRelay::encode(const BatchReceiver::Message& message)
+{
+    FramePtr f = frame(wire::HEADER_SIZE + message.header.size);
+    wire::encodeHeader(message.header, f->bytes.data());
+    if (message.header.size > 0)
+        std::memcpy(f->bytes.data() + wire::HEADER_SIZE, message.payload, message.header.size);
+    return f;
+}
+
+} // namespace net
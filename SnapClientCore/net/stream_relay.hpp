@@ -0,0 +1,179 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// local headers
+#include "net/batch_receiver.hpp"
+#include "net/handler_memory.hpp"
+#include "probe/stream_wire.hpp"
+
+// 3rd party headers
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+// Standard headers
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace net
+{
+
+struct RelayOptions
+{
+    /// Where downstream clients connect (the stream port of a server)
+    std::string address{"0.0.0.0"};
+    uint16_t port{1704};
+    size_t maxClients{8};
+    /// A client with more than this waiting to be written is dropped: it
+    /// cannot keep up, and holding its backlog would hold the frames
+    size_t maxQueuedBytes{1024 * 1024};
+    /// Frames handed to one gather write
+    size_t maxGather{16};
+};
+
+/// Re-serves the received stream to downstream Snapcast clients.
+///
+/// The relay listens like a server's stream port. A client's Hello is
+/// answered with the last ServerSettings and CodecHeader received from
+/// upstream, then every message publish() is given is forwarded as is:
+/// chunk timestamps stay in the upstream server's time base. Time requests
+/// are answered in that time base too, from the local clock plus the
+/// offset the caller's own sync measured (setClockOffset()), so downstream
+/// clients play in sync with everything connected to the server.
+///
+/// A message is copied once, out of the upstream receive buffer into a
+/// frame shared by every client's write queue; clients are written with
+/// gather writes straight from the shared frames. Frames are recycled once
+/// no queue holds them, so a steady stream does not allocate. Time replies
+/// go ahead of the audio waiting in a queue: a reply held behind chunks
+/// would skew the client's offset by the wait.
+///
+/// Downstream clients are not announced to the server: they play at the
+/// relay's settings (volume, latency) and do not show up in its client list.
+///
+/// Single io thread: start(), publish() and setClockOffset() on the thread
+/// running the upstream session; stop() from any thread.
+class StreamRelay : public std::enable_shared_from_this<StreamRelay>
+{
+public:
+    struct Stats
+    {
+        uint64_t accepted{0};
+        uint64_t rejected{0};         ///< Connections beyond maxClients
+        uint64_t dropped{0};          ///< Clients that fell maxQueuedBytes behind
+        uint64_t published{0};        ///< Upstream messages taken
+        uint64_t framesAllocated{0};  ///< Frames (or frame growth) not served from the pool
+        uint64_t timeReplies{0};
+        uint64_t writes{0};           ///< Gather writes issued
+        uint64_t bytesSent{0};
+    };
+
+    StreamRelay(boost::asio::io_context& io_context, RelayOptions options);
+
+    /// Listen and accept downstream clients
+    /// @return false if the port could not be bound (@p ec tells why)
+    bool start(boost::system::error_code& ec);
+    /// Close the listener and every client
+    void stop();
+
+    /// Forward an upstream batch, as a StreamReader::Tap delivers it. Time
+    /// replies are the relay's own business and skipped.
+    void publish(const std::vector<BatchReceiver::Message>& batch);
+
+    /// Server clock - local clock, from the upstream time sync. Time
+    /// requests are not answered before the first offset.
+    void setClockOffset(std::chrono::microseconds offset);
+
+    /// Bound port (useful with port 0)
+    uint16_t port() const;
+    size_t clients() const
+    {
+        return clients_.size();
+    }
+    const Stats& stats() const
+    {
+        return stats_;
+    }
+
+private:
+    /// One encoded message, shared by the write queues it is in
+    struct Frame
+    {
+        std::vector<uint8_t> bytes;
+    };
+    using FramePtr = std::shared_ptr<Frame>;
+
+    struct Client
+    {
+        explicit Client(boost::asio::ip::tcp::socket s) : socket(std::move(s))
+        {
+        }
+
+        boost::asio::ip::tcp::socket socket;
+        std::shared_ptr<BatchReceiver> receiver;
+        /// Frames to write; the first inFlight are in the pending write. A
+        /// vector, unlike a deque, keeps its storage as it drains.
+        std::vector<FramePtr> queue;
+        size_t inFlight{0};
+        /// Bytes of the first frame already written
+        size_t sentBytes{0};
+        size_t queuedBytes{0};
+        std::vector<boost::asio::const_buffer> gather;
+        /// The pending write's operation
+        HandlerMemory memory;
+        bool helloed{false};
+        bool closed{false};
+    };
+    using ClientPtr = std::shared_ptr<Client>;
+
+    void accept();
+    void onClientMessages(const ClientPtr& client, const std::vector<BatchReceiver::Message>& batch);
+    void answerTime(const ClientPtr& client, const BatchReceiver::Message& request);
+    /// Queue @p frame for @p client; @p urgent goes ahead of what waits
+    void enqueue(const ClientPtr& client, const FramePtr& frame, bool urgent = false);
+    void write(const ClientPtr& client);
+    void close(const ClientPtr& client);
+    /// A frame no queue holds any more, or a new one
+    FramePtr frame(size_t size);
+    /// Copy of @p message as one frame
+    FramePtr encode(const BatchReceiver::Message& message);
+
+    boost::asio::io_context& io_context_;
+    boost::asio::ip::tcp::acceptor acceptor_;
+    RelayOptions options_;
+    std::vector<ClientPtr> clients_;
+
+    /// Sent to a client after its Hello
+    FramePtr serverSettings_;
+    FramePtr codecHeader_;
+
+    std::vector<FramePtr> pool_;
+    size_t poolCursor_{0};
+
+    std::chrono::microseconds offset_{0};
+    bool synced_{false};
+    bool stopped_{false};
+    Stats stats_;
+};
+
+} // namespace net
@@ -0,0 +1,209 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "chunk_ring.hpp"
+
+// Standard headers
+#include <algorithm>
+#include <cstring>
+
+namespace playout
+{
+
+namespace
+{
+
+constexpr int64_t USEC_PER_SEC = 1'000'000;
+
+} // namespace
+
+
+ChunkRing::ChunkRing(uint32_t sampleRate, uint32_t frameSize, std::chrono::milliseconds capacity, size_t maxChunks)
+    : sampleRate_(sampleRate), frameSize_(frameSize)
+{
+    auto ms = static_cast<size_t>(std::max<int64_t>(capacity.count(), 1));
+    capacityFrames_ = (ms * sampleRate_ + 999) / 1000;
+    pcm_.resize(capacityFrames_ * frameSize_);
+    if (maxChunks == 0)
+        maxChunks = ms / 10 + 2;
+    chunks_.resize(std::max<size_t>(maxChunks, 2));
+}
+
+
+bool ChunkRing::append(usec start, const void* pcm, uint32_t frames)
+{
+    if (frames == 0 || frames > capacityFrames_)
+    {
+        stats_.rejected++;
+        return false;
+    }
+    int64_t begin = start.count();
+    if (count_ > 0)
+    {
+        // Overlap of up to one frame is timestamp rounding, more is out of order
+        int64_t frameUs = (USEC_PER_SEC + sampleRate_ - 1) / sampleRate_;
+        if (begin < at(count_ - 1).end - frameUs)
+        {
+            stats_.rejected++;
+            return false;
+        }
+    }
+
+    while (count_ > 0 && (usedFrames_ + frames > capacityFrames_ || count_ == chunks_.size()))
+    {
+        dropFront();
+        stats_.dropped++;
+    }
+
+    // Copy into the byte ring, wrapping once at most
+    const auto* src = static_cast<const uint8_t*>(pcm);
+    size_t first = std::min<size_t>(frames, capacityFrames_ - writeFrame_);
+    std::memcpy(pcm_.data() + writeFrame_ * frameSize_, src, first * frameSize_);
+    if (first < frames)
+        std::memcpy(pcm_.data(), src + first * frameSize_, (frames - first) * frameSize_);
+
+    Chunk& c = chunks_[(head_ + count_) % chunks_.size()];
+    c.start = begin;
+    c.end = begin + static_cast<int64_t>(frames) * USEC_PER_SEC / sampleRate_;
+    c.frames = frames;
+    c.frame = writeFrame_;
+    count_++;
+
+    writeFrame_ = (writeFrame_ + frames) % capacityFrames_;
+    usedFrames_ += frames;
+    heldUs_ += c.end - c.start;
+    stats_.appended++;
+    return true;
+}
+
+
+uint32_t ChunkRing::read(usec at, void* out, uint32_t frames) const
+{
+    auto* dst = static_cast<uint8_t*>(out);
+    const int64_t t0 = at.count();
+    uint32_t produced = 0;
+    uint32_t fromChunks = 0;
+
+    size_t i = upperBound(t0);
+    while (produced < frames)
+    {
+        uint32_t left = frames - produced;
+        if (i == count_)
+        {
+            std::memset(dst + static_cast<size_t>(produced) * frameSize_, 0, static_cast<size_t>(left) * frameSize_);
+            break;
+        }
+
+        // Exact time of the next output frame, no accumulated rounding
+        int64_t t = t0 + static_cast<int64_t>(produced) * USEC_PER_SEC / sampleRate_;
+        const Chunk& c = this->at(i);
+        if (t < c.start)
+        {
+            // Gap before this chunk: silence up to its first frame
+            int64_t gap = ((c.start - t) * sampleRate_ + USEC_PER_SEC - 1) / USEC_PER_SEC;
+            auto n = static_cast<uint32_t>(std::min<int64_t>(gap, left));
+            std::memset(dst + static_cast<size_t>(produced) * frameSize_, 0, static_cast<size_t>(n) * frameSize_);
+            produced += n;
+            continue;
+        }
+
+        auto offset = static_cast<uint32_t>((t - c.start) * sampleRate_ / USEC_PER_SEC);
+        if (offset < c.frames)
+        {
+            uint32_t n = std::min(c.frames - offset, left);
+            copyOut((c.frame + offset) % capacityFrames_, n, dst + static_cast<size_t>(produced) * frameSize_);
+            produced += n;
+            fromChunks += n;
+        }
+        ++i;
+    }
+    return fromChunks;
+}
+
+
+void ChunkRing::trimBefore(usec t)
+{
+    size_t n = upperBound(t.count());
+    for (size_t i = 0; i < n; ++i)
+        dropFront();
+}
+
+
+void ChunkRing::clear()
+{
+    head_ = 0;
+    count_ = 0;
+    writeFrame_ = 0;
+    usedFrames_ = 0;
+    heldUs_ = 0;
+}
+
+
+ChunkRing::usec ChunkRing::front() const
+{
+    return usec(count_ ? at(0).start : 0);
+}
+
+
+ChunkRing::usec ChunkRing::back() const
+{
+    return usec(count_ ? at(count_ - 1).end : 0);
+}
+
+
+ChunkRing::usec ChunkRing::duration() const
+{
+    return usec(heldUs_);
+}
+
+
+size_t ChunkRing::upperBound(int64_t t) const
+{
+    size_t lo = 0;
+    size_t hi = count_;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (at(mid).end <= t)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+
+void ChunkRing::dropFront()
+{
+    const Chunk& c = at(0);
+    usedFrames_ -= c.frames;
+    heldUs_ -= c.end - c.start;
+    head_ = (head_ + 1) % chunks_.size();
+    count_--;
+}
+
+
+void ChunkRing::copyOut(size_t frame, uint32_t frames, uint8_t* out) const
+{
+    size_t first = std::min<size_t>(frames, capacityFrames_ - frame);
+    std::memcpy(out, pcm_.data() + frame * frameSize_, first * frameSize_);
+    if (first < frames)
+        std::memcpy(out + first * frameSize_, pcm_.data(), (frames - first) * frameSize_);
+}
+
+} // namespace playout
@@ -0,0 +1,148 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// Standard headers
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace playout
+{
+
+/// Timestamp-indexed ring of decoded PCM chunks.
+///
+/// Replaces the queue of individually allocated chunks that Snapcast's
+/// Stream walked and popped to find the audio for a given time
+/// (patches/ios-chunk-ring.patch). PCM lives in one byte ring sized for the
+/// buffer depth; chunk descriptors (start time, frame count, byte offset)
+/// live in a second ring. Both are allocated once.
+///
+/// - append() is O(1): one copy into the byte ring, the oldest chunks are
+///   dropped if the ring is full.
+/// - read() finds the chunk covering a playout time by binary search over
+///   the descriptors (O(log n)) and copies from any frame offset inside it,
+///   across chunk boundaries, zero-filling gaps. Nothing is allocated.
+/// - trimBefore() drops chunks that end before a time, O(log n).
+///
+/// Times are chunk timestamps in microseconds on one clock (the server's).
+/// Chunks must be appended in timestamp order.
+///
+/// Not thread-safe: the owner guards it as it guarded its chunk queue.
+class ChunkRing
+{
+public:
+    using usec = std::chrono::microseconds;
+
+    struct Stats
+    {
+        uint64_t appended{0};  ///< Chunks stored
+        uint64_t dropped{0};   ///< Oldest chunks dropped to make room
+        uint64_t rejected{0};  ///< Out of order or larger than the ring
+    };
+
+    /// Holds nothing (every append() is rejected) until a sized ring is assigned
+    ChunkRing() = default;
+
+    /// @param capacity   buffer depth to hold (rounded up to whole frames)
+    /// @param maxChunks  descriptor slots; 0 sizes them for 10 ms chunks
+    ChunkRing(uint32_t sampleRate, uint32_t frameSize, std::chrono::milliseconds capacity, size_t maxChunks = 0);
+
+    /// Store a chunk starting at @p start. Frames are copied.
+    /// @return false if the chunk starts before the newest one or cannot fit
+    bool append(usec start, const void* pcm, uint32_t frames);
+
+    /// Copy @p frames frames of audio starting at playout time @p at.
+    /// Frames not covered by a chunk (before, between, after) are zero.
+    /// @return number of frames that came from chunks
+    uint32_t read(usec at, void* out, uint32_t frames) const;
+
+    /// Drop chunks that end at or before @p t
+    void trimBefore(usec t);
+
+    void clear();
+
+    bool empty() const
+    {
+        return count_ == 0;
+    }
+    size_t chunks() const
+    {
+        return count_;
+    }
+    /// Start of the oldest chunk (0 if empty)
+    usec front() const;
+    /// End of the newest chunk (0 if empty)
+    usec back() const;
+    /// Audio held, back() - front() minus gaps
+    usec duration() const;
+
+    uint32_t sampleRate() const
+    {
+        return sampleRate_;
+    }
+    uint32_t frameSize() const
+    {
+        return frameSize_;
+    }
+    size_t capacityFrames() const
+    {
+        return capacityFrames_;
+    }
+    const Stats& stats() const
+    {
+        return stats_;
+    }
+
+private:
+    struct Chunk
+    {
+        int64_t start;    ///< µs
+        int64_t end;      ///< µs, start + frames / rate
+        uint32_t frames;
+        size_t frame;     ///< First frame in the PCM ring
+    };
+
+    const Chunk& at(size_t i) const
+    {
+        return chunks_[(head_ + i) % chunks_.size()];
+    }
+    /// Index of the first chunk ending after @p t (count_ if none)
+    size_t upperBound(int64_t t) const;
+    void dropFront();
+    void copyOut(size_t frame, uint32_t frames, uint8_t* out) const;
+
+    uint32_t sampleRate_{0};
+    uint32_t frameSize_{0};
+    size_t capacityFrames_{0};
+
+    std::vector<uint8_t> pcm_;
+    size_t writeFrame_{0};
+    size_t usedFrames_{0};
+    int64_t heldUs_{0};
+
+    std::vector<Chunk> chunks_;
+    size_t head_{0};
+    size_t count_{0};
+
+    Stats stats_;
+};
+
+} // namespace playout
@@ -0,0 +1,163 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "pcm_tap.hpp"
+
+// Standard headers
+#include <algorithm>
+#include <cstring>
+
+namespace playout
+{
+
+PcmTap::PcmTap(const Format& format, std::chrono::milliseconds capacity)
+    : format_(format), frameBytes_(static_cast<size_t>(format.channels) * ((format.bits == 16) ? 2 : 4)),
+      capacityFrames_(std::max<size_t>(static_cast<size_t>(format.rate) * static_cast<size_t>(capacity.count()) / 1000, MIN_BLOCK_FRAMES)),
+      pcm_(capacityFrames_ * frameBytes_), slots_(capacityFrames_ / MIN_BLOCK_FRAMES + 2)
+{
+}
+
+
+bool PcmTap::intact(uint64_t firstFrame) const
+{
+    return reserved_.load(std::memory_order_relaxed) - firstFrame <= capacityFrames_;
+}
+
+
+void PcmTap::push(const void* pcm, uint32_t frames, Clock::time_point playAt)
+{
+    if ((frames == 0) || (readers_.load(std::memory_order_relaxed) == 0))
+        return;
+
+    // A buffer longer than the ring keeps its end, which plays that much later
+    const auto* src = static_cast<const uint8_t*>(pcm);
+    if (frames > capacityFrames_)
+    {
+        const uint32_t skip = frames - static_cast<uint32_t>(capacityFrames_);
+        playAt += std::chrono::nanoseconds(static_cast<int64_t>(skip) * 1000000000 / std::max<uint32_t>(format_.rate, 1));
+        src += skip * frameBytes_;
+        frames -= skip;
+    }
+
+    const uint64_t n = published_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[n % slots_.size()];
+    const uint64_t first = writeFrame_;
+
+    // Readers check reserved_ and the slot after reading: announce the
+    // overwrite before it starts
+    reserved_.store(first + frames, std::memory_order_relaxed);
+    slot.sequence.store(INVALID, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const size_t offset = first % capacityFrames_;
+    const size_t head = std::min<size_t>(frames, capacityFrames_ - offset);
+    std::memcpy(pcm_.data() + offset * frameBytes_, src, head * frameBytes_);
+    if (head < frames)
+        std::memcpy(pcm_.data(), src + head * frameBytes_, (frames - head) * frameBytes_);
+
+    slot.firstFrame.store(first, std::memory_order_relaxed);
+    slot.frames.store(frames, std::memory_order_relaxed);
+    slot.playAt.store(playAt.time_since_epoch().count(), std::memory_order_relaxed);
+    slot.sequence.store(n, std::memory_order_release);
+    writeFrame_ = first + frames;
+    published_.store(n + 1, std::memory_order_release);
+}
+
+
+PcmTap::Reader::Reader(const PcmTap& tap) : tap_(tap)
+{
+    tap_.readers_.fetch_add(1, std::memory_order_relaxed);
+    next_ = tap_.published_.load(std::memory_order_acquire);
+}
+
+
+PcmTap::Reader::~Reader()
+{
+    tap_.readers_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+
+void PcmTap::Reader::overrun()
+{
+    ++overruns_;
+    lapped_ = true;
+}
+
+
+bool PcmTap::Reader::acquire(Block& block)
+{
+    for (;;)
+    {
+        const uint64_t published = tap_.published_.load(std::memory_order_acquire);
+        if (lapped_ && (published > 0))
+        {
+            next_ = std::max(next_, published - 1);
+            lapped_ = false;
+        }
+        if (next_ >= published)
+            return false;
+
+        const Slot& slot = tap_.slots_[next_ % tap_.slots_.size()];
+        if (slot.sequence.load(std::memory_order_acquire) != next_)
+        {
+            overrun();  // The descriptor was reused
+            continue;
+        }
+        const uint64_t first = slot.firstFrame.load(std::memory_order_relaxed);
+        const uint32_t frames = slot.frames.load(std::memory_order_relaxed);
+        const int64_t playAt = slot.playAt.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((slot.sequence.load(std::memory_order_relaxed) != next_) || !tap_.intact(first))
+        {
+            overrun();  // Reused while read, or its frames are being overwritten
+            continue;
+        }
+
+        if ((nextFrame_ != INVALID) && (first > nextFrame_))
+            lostFrames_ += first - nextFrame_;
+        nextFrame_ = first + frames;
+
+        const size_t offset = first % tap_.capacityFrames_;
+        const uint32_t head = static_cast<uint32_t>(std::min<size_t>(frames, tap_.capacityFrames_ - offset));
+        block.data[0] = tap_.pcm_.data() + offset * tap_.frameBytes_;
+        block.frames[0] = head;
+        block.data[1] = (head < frames) ? tap_.pcm_.data() : nullptr;
+        block.frames[1] = frames - head;
+        block.firstFrame = first;
+        block.sequence = next_;
+        block.playAt = Clock::time_point(Clock::duration(playAt));
+        ++next_;
+        return true;
+    }
+}
+
+
+bool PcmTap::Reader::release(const Block& block)
+{
+    // Orders the consumer's reads of the block before the check
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (tap_.intact(block.firstFrame))
+        return true;
+    // Lapped while it was held: its frames count as lost
+    overrun();
+    if (nextFrame_ == block.firstFrame + block.totalFrames())
+        nextFrame_ = block.firstFrame;
+    return false;
+}
+
+} // namespace playout
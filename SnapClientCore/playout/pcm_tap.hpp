@@ -0,0 +1,178 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// Standard headers
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace playout
+{
+
+/// Broadcast ring of the played PCM, with the time each buffer plays.
+///
+/// The audio thread copies each buffer once into a byte ring sized for
+/// @p capacity of audio and publishes a block descriptor (first frame,
+/// frame count, playout time). Consumers read the blocks in place through
+/// a Reader: acquire() hands out pointers into the ring, release() tells
+/// whether the writer overwrote them meanwhile. The writer never waits for
+/// a reader, so a slow consumer cannot hold up playback; it is lapped
+/// instead, and its Reader counts the overrun and the frames lost and
+/// resumes at the newest block.
+///
+/// push() is wait-free and does not allocate; without a Reader it returns
+/// at once. One writer, any number of Readers on other threads.
+class PcmTap
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Format
+    {
+        uint32_t rate{48000};
+        uint16_t channels{2};
+        /// 16, 24 (in a 32-bit container) or 32
+        uint16_t bits{16};
+    };
+
+    /// Played frames, interleaved, in the ring: @p data[1] continues
+    /// @p data[0] where the ring wraps (frames[1] is 0 if it does not)
+    struct Block
+    {
+        const void* data[2]{nullptr, nullptr};
+        uint32_t frames[2]{0, 0};
+        /// Frames pushed before this block
+        uint64_t firstFrame{0};
+        /// Blocks pushed before this one
+        uint64_t sequence{0};
+        /// When the first frame plays
+        Clock::time_point playAt;
+
+        uint32_t totalFrames() const
+        {
+            return frames[0] + frames[1];
+        }
+    };
+
+    /// A consumer's position in the tap; attaches at the newest block
+    class Reader
+    {
+    public:
+        explicit Reader(const PcmTap& tap);
+        ~Reader();
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        /// The next block, false if the consumer is up to date. After an
+        /// overrun this is the newest block.
+        bool acquire(Block& block);
+
+        /// Done with @p block. False if the writer overwrote it while it
+        /// was held: what was read is garbage, counted as an overrun.
+        bool release(const Block& block);
+
+        /// Times the consumer was lapped
+        uint64_t overruns() const
+        {
+            return overruns_;
+        }
+        /// Frames it missed through those
+        uint64_t lostFrames() const
+        {
+            return lostFrames_;
+        }
+
+    private:
+        void overrun();
+
+        const PcmTap& tap_;
+        uint64_t next_;
+        /// First frame expected next, INVALID until the first block
+        uint64_t nextFrame_{INVALID};
+        /// Lapped: resume at the newest block
+        bool lapped_{false};
+        uint64_t overruns_{0};
+        uint64_t lostFrames_{0};
+    };
+
+    explicit PcmTap(const Format& format, std::chrono::milliseconds capacity = std::chrono::milliseconds(2000));
+
+    /// Audio thread: @p pcm is a buffer of @p frames whose first frame
+    /// plays at @p playAt. If it exceeds the ring only its end is kept.
+    void push(const void* pcm, uint32_t frames, Clock::time_point playAt);
+
+    const Format& format() const
+    {
+        return format_;
+    }
+    size_t frameBytes() const
+    {
+        return frameBytes_;
+    }
+    size_t capacityFrames() const
+    {
+        return capacityFrames_;
+    }
+    /// Blocks pushed so far
+    uint64_t published() const
+    {
+        return published_.load(std::memory_order_acquire);
+    }
+    /// Readers attached
+    uint32_t readers() const
+    {
+        return readers_.load(std::memory_order_relaxed);
+    }
+
+private:
+    /// Buffers are at least this long: sizes the descriptor ring so the
+    /// byte ring is what laps a reader
+    static constexpr uint32_t MIN_BLOCK_FRAMES = 256;
+    static constexpr uint64_t INVALID = ~uint64_t(0);
+
+    struct Slot
+    {
+        /// Block number, INVALID while written
+        std::atomic<uint64_t> sequence{INVALID};
+        std::atomic<uint64_t> firstFrame{0};
+        std::atomic<uint32_t> frames{0};
+        std::atomic<int64_t> playAt{0};  ///< Clock ticks
+    };
+
+    /// Frames from @p firstFrame on are still in the ring
+    bool intact(uint64_t firstFrame) const;
+
+    Format format_;
+    size_t frameBytes_;
+    size_t capacityFrames_;
+    std::vector<uint8_t> pcm_;
+    std::vector<Slot> slots_;
+
+    /// Writer only
+    uint64_t writeFrame_{0};
+    /// End of the frames the writer has started to overwrite
+    std::atomic<uint64_t> reserved_{0};
+    std::atomic<uint64_t> published_{0};
+    mutable std::atomic<uint32_t> readers_{0};
+};
+
+} // namespace playout
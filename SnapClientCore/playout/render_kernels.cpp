@@ -0,0 +1,229 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "render_kernels.hpp"
+
+// Standard headers
+#include <algorithm>
+
+namespace playout
+{
+
+namespace
+{
+
+struct Pcm16
+{
+    using Sample = int16_t;
+    using Math = float;
+    static constexpr Math FULL_SCALE = 32768.f;
+};
+
+struct Pcm24
+{
+    using Sample = int32_t;
+    using Math = float;  // 24 significant bits fit the float mantissa
+    static constexpr Math FULL_SCALE = 8388608.f;
+};
+
+struct Pcm32
+{
+    using Sample = int32_t;
+    using Math = double;
+    static constexpr Math FULL_SCALE = 2147483648.;
+};
+
+
+/// Frames per block. With the channel count fixed, each block is a loop of
+/// constant length through a local buffer, which the compiler vectorizes
+/// even at -O2 and without alias checks between the in and out buffers
+/// (they may be the same).
+static constexpr size_t BLOCK_FRAMES = 16;
+
+
+/// Gains are clamped to [0, 1] once per buffer, so the product always fits
+/// the sample type and the per-sample loop needs no clamp.
+/// Channels == 0: generic instance, channel count from the argument
+template <typename Pcm, int Channels>
+void renderNative(const void* in, void* out, size_t frames, const float* gains, uint16_t channels)
+{
+    using Sample = typename Pcm::Sample;
+    using Math = typename Pcm::Math;
+    constexpr size_t MAX_CHANNELS = (Channels > 0) ? Channels : MAX_RENDER_CHANNELS;
+
+    const size_t n = (Channels > 0) ? static_cast<size_t>(Channels) : channels;
+    // Gains repeated over a block: the inner loop doesn't index by channel
+    Math gain[BLOCK_FRAMES * MAX_CHANNELS];
+    for (size_t i = 0; i < BLOCK_FRAMES * n; ++i)
+        gain[i] = static_cast<Math>(std::clamp(gains[i % n], 0.f, 1.f));
+
+    const auto* src = static_cast<const Sample*>(in);
+    auto* dst = static_cast<Sample*>(out);
+    Math block[BLOCK_FRAMES * MAX_CHANNELS];
+    size_t f = 0;
+    for (; f + BLOCK_FRAMES <= frames; f += BLOCK_FRAMES)
+    {
+        const Sample* s = src + f * n;
+        Sample* d = dst + f * n;
+        for (size_t i = 0; i < BLOCK_FRAMES * n; ++i)
+            block[i] = static_cast<Math>(s[i]) * gain[i];
+        for (size_t i = 0; i < BLOCK_FRAMES * n; ++i)
+            d[i] = static_cast<Sample>(block[i]);
+    }
+    for (size_t i = f * n; i < frames * n; ++i)
+        dst[i] = static_cast<Sample>(static_cast<Math>(src[i]) * gain[i - f * n]);
+}
+
+
+template <typename Pcm, int Channels>
+void renderFloat(const void* in, void* out, size_t frames, const float* gains, uint16_t channels)
+{
+    using Sample = typename Pcm::Sample;
+    using Math = typename Pcm::Math;
+    constexpr size_t MAX_CHANNELS = (Channels > 0) ? Channels : MAX_RENDER_CHANNELS;
+
+    const size_t n = (Channels > 0) ? static_cast<size_t>(Channels) : channels;
+    Math gain[BLOCK_FRAMES * MAX_CHANNELS];
+    for (size_t i = 0; i < BLOCK_FRAMES * n; ++i)
+        gain[i] = static_cast<Math>(std::clamp(gains[i % n], 0.f, 1.f)) / Pcm::FULL_SCALE;
+
+    const auto* src = static_cast<const Sample*>(in);
+    auto* dst = static_cast<float*>(out);
+    size_t f = 0;
+    for (; f + BLOCK_FRAMES <= frames; f += BLOCK_FRAMES)
+    {
+        const Sample* s = src + f * n;
+        float* d = dst + f * n;
+        for (size_t i = 0; i < BLOCK_FRAMES * n; ++i)
+            d[i] = static_cast<float>(static_cast<Math>(s[i]) * gain[i]);
+    }
+    for (size_t i = f * n; i < frames * n; ++i)
+        dst[i] = static_cast<float>(static_cast<Math>(src[i]) * gain[i - f * n]);
+}
+
+
+template <typename Pcm>
+void toNative(const float* in, void* out, size_t samples, float gain)
+{
+    using Sample = typename Pcm::Sample;
+    using Math = typename Pcm::Math;
+    auto* dst = static_cast<Sample*>(out);
+    const Math scale = static_cast<Math>(gain) * Pcm::FULL_SCALE;
+    for (size_t i = 0; i < samples; ++i)
+        dst[i] = static_cast<Sample>(std::clamp(static_cast<Math>(in[i]) * scale, -Pcm::FULL_SCALE, Pcm::FULL_SCALE - 1));
+}
+
+
+template <typename Pcm, int Channels>
+RenderKernel::Fn pick(OutputFormat output)
+{
+    return (output == OutputFormat::Float32) ? &renderFloat<Pcm, Channels> : &renderNative<Pcm, Channels>;
+}
+
+
+template <typename Pcm>
+RenderKernel::Fn pick(uint16_t channels, OutputFormat output, bool& specialized)
+{
+    specialized = true;
+    switch (channels)
+    {
+        case 1:
+            return pick<Pcm, 1>(output);
+        case 2:
+            return pick<Pcm, 2>(output);
+        case 6:
+            return pick<Pcm, 6>(output);
+        default:
+            specialized = false;
+            return pick<Pcm, 0>(output);
+    }
+}
+
+} // namespace
+
+
+const char* toString(OutputFormat format)
+{
+    switch (format)
+    {
+        case OutputFormat::Native:
+            return "native";
+        case OutputFormat::Float32:
+            return "float32";
+    }
+    return "unknown";
+}
+
+
+size_t RenderKernel::inFrameBytes() const
+{
+    return static_cast<size_t>(format_.channels) * ((format_.bits == 16) ? 2 : 4);
+}
+
+
+size_t RenderKernel::outFrameBytes() const
+{
+    return (format_.output == OutputFormat::Float32) ? static_cast<size_t>(format_.channels) * sizeof(float) : inFrameBytes();
+}
+
+
+void toNative(const float* in, void* out, size_t samples, uint16_t bits, float gain)
+{
+    gain = std::clamp(gain, 0.f, 1.f);
+    switch (bits)
+    {
+        case 16:
+            toNative<Pcm16>(in, out, samples, gain);
+            break;
+        case 24:
+            toNative<Pcm24>(in, out, samples, gain);
+            break;
+        case 32:
+            toNative<Pcm32>(in, out, samples, gain);
+            break;
+        default:
+            break;
+    }
+}
+
+
+RenderKernel selectKernel(const RenderFormat& format)
+{
+    RenderKernel kernel;
+    if ((format.channels == 0) || (format.channels > MAX_RENDER_CHANNELS))
+        return kernel;
+
+    switch (format.bits)
+    {
+        case 16:
+            kernel.fn_ = pick<Pcm16>(format.channels, format.output, kernel.specialized_);
+            break;
+        case 24:
+            kernel.fn_ = pick<Pcm24>(format.channels, format.output, kernel.specialized_);
+            break;
+        case 32:
+            kernel.fn_ = pick<Pcm32>(format.channels, format.output, kernel.specialized_);
+            break;
+        default:
+            return kernel;
+    }
+    kernel.format_ = format;
+    return kernel;
+}
+
+} // namespace playout
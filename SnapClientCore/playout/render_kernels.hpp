@@ -0,0 +1,110 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// Standard headers
+#include <cstddef>
+#include <cstdint>
+
+namespace playout
+{
+
+/// Sample format of the rendered buffer
+enum class OutputFormat
+{
+    Native,   ///< Same integer format as the stream (in place allowed)
+    Float32,  ///< Normalized float, [-1, 1)
+};
+
+const char* toString(OutputFormat format);
+
+struct RenderFormat
+{
+    /// 16, 24 (in a 32-bit container, as Snapcast stores it) or 32
+    uint16_t bits{16};
+    uint16_t channels{2};
+    OutputFormat output{OutputFormat::Native};
+};
+
+/// Kernels handle at most this many channels
+static constexpr uint16_t MAX_RENDER_CHANNELS = 32;
+
+/// Gain stage from decoded PCM to the output buffer.
+///
+/// The kernel is picked once per format by selectKernel(): for 16/24/32
+/// bits × 1/2/6 channels × each output format it is a template instance
+/// with the sample type and channel count fixed at compile time, so the
+/// per-buffer loop has no format branch and the compiler vectorizes it.
+/// Other channel counts get a generic kernel of the same sample type.
+///
+/// Gains are per channel (channel order of the stream) and attenuate only:
+/// they are clamped to [0, 1], so no sample can pass full scale. 16- and
+/// 24-bit samples are scaled in float, 32-bit in double, then truncated as
+/// Snapcast's adjustVolume did. Little-endian samples only.
+class RenderKernel
+{
+public:
+    using Fn = void (*)(const void* in, void* out, size_t frames, const float* gains, uint16_t channels);
+
+    RenderKernel() = default;
+
+    /// Render @p frames frames; @p gains has one entry per channel. @p in
+    /// and @p out may be the same buffer for OutputFormat::Native.
+    void operator()(const void* in, void* out, size_t frames, const float* gains) const
+    {
+        fn_(in, out, frames, gains, format_.channels);
+    }
+
+    explicit operator bool() const
+    {
+        return fn_ != nullptr;
+    }
+
+    /// true for a compile-time specialized instance, false for the generic one
+    bool specialized() const
+    {
+        return specialized_;
+    }
+
+    const RenderFormat& format() const
+    {
+        return format_;
+    }
+
+    size_t inFrameBytes() const;
+    size_t outFrameBytes() const;
+
+private:
+    friend RenderKernel selectKernel(const RenderFormat& format);
+
+    Fn fn_{nullptr};
+    RenderFormat format_;
+    bool specialized_{false};
+};
+
+/// Kernel for @p format; empty (false) for unsupported bit depths or
+/// channel counts
+RenderKernel selectKernel(const RenderFormat& format);
+
+/// Normalized float back to integer PCM of @p bits (16, or 24/32 in a
+/// 32-bit container), scaled by @p gain and clamped to full scale: after a
+/// mix or a filter the float signal may pass 1.
+void toNative(const float* in, void* out, size_t samples, uint16_t bits, float gain = 1.f);
+
+} // namespace playout
@@ -0,0 +1,242 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "source_mixer.hpp"
+
+// Standard headers
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace playout
+{
+
+namespace
+{
+
+/// Samples per vector loop: a fixed trip count the compiler vectorizes at -O2
+static constexpr size_t BLOCK = 64;
+
+
+std::chrono::nanoseconds framesToTime(uint64_t frames, uint32_t rate)
+{
+    return std::chrono::nanoseconds(static_cast<int64_t>(frames) * 1000000000 / std::max<uint32_t>(rate, 1));
+}
+
+} // namespace
+
+
+SourceMixer::Source::Source(const SourceMixer& mixer, size_t capacityFrames)
+    : mixer_(mixer), capacityFrames_(capacityFrames), ring_(capacityFrames * mixer.format().channels)
+{
+}
+
+
+uint32_t SourceMixer::Source::queued() const
+{
+    return static_cast<uint32_t>(writeFrame_.load(std::memory_order_acquire) - readFrame_.load(std::memory_order_acquire));
+}
+
+
+uint32_t SourceMixer::Source::writable() const
+{
+    return static_cast<uint32_t>(capacityFrames_) - queued();
+}
+
+
+uint32_t SourceMixer::Source::write(const float* pcm, uint32_t frames)
+{
+    const uint64_t write = writeFrame_.load(std::memory_order_relaxed);
+    const uint64_t read = readFrame_.load(std::memory_order_acquire);
+    frames = std::min(frames, static_cast<uint32_t>(capacityFrames_ - (write - read)));
+    if (frames == 0)
+        return 0;
+
+    const size_t channels = mixer_.format().channels;
+    const size_t offset = write % capacityFrames_;
+    const size_t head = std::min<size_t>(frames, capacityFrames_ - offset);
+    std::memcpy(ring_.data() + offset * channels, pcm, head * channels * sizeof(float));
+    if (head < frames)
+        std::memcpy(ring_.data(), pcm + head * channels, (frames - head) * channels * sizeof(float));
+    writeFrame_.store(write + frames, std::memory_order_release);
+    return frames;
+}
+
+
+SourceMixer::Clock::time_point SourceMixer::Source::nextPlayAt() const
+{
+    const int64_t outputAt = mixer_.outputAt_.load(std::memory_order_acquire);
+    if (outputAt == 0)
+        return Clock::time_point();
+    return Clock::time_point(Clock::duration(outputAt)) + framesToTime(queued(), mixer_.format().rate);
+}
+
+
+void SourceMixer::Source::setGain(float gain)
+{
+    target_.store(std::max(gain, 0.f), std::memory_order_relaxed);
+}
+
+
+SourceMixer::SourceMixer(const Format& format, std::chrono::milliseconds capacity, std::chrono::milliseconds ramp)
+    : format_(format), capacityFrames_(std::max<size_t>(static_cast<size_t>(format.rate) * static_cast<size_t>(capacity.count()) / 1000, 1)),
+      rampFrames_(std::max<uint32_t>(static_cast<uint32_t>(static_cast<uint64_t>(format.rate) * static_cast<uint64_t>(ramp.count()) / 1000), 1))
+{
+}
+
+
+std::shared_ptr<SourceMixer::Source> SourceMixer::add(float gain)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < MAX_MIX_SOURCES; ++i)
+    {
+        if (owners_[i])
+            continue;
+        auto source = std::make_shared<Source>(*this, capacityFrames_);
+        source->setGain(gain);
+        source->current_ = source->rampTarget_ = source->gain();
+        owners_[i] = source;
+        slots_[i].store(source.get(), std::memory_order_release);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        return source;
+    }
+    return nullptr;
+}
+
+
+void SourceMixer::remove(const std::shared_ptr<Source>& source)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < MAX_MIX_SOURCES; ++i)
+    {
+        if (!source || (owners_[i] != source))
+            continue;
+        slots_[i].store(nullptr, std::memory_order_seq_cst);
+        count_.fetch_sub(1, std::memory_order_relaxed);
+        // A mix() that loaded the slot before it was cleared may still read
+        // it: wait until that one has returned (one buffer at most)
+        const uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+        if (epoch % 2 == 1)
+        {
+            while (epoch_.load(std::memory_order_acquire) == epoch)
+                std::this_thread::yield();
+        }
+        owners_[i].reset();
+        return;
+    }
+}
+
+
+void SourceMixer::accumulate(float* out, const float* in, size_t samples, float gain)
+{
+    // Through a local block: out and in provably apart, one vector loop
+    alignas(16) float x[BLOCK];
+    size_t i = 0;
+    for (; i + BLOCK <= samples; i += BLOCK)
+    {
+        std::memcpy(x, in + i, sizeof(x));
+        float* o = out + i;
+        for (size_t j = 0; j < BLOCK; ++j)
+            o[j] += x[j] * gain;
+    }
+    for (; i < samples; ++i)
+        out[i] += in[i] * gain;
+}
+
+
+void SourceMixer::accumulateRamp(float* out, const float* in, uint32_t frames, float gain, float step) const
+{
+    const size_t channels = format_.channels;
+    const size_t samples = static_cast<size_t>(frames) * channels;
+    alignas(16) float x[BLOCK];
+    alignas(16) float g[BLOCK];
+    size_t i = 0;
+    // Per-sample gains of a block, then one vector loop over it
+    for (; i + BLOCK <= samples; i += BLOCK)
+    {
+        for (size_t j = 0; j < BLOCK; ++j)
+            g[j] = gain + step * static_cast<float>((i + j) / channels);
+        std::memcpy(x, in + i, sizeof(x));
+        float* o = out + i;
+        for (size_t j = 0; j < BLOCK; ++j)
+            o[j] += x[j] * g[j];
+    }
+    for (; i < samples; ++i)
+        out[i] += in[i] * (gain + step * static_cast<float>(i / channels));
+}
+
+
+void SourceMixer::mixSource(Source& source, float* out, uint32_t frames)
+{
+    const size_t channels = format_.channels;
+    const uint64_t read = source.readFrame_.load(std::memory_order_relaxed);
+    const uint64_t write = source.writeFrame_.load(std::memory_order_acquire);
+    const uint32_t available = static_cast<uint32_t>(std::min<uint64_t>(write - read, frames));
+    if ((available < frames) && (write > 0))
+        source.underrunFrames_.fetch_add(frames - available, std::memory_order_relaxed);
+
+    const float target = source.target_.load(std::memory_order_relaxed);
+    if (target != source.rampTarget_)
+    {
+        source.rampTarget_ = target;
+        source.rampLeft_ = rampFrames_;
+        source.rampStep_ = (target - source.current_) / static_cast<float>(rampFrames_);
+    }
+
+    // The ring in up to two pieces; a missing tail is silence, the ramp
+    // goes on through it
+    uint32_t done = 0;
+    while (done < frames)
+    {
+        const uint64_t frame = read + done;
+        const size_t offset = frame % source.capacityFrames_;
+        uint32_t run = (done < available) ? static_cast<uint32_t>(std::min<uint64_t>(available - done, source.capacityFrames_ - offset))
+                                          : frames - done;
+        const bool silent = done >= available;
+        if (source.rampLeft_ > 0)
+        {
+            run = std::min(run, source.rampLeft_);
+            if (!silent)
+                accumulateRamp(out + done * channels, source.ring_.data() + offset * channels, run, source.current_, source.rampStep_);
+            source.rampLeft_ -= run;
+            source.current_ = (source.rampLeft_ == 0) ? source.rampTarget_ : source.current_ + source.rampStep_ * static_cast<float>(run);
+        }
+        else if (!silent && (source.current_ != 0.f))
+        {
+            accumulate(out + done * channels, source.ring_.data() + offset * channels, static_cast<size_t>(run) * channels, source.current_);
+        }
+        done += run;
+    }
+    source.readFrame_.store(read + available, std::memory_order_release);
+}
+
+
+void SourceMixer::mix(float* out, uint32_t frames, Clock::time_point playAt)
+{
+    epoch_.fetch_add(1, std::memory_order_seq_cst);
+    for (auto& slot : slots_)
+    {
+        Source* source = slot.load(std::memory_order_seq_cst);
+        if (source)
+            mixSource(*source, out, frames);
+    }
+    outputAt_.store((playAt + framesToTime(frames, format_.rate)).time_since_epoch().count(), std::memory_order_release);
+    epoch_.fetch_add(1, std::memory_order_release);
+}
+
+} // namespace playout
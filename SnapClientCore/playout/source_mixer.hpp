@@ -0,0 +1,161 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// Standard headers
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace playout
+{
+
+/// Sources one output mixes at most
+static constexpr size_t MAX_MIX_SOURCES = 8;
+
+/// Mixes several streams into one output.
+///
+/// Each source is a single-producer ring of normalized float frames at the
+/// mixer's format, written by the thread that renders its stream; the
+/// output thread adds the sources' next frames to its buffer in mix().
+/// Nothing on the output side locks or allocates: sources sit in a fixed
+/// array of atomic slots, and each ring is read in place.
+///
+/// Every source keeps its own sync: nextPlayAt() is when the next frame it
+/// writes plays (the output's position plus what the source has queued),
+/// which it asks its stream for, as a player asks for its buffer.
+///
+/// A source's gain changes are ramped linearly over @p ramp, so levels can
+/// move without clicks. The sum is plain: a limiter after the mixer keeps
+/// it below full scale.
+class SourceMixer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Format
+    {
+        uint32_t rate{48000};
+        uint16_t channels{2};
+    };
+
+    class Source
+    {
+    public:
+        Source(const SourceMixer& mixer, size_t capacityFrames);
+
+        /// Frames write() takes now
+        uint32_t writable() const;
+        /// Frames written and not yet mixed
+        uint32_t queued() const;
+
+        /// Producer: append up to @p frames interleaved frames, returns how
+        /// many fit. Never waits for the output.
+        uint32_t write(const float* pcm, uint32_t frames);
+
+        /// When the next frame written plays; the epoch while the output
+        /// has not mixed yet
+        Clock::time_point nextPlayAt() const;
+
+        /// Level of the source in the mix, ramped to from the current one
+        void setGain(float gain);
+        float gain() const
+        {
+            return target_.load(std::memory_order_relaxed);
+        }
+
+        /// Frames the output wanted after the source had started and that
+        /// were not there (played as silence)
+        uint64_t underrunFrames() const
+        {
+            return underrunFrames_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        friend class SourceMixer;
+
+        const SourceMixer& mixer_;
+        size_t capacityFrames_;
+        std::vector<float> ring_;
+        std::atomic<uint64_t> writeFrame_{0};
+        std::atomic<uint64_t> readFrame_{0};
+        std::atomic<float> target_{1.f};
+        std::atomic<uint64_t> underrunFrames_{0};
+
+        /// Output thread only: gain now, and the ramp towards target_
+        float current_{1.f};
+        float rampTarget_{1.f};
+        float rampStep_{0.f};
+        uint32_t rampLeft_{0};
+    };
+
+    explicit SourceMixer(const Format& format, std::chrono::milliseconds capacity = std::chrono::milliseconds(400),
+                         std::chrono::milliseconds ramp = std::chrono::milliseconds(20));
+
+    /// A new source with an empty ring, nullptr if MAX_MIX_SOURCES are in
+    std::shared_ptr<Source> add(float gain = 1.f);
+
+    /// Take @p source out; once this returns the output no longer reads it
+    void remove(const std::shared_ptr<Source>& source);
+
+    /// Sources in the mix
+    size_t sources() const
+    {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    /// Output thread: add the sources' next @p frames to @p out (interleaved
+    /// float at format()), whose first frame plays at @p playAt
+    void mix(float* out, uint32_t frames, Clock::time_point playAt);
+
+    const Format& format() const
+    {
+        return format_;
+    }
+
+private:
+    /// Add @p samples of @p in to @p out at a fixed gain
+    static void accumulate(float* out, const float* in, size_t samples, float gain);
+    /// Add @p frames of @p in to @p out with the gain stepping by @p step a frame
+    void accumulateRamp(float* out, const float* in, uint32_t frames, float gain, float step) const;
+    /// Mix @p frames from @p source's ring into @p out, ramping its gain
+    void mixSource(Source& source, float* out, uint32_t frames);
+
+    Format format_;
+    size_t capacityFrames_;
+    uint32_t rampFrames_;
+
+    std::array<std::atomic<Source*>, MAX_MIX_SOURCES> slots_{};
+    std::atomic<size_t> count_{0};
+    /// Odd while the output is in mix(): remove() waits for it to leave
+    std::atomic<uint64_t> epoch_{0};
+    /// When the frame after the last mixed one plays, Clock ticks (0: never)
+    std::atomic<int64_t> outputAt_{0};
+
+    /// Owners of the sources in slots_, for add() and remove()
+    std::mutex mutex_;
+    std::array<std::shared_ptr<Source>, MAX_MIX_SOURCES> owners_;
+};
+
+} // namespace playout
@@ -0,0 +1,276 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "stream_handoff.hpp"
+
+// Standard headers
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace playout
+{
+
+namespace
+{
+
+bool valid(const PcmFormat& format)
+{
+    return (format.rate > 0) && ((format.bits == 16) || (format.bits == 24) || (format.bits == 32)) && (format.channels > 0) &&
+           (format.channels <= MAX_RENDER_CHANNELS);
+}
+
+
+/// First frame with a non-zero sample (@p frames if none)
+uint32_t firstAudible(const float* pcm, uint32_t frames, uint16_t channels)
+{
+    for (uint32_t f = 0; f < frames; ++f)
+    {
+        for (uint16_t c = 0; c < channels; ++c)
+        {
+            if (pcm[f * channels + c] != 0.f)
+                return f;
+        }
+    }
+    return frames;
+}
+
+} // namespace
+
+
+const char* toString(Conversion conversion)
+{
+    switch (conversion)
+    {
+        case Conversion::None:
+            return "none";
+        case Conversion::Convert:
+            return "convert";
+        case Conversion::Unsupported:
+            return "unsupported";
+    }
+    return "unknown";
+}
+
+
+Conversion conversionFor(const PcmFormat& from, const PcmFormat& to)
+{
+    if (!valid(from) || !valid(to) || (from.rate != to.rate))
+        return Conversion::Unsupported;
+    return (from == to) ? Conversion::None : Conversion::Convert;
+}
+
+
+StreamHandoff::StreamHandoff(const PcmFormat& output, uint32_t maxFrames, HandoffOptions options)
+    : output_(output), maxFrames_(std::max<uint32_t>(maxFrames, 1))
+{
+    auto ms = static_cast<uint64_t>(std::max<int64_t>(options.crossfade.count(), 0));
+    fadeFrames_ = static_cast<uint32_t>(ms * output_.rate / 1000);
+    fadeIn_.resize(fadeFrames_);
+    fadeOut_.resize(fadeFrames_);
+    const double quarter = std::acos(-1.) / 2.;
+    for (uint32_t i = 0; i < fadeFrames_; ++i)
+    {
+        double w = (static_cast<double>(i) + 0.5) / fadeFrames_ * quarter;
+        fadeIn_[i] = static_cast<float>(std::sin(w));
+        fadeOut_[i] = static_cast<float>(std::cos(w));
+    }
+
+    old_.resize(static_cast<size_t>(maxFrames_) * output_.channels);
+    new_.resize(old_.size());
+    unity_.fill(1.f);
+    gains_.fill(1.f);
+    native_ = selectKernel({output_.bits, output_.channels, OutputFormat::Native});
+}
+
+
+bool StreamHandoff::assign(Slot& slot, std::shared_ptr<PcmSource> source)
+{
+    slot = Slot{};
+    if (!source || !valid(output_))
+        return false;
+    PcmFormat format = source->format();
+    Conversion conversion = conversionFor(format, output_);
+    if (conversion == Conversion::Unsupported)
+        return false;
+
+    slot.toFloat = selectKernel({format.bits, format.channels, OutputFormat::Float32});
+    if (!slot.toFloat)
+        return false;
+    slot.source = std::move(source);
+    slot.format = format;
+    slot.conversion = conversion;
+    // Scratch sized here, never in render()
+    raw_.resize(std::max(raw_.size(), static_cast<size_t>(maxFrames_) * format.frameBytes()));
+    sourceFloat_.resize(std::max(sourceFloat_.size(), static_cast<size_t>(maxFrames_) * format.channels));
+    return true;
+}
+
+
+bool StreamHandoff::setOutgoing(std::shared_ptr<PcmSource> source)
+{
+    outgoingActive_ = assign(outgoing_, std::move(source));
+    outgoingPlayed_ = false;
+    return outgoingActive_;
+}
+
+
+bool StreamHandoff::setIncoming(std::shared_ptr<PcmSource> source)
+{
+    if (!assign(incoming_, std::move(source)))
+        return false;
+    // Nothing to hand over from: play from the start, no fade-in
+    incomingStarted_ = !outgoingActive_;
+    fadePos_ = incomingStarted_ ? fadeFrames_ : 0;
+    return true;
+}
+
+
+void StreamHandoff::collect()
+{
+    if (!outgoingActive_)
+        outgoing_.source.reset();
+}
+
+
+bool StreamHandoff::readFloat(Slot& slot, float* out, uint32_t frames, std::chrono::microseconds delay)
+{
+    const uint16_t n = output_.channels;
+    const uint16_t in = slot.format.channels;
+    if (!slot.source->read(raw_.data(), frames, delay))
+    {
+        std::fill(out, out + static_cast<size_t>(frames) * n, 0.f);
+        return false;
+    }
+    if (in == n)
+    {
+        slot.toFloat(raw_.data(), out, frames, unity_.data());
+    }
+    else
+    {
+        // Mono is copied to every channel, otherwise channels map by index
+        // and missing ones are silent
+        slot.toFloat(raw_.data(), sourceFloat_.data(), frames, unity_.data());
+        const float* src = sourceFloat_.data();
+        for (uint32_t f = 0; f < frames; ++f)
+        {
+            for (uint16_t c = 0; c < n; ++c)
+                out[f * n + c] = (in == 1) ? src[f] : ((c < in) ? src[f * in + c] : 0.f);
+        }
+    }
+    if (slot.conversion == Conversion::Convert)
+        stats_.convertedFrames += frames;
+    return true;
+}
+
+
+bool StreamHandoff::renderIncoming(void* out, uint32_t frames, std::chrono::microseconds delay, float gain)
+{
+    if (incoming_.conversion == Conversion::None)
+    {
+        if (!incoming_.source->read(out, frames, delay))
+            return false;
+        gains_.fill(gain);
+        native_(out, out, frames, gains_.data());
+        return true;
+    }
+    bool hasAudio = readFloat(incoming_, new_.data(), frames, delay);
+    toNative(new_.data(), out, static_cast<size_t>(frames) * output_.channels, output_.bits, gain);
+    return hasAudio;
+}
+
+
+bool StreamHandoff::render(void* out, uint32_t frames, std::chrono::microseconds delay, float gain)
+{
+    frames = std::min(frames, maxFrames_);
+    const uint16_t n = output_.channels;
+    const size_t samples = static_cast<size_t>(frames) * n;
+    if (!incoming_.source && !outgoingActive_)
+    {
+        std::memset(out, 0, static_cast<size_t>(frames) * output_.frameBytes());
+        return false;
+    }
+    if (incoming_.source && settled())
+        return renderIncoming(out, frames, delay, gain);
+
+    bool oldHas = false;
+    if (outgoingActive_)
+    {
+        oldHas = readFloat(outgoing_, old_.data(), frames, delay);
+        outgoingActive_ = oldHas;
+        outgoingPlayed_ = outgoingPlayed_ || oldHas;
+    }
+
+    // Frames of this buffer before the incoming audio starts
+    uint32_t start = 0;
+    if (incoming_.source)
+    {
+        bool newHas = readFloat(incoming_, new_.data(), frames, delay);
+        if (!incomingStarted_)
+        {
+            start = newHas ? firstAudible(new_.data(), frames, n) : frames;
+            incomingStarted_ = (start < frames);
+        }
+    }
+
+    if (!incomingStarted_)
+    {
+        if (oldHas)
+        {
+            stats_.outgoingFrames += frames;
+            toNative(old_.data(), out, samples, output_.bits, gain);
+        }
+        else
+        {
+            if (outgoingPlayed_)
+                stats_.gapFrames += frames;
+            std::memset(out, 0, static_cast<size_t>(frames) * output_.frameBytes());
+        }
+        return oldHas;
+    }
+
+    if (oldHas)
+        stats_.outgoingFrames += start;
+    else if (outgoingPlayed_)
+        stats_.gapFrames += start;
+
+    // Outgoing at full level up to the start, then both on the quarter waves
+    for (uint32_t f = 0; f < frames; ++f)
+    {
+        float gOld = oldHas ? 1.f : 0.f;
+        float gNew = 0.f;
+        if (f >= start)
+        {
+            uint32_t pos = fadePos_ + (f - start);
+            gNew = (pos < fadeFrames_) ? fadeIn_[pos] : 1.f;
+            gOld = (oldHas && (pos < fadeFrames_)) ? fadeOut_[pos] : 0.f;
+        }
+        for (uint16_t c = 0; c < n; ++c)
+            new_[f * n + c] = old_[f * n + c] * gOld + new_[f * n + c] * gNew;
+    }
+    uint32_t faded = std::min(fadeFrames_ - std::min(fadePos_, fadeFrames_), frames - start);
+    stats_.crossfadeFrames += faded;
+    fadePos_ += faded;
+    if (fadePos_ >= fadeFrames_)
+        outgoingActive_ = false;
+
+    toNative(new_.data(), out, samples, output_.bits, gain);
+    return true;
+}
+
+} // namespace playout
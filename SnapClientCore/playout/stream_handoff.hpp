@@ -0,0 +1,193 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// local headers
+#include "playout/render_kernels.hpp"
+
+// Standard headers
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace playout
+{
+
+/// Interleaved integer PCM, 24 bits in a 32-bit container
+struct PcmFormat
+{
+    uint32_t rate{48000};
+    uint16_t bits{16};
+    uint16_t channels{2};
+
+    size_t frameBytes() const
+    {
+        return static_cast<size_t>(channels) * ((bits == 16) ? 2 : 4);
+    }
+    bool operator==(const PcmFormat& other) const
+    {
+        return (rate == other.rate) && (bits == other.bits) && (channels == other.channels);
+    }
+    bool operator!=(const PcmFormat& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+/// How a source's PCM reaches an output
+enum class Conversion
+{
+    None,         ///< Same format, copied as is
+    Convert,      ///< Sample size and channel count converted in the engine
+    Unsupported,  ///< Different rate (or an invalid format): needs a resampler
+};
+
+const char* toString(Conversion conversion);
+
+Conversion conversionFor(const PcmFormat& from, const PcmFormat& to);
+
+/// Time-synced PCM, e.g. a Snapcast Stream
+class PcmSource
+{
+public:
+    virtual ~PcmSource() = default;
+
+    virtual PcmFormat format() const = 0;
+
+    /// Fill @p frames frames for playout in @p delay. Leading frames may be
+    /// silence when the audio starts inside the buffer.
+    /// @return false (and silence) when there is no audio for that time
+    virtual bool read(void* out, uint32_t frames, std::chrono::microseconds delay) = 0;
+};
+
+struct HandoffOptions
+{
+    /// Equal-power crossfade from the outgoing to the incoming source
+    std::chrono::milliseconds crossfade{20};
+};
+
+/// Output stage across a stream change.
+///
+/// When the server switches a group's stream, the audio already buffered
+/// for the old codec still covers the next second or so, and the new
+/// stream's chunks start where it ends. The handoff keeps playing the
+/// outgoing source until the incoming one has audio, then crossfades from
+/// the first non-silent incoming frame. Sources of another sample size or
+/// channel count are converted to the output format in the engine; a
+/// different rate is refused and the caller reopens its output instead.
+///
+/// Once the outgoing source is done and the incoming one has the output
+/// format, passthrough() is true and render() is a plain read plus gain.
+///
+/// setOutgoing() / setIncoming() before the first render(); render() is
+/// real-time safe (no allocation, no locks).
+class StreamHandoff
+{
+public:
+    struct Stats
+    {
+        uint64_t outgoingFrames{0};  ///< Rendered from the outgoing source alone
+        uint64_t gapFrames{0};       ///< Silence between the outgoing audio and the incoming audio
+        uint64_t crossfadeFrames{0};
+        uint64_t convertedFrames{0};
+    };
+
+    StreamHandoff(const PcmFormat& output, uint32_t maxFrames, HandoffOptions options = {});
+
+    /// Source to play out and fade from.
+    /// @return false if it can't be converted to the output format
+    bool setOutgoing(std::shared_ptr<PcmSource> source);
+    /// Source to fade to. Without an outgoing source it plays right away.
+    /// @return false if it can't be converted to the output format
+    bool setIncoming(std::shared_ptr<PcmSource> source);
+
+    /// Render @p frames (at most maxFrames) in the output format, scaled by
+    /// @p gain. @return false if neither source had audio (out is silence)
+    bool render(void* out, uint32_t frames, std::chrono::microseconds delay, float gain);
+
+    /// The incoming source plays alone in the output format
+    bool passthrough() const
+    {
+        return settled() && (incoming_.conversion == Conversion::None);
+    }
+    /// The crossfade is over and the outgoing source no longer read
+    bool settled() const
+    {
+        return incomingStarted_ && !outgoingActive_ && (fadePos_ >= fadeFrames_);
+    }
+
+    /// Release a finished outgoing source (not from the real-time thread)
+    void collect();
+
+    const PcmFormat& output() const
+    {
+        return output_;
+    }
+    uint32_t crossfadeFrames() const
+    {
+        return fadeFrames_;
+    }
+    const Stats& stats() const
+    {
+        return stats_;
+    }
+
+private:
+    struct Slot
+    {
+        std::shared_ptr<PcmSource> source;
+        PcmFormat format;
+        Conversion conversion{Conversion::Unsupported};
+        RenderKernel toFloat;
+    };
+
+    bool assign(Slot& slot, std::shared_ptr<PcmSource> source);
+    /// Read @p slot into @p out as float in the output channel layout
+    bool readFloat(Slot& slot, float* out, uint32_t frames, std::chrono::microseconds delay);
+    bool renderIncoming(void* out, uint32_t frames, std::chrono::microseconds delay, float gain);
+
+    PcmFormat output_;
+    uint32_t maxFrames_;
+    uint32_t fadeFrames_;
+
+    Slot outgoing_;
+    Slot incoming_;
+    bool outgoingActive_{false};
+    bool outgoingPlayed_{false};
+    bool incomingStarted_{false};
+    uint32_t fadePos_{0};
+
+    /// sin / cos quarter waves over the crossfade
+    std::vector<float> fadeIn_;
+    std::vector<float> fadeOut_;
+    std::vector<uint8_t> raw_;
+    std::vector<float> sourceFloat_;
+    std::vector<float> old_;
+    std::vector<float> new_;
+    RenderKernel native_;  ///< Gain stage of the passthrough path
+    std::array<float, MAX_RENDER_CHANNELS> unity_;
+    std::array<float, MAX_RENDER_CHANNELS> gains_;
+
+    Stats stats_;
+};
+
+} // namespace playout
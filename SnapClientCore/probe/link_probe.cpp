@@ -0,0 +1,407 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "link_probe.hpp"
+
+// local headers
+#include "common/aixlog.hpp"
+#include "timesync/rx_timestamp.hpp"
+
+// 3rd party headers
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/write.hpp>
+
+// Standard headers
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <vector>
+
+namespace probe
+{
+
+static constexpr auto LOG_TAG = "LinkProbe";
+
+using boost::asio::ip::tcp;
+using std::chrono::microseconds;
+
+namespace
+{
+
+/// CodecHeader payload: uint32 length + codec name, then the codec's own header
+std::string codecName(const std::vector<uint8_t>& payload)
+{
+    if (payload.size() < 4)
+        return {};
+    uint32_t len = payload[0] | (payload[1] << 8) | (payload[2] << 16) | (static_cast<uint32_t>(payload[3]) << 24);
+    if (len > payload.size() - 4)
+        return {};
+    return std::string(payload.begin() + 4, payload.begin() + 4 + len);
+}
+
+microseconds percentile(const std::vector<microseconds>& sorted, double p)
+{
+    if (sorted.empty())
+        return microseconds(0);
+    auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+} // namespace
+
+
+struct LinkProbe::Session : std::enable_shared_from_this<Session>
+{
+    Session(boost::asio::io_context& io_context, LinkProbeOptions opts, Handler h)
+        : resolver(io_context), socket(io_context), connectTimer(io_context), windowTimer(io_context), timeTimer(io_context),
+          options(std::move(opts)), handler(std::move(h)), holFilter(options.holFilter)
+    {
+    }
+
+    void start(const Endpoint& endpoint)
+    {
+        startTime = wire::now();
+        connectTimer.expires_after(options.connectTimeout);
+        connectTimer.async_wait([self = shared_from_this()](const boost::system::error_code& ec)
+        {
+            if (!ec)
+                self->finish(ProbeStatus::TimedOut, boost::asio::error::timed_out);
+        });
+
+        resolver.async_resolve(endpoint.host, std::to_string(endpoint.port),
+                               [self = shared_from_this()](const boost::system::error_code& ec, const tcp::resolver::results_type& endpoints)
+        {
+            if (self->done)
+                return;
+            if (ec)
+            {
+                self->finish(ProbeStatus::ResolveFailed, ec);
+                return;
+            }
+            boost::asio::async_connect(self->socket, endpoints, [self](const boost::system::error_code& ec, const tcp::endpoint&)
+            {
+                if (self->done)
+                    return;
+                if (ec)
+                {
+                    self->finish(ProbeStatus::ConnectFailed, ec);
+                    return;
+                }
+                self->onConnected();
+            });
+        });
+    }
+
+    void onConnected()
+    {
+        connectTimer.cancel();
+        quality.connectTime = wire::now() - startTime;
+        boost::system::error_code ec;
+        socket.set_option(tcp::no_delay(true), ec);
+        if (options.kernelTimestamps && !timesync::enableRxTimestamps(socket.native_handle()))
+            LOG(DEBUG, LOG_TAG) << "No kernel receive timestamps, stamping in user space\n";
+
+        helloTime = wire::now();
+        send(wire::encodeHello(nextId++, options.hello, helloTime));
+        readSome();
+        sendTime();
+
+        windowTimer.expires_after(options.receiveWindow);
+        windowTimer.async_wait([self = shared_from_this()](const boost::system::error_code& ec)
+        {
+            if (!ec)
+                self->finish(ProbeStatus::Ok, {});
+        });
+    }
+
+    void sendTime()
+    {
+        if (done || (timeSent >= options.timeSamples))
+            return;
+        timeSent++;
+        timeInFlight = nextId++;
+        inbound.requestSent();
+        send(wire::encodeTime(timeInFlight, wire::now()));
+    }
+
+    void send(std::vector<uint8_t> message)
+    {
+        writeQueue.push_back(std::move(message));
+        if (writeQueue.size() == 1)
+            writeNext();
+    }
+
+    void writeNext()
+    {
+        boost::asio::async_write(socket, boost::asio::buffer(writeQueue.front()), [self = shared_from_this()](const boost::system::error_code& ec, size_t)
+        {
+            if (self->done)
+                return;
+            if (ec)
+            {
+                self->finish(ProbeStatus::NoReply, ec);
+                return;
+            }
+            self->writeQueue.pop_front();
+            if (!self->writeQueue.empty())
+                self->writeNext();
+        });
+    }
+
+    /// Wait for data, then read everything buffered with its kernel receive
+    /// time (or the time of the read if the kernel gave none)
+    void readSome()
+    {
+        socket.async_wait(tcp::socket::wait_read, [self = shared_from_this()](const boost::system::error_code& ec)
+        {
+            if (self->done)
+                return;
+            if (ec)
+            {
+                self->finish(ProbeStatus::NoReply, ec);
+                return;
+            }
+            self->drain();
+        });
+    }
+
+    /// Read what is buffered one message at a time. A read never goes past
+    /// the end of the current message, so its kernel stamp is the arrival of
+    /// the packet that completed it, not of audio queued behind it.
+    void drain()
+    {
+        while (!done)
+        {
+            size_t want = wire::HEADER_SIZE;
+            if (rx.size() >= wire::HEADER_SIZE)
+            {
+                incoming = wire::decodeHeader(rx.data());
+                if (incoming.size > wire::MAX_MESSAGE_SIZE)
+                {
+                    finish(ProbeStatus::NoReply, boost::asio::error::message_size);
+                    return;
+                }
+                want += incoming.size;
+                if (rx.size() == want)
+                {
+                    payload.assign(rx.begin() + wire::HEADER_SIZE, rx.end());
+                    rx.clear();
+                    onMessage(rxTime);
+                    continue;
+                }
+            }
+
+            size_t used = rx.size();
+            rx.resize(want);
+            boost::system::error_code ec;
+            auto received = timesync::receive(socket.native_handle(), rx.data() + used, want - used, ec);
+            rx.resize(used + received.bytes);
+            if (ec == boost::asio::error::would_block)
+                break;
+            if (ec)
+            {
+                finish(ProbeStatus::NoReply, ec);
+                return;
+            }
+            if (received.stamp)
+                quality.kernelTimestamps = true;
+            rxTime = received.stamp.value_or(wire::now());
+        }
+        if (!done)
+            readSome();
+    }
+
+    void onMessage(microseconds now)
+    {
+        const uint64_t size = wire::HEADER_SIZE + incoming.size;
+        quality.bytes += size;
+        auto bin = static_cast<size_t>((now - helloTime) / std::max(options.throughputBin, std::chrono::milliseconds(1)));
+        if (bins.size() <= bin)
+            bins.resize(bin + 1, 0);
+        bins[bin] += size;
+
+        if (incoming.type != wire::kTime)
+            inbound.received(now, size);
+
+        switch (incoming.type)
+        {
+            case wire::kWireChunk:
+                quality.chunks++;
+                break;
+            case wire::kCodecHeader:
+                quality.codec = codecName(payload);
+                break;
+            case wire::kTime:
+            {
+                microseconds latency;
+                if ((incoming.refersTo != timeInFlight) || !wire::decodeTime(payload.data(), payload.size(), latency))
+                    break;
+                auto sample = wire::timeSample(latency, wire::fromTimeval(incoming.sent), now);
+                rtts.push_back(std::max(sample.rtt, microseconds(0)));
+                offsets.push_back(sample.offset);
+                holFilter.add(inbound.reply(now, rtts.back(), sample.offset));
+                timeInFlight = 0;
+
+                timeTimer.expires_after(options.timeInterval);
+                timeTimer.async_wait([self = shared_from_this()](const boost::system::error_code& ec)
+                {
+                    if (!ec)
+                        self->sendTime();
+                });
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    void finish(ProbeStatus status, const boost::system::error_code& ec)
+    {
+        if (done)
+            return;
+        done = true;
+
+        boost::system::error_code ignored;
+        resolver.cancel();
+        socket.close(ignored);
+        connectTimer.cancel();
+        windowTimer.cancel();
+        timeTimer.cancel();
+
+        // A connected link that never answered Time is not usable
+        if ((status == ProbeStatus::Ok) && rtts.empty())
+            status = ProbeStatus::NoReply;
+        quality.status = status;
+        quality.error = ec;
+        computeStats();
+
+        LOG(DEBUG, LOG_TAG) << "Link probe: " << toString(status) << ", " << quality.samples << " samples, rtt median "
+                            << quality.rttMedian.count() << " us, " << quality.throughputKbps << " kbps\n";
+        if (handler)
+        {
+            auto h = std::move(handler);
+            handler = nullptr;
+            h(quality);
+        }
+    }
+
+    void computeStats()
+    {
+        quality.samples = static_cast<int>(rtts.size());
+        if (!rtts.empty())
+        {
+            microseconds jitterSum{0};
+            for (size_t i = 1; i < rtts.size(); ++i)
+                jitterSum += (rtts[i] > rtts[i - 1]) ? (rtts[i] - rtts[i - 1]) : (rtts[i - 1] - rtts[i]);
+            if (rtts.size() > 1)
+                quality.jitter = jitterSum / static_cast<int64_t>(rtts.size() - 1);
+
+            std::vector<microseconds> sorted = rtts;
+            std::sort(sorted.begin(), sorted.end());
+            quality.rttMin = sorted.front();
+            quality.rttMax = sorted.back();
+            quality.rttMedian = percentile(sorted, 0.5);
+            quality.rttP95 = percentile(sorted, 0.95);
+
+            sorted = offsets;
+            std::sort(sorted.begin(), sorted.end());
+            quality.offsetMedian = percentile(sorted, 0.5);
+            double mean = 0;
+            for (auto o : offsets)
+                mean += static_cast<double>(o.count());
+            mean /= static_cast<double>(offsets.size());
+            double var = 0;
+            for (auto o : offsets)
+                var += (static_cast<double>(o.count()) - mean) * (static_cast<double>(o.count()) - mean);
+            quality.offsetStdDev = microseconds(static_cast<int64_t>(std::sqrt(var / static_cast<double>(offsets.size()))));
+            quality.offsetFiltered = holFilter.offset().value_or(quality.offsetMedian);
+            quality.holDiscarded = static_cast<int>(holFilter.stats().discarded);
+        }
+
+        if (helloTime.count() > 0)
+        {
+            double seconds = std::chrono::duration<double>(wire::now() - helloTime).count();
+            if (seconds > 0)
+                quality.throughputKbps = static_cast<double>(quality.bytes) * 8.0 / 1000.0 / seconds;
+            double binSeconds = std::chrono::duration<double>(options.throughputBin).count();
+            // The last bin is partial: only count it if it's the only one
+            size_t fullBins = (bins.size() > 1) ? bins.size() - 1 : bins.size();
+            for (size_t i = 0; (i < fullBins) && (binSeconds > 0); ++i)
+                quality.peakThroughputKbps = std::max(quality.peakThroughputKbps, static_cast<double>(bins[i]) * 8.0 / 1000.0 / binSeconds);
+        }
+    }
+
+    tcp::resolver resolver;
+    tcp::socket socket;
+    boost::asio::steady_timer connectTimer;
+    boost::asio::steady_timer windowTimer;
+    boost::asio::steady_timer timeTimer;
+    LinkProbeOptions options;
+    Handler handler;
+    LinkQuality quality;
+
+    microseconds startTime{0};
+    microseconds helloTime{0};
+    uint16_t nextId{1};
+    uint16_t timeInFlight{0};
+    int timeSent{0};
+    std::vector<microseconds> rtts;
+    std::vector<microseconds> offsets;
+    std::vector<uint64_t> bins;  ///< Bytes received per throughputBin since the Hello
+    timesync::InboundTracker inbound;
+    timesync::HolFilter holFilter;
+
+    std::deque<std::vector<uint8_t>> writeQueue;
+    std::vector<uint8_t> rx;  ///< The message being read
+    microseconds rxTime{0};   ///< Receive time of its latest read
+    std::vector<uint8_t> payload;
+    wire::Header incoming;
+    bool done{false};
+};
+
+
+LinkProbe::LinkProbe(boost::asio::io_context& io_context) : io_context_(io_context)
+{
+}
+
+
+LinkProbe::~LinkProbe()
+{
+    if (session_)
+        session_->handler = nullptr;
+}
+
+
+void LinkProbe::run(const Endpoint& endpoint, LinkProbeOptions options, Handler handler)
+{
+    cancel();
+    session_ = std::make_shared<Session>(io_context_, std::move(options), std::move(handler));
+    session_->start(endpoint);
+}
+
+
+void LinkProbe::cancel()
+{
+    if (session_)
+        session_->finish(ProbeStatus::Cancelled, boost::asio::error::operation_aborted);
+}
+
+} // namespace probe
@@ -0,0 +1,129 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// local headers
+#include "reachability_prober.hpp"
+#include "stream_wire.hpp"
+#include "timesync/hol_filter.hpp"
+
+// 3rd party headers
+#include <boost/asio/io_context.hpp>
+#include <boost/system/error_code.hpp>
+
+// Standard headers
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace probe
+{
+
+struct LinkProbeOptions
+{
+    /// Hello identity. Use the app's own client ID (the server stores it).
+    wire::HelloInfo hello;
+    /// Number of Time exchanges, one in flight at a time
+    int timeSamples{20};
+    /// Spacing between Time requests
+    std::chrono::milliseconds timeInterval{25};
+    /// How long audio is received after the Hello (Time runs in parallel)
+    std::chrono::milliseconds receiveWindow{1000};
+    /// Throughput is also reported for the best bin of this size
+    std::chrono::milliseconds throughputBin{100};
+    /// Connect timeout
+    std::chrono::milliseconds connectTimeout{2000};
+    /// Take Time reply receive times from the kernel (SO_TIMESTAMPNS /
+    /// SO_TIMESTAMP) instead of after the read; falls back if unsupported
+    bool kernelTimestamps{true};
+    /// Head-of-line filtering of the Time samples for offsetFiltered
+    timesync::HolFilterOptions holFilter;
+};
+
+/// Result of a link quality probe. Durations are in microseconds.
+struct LinkQuality
+{
+    ProbeStatus status{ProbeStatus::TimedOut};
+    boost::system::error_code error;
+    std::chrono::microseconds connectTime{0};
+
+    /// Round trip of the Time exchanges, while audio is flowing
+    int samples{0};
+    std::chrono::microseconds rttMin{0};
+    std::chrono::microseconds rttMedian{0};
+    std::chrono::microseconds rttP95{0};
+    std::chrono::microseconds rttMax{0};
+    /// Mean absolute difference of consecutive RTTs (RFC 3550 style)
+    std::chrono::microseconds jitter{0};
+
+    /// Server clock - client clock, and its standard deviation across samples.
+    /// A large deviation means the time sync will need many samples.
+    std::chrono::microseconds offsetMedian{0};
+    std::chrono::microseconds offsetStdDev{0};
+    /// Offset with Time replies that queued behind audio discarded and slow
+    /// ones down-weighted. Prefer it over offsetMedian to seed a clock.
+    std::chrono::microseconds offsetFiltered{0};
+    /// Time replies discarded as head-of-line delayed
+    int holDiscarded{0};
+    /// Receive times came from the kernel, not from the io thread
+    bool kernelTimestamps{false};
+
+    /// Everything received during the window (headers included)
+    uint64_t bytes{0};
+    uint32_t chunks{0};
+    std::string codec;  ///< From the CodecHeader, empty if none arrived
+    double throughputKbps{0};      ///< Over the whole receive window
+    double peakThroughputKbps{0};  ///< Best throughputBin (the server's initial buffer burst)
+};
+
+/// Protocol-level link quality probe.
+///
+/// Connects to the stream port, sends a real Hello so the server starts
+/// streaming, and then does two things at once for receiveWindow:
+/// - it counts the audio bytes received;
+/// - it sends a burst of Time requests, one at a time.
+/// The Time replies queue behind the audio, so the RTT and jitter reflect a
+/// link carrying a stream, not an idle one.
+///
+/// The io_context must be run by a single thread; the handler is invoked on
+/// it exactly once. Destroy only after the handler ran or the io_context
+/// stopped.
+class LinkProbe
+{
+public:
+    using Handler = std::function<void(const LinkQuality& quality)>;
+
+    explicit LinkProbe(boost::asio::io_context& io_context);
+    ~LinkProbe();
+
+    void run(const Endpoint& endpoint, LinkProbeOptions options, Handler handler);
+
+    /// Stop now, the handler gets the measurements so far
+    void cancel();
+
+private:
+    struct Session;
+
+    boost::asio::io_context& io_context_;
+    std::shared_ptr<Session> session_;
+};
+
+} // namespace probe
@@ -0,0 +1,347 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "reachability_prober.hpp"
+
+// local headers
+#include "common/aixlog.hpp"
+
+// 3rd party headers
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/write.hpp>
+
+// Standard headers
+#include <algorithm>
+#include <array>
+
+namespace probe
+{
+
+static constexpr auto LOG_TAG = "Prober";
+
+using boost::asio::ip::tcp;
+
+/// One endpoint's probe (owned by its Run)
+struct ReachabilityProber::Attempt
+{
+    explicit Attempt(boost::asio::io_context& io_context) : resolver(io_context), socket(io_context) {}
+
+    tcp::resolver resolver;
+    tcp::socket socket;
+    std::vector<uint8_t> request;
+    std::array<uint8_t, wire::HEADER_SIZE> header{};
+    std::vector<uint8_t> payload;
+    wire::Header incoming;
+    bool connected{false};
+    bool finished{false};
+};
+
+
+/// State of one probe() call. Every async handler holds a shared_ptr to it.
+struct ReachabilityProber::Run : std::enable_shared_from_this<Run>
+{
+    static constexpr uint16_t HELLO_ID = 1;
+    static constexpr uint16_t TIME_ID = 2;
+
+    Run(boost::asio::io_context& io_context, ReachabilityOptions opts, Handler h)
+        : io(io_context), deadlineTimer(io_context), graceTimer(io_context), options(std::move(opts)), handler(std::move(h))
+    {
+    }
+
+    void start(std::vector<Endpoint> endpoints)
+    {
+        startTime = wire::now();
+        results.resize(endpoints.size());
+        for (size_t i = 0; i < endpoints.size(); ++i)
+        {
+            results[i].index = i;
+            results[i].endpoint = std::move(endpoints[i]);
+            attempts.push_back(std::make_unique<Attempt>(io));
+        }
+        remaining = results.size();
+        if (remaining == 0)
+        {
+            finish(ProbeStatus::Cancelled);
+            return;
+        }
+
+        deadlineTimer.expires_after(options.deadline);
+        deadlineTimer.async_wait([self = shared_from_this()](const boost::system::error_code& ec)
+        {
+            if (!ec)
+                self->finish(ProbeStatus::TimedOut);
+        });
+
+        for (size_t i = 0; i < results.size(); ++i)
+            resolve(i);
+    }
+
+    void resolve(size_t i)
+    {
+        const Endpoint& ep = results[i].endpoint;
+        attempts[i]->resolver.async_resolve(ep.host, std::to_string(ep.port),
+                                            [self = shared_from_this(), i](const boost::system::error_code& ec, const tcp::resolver::results_type& endpoints)
+        {
+            if (self->done)
+                return;
+            if (ec)
+            {
+                self->complete(i, ProbeStatus::ResolveFailed, ec);
+                return;
+            }
+            boost::asio::async_connect(self->attempts[i]->socket, endpoints,
+                                       [self, i](const boost::system::error_code& ec, const tcp::endpoint&)
+            {
+                if (self->done)
+                    return;
+                if (ec)
+                {
+                    self->complete(i, ProbeStatus::ConnectFailed, ec);
+                    return;
+                }
+                self->onConnected(i);
+            });
+        });
+    }
+
+    void onConnected(size_t i)
+    {
+        Attempt& a = *attempts[i];
+        a.connected = true;
+        results[i].connectTime = wire::now() - startTime;
+
+        boost::system::error_code ec;
+        a.socket.set_option(tcp::no_delay(true), ec);
+
+        if (options.sendHello)
+            a.request = wire::encodeHello(HELLO_ID, options.hello, wire::now());
+        auto time = wire::encodeTime(TIME_ID, wire::now());
+        a.request.insert(a.request.end(), time.begin(), time.end());
+
+        boost::asio::async_write(a.socket, boost::asio::buffer(a.request), [self = shared_from_this(), i](const boost::system::error_code& ec, size_t)
+        {
+            if (self->done)
+                return;
+            if (ec)
+            {
+                self->complete(i, ProbeStatus::NoReply, ec);
+                return;
+            }
+            self->readHeader(i);
+        });
+    }
+
+    void readHeader(size_t i)
+    {
+        Attempt& a = *attempts[i];
+        boost::asio::async_read(a.socket, boost::asio::buffer(a.header), [self = shared_from_this(), i](const boost::system::error_code& ec, size_t)
+        {
+            if (self->done)
+                return;
+            if (ec)
+            {
+                self->complete(i, ProbeStatus::NoReply, ec);
+                return;
+            }
+            Attempt& a = *self->attempts[i];
+            a.incoming = wire::decodeHeader(a.header.data());
+            if (a.incoming.size > wire::MAX_MESSAGE_SIZE)
+            {
+                self->complete(i, ProbeStatus::NoReply, boost::asio::error::message_size);
+                return;
+            }
+            self->readPayload(i);
+        });
+    }
+
+    void readPayload(size_t i)
+    {
+        Attempt& a = *attempts[i];
+        a.payload.resize(a.incoming.size);
+        boost::asio::async_read(a.socket, boost::asio::buffer(a.payload), [self = shared_from_this(), i](const boost::system::error_code& ec, size_t)
+        {
+            if (self->done)
+                return;
+            if (ec)
+            {
+                self->complete(i, ProbeStatus::NoReply, ec);
+                return;
+            }
+            Attempt& a = *self->attempts[i];
+            std::chrono::microseconds latency;
+            // Anything else (ServerSettings, CodecHeader after a Hello) is skipped
+            if ((a.incoming.type != wire::kTime) || (a.incoming.refersTo != TIME_ID) ||
+                !wire::decodeTime(a.payload.data(), a.payload.size(), latency))
+            {
+                self->readHeader(i);
+                return;
+            }
+            auto sample = wire::timeSample(latency, wire::fromTimeval(a.incoming.sent), wire::now());
+            self->results[i].rtt = std::max(sample.rtt, std::chrono::microseconds(0));
+            self->complete(i, ProbeStatus::Ok, {});
+        });
+    }
+
+    void complete(size_t i, ProbeStatus status, const boost::system::error_code& ec)
+    {
+        Attempt& a = *attempts[i];
+        if (a.finished)
+            return;
+        a.finished = true;
+        results[i].status = status;
+        results[i].error = ec;
+        boost::system::error_code ignored;
+        a.socket.close(ignored);
+
+        if (--remaining == 0)
+        {
+            finish(ProbeStatus::Cancelled);
+            return;
+        }
+        if ((status == ProbeStatus::Ok) && !graceArmed)
+        {
+            graceArmed = true;
+            graceTimer.expires_after(options.grace);
+            graceTimer.async_wait([self = shared_from_this()](const boost::system::error_code& ec)
+            {
+                if (!ec)
+                    self->finish(ProbeStatus::Cancelled);
+            });
+        }
+    }
+
+    /// @param unfinished  status for probes still running (TimedOut at the deadline)
+    void finish(ProbeStatus unfinished)
+    {
+        if (done)
+            return;
+        done = true;
+        deadlineTimer.cancel();
+        graceTimer.cancel();
+
+        for (size_t i = 0; i < attempts.size(); ++i)
+        {
+            Attempt& a = *attempts[i];
+            if (!a.finished)
+            {
+                ProbeStatus status = unfinished;
+                if ((status == ProbeStatus::TimedOut) && a.connected)
+                    status = ProbeStatus::NoReply;
+                results[i].status = status;
+                results[i].error = boost::asio::error::timed_out;
+                a.finished = true;
+            }
+            boost::system::error_code ignored;
+            a.resolver.cancel();
+            a.socket.close(ignored);
+        }
+
+        rankResults(results);
+        if (handler)
+        {
+            auto h = std::move(handler);
+            handler = nullptr;
+            h(std::move(results));
+        }
+    }
+
+    boost::asio::io_context& io;
+    boost::asio::steady_timer deadlineTimer;
+    boost::asio::steady_timer graceTimer;
+    ReachabilityOptions options;
+    Handler handler;
+
+    std::chrono::microseconds startTime{0};
+    std::vector<ReachabilityResult> results;
+    std::vector<std::unique_ptr<Attempt>> attempts;
+    size_t remaining{0};
+    bool graceArmed{false};
+    bool done{false};
+};
+
+
+ReachabilityProber::ReachabilityProber(boost::asio::io_context& io_context) : io_context_(io_context)
+{
+}
+
+
+ReachabilityProber::~ReachabilityProber()
+{
+    if (run_)
+        run_->handler = nullptr;
+}
+
+
+void ReachabilityProber::probe(std::vector<Endpoint> endpoints, ReachabilityOptions options, Handler handler)
+{
+    if (run_)
+        run_->finish(ProbeStatus::Cancelled);
+
+    LOG(DEBUG, LOG_TAG) << "Probing " << endpoints.size() << " endpoints, deadline " << options.deadline.count() << " ms\n";
+    run_ = std::make_shared<Run>(io_context_, std::move(options), std::move(handler));
+    run_->start(std::move(endpoints));
+}
+
+
+void ReachabilityProber::cancel()
+{
+    if (run_)
+        run_->finish(ProbeStatus::Cancelled);
+}
+
+
+void rankResults(std::vector<ReachabilityResult>& results)
+{
+    std::stable_sort(results.begin(), results.end(), [](const ReachabilityResult& a, const ReachabilityResult& b)
+    {
+        if (a.reachable() != b.reachable())
+            return a.reachable();
+        if (!a.reachable())
+            return a.index < b.index;
+        if (a.rtt != b.rtt)
+            return a.rtt < b.rtt;
+        return a.connectTime < b.connectTime;
+    });
+}
+
+
+const char* toString(ProbeStatus status)
+{
+    switch (status)
+    {
+        case ProbeStatus::Ok:
+            return "ok";
+        case ProbeStatus::ResolveFailed:
+            return "resolve failed";
+        case ProbeStatus::ConnectFailed:
+            return "connect failed";
+        case ProbeStatus::NoReply:
+            return "no reply";
+        case ProbeStatus::TimedOut:
+            return "timed out";
+        case ProbeStatus::Cancelled:
+            return "cancelled";
+    }
+    return "unknown";
+}
+
+} // namespace probe
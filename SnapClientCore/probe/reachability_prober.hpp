@@ -0,0 +1,121 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// local headers
+#include "stream_wire.hpp"
+
+// 3rd party headers
+#include <boost/asio/io_context.hpp>
+#include <boost/system/error_code.hpp>
+
+// Standard headers
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace probe
+{
+
+/// Default port of the Snapcast stream protocol
+static constexpr uint16_t STREAM_TCP_PORT = 1704;
+
+struct Endpoint
+{
+    std::string host;
+    uint16_t port{STREAM_TCP_PORT};
+};
+
+enum class ProbeStatus
+{
+    Ok,             ///< Connected and answered a Time request
+    ResolveFailed,
+    ConnectFailed,  ///< Refused, unreachable, ...
+    NoReply,        ///< Connected, but no Time reply before the deadline
+    TimedOut,       ///< Connect did not complete before the deadline
+    Cancelled,      ///< The run ended (grace period, cancel()) before this probe did
+};
+
+struct ReachabilityResult
+{
+    size_t index{0};  ///< Position in the endpoint list passed to probe()
+    Endpoint endpoint;
+    ProbeStatus status{ProbeStatus::TimedOut};
+    boost::system::error_code error;
+    std::chrono::microseconds connectTime{0};  ///< Start of the probe until TCP connected
+    std::chrono::microseconds rtt{0};          ///< Time request round trip, server processing excluded
+
+    bool reachable() const { return status == ProbeStatus::Ok; }
+};
+
+struct ReachabilityOptions
+{
+    /// Hard limit for the whole run, whatever the endpoints do
+    std::chrono::milliseconds deadline{2000};
+    /// After the first endpoint answered, wait this long for the others, then
+    /// rank what we have. Servers slower than that would not be chosen anyway.
+    std::chrono::milliseconds grace{100};
+    /// Send a Hello before the Time request. Not needed for Time; note that
+    /// the server adds the Hello's client ID to its configuration.
+    bool sendHello{false};
+    wire::HelloInfo hello;
+};
+
+/// Concurrent reachability prober for Snapcast servers.
+///
+/// All endpoints are resolved, connected and sent a Time request at the same
+/// time on the caller's io_context. The run ends when every probe finished,
+/// at the deadline, or once the grace period after the first answer expired.
+/// Results are ranked: reachable endpoints by RTT (then connect time), then
+/// the unreachable ones in input order.
+///
+/// The io_context must be run by a single thread; the handler is invoked on
+/// it. One run at a time: probe() cancels a run in progress (its handler is
+/// still called, with what it has).
+class ReachabilityProber
+{
+public:
+    using Handler = std::function<void(std::vector<ReachabilityResult> ranked)>;
+
+    explicit ReachabilityProber(boost::asio::io_context& io_context);
+    /// Abandons a run in progress without calling its handler
+    ~ReachabilityProber();
+
+    void probe(std::vector<Endpoint> endpoints, ReachabilityOptions options, Handler handler);
+
+    /// End the current run now, the handler gets the results so far
+    void cancel();
+
+private:
+    struct Run;
+    struct Attempt;
+
+    boost::asio::io_context& io_context_;
+    std::shared_ptr<Run> run_;
+};
+
+/// Rank results in place (see ReachabilityProber)
+void rankResults(std::vector<ReachabilityResult>& results);
+
+const char* toString(ProbeStatus status);
+
+} // namespace probe
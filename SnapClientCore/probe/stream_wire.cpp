@@ -0,0 +1,214 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "stream_wire.hpp"
+
+// local headers
+#include "common/json.hpp"
+
+// Standard headers
+#include <algorithm>
+
+namespace probe::wire
+{
+
+namespace
+{
+
+void put16(uint8_t* p, uint16_t v)
+{
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+void put32(uint8_t* p, uint32_t v)
+{
+    for (int i = 0; i < 4; ++i)
+        p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+uint16_t get16(const uint8_t* p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t get32(const uint8_t* p)
+{
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void putTimeval(uint8_t* p, const Timeval& tv)
+{
+    put32(p, static_cast<uint32_t>(tv.sec));
+    put32(p + 4, static_cast<uint32_t>(tv.usec));
+}
+
+Timeval getTimeval(const uint8_t* p)
+{
+    return {static_cast<int32_t>(get32(p)), static_cast<int32_t>(get32(p + 4))};
+}
+
+std::vector<uint8_t> encode(const Header& header, const uint8_t* payload, size_t size)
+{
+    std::vector<uint8_t> out(HEADER_SIZE + size);
+    Header h = header;
+    h.size = static_cast<uint32_t>(size);
+    encodeHeader(h, out.data());
+    if (size > 0)
+        std::copy(payload, payload + size, out.begin() + HEADER_SIZE);
+    return out;
+}
+
+} // namespace
+
+
+std::chrono::microseconds now()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch());
+}
+
+
+Timeval toTimeval(std::chrono::microseconds t)
+{
+    auto sec = std::chrono::duration_cast<std::chrono::seconds>(t);
+    if (t < sec)  // Negative values: keep usec in [0, 1e6)
+        sec -= std::chrono::seconds(1);
+    return {static_cast<int32_t>(sec.count()), static_cast<int32_t>((t - sec).count())};
+}
+
+
+std::chrono::microseconds fromTimeval(const Timeval& tv)
+{
+    return std::chrono::seconds(tv.sec) + std::chrono::microseconds(tv.usec);
+}
+
+
+void encodeHeader(const Header& header, uint8_t* out)
+{
+    put16(out, header.type);
+    put16(out + 2, header.id);
+    put16(out + 4, header.refersTo);
+    putTimeval(out + 6, header.sent);
+    putTimeval(out + 14, header.received);
+    put32(out + 22, header.size);
+}
+
+
+Header decodeHeader(const uint8_t* in)
+{
+    Header h;
+    h.type = get16(in);
+    h.id = get16(in + 2);
+    h.refersTo = get16(in + 4);
+    h.sent = getTimeval(in + 6);
+    h.received = getTimeval(in + 14);
+    h.size = get32(in + 22);
+    return h;
+}
+
+
+std::vector<uint8_t> encodeTime(uint16_t id, std::chrono::microseconds sent)
+{
+    return encodeTimeReply(id, 0, std::chrono::microseconds(0), sent);
+}
+
+
+void encodeTime(uint16_t id, std::chrono::microseconds sent, uint8_t* out)
+{
+    Header h;
+    h.type = kTime;
+    h.id = id;
+    h.sent = toTimeval(sent);
+    h.size = TIME_MESSAGE_SIZE - HEADER_SIZE;
+    encodeHeader(h, out);
+    putTimeval(out + HEADER_SIZE, {});
+}
+
+
+std::vector<uint8_t> encodeTimeReply(uint16_t id, uint16_t refersTo, std::chrono::microseconds latency, std::chrono::microseconds sent)
+{
+    Header h;
+    h.type = kTime;
+    h.id = id;
+    h.refersTo = refersTo;
+    h.sent = toTimeval(sent);
+    uint8_t payload[8];
+    putTimeval(payload, toTimeval(latency));
+    return encode(h, payload, sizeof(payload));
+}
+
+
+void encodeTimeReply(uint16_t id, uint16_t refersTo, std::chrono::microseconds latency, std::chrono::microseconds sent, uint8_t* out)
+{
+    Header h;
+    h.type = kTime;
+    h.id = id;
+    h.refersTo = refersTo;
+    h.sent = toTimeval(sent);
+    h.size = TIME_MESSAGE_SIZE - HEADER_SIZE;
+    encodeHeader(h, out);
+    putTimeval(out + HEADER_SIZE, toTimeval(latency));
+}
+
+
+std::vector<uint8_t> encodeHello(uint16_t id, const HelloInfo& info, std::chrono::microseconds sent)
+{
+    nlohmann::json j = {
+        {"Arch", info.arch},
+        {"ClientName", info.clientName},
+        {"HostName", info.hostName},
+        {"ID", info.id},
+        {"Instance", info.instance},
+        {"MAC", info.id},
+        {"OS", info.os},
+        {"SnapStreamProtocolVersion", 2},
+        {"Version", info.version},
+    };
+    const std::string text = j.dump();
+
+    // JsonMessage payload: uint32 length + JSON text
+    std::vector<uint8_t> payload(4 + text.size());
+    put32(payload.data(), static_cast<uint32_t>(text.size()));
+    std::copy(text.begin(), text.end(), payload.begin() + 4);
+
+    Header h;
+    h.type = kHello;
+    h.id = id;
+    h.sent = toTimeval(sent);
+    return encode(h, payload.data(), payload.size());
+}
+
+
+bool decodeTime(const uint8_t* payload, size_t size, std::chrono::microseconds& latency)
+{
+    if (size < 8)
+        return false;
+    latency = fromTimeval(getTimeval(payload));
+    return true;
+}
+
+
+TimeSample timeSample(std::chrono::microseconds latency, std::chrono::microseconds sent, std::chrono::microseconds received)
+{
+    const std::chrono::microseconds c2s = latency;
+    const std::chrono::microseconds s2c = received - sent;
+    return {c2s + s2c, (c2s - s2c) / 2};
+}
+
+} // namespace probe::wire
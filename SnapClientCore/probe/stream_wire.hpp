@@ -0,0 +1,126 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// Standard headers
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Minimal codec for the Snapcast stream protocol (port 1704).
+///
+/// Only what the probes need: the 26-byte base header, Hello and Time.
+/// Keeping it separate from the Snapcast client library means a probe never
+/// touches the Controller, TimeProvider or player singletons.
+///
+/// All fields are little-endian. Timestamps are steady-clock times: each side
+/// uses its own clock, the offset between them is what Time measures.
+namespace probe::wire
+{
+
+enum MessageType : uint16_t
+{
+    kCodecHeader = 1,
+    kWireChunk = 2,
+    kServerSettings = 3,
+    kTime = 4,
+    kHello = 5,
+};
+
+static constexpr size_t HEADER_SIZE = 26;
+/// Upper bound for a message we are willing to read (chunks are a few KB)
+static constexpr uint32_t MAX_MESSAGE_SIZE = 1024 * 1024;
+/// Time request or reply: header + latency Timeval
+static constexpr size_t TIME_MESSAGE_SIZE = HEADER_SIZE + 8;
+
+struct Timeval
+{
+    int32_t sec{0};
+    int32_t usec{0};
+};
+
+struct Header
+{
+    uint16_t type{0};
+    uint16_t id{0};
+    uint16_t refersTo{0};
+    Timeval sent;
+    Timeval received;
+    uint32_t size{0};
+};
+
+/// Identity sent in Hello. Use the app's own client ID: the server adds every
+/// new ID to its client list.
+struct HelloInfo
+{
+    std::string id;
+    std::string hostName;
+    std::string clientName{"SnapForge"};
+    std::string version;
+    std::string os{"iOS"};
+    std::string arch{"arm64"};
+    int instance{1};
+};
+
+/// Current steady-clock time, the time base of all probe timestamps
+std::chrono::microseconds now();
+
+Timeval toTimeval(std::chrono::microseconds t);
+std::chrono::microseconds fromTimeval(const Timeval& tv);
+
+void encodeHeader(const Header& header, uint8_t* out);
+Header decodeHeader(const uint8_t* in);
+
+/// Encode a Time request stamped with @p sent
+std::vector<uint8_t> encodeTime(uint16_t id, std::chrono::microseconds sent);
+
+/// Encode a Time request into @p out (TIME_MESSAGE_SIZE bytes), no allocation
+void encodeTime(uint16_t id, std::chrono::microseconds sent, uint8_t* out);
+
+/// Encode a Hello message
+std::vector<uint8_t> encodeHello(uint16_t id, const HelloInfo& info, std::chrono::microseconds sent);
+
+/// Encode a Time reply (used by mock servers in tests)
+std::vector<uint8_t> encodeTimeReply(uint16_t id, uint16_t refersTo, std::chrono::microseconds latency, std::chrono::microseconds sent);
+
+/// Encode a Time reply into @p out (TIME_MESSAGE_SIZE bytes), no allocation
+void encodeTimeReply(uint16_t id, uint16_t refersTo, std::chrono::microseconds latency, std::chrono::microseconds sent, uint8_t* out);
+
+/// Decode the payload of a Time message
+/// @return false if the payload is too short
+bool decodeTime(const uint8_t* payload, size_t size, std::chrono::microseconds& latency);
+
+/// One clock sample from a Time reply.
+///
+/// c2s = server receive - client send (includes the clock offset),
+/// s2c = client receive - server send (includes minus the offset).
+struct TimeSample
+{
+    std::chrono::microseconds rtt;     ///< Round trip without server processing time
+    std::chrono::microseconds offset;  ///< Server clock - client clock
+};
+
+/// @param latency   latency field of the reply (c2s)
+/// @param sent      reply header's sent time (server clock)
+/// @param received  our receive time (client clock)
+TimeSample timeSample(std::chrono::microseconds latency, std::chrono::microseconds sent, std::chrono::microseconds received);
+
+} // namespace probe::wire
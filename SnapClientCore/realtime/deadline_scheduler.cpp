@@ -0,0 +1,261 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "deadline_scheduler.hpp"
+
+// local headers
+#include "common/aixlog.hpp"
+
+// Standard headers
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#include <mach/mach_time.h>
+#include <mach/thread_policy.h>
+#elif defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace realtime
+{
+
+static constexpr auto LOG_TAG = "DeadlineScheduler";
+
+using namespace std::chrono;
+
+
+nanoseconds BufferGeometry::period() const
+{
+    if (!valid())
+        return nanoseconds(0);
+    return nanoseconds(static_cast<int64_t>(framesPerBuffer) * 1'000'000'000 / sampleRate);
+}
+
+
+DeadlinePolicy policyFor(const BufferGeometry& geometry, const PolicyOptions& options)
+{
+    DeadlinePolicy policy;
+    policy.period = geometry.period();
+    if (policy.period.count() == 0)
+        return policy;
+
+    auto share = [&](double fraction) { return nanoseconds(static_cast<int64_t>(static_cast<double>(policy.period.count()) * fraction)); };
+    policy.computation = std::clamp(share(options.computationShare), options.minComputation, options.maxComputation);
+    // computation <= constraint <= period, as every backend requires
+    policy.constraint = std::clamp(share(options.constraintShare), policy.computation, policy.period);
+    policy.computation = std::min(policy.computation, policy.period);
+    return policy;
+}
+
+
+const char* toString(Backend backend)
+{
+    switch (backend)
+    {
+        case Backend::None:
+            return "none";
+        case Backend::TimeConstraint:
+            return "time-constraint";
+        case Backend::Deadline:
+            return "SCHED_DEADLINE";
+        case Backend::Fifo:
+            return "SCHED_FIFO";
+    }
+    return "unknown";
+}
+
+
+#if defined(__APPLE__)
+static bool applyTimeConstraint(const DeadlinePolicy& policy)
+{
+    // The policy is in Mach absolute time units, not nanoseconds: 1:1 on
+    // Intel, 125:3 on Apple silicon
+    mach_timebase_info_data_t timebase;
+    if ((mach_timebase_info(&timebase) != KERN_SUCCESS) || (timebase.numer == 0))
+        return false;
+    auto toAbs = [&](nanoseconds ns) { return static_cast<uint32_t>(static_cast<uint64_t>(ns.count()) * timebase.denom / timebase.numer); };
+
+    thread_time_constraint_policy_data_t mach_policy;
+    mach_policy.period = toAbs(policy.period);
+    mach_policy.computation = toAbs(policy.computation);
+    mach_policy.constraint = toAbs(policy.constraint);
+    mach_policy.preemptible = 1;
+
+    kern_return_t result = thread_policy_set(pthread_mach_thread_np(pthread_self()), THREAD_TIME_CONSTRAINT_POLICY,
+                                             reinterpret_cast<thread_policy_t>(&mach_policy), THREAD_TIME_CONSTRAINT_POLICY_COUNT);
+    if (result != KERN_SUCCESS)
+    {
+        LOG(WARNING, LOG_TAG) << "THREAD_TIME_CONSTRAINT_POLICY failed: " << result << "\n";
+        return false;
+    }
+    return true;
+}
+#endif
+
+
+#if defined(__linux__)
+// Not exported by glibc
+struct SchedAttr
+{
+    uint32_t size;
+    uint32_t sched_policy;
+    uint64_t sched_flags;
+    int32_t sched_nice;
+    uint32_t sched_priority;
+    uint64_t sched_runtime;
+    uint64_t sched_deadline;
+    uint64_t sched_period;
+};
+
+static constexpr uint32_t SCHED_DEADLINE_POLICY = 6;
+
+
+static bool applyDeadline(const DeadlinePolicy& policy)
+{
+    // SCHED_DEADLINE enforces the runtime as a hard budget (the thread is
+    // throttled until the next period once it is used up), while Mach takes
+    // computation as a hint. The budget is therefore the whole constraint,
+    // so a slow fill finishes late instead of being stopped mid-buffer.
+    SchedAttr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.sched_policy = SCHED_DEADLINE_POLICY;
+    attr.sched_runtime = static_cast<uint64_t>(policy.constraint.count());
+    attr.sched_deadline = static_cast<uint64_t>(policy.constraint.count());
+    attr.sched_period = static_cast<uint64_t>(policy.period.count());
+
+    if (syscall(SYS_sched_setattr, 0, &attr, 0) != 0)
+    {
+        LOG(DEBUG, LOG_TAG) << "SCHED_DEADLINE failed: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    return true;
+}
+#endif
+
+
+static bool applyFifo()
+{
+    sched_param param{};
+    param.sched_priority = sched_get_priority_max(SCHED_FIFO);
+    int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (result != 0)
+    {
+        LOG(WARNING, LOG_TAG) << "SCHED_FIFO failed: " << std::strerror(result) << "\n";
+        return false;
+    }
+    return true;
+}
+
+
+Backend applyToCurrentThread(const DeadlinePolicy& policy, bool allowDeadline)
+{
+    if (policy.period.count() == 0)
+        return Backend::None;
+
+#if defined(__APPLE__)
+    (void)allowDeadline;
+    if (applyTimeConstraint(policy))
+        return Backend::TimeConstraint;
+#elif defined(__linux__)
+    if (allowDeadline && applyDeadline(policy))
+        return Backend::Deadline;
+#else
+    (void)allowDeadline;
+#endif
+
+    if (applyFifo())
+        return Backend::Fifo;
+    return Backend::None;
+}
+
+
+void DeadlineMonitor::setPolicy(const DeadlinePolicy& policy)
+{
+    periodNs_.store(policy.period.count(), std::memory_order_relaxed);
+    constraintNs_.store(policy.constraint.count(), std::memory_order_relaxed);
+}
+
+
+void DeadlineMonitor::begin(steady_clock::time_point now)
+{
+    const nanoseconds period(periodNs_.load(std::memory_order_relaxed));
+    // Releases follow the period grid; a start after a gap (first fill,
+    // pause, underrun) or ahead of the grid re-anchors it
+    if ((period.count() == 0) || (release_ == steady_clock::time_point{}) || (now - lastBegin_ > 4 * period))
+        release_ = now;
+    else
+        release_ = std::min(release_ + period, now);
+    lastBegin_ = now;
+}
+
+
+void DeadlineMonitor::end(steady_clock::time_point now)
+{
+    const int64_t constraint = constraintNs_.load(std::memory_order_relaxed);
+    const int64_t response = duration_cast<nanoseconds>(now - release_).count();
+    fills_.fetch_add(1, std::memory_order_relaxed);
+    if ((constraint > 0) && (response > constraint))
+        misses_.fetch_add(1, std::memory_order_relaxed);
+    // Single writer
+    const int64_t responseUs = response / 1000;
+    if (responseUs > worstResponseUs_.load(std::memory_order_relaxed))
+        worstResponseUs_.store(responseUs, std::memory_order_relaxed);
+}
+
+
+void DeadlineMonitor::reset()
+{
+    release_ = {};
+    lastBegin_ = {};
+    fills_.store(0, std::memory_order_relaxed);
+    misses_.store(0, std::memory_order_relaxed);
+    worstResponseUs_.store(0, std::memory_order_relaxed);
+}
+
+
+DeadlineScheduler::DeadlineScheduler(PolicyOptions options, bool allowDeadline) : options_(options), allowDeadline_(allowDeadline)
+{
+}
+
+
+bool DeadlineScheduler::update(const BufferGeometry& geometry)
+{
+    if (!geometry.valid() || ((geometry == geometry_) && (backend_ != Backend::None)))
+        return false;
+
+    DeadlinePolicy policy = policyFor(geometry, options_);
+    Backend backend = applyToCurrentThread(policy, allowDeadline_);
+    LOG(INFO, LOG_TAG) << "Buffer " << geometry.framesPerBuffer << " frames @ " << geometry.sampleRate << " Hz x " << geometry.buffers << ": period "
+                       << duration_cast<microseconds>(policy.period).count() << " us, computation " << duration_cast<microseconds>(policy.computation).count()
+                       << " us, constraint " << duration_cast<microseconds>(policy.constraint).count() << " us via " << toString(backend) << "\n";
+
+    geometry_ = geometry;
+    policy_ = policy;
+    backend_ = backend;
+    monitor_.setPolicy(policy);
+    return backend != Backend::None;
+}
+
+} // namespace realtime
@@ -0,0 +1,198 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// Standard headers
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/// Real-time scheduling for the audio thread, derived from the buffer it
+/// has to keep filled.
+///
+/// A fixed policy (say 10 ms of computation within 20 ms, no period) is
+/// wrong for every geometry but one: too loose for small low-latency
+/// buffers, needlessly greedy for large ones. policyFor() derives the
+/// period from the buffer duration and the computation and constraint as
+/// shares of it; DeadlineScheduler re-applies the policy when the geometry
+/// changes, and DeadlineMonitor counts callbacks that finished past their
+/// constraint.
+///
+/// Backends, in order of preference: Mach THREAD_TIME_CONSTRAINT_POLICY
+/// (Apple), SCHED_DEADLINE (Linux), SCHED_FIFO (POSIX).
+namespace realtime
+{
+
+/// The audio buffers the thread keeps filled
+struct BufferGeometry
+{
+    uint32_t sampleRate{0};
+    uint32_t framesPerBuffer{0};
+    uint32_t buffers{0};
+
+    bool valid() const
+    {
+        return (sampleRate > 0) && (framesPerBuffer > 0) && (buffers > 0);
+    }
+
+    /// Duration of one buffer: how often the thread is asked to fill one
+    std::chrono::nanoseconds period() const;
+
+    bool operator==(const BufferGeometry& other) const
+    {
+        return (sampleRate == other.sampleRate) && (framesPerBuffer == other.framesPerBuffer) && (buffers == other.buffers);
+    }
+
+    bool operator!=(const BufferGeometry& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+struct PolicyOptions
+{
+    /// Expected work per fill, as a share of the period
+    double computationShare{0.1};
+    /// Time by which a fill must be done, as a share of the period
+    double constraintShare{0.5};
+    /// Mach accepts computation in [50 µs, 50 ms]
+    std::chrono::nanoseconds minComputation{50'000};
+    std::chrono::nanoseconds maxComputation{50'000'000};
+};
+
+struct DeadlinePolicy
+{
+    std::chrono::nanoseconds period{0};
+    std::chrono::nanoseconds computation{0};
+    std::chrono::nanoseconds constraint{0};
+};
+
+DeadlinePolicy policyFor(const BufferGeometry& geometry, const PolicyOptions& options = {});
+
+enum class Backend
+{
+    None,            ///< Nothing could be applied, default scheduling
+    TimeConstraint,  ///< Mach THREAD_TIME_CONSTRAINT_POLICY
+    Deadline,        ///< Linux SCHED_DEADLINE
+    Fifo,            ///< SCHED_FIFO at the highest priority
+};
+
+const char* toString(Backend backend);
+
+/// Apply @p policy to the calling thread with the best backend available
+/// @param allowDeadline  false skips SCHED_DEADLINE (Linux), e.g. for a
+///                       thread that must block on other threads' locks
+Backend applyToCurrentThread(const DeadlinePolicy& policy, bool allowDeadline = true);
+
+
+/// Counts fills that finished past their constraint. begin() and end() are
+/// lock-free and allocation-free (audio thread); the counters can be read
+/// from any thread.
+///
+/// The release time of a fill is estimated as the previous begin plus the
+/// period, so a fill is late when the thread was woken late, ran long, or
+/// both.
+class DeadlineMonitor
+{
+public:
+    void setPolicy(const DeadlinePolicy& policy);
+
+    void begin(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+    void end(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+    uint64_t fills() const
+    {
+        return fills_.load(std::memory_order_relaxed);
+    }
+    uint64_t misses() const
+    {
+        return misses_.load(std::memory_order_relaxed);
+    }
+    /// Worst release-to-completion time seen, µs
+    int64_t worstResponseUs() const
+    {
+        return worstResponseUs_.load(std::memory_order_relaxed);
+    }
+
+    void reset();
+
+    /// begin() on construction, end() on destruction
+    class Scope
+    {
+    public:
+        explicit Scope(DeadlineMonitor& monitor) : monitor_(monitor)
+        {
+            monitor_.begin();
+        }
+        ~Scope()
+        {
+            monitor_.end();
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        DeadlineMonitor& monitor_;
+    };
+
+private:
+    std::atomic<int64_t> periodNs_{0};
+    std::atomic<int64_t> constraintNs_{0};
+    std::chrono::steady_clock::time_point lastBegin_{};
+    std::chrono::steady_clock::time_point release_{};
+    std::atomic<uint64_t> fills_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<int64_t> worstResponseUs_{0};
+};
+
+
+/// Keeps the calling thread's policy in line with the buffer geometry.
+/// Use from the audio thread only.
+class DeadlineScheduler
+{
+public:
+    explicit DeadlineScheduler(PolicyOptions options = {}, bool allowDeadline = true);
+
+    /// (Re)apply the policy if @p geometry differs from the applied one
+    /// @return true if a policy was applied
+    bool update(const BufferGeometry& geometry);
+
+    Backend backend() const
+    {
+        return backend_;
+    }
+    const DeadlinePolicy& policy() const
+    {
+        return policy_;
+    }
+    DeadlineMonitor& monitor()
+    {
+        return monitor_;
+    }
+
+private:
+    PolicyOptions options_;
+    bool allowDeadline_;
+    BufferGeometry geometry_;
+    DeadlinePolicy policy_;
+    Backend backend_{Backend::None};
+    DeadlineMonitor monitor_;
+};
+
+} // namespace realtime
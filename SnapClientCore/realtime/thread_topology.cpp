@@ -0,0 +1,159 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "thread_topology.hpp"
+
+// local headers
+#include "common/aixlog.hpp"
+
+// Standard headers
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+
+#if defined(__APPLE__)
+#include <pthread/qos.h>
+#elif defined(__linux__)
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace realtime
+{
+
+static constexpr auto LOG_TAG = "ThreadTopology";
+
+
+const char* toString(QosClass qos)
+{
+    switch (qos)
+    {
+        case QosClass::UserInteractive:
+            return "user-interactive";
+        case QosClass::UserInitiated:
+            return "user-initiated";
+        case QosClass::Default:
+            return "default";
+        case QosClass::Utility:
+            return "utility";
+        case QosClass::Background:
+            return "background";
+    }
+    return "unknown";
+}
+
+
+int niceValue(const ThreadProfile& profile)
+{
+    int base = 0;
+    switch (profile.qos)
+    {
+        case QosClass::UserInteractive:
+            base = -10;
+            break;
+        case QosClass::UserInitiated:
+            base = -5;
+            break;
+        case QosClass::Default:
+            base = 0;
+            break;
+        case QosClass::Utility:
+            base = 5;
+            break;
+        case QosClass::Background:
+            base = 19;
+            break;
+    }
+    // Relative priority 0..-15 spans the gap to the next class (5 nice steps)
+    int relative = std::clamp(profile.relativePriority, -15, 0);
+    return std::min(19, base - relative / 3);
+}
+
+
+#if defined(__APPLE__)
+static qos_class_t toQosClass(QosClass qos)
+{
+    switch (qos)
+    {
+        case QosClass::UserInteractive:
+            return QOS_CLASS_USER_INTERACTIVE;
+        case QosClass::UserInitiated:
+            return QOS_CLASS_USER_INITIATED;
+        case QosClass::Default:
+            return QOS_CLASS_DEFAULT;
+        case QosClass::Utility:
+            return QOS_CLASS_UTILITY;
+        case QosClass::Background:
+            return QOS_CLASS_BACKGROUND;
+    }
+    return QOS_CLASS_DEFAULT;
+}
+#endif
+
+
+bool applyToCurrentThread(const std::string& name, const ThreadProfile& profile)
+{
+    bool ok = true;
+#if defined(__APPLE__)
+    if (!name.empty())
+        pthread_setname_np(name.c_str());
+    int result = pthread_set_qos_class_self_np(toQosClass(profile.qos), std::clamp(profile.relativePriority, QOS_MIN_RELATIVE_PRIORITY, 0));
+    if (result != 0)
+    {
+        LOG(WARNING, LOG_TAG) << name << ": QoS " << toString(profile.qos) << " failed: " << std::strerror(result) << "\n";
+        ok = false;
+    }
+    if (profile.cpu >= 0)
+        LOG(DEBUG, LOG_TAG) << name << ": CPU affinity is not supported, ignoring cpu " << profile.cpu << "\n";
+#elif defined(__linux__)
+    // Thread names are limited to 15 characters
+    if (!name.empty())
+        pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+    // Nice is per thread on Linux
+    const int nice = niceValue(profile);
+    if (setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), nice) != 0)
+    {
+        LOG(WARNING, LOG_TAG) << name << ": nice " << nice << " failed: " << std::strerror(errno) << "\n";
+        ok = false;
+    }
+    if (profile.cpu >= 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(profile.cpu, &set);
+        int result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (result != 0)
+        {
+            LOG(WARNING, LOG_TAG) << name << ": affinity to cpu " << profile.cpu << " failed: " << std::strerror(result) << "\n";
+            ok = false;
+        }
+    }
+#else
+    (void)name;
+    (void)profile;
+    ok = false;
+#endif
+    LOG(DEBUG, LOG_TAG) << name << ": " << toString(profile.qos) << " " << profile.relativePriority
+                        << (profile.cpu >= 0 ? ", cpu " + std::to_string(profile.cpu) : std::string()) << (ok ? "" : " (not fully applied)") << "\n";
+    return ok;
+}
+
+} // namespace realtime
@@ -0,0 +1,76 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// Standard headers
+#include <string>
+
+/// Priorities of the engine's non-real-time threads.
+///
+/// The audio thread has its own policy (DeadlineScheduler). The others are
+/// given a role: the stream io thread, which receives chunks, decodes them
+/// and answers the clock sync, must win against the UI; the control plane
+/// can wait; background work (diagnostics, telemetry, cache writes) should
+/// only use idle time.
+///
+/// On Apple platforms a role maps to a QoS class with a relative priority
+/// (there is no CPU affinity); on Linux to a per-thread nice value and an
+/// optional CPU.
+namespace realtime
+{
+
+enum class QosClass
+{
+    UserInteractive,
+    UserInitiated,
+    Default,
+    Utility,
+    Background,
+};
+
+const char* toString(QosClass qos);
+
+struct ThreadProfile
+{
+    QosClass qos{QosClass::Default};
+    /// Within the class, 0 (highest) to -15 (Apple's QOS_MIN_RELATIVE_PRIORITY)
+    int relativePriority{0};
+    /// Pin to this CPU (Linux only), -1 for any
+    int cpu{-1};
+};
+
+/// Linux nice value for a profile: the class sets the range, the relative
+/// priority moves within it
+int niceValue(const ThreadProfile& profile);
+
+struct ThreadTopology
+{
+    bool enabled{true};
+    ThreadProfile io{QosClass::UserInteractive, 0, -1};
+    ThreadProfile control{QosClass::Utility, 0, -1};
+    ThreadProfile background{QosClass::Background, 0, -1};
+};
+
+/// Name the calling thread (unless @p name is empty) and apply @p profile
+/// @return false if the priority or the affinity could not be applied
+///         (e.g. raising it without CAP_SYS_NICE); the thread keeps running
+///         with what it has
+bool applyToCurrentThread(const std::string& name, const ThreadProfile& profile);
+
+} // namespace realtime
@@ -0,0 +1,140 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "hol_filter.hpp"
+
+// Standard headers
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace timesync
+{
+
+void InboundTracker::requestSent()
+{
+    atRequest_ = total_;
+}
+
+
+void InboundTracker::received(usec now, uint64_t bytes)
+{
+    lastReceive_ = now;
+    total_ += bytes;
+}
+
+
+Exchange InboundTracker::reply(usec now, usec rtt, usec offset)
+{
+    Exchange e;
+    e.rtt = rtt;
+    e.offset = offset;
+    e.bytesInFlight = total_ - atRequest_;
+    e.quietBefore = (lastReceive_.count() != 0) ? now - lastReceive_ : usec::max();
+    return e;
+}
+
+
+HolFilter::HolFilter(HolFilterOptions options) : options_(options)
+{
+}
+
+
+HolFilter::Verdict HolFilter::add(const Exchange& exchange)
+{
+    window_.push_back(exchange);
+    if (window_.size() > options_.window)
+        window_.pop_front();
+
+    double w = weight(exchange, minRtt());
+    if (w == 0.0)
+    {
+        stats_.discarded++;
+        return Verdict::Discarded;
+    }
+    if (exchange.rtt - minRtt() <= options_.rttMargin)
+    {
+        stats_.clean++;
+        return Verdict::Clean;
+    }
+    stats_.weighted++;
+    return Verdict::Weighted;
+}
+
+
+std::optional<usec> HolFilter::offset() const
+{
+    if (window_.empty())
+        return std::nullopt;
+
+    usec min = minRtt();
+    std::vector<std::pair<usec, double>> weighted;
+    weighted.reserve(window_.size());
+    double total = 0;
+    for (const auto& e : window_)
+    {
+        double w = weight(e, min);
+        if (w > 0)
+        {
+            weighted.emplace_back(e.offset, w);
+            total += w;
+        }
+    }
+    // The fastest exchange always has weight 1, so this is never empty
+    std::sort(weighted.begin(), weighted.end());
+    double half = total / 2;
+    double sum = 0;
+    for (const auto& [offset, w] : weighted)
+    {
+        sum += w;
+        if (sum >= half)
+            return offset;
+    }
+    return weighted.back().first;
+}
+
+
+usec HolFilter::minRtt() const
+{
+    usec min = usec::max();
+    for (const auto& e : window_)
+        min = std::min(min, e.rtt);
+    return window_.empty() ? usec(0) : min;
+}
+
+
+void HolFilter::clear()
+{
+    window_.clear();
+}
+
+
+double HolFilter::weight(const Exchange& e, usec minRtt) const
+{
+    usec excess = e.rtt - minRtt;
+    if (excess <= options_.rttMargin)
+        return 1.0;
+    // Audio kept arriving during the time the reply was late: it waited behind it
+    bool queued = (e.bytesInFlight >= options_.queuedBytes) && (e.quietBefore < excess);
+    if (queued)
+        return 0.0;
+    double x = static_cast<double>(excess.count()) / static_cast<double>(options_.rttMargin.count());
+    return 1.0 / (1.0 + x * x);
+}
+
+} // namespace timesync
@@ -0,0 +1,131 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// Standard headers
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+
+/// Head-of-line aware filtering of Time samples.
+///
+/// Time replies share the TCP connection with the audio. A reply that waits
+/// behind a burst of WireChunks arrives late, which inflates only the
+/// server-to-client half of the round trip: the RTT grows and the offset
+/// estimate is pulled down by half the wait. A plain median over such
+/// samples is biased whenever more than a few replies queue.
+///
+/// A queued reply has a signature: audio bytes arrived while it was in
+/// flight, and kept arriving until just before it, during the time it was
+/// late. A reply delayed by the radio instead arrives after a quiet spell.
+/// InboundTracker records both facts per reply; HolFilter drops replies that
+/// are slow and show the signature, and weights the other slow ones down.
+namespace timesync
+{
+
+using usec = std::chrono::microseconds;
+
+/// One Time exchange and the inbound traffic around it
+struct Exchange
+{
+    usec rtt{0};
+    usec offset{0};  ///< Server clock - client clock
+    /// Bytes received between sending the request and receiving the reply
+    uint64_t bytesInFlight{0};
+    /// Time between the last other message and the reply
+    usec quietBefore{0};
+};
+
+/// Builds Exchanges from receive events; one request in flight at a time
+class InboundTracker
+{
+public:
+    /// A Time request was written
+    void requestSent();
+    /// Any message other than the Time reply was received at @p now
+    void received(usec now, uint64_t bytes);
+    /// The Time reply was received at @p now
+    Exchange reply(usec now, usec rtt, usec offset);
+
+private:
+    uint64_t total_{0};
+    uint64_t atRequest_{0};
+    usec lastReceive_{0};
+};
+
+struct HolFilterOptions
+{
+    /// Exchanges kept for the estimate
+    size_t window{100};
+    /// Bytes in flight with a reply that can hold it up (about one small
+    /// compressed chunk)
+    uint64_t queuedBytes{1024};
+    /// RTT above the window's minimum still considered clean; also the
+    /// scale of the down-weighting beyond it
+    usec rttMargin{usec(1000)};
+};
+
+class HolFilter
+{
+public:
+    enum class Verdict
+    {
+        Clean,      ///< Close to the minimum RTT, full weight
+        Weighted,   ///< Slow but not queued behind data, reduced weight
+        Discarded,  ///< Queued behind data and slow: head-of-line delayed
+    };
+
+    struct Stats
+    {
+        uint64_t clean{0};
+        uint64_t weighted{0};
+        uint64_t discarded{0};
+    };
+
+    explicit HolFilter(HolFilterOptions options = {});
+
+    Verdict add(const Exchange& exchange);
+
+    /// Weighted median offset over the window, judged against the current
+    /// minimum RTT. nullopt if empty.
+    std::optional<usec> offset() const;
+    usec minRtt() const;
+
+    void clear();
+    size_t size() const
+    {
+        return window_.size();
+    }
+    const Stats& stats() const
+    {
+        return stats_;
+    }
+
+private:
+    /// 0 for a discarded exchange
+    double weight(const Exchange& e, usec minRtt) const;
+
+    HolFilterOptions options_;
+    std::deque<Exchange> window_;
+    Stats stats_;
+};
+
+} // namespace timesync
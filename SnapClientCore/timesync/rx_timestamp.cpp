@@ -0,0 +1,130 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "rx_timestamp.hpp"
+
+// 3rd party headers
+#include <boost/asio/error.hpp>
+
+// Standard headers
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+
+namespace timesync
+{
+
+namespace
+{
+
+using std::chrono::microseconds;
+
+/// Steady-clock time of an event that happened at wall-clock @p wall
+microseconds toSteady(const struct timespec& wall)
+{
+    auto steadyNow = std::chrono::steady_clock::now();
+    auto wallNow = std::chrono::system_clock::now();
+    auto at = std::chrono::seconds(wall.tv_sec) + std::chrono::nanoseconds(wall.tv_nsec);
+    auto age = std::chrono::duration_cast<microseconds>(wallNow.time_since_epoch() - at);
+    // A wall clock step between the stamp and now would make the age meaningless
+    if (age < microseconds(0) || age > std::chrono::seconds(1))
+        age = microseconds(0);
+    return std::chrono::duration_cast<microseconds>(steadyNow.time_since_epoch()) - age;
+}
+
+} // namespace
+
+
+bool enableRxTimestamps(int fd)
+{
+    int on = 1;
+#if defined(SO_TIMESTAMPNS)
+    return setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) == 0;
+#elif defined(SO_TIMESTAMP)
+    return setsockopt(fd, SOL_SOCKET, SO_TIMESTAMP, &on, sizeof(on)) == 0;
+#else
+    (void)fd;
+    (void)on;
+    return false;
+#endif
+}
+
+
+Received receive(int fd, void* data, size_t size, boost::system::error_code& ec)
+{
+    Received r;
+    struct iovec iov;
+    iov.iov_base = data;
+    iov.iov_len = size;
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(struct timespec)) + CMSG_SPACE(sizeof(struct timeval))];
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t n;
+    do
+    {
+        n = recvmsg(fd, &msg, MSG_DONTWAIT);
+    } while (n < 0 && errno == EINTR);
+
+    if (n < 0)
+    {
+        ec = (errno == EAGAIN || errno == EWOULDBLOCK) ? make_error_code(boost::asio::error::would_block)
+                                                       : boost::system::error_code(errno, boost::system::system_category());
+        return r;
+    }
+    if (n == 0)
+    {
+        ec = boost::asio::error::eof;
+        return r;
+    }
+    ec = {};
+    r.bytes = static_cast<size_t>(n);
+
+    for (struct cmsghdr* c = CMSG_FIRSTHDR(&msg); c != nullptr; c = CMSG_NXTHDR(&msg, c))
+    {
+        if (c->cmsg_level != SOL_SOCKET)
+            continue;
+#if defined(SCM_TIMESTAMPNS)
+        if (c->cmsg_type == SCM_TIMESTAMPNS)
+        {
+            struct timespec ts;
+            std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+            r.stamp = toSteady(ts);
+        }
+#endif
+#if defined(SCM_TIMESTAMP)
+        if (c->cmsg_type == SCM_TIMESTAMP)
+        {
+            struct timeval tv;
+            std::memcpy(&tv, CMSG_DATA(c), sizeof(tv));
+            r.stamp = toSteady({tv.tv_sec, static_cast<long>(tv.tv_usec) * 1000});
+        }
+#endif
+    }
+    return r;
+}
+
+} // namespace timesync
@@ -0,0 +1,56 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// 3rd party headers
+#include <boost/system/error_code.hpp>
+
+// Standard headers
+#include <chrono>
+#include <cstddef>
+#include <optional>
+
+/// Kernel receive timestamps for stream sockets.
+///
+/// A receive time taken after an asio read completes includes however long
+/// the io thread took to get scheduled and run the handler. With
+/// SO_TIMESTAMPNS (Linux) or SO_TIMESTAMP (Darwin, BSD) the kernel stamps
+/// each packet as it arrives and recvmsg() returns the stamp of the newest
+/// packet it consumed. Stamps are on the wall clock; they are converted to
+/// the steady clock the time sync math uses by their age.
+namespace timesync
+{
+
+/// Ask the kernel to stamp received data on @p fd.
+/// @return false if the platform or socket does not support it
+bool enableRxTimestamps(int fd);
+
+struct Received
+{
+    size_t bytes{0};
+    /// Kernel receive time of the newest packet read, steady clock µs.
+    /// Empty if the kernel sent no stamp.
+    std::optional<std::chrono::microseconds> stamp;
+};
+
+/// Non-blocking recvmsg() into @p data. Sets @p ec to would_block when
+/// nothing is buffered, and to eof when the peer closed.
+Received receive(int fd, void* data, size_t size, boost::system::error_code& ec);
+
+} // namespace timesync
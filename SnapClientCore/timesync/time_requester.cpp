@@ -0,0 +1,119 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "time_requester.hpp"
+
+// 3rd party headers
+#include <boost/asio/write.hpp>
+
+namespace timesync
+{
+
+using std::chrono::microseconds;
+namespace wire = probe::wire;
+
+
+TimeRequester::TimeRequester(boost::asio::ip::tcp::socket& socket, TimeRequesterOptions options)
+    : socket_(socket), timer_(socket.get_executor()), options_(options)
+{
+}
+
+
+void TimeRequester::start(SampleHandler onSample, SentHandler onSent)
+{
+    onSample_ = std::move(onSample);
+    onSent_ = std::move(onSent);
+    next_ = std::chrono::steady_clock::now();
+    send(wire::now());
+    tick();
+}
+
+
+void TimeRequester::stop()
+{
+    stopped_ = true;
+    timer_.cancel();
+    pending_.clear();
+}
+
+
+bool TimeRequester::onReply(const wire::Header& header, const uint8_t* payload, microseconds received)
+{
+    auto* request = pending_.find([&header](const Pending& p) { return p.id == header.refersTo; });
+    microseconds latency;
+    if ((request == nullptr) || !wire::decodeTime(payload, header.size, latency))
+        return false;
+    pending_.release(request);
+    stats_.answered++;
+    if (onSample_)
+        onSample_(wire::timeSample(latency, wire::fromTimeval(header.sent), received));
+    return true;
+}
+
+
+void TimeRequester::tick()
+{
+    next_ += options_.interval;
+    timer_.expires_at(next_);
+    timer_.async_wait(net::recycled(memory_, [self = shared_from_this()](const boost::system::error_code& ec)
+    {
+        if (ec || self->stopped_)
+            return;
+        self->send(wire::now());
+        self->tick();
+    }));
+}
+
+
+void TimeRequester::send(microseconds now)
+{
+    stats_.expired += pending_.releaseIf([this, now](const Pending& p) { return now - p.sent > options_.replyTimeout; });
+
+    Pending* request = writing_ ? nullptr : pending_.acquire();
+    if (request == nullptr)
+    {
+        stats_.skipped++;
+        return;
+    }
+    request->id = nextId_++;
+    if (nextId_ == 0)
+        nextId_ = 1;
+    request->sent = now;
+    wire::encodeTime(request->id, now, request_.data());
+
+    if (onSent_)
+        onSent_();
+    // The handler may have stopped us (e.g. failing the connection),
+    // which already dropped the request
+    if (stopped_)
+        return;
+    stats_.sent++;
+    if (writer_)
+    {
+        writer_(request_.data(), request_.size());
+        return;
+    }
+    writing_ = true;
+    boost::asio::async_write(socket_, boost::asio::buffer(request_), net::recycled(memory_, [self = shared_from_this()](const boost::system::error_code&, size_t)
+    {
+        // Errors surface on the read side, which owns the connection
+        self->writing_ = false;
+    }));
+}
+
+} // namespace timesync
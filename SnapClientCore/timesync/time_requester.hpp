@@ -0,0 +1,136 @@
+/***
+    This file is part of snapcast-ios (SnapForge project)
+    Copyright (C) 2025  SnapForge contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+// local headers
+#include "net/handler_memory.hpp"
+#include "net/request_pool.hpp"
+#include "probe/stream_wire.hpp"
+
+// 3rd party headers
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+// Standard headers
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace timesync
+{
+
+struct TimeRequesterOptions
+{
+    std::chrono::milliseconds interval{1000};
+    /// A request unanswered this long is dropped from the pending set
+    std::chrono::milliseconds replyTimeout{2000};
+};
+
+/// Periodic Time requests on a stream connection, without heap traffic.
+///
+/// The request is encoded into a buffer owned by the requester, pending
+/// requests live in a fixed RequestPool instead of a map, and the write and
+/// timer operations are allocated from the connection's HandlerMemory. The
+/// caller feeds received Time messages to onReply(), which matches them by
+/// refersTo and reports the clock sample.
+///
+/// Single io thread. Destroy after stop() and once the io_context ran the
+/// cancelled handlers, or after it stopped.
+class TimeRequester : public std::enable_shared_from_this<TimeRequester>
+{
+public:
+    struct Stats
+    {
+        uint64_t sent{0};
+        uint64_t answered{0};
+        uint64_t expired{0};  ///< Dropped after replyTimeout
+        uint64_t skipped{0};  ///< Ticks with the previous write still pending, or the pool full
+    };
+
+    using SampleHandler = std::function<void(const probe::wire::TimeSample& sample)>;
+    /// Called right before a request is written (e.g. BatchReceiver::expectReply)
+    using SentHandler = std::function<void()>;
+    /// Takes an encoded request (copied during the call) for the
+    /// connection's own send queue
+    using Writer = std::function<void(const uint8_t* data, size_t size)>;
+
+    TimeRequester(boost::asio::ip::tcp::socket& socket, TimeRequesterOptions options = {});
+
+    void start(SampleHandler onSample, SentHandler onSent = {});
+    void stop();
+
+    /// Hand requests to @p writer instead of writing them to the socket,
+    /// where they could interleave with the connection's other writes.
+    /// Call before start().
+    void setWriter(Writer writer)
+    {
+        writer_ = std::move(writer);
+    }
+
+    /// Change the request interval (e.g. from a quick initial burst to the
+    /// steady rate), effective after the pending tick
+    void setInterval(std::chrono::milliseconds interval)
+    {
+        options_.interval = interval;
+    }
+
+    /// Hand over a received Time message
+    /// @return false if it answers no pending request
+    bool onReply(const probe::wire::Header& header, const uint8_t* payload, std::chrono::microseconds received);
+
+    const Stats& stats() const
+    {
+        return stats_;
+    }
+
+    const net::HandlerMemory& memory() const
+    {
+        return memory_;
+    }
+
+private:
+    struct Pending
+    {
+        uint16_t id{0};
+        std::chrono::microseconds sent{0};
+    };
+
+    void tick();
+    void send(std::chrono::microseconds now);
+
+    boost::asio::ip::tcp::socket& socket_;
+    boost::asio::steady_timer timer_;
+    TimeRequesterOptions options_;
+    SampleHandler onSample_;
+    SentHandler onSent_;
+    Writer writer_;
+
+    net::HandlerMemory memory_;
+    net::RequestPool<Pending, 8> pending_;
+    std::array<uint8_t, probe::wire::TIME_MESSAGE_SIZE> request_{};
+    std::chrono::steady_clock::time_point next_;
+    uint16_t nextId_{1};
+    bool writing_{false};
+    bool stopped_{false};
+    Stats stats_;
+};
+
+} // namespace timesync
@@ -0,0 +1,345 @@
+/***
+    AnalysisTapBenchmark.cpp
+
+    Measures dsp::AnalysisTap, the copy of the played audio the UI's level
+    meters and spectrum are computed from, and dsp::SpectrumAnalyzer, which
+    computes them off the audio thread.
+
+    - Real-time side: ns per push() for the player's 100 ms buffers (4800
+      frames), which must stay under 1 us for 16-bit stereo.
+    - Concurrency: a writer pushing as fast as it can while a reader reads;
+      every window read must be one consistent buffer (the seqlock rejects
+      torn copies), never a mix of two.
+    - Playout time: the reader only gets windows that started playing.
+    - Analysis: levels and bands of known tones, and the meter fall once
+      playback stops; the cost of one analysis on the background thread.
+
+    Build & run: ./scripts/run-linux-benchmarks.sh AnalysisTap
+
+    Copyright (C) 2025 SnapForge contributors
+    License: GPL-3.0
+***/
+
+#include "dsp/analysis_tap.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace analysis_tap_bench {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t RATE = 48000;
+constexpr uint32_t FRAMES = 4800;  // 100 ms at 48 kHz
+constexpr size_t PUSHES = 200'000;
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+    double duration_ms;
+};
+
+std::vector<TestResult> g_results;
+
+void log(const std::string& msg) {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::cout << "[" << std::put_time(std::localtime(&time), "%H:%M:%S") << "] " << msg << std::endl;
+}
+
+std::string fmt(double v, int precision = 1) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(precision) << v;
+    return out.str();
+}
+
+/// Interleaved 16-bit tone, one amplitude per channel
+std::vector<int16_t> tone(uint16_t channels, uint32_t frames, double hz, const std::vector<double>& amplitude) {
+    std::vector<int16_t> pcm(static_cast<size_t>(frames) * channels);
+    for (uint32_t f = 0; f < frames; ++f)
+        for (uint16_t c = 0; c < channels; ++c)
+            pcm[f * channels + c] = static_cast<int16_t>(std::lrint(amplitude[c] * 32767. * std::sin(2. * M_PI * hz * f / RATE)));
+    return pcm;
+}
+
+// ============================================================================
+// Test 1: real-time side
+// ============================================================================
+
+struct PushCost {
+    double median;
+    double p99;
+    double mean;
+};
+
+PushCost measurePush(uint16_t channels, uint16_t bits) {
+    dsp::AnalysisTap tap({RATE, channels, bits});
+    std::vector<char> buffer(static_cast<size_t>(FRAMES) * channels * ((bits == 16) ? 2 : 4), 1);
+    std::vector<double> ns(PUSHES);
+    const auto playAt = Clock::now();
+    for (size_t i = 0; i < 1000; ++i) tap.push(buffer.data(), FRAMES, playAt);  // warm-up
+    auto total0 = Clock::now();
+    for (size_t i = 0; i < PUSHES; ++i) {
+        auto t0 = Clock::now();
+        tap.push(buffer.data(), FRAMES, playAt);
+        ns[i] = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+    }
+    double mean = std::chrono::duration<double, std::nano>(Clock::now() - total0).count() / PUSHES;
+    std::sort(ns.begin(), ns.end());
+    return {ns[PUSHES / 2], ns[PUSHES * 99 / 100], mean};
+}
+
+TestResult test_push_cost() {
+    TestResult result{"Real-time side under 1 us per buffer", true, "", 0};
+    auto start = Clock::now();
+
+    log("Format            copied    median     p99       mean   (ns per push)");
+    struct Case {
+        const char* name;
+        uint16_t channels;
+        uint16_t bits;
+    };
+    const Case cases[] = {{"16-bit stereo  ", 2, 16}, {"24-bit stereo  ", 2, 24}, {"16-bit mono    ", 1, 16}, {"24-bit 5.1     ", 6, 24}};
+    PushCost stereo{};
+    for (const auto& c : cases) {
+        auto cost = measurePush(c.channels, c.bits);
+        if (c.channels == 2 && c.bits == 16) stereo = cost;
+        const double kib = dsp::TAP_WINDOW * c.channels * ((c.bits == 16) ? 2 : 4) / 1024.;
+        log(std::string(c.name) + "   " + fmt(kib, 0) + " KiB     " + fmt(cost.median, 0) + "       " + fmt(cost.p99, 0) + "       " +
+            fmt(cost.mean, 0));
+    }
+
+    if (stereo.median > 1000.) {
+        result.passed = false;
+        result.message = "16-bit stereo push takes " + fmt(stereo.median, 0) + " ns";
+    } else {
+        result.message = "16-bit stereo " + fmt(stereo.median, 0) + " ns median, " + fmt(stereo.p99, 0) + " ns p99 per 100 ms buffer";
+    }
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Test 2: concurrency
+// ============================================================================
+
+TestResult test_concurrency() {
+    TestResult result{"Reader never sees a torn window", true, "", 0};
+    auto start = Clock::now();
+
+    // Every sample of buffer n is n: a torn copy mixes two values
+    dsp::AnalysisTap tap({RATE, 2, 16});
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        std::vector<int16_t> buffer(static_cast<size_t>(FRAMES) * 2);
+        const auto playAt = Clock::now() - std::chrono::seconds(1);
+        for (uint32_t n = 0; !stop.load(std::memory_order_relaxed); ++n) {
+            std::fill(buffer.begin(), buffer.end(), static_cast<int16_t>(n & 0x7FFF));
+            tap.push(buffer.data(), FRAMES, playAt);
+        }
+    });
+
+    dsp::AnalysisTap::Window window;
+    size_t reads = 0, misses = 0, torn = 0;
+    uint64_t lastSequence = 0;
+    size_t backwards = 0;
+    const auto end = Clock::now() + std::chrono::milliseconds(500);
+    while (Clock::now() < end) {
+        if (!tap.read(Clock::now(), window)) {
+            ++misses;
+            continue;
+        }
+        ++reads;
+        const float first = window.samples[0];
+        for (uint32_t i = 0; i < window.frames * 2; ++i) {
+            if (window.samples[i] != first) {
+                ++torn;
+                break;
+            }
+        }
+        if (window.sequence < lastSequence) ++backwards;
+        lastSequence = window.sequence;
+    }
+    stop = true;
+    writer.join();
+
+    log("  " + std::to_string(tap.pushed()) + " windows pushed, " + std::to_string(reads) + " read, " + std::to_string(misses) +
+        " reads found no complete window, " + std::to_string(torn) + " torn");
+    if (torn > 0 || backwards > 0) {
+        result.passed = false;
+        result.message = std::to_string(torn) + " torn windows, " + std::to_string(backwards) + " older than the one before";
+    } else if (reads == 0) {
+        result.passed = false;
+        result.message = "the reader never got a window";
+    } else {
+        result.message = std::to_string(reads) + " consistent windows while " + std::to_string(tap.pushed()) + " were pushed";
+    }
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Test 3: playout time
+// ============================================================================
+
+TestResult test_playout_time() {
+    TestResult result{"Windows follow the playout time", true, "", 0};
+    auto start = Clock::now();
+
+    // Four buffers queued back to back, the first playing from t0
+    dsp::AnalysisTap tap({RATE, 2, 16});
+    const auto t0 = Clock::now();
+    const auto buffer = std::chrono::milliseconds(100);
+    std::vector<int16_t> pcm(static_cast<size_t>(FRAMES) * 2);
+    for (int n = 0; n < 4; ++n) {
+        std::fill(pcm.begin(), pcm.end(), static_cast<int16_t>(n + 1));
+        tap.push(pcm.data(), FRAMES, t0 + n * buffer);
+    }
+    // The window is the last 2048 frames: it starts 57.3 ms into a buffer
+    const auto lead = std::chrono::nanoseconds((FRAMES - dsp::TAP_WINDOW) * 1000000000LL / RATE);
+
+    struct Check {
+        std::chrono::nanoseconds at;
+        int expected;  // 0: none
+    };
+    const Check checks[] = {
+        {std::chrono::nanoseconds(0), 0},
+        {lead - std::chrono::nanoseconds(1), 0},
+        {lead, 1},
+        {buffer + lead - std::chrono::nanoseconds(1), 1},
+        {buffer + lead, 2},
+        {3 * buffer + lead, 4},
+        {std::chrono::seconds(10), 4},
+    };
+    dsp::AnalysisTap::Window window;
+    int passed = 0;
+    for (const auto& check : checks) {
+        const bool got = tap.read(t0 + check.at, window);
+        const int value = got ? static_cast<int>(std::lrint(window.samples[0] * 32768.f)) : 0;
+        if (value == check.expected) {
+            ++passed;
+        } else {
+            result.passed = false;
+            result.message = "at " + fmt(check.at.count() / 1e6, 3) + " ms got buffer " + std::to_string(value) + ", expected " +
+                             std::to_string(check.expected);
+        }
+    }
+    log("  " + std::to_string(passed) + " of " + std::to_string(std::size(checks)) + " reads picked the window playing at that time");
+    if (result.passed) result.message = "the window playing at each time, none before the first starts";
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Test 4: analysis
+// ============================================================================
+
+/// Band of @p hz for 20 Hz .. 20 kHz
+size_t bandOf(double hz) {
+    return static_cast<size_t>(std::log(hz / 20.) / std::log(1000.) * dsp::SPECTRUM_BANDS);
+}
+
+TestResult test_analysis() {
+    TestResult result{"Levels, bands and meter fall", true, "", 0};
+    auto start = Clock::now();
+
+    // 1 kHz, left at -6 dBFS, right at -12 dBFS
+    dsp::AnalysisTap tap({RATE, 2, 16});
+    auto pcm = tone(2, FRAMES, 1000., {0.5, 0.25});
+    const auto t0 = Clock::now();
+    tap.push(pcm.data(), FRAMES, t0 - std::chrono::seconds(1));
+
+    dsp::SpectrumAnalyzer analyzer;
+    analyzer.update(&tap, t0, std::chrono::milliseconds(33));
+    const auto frame = analyzer.frame();
+    const size_t band = bandOf(1000.);
+    float far = dsp::SILENCE_DB;
+    for (size_t b = 0; b < dsp::SPECTRUM_BANDS; ++b)
+        if (b + 3 < band || b > band + 3) far = std::max(far, frame.bandsDb[b]);
+    const float toneBand = std::max(frame.bandsDb[band], frame.bandsDb[band + 1]);
+    log("  Peak L " + fmt(frame.peakDb[0], 2) + " R " + fmt(frame.peakDb[1], 2) + " dBFS, RMS L " + fmt(frame.rmsDb[0], 2) + " R " +
+        fmt(frame.rmsDb[1], 2) + " dBFS");
+    log("  1 kHz band " + fmt(toneBand, 2) + " dB (sum of channels: " + fmt(20. * std::log10(0.375), 2) + "), highest band 3+ away " +
+        fmt(far, 1) + " dB");
+
+    // The queue stops: one second later the meters are 24 dB lower
+    for (int i = 0; i < 30; ++i) analyzer.update(nullptr, t0, std::chrono::microseconds(33'333));
+    const float fallen = frame.peakDb[0] - analyzer.frame().peakDb[0];
+    log("  After 1 s without audio: peak fell " + fmt(fallen, 1) + " dB");
+
+    // Cost of one analysis on the background thread
+    auto c0 = Clock::now();
+    const int updates = 2000;
+    for (int i = 0; i < updates; ++i) {
+        tap.push(pcm.data(), FRAMES, t0 - std::chrono::seconds(1));
+        analyzer.update(&tap, t0, std::chrono::milliseconds(33));
+    }
+    const double us = std::chrono::duration<double, std::micro>(Clock::now() - c0).count() / updates;
+    log("  Analysis: " + fmt(us, 1) + " us per frame, " + fmt(us * 30 / 1000., 2) + " ms/s at 30 frames per second");
+
+    auto near = [](double a, double b, double tolerance) { return std::fabs(a - b) <= tolerance; };
+    if (!near(frame.peakDb[0], -6.02, 0.1) || !near(frame.peakDb[1], -12.04, 0.1) || !near(frame.rmsDb[0], -9.03, 0.1) ||
+        !near(frame.rmsDb[1], -15.05, 0.1)) {
+        result.passed = false;
+        result.message = "levels off: peak " + fmt(frame.peakDb[0], 2) + " / " + fmt(frame.peakDb[1], 2) + ", RMS " + fmt(frame.rmsDb[0], 2) +
+                         " / " + fmt(frame.rmsDb[1], 2) + " dBFS";
+    } else if (!near(toneBand, 20. * std::log10(0.375), 1.) || far > -60.f) {
+        result.passed = false;
+        result.message = "1 kHz band at " + fmt(toneBand, 1) + " dB, " + fmt(far, 1) + " dB far from it";
+    } else if (!near(fallen, 24., 0.5)) {
+        result.passed = false;
+        result.message = "meters fell " + fmt(fallen, 1) + " dB in a second, expected 24";
+    } else {
+        result.message = "levels within 0.1 dB, tone band " + fmt(toneBand, 1) + " dB, leakage below " + fmt(far, 0) + " dB; " + fmt(us, 1) +
+                         " us per analysis";
+    }
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int run_all_tests() {
+    std::cout << "\n";
+    std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║       Analysis Tap Benchmark                                 ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════════════╝\n";
+    std::cout << "\n";
+
+    g_results.push_back(test_push_cost());
+    std::cout << "\n";
+    g_results.push_back(test_concurrency());
+    std::cout << "\n";
+    g_results.push_back(test_playout_time());
+    std::cout << "\n";
+    g_results.push_back(test_analysis());
+    std::cout << "\n";
+
+    int failed = 0;
+    for (const auto& result : g_results) {
+        std::string status = result.passed ? "✅ PASS" : "❌ FAIL";
+        std::cout << "  " << status << "  " << result.name << "\n";
+        std::cout << "         " << result.message << " (" << result.duration_ms << " ms)\n";
+        if (!result.passed) failed++;
+    }
+    std::cout << "\n";
+    return failed;
+}
+
+} // namespace analysis_tap_bench
+
+int main() {
+    return analysis_tap_bench::run_all_tests() == 0 ? 0 : 1;
+}
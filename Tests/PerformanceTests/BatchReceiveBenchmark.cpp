@@ -0,0 +1,469 @@
+/***
+    BatchReceiveBenchmark.cpp
+
+    Measures io thread wakeups and CPU time for the stream connection's
+    receive path: the one-message-per-read loop (header, then payload, then
+    the handler, as Snapcast's ClientConnection does), BatchReceiver in
+    normal mode, and BatchReceiver in low-power mode with the latency budget
+    of a 1000 ms playout buffer.
+
+    A loopback mock server streams 48 kHz/16/2 PCM in 20 ms chunks and
+    answers a Time request every second. Each received chunk gets a small
+    checksum pass standing in for decoding. Wakeups are the io thread's
+    voluntary context switches (each one a sleep in epoll_wait), CPU time is
+    the thread's user + system time (getrusage RUSAGE_THREAD, Linux).
+
+    Also checks what low-power mode must not cost: every chunk arrives, no
+    chunk waits longer than the budget (also with a stream at half the
+    bitrate the low-water mark was sized for, where the budget timer has to
+    fire), and Time replies are not held back behind the low-water mark.
+
+    Build & run: ./scripts/run-linux-benchmarks.sh BatchReceive
+
+    Copyright (C) 2025 SnapForge contributors
+    License: GPL-3.0
+***/
+
+#include "net/batch_receiver.hpp"
+#include "probe/stream_wire.hpp"
+
+#include <boost/asio.hpp>
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace batch_bench {
+
+using boost::asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+namespace wire = probe::wire;
+
+constexpr auto CHUNK_DURATION = milliseconds(20);
+constexpr size_t CHUNK_BYTES = 48000 * 4 / 50;  // 20 ms of 48 kHz/16/2
+constexpr uint64_t STREAM_BITRATE = 48000 * 16 * 2;
+constexpr auto RUN_TIME = std::chrono::seconds(5);
+constexpr auto BUFFER_DEPTH = milliseconds(1000);
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+    double duration_ms;
+};
+
+std::vector<TestResult> g_results;
+
+void log(const std::string& msg) {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::cout << "[" << std::put_time(std::localtime(&time), "%H:%M:%S") << "] " << msg << std::endl;
+}
+
+std::string fmt(double v, int precision = 0) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(precision) << v;
+    return out.str();
+}
+
+// ============================================================================
+// Mock streaming server
+// ============================================================================
+
+class MockStreamServer {
+public:
+    explicit MockStreamServer(milliseconds interval)
+        : interval_(interval), acceptor_(io_, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)) {
+        accept();
+        thread_ = std::thread([this]() { io_.run(); });
+    }
+
+    ~MockStreamServer() {
+        io_.stop();
+        thread_.join();
+    }
+
+    uint16_t port() const { return acceptor_.local_endpoint().port(); }
+
+private:
+    struct Session : std::enable_shared_from_this<Session> {
+        Session(boost::asio::io_context& io, tcp::socket s, milliseconds interval)
+            : socket(std::move(s)), chunkTimer(io), interval(interval) {}
+
+        void start() {
+            next = Clock::now();
+            scheduleChunk();
+            read();
+        }
+
+        void read() {
+            boost::asio::async_read(socket, boost::asio::buffer(header), [self = shared_from_this()](auto ec, size_t) {
+                if (ec) return;
+                auto h = wire::decodeHeader(self->header.data());
+                auto received = wire::now();
+                self->payload.resize(h.size);
+                boost::asio::async_read(self->socket, boost::asio::buffer(self->payload),
+                                        [self, h, received](auto ec, size_t) {
+                                            if (ec) return;
+                                            if (h.type == wire::kTime) {
+                                                auto latency = received - wire::fromTimeval(h.sent);
+                                                self->send(wire::encodeTimeReply(0, h.id, latency, wire::now()));
+                                            }
+                                            self->read();
+                                        });
+            });
+        }
+
+        void scheduleChunk() {
+            next += interval;
+            chunkTimer.expires_at(next);
+            chunkTimer.async_wait([self = shared_from_this()](auto ec) {
+                if (ec) return;
+                wire::Header h;
+                h.type = wire::kWireChunk;
+                h.sent = wire::toTimeval(wire::now());
+                h.size = static_cast<uint32_t>(8 + 4 + CHUNK_BYTES);
+                std::vector<uint8_t> out(wire::HEADER_SIZE + h.size, 0x5a);
+                wire::encodeHeader(h, out.data());
+                self->send(std::move(out));
+                self->scheduleChunk();
+            });
+        }
+
+        void send(std::vector<uint8_t> data) {
+            boost::system::error_code ec;
+            boost::asio::write(socket, boost::asio::buffer(data), ec);
+            if (ec) chunkTimer.cancel();
+        }
+
+        tcp::socket socket;
+        boost::asio::steady_timer chunkTimer;
+        milliseconds interval;
+        Clock::time_point next;
+        std::array<uint8_t, wire::HEADER_SIZE> header{};
+        std::vector<uint8_t> payload;
+    };
+
+    void accept() {
+        acceptor_.async_accept([this](auto ec, tcp::socket socket) {
+            if (ec) return;
+            socket.set_option(tcp::no_delay(true), ec);
+            auto session = std::make_shared<Session>(io_, std::move(socket), interval_);
+            session->start();
+            sessions_.push_back(session);
+            accept();
+        });
+    }
+
+    milliseconds interval_;
+    boost::asio::io_context io_;
+    tcp::acceptor acceptor_;
+    std::vector<std::shared_ptr<Session>> sessions_;
+    std::thread thread_;
+};
+
+// ============================================================================
+// Clients
+// ============================================================================
+
+enum class Mode { PerMessage, Batched, LowPower };
+
+std::string toString(Mode mode) {
+    switch (mode) {
+        case Mode::PerMessage: return "per message";
+        case Mode::Batched: return "batched";
+        case Mode::LowPower: return "low power";
+    }
+    return "?";
+}
+
+struct Usage {
+    double cpu_us{0};
+    long wakeups{0};
+};
+
+Usage threadUsage() {
+    rusage ru{};
+    getrusage(RUSAGE_THREAD, &ru);
+    Usage u;
+    u.cpu_us = static_cast<double>(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1e6 +
+               static_cast<double>(ru.ru_utime.tv_usec + ru.ru_stime.tv_usec);
+    u.wakeups = ru.ru_nvcsw;
+    return u;
+}
+
+struct RunResult {
+    double seconds{0};
+    double wakeups_per_s{0};
+    double cpu_ms_per_s{0};
+    uint64_t chunks{0};
+    uint64_t handlerCalls{0};
+    double max_hold_ms{0};
+    double p50_rtt_us{0};
+    double max_rtt_us{0};
+    int replies{0};
+};
+
+/// Stands in for decoding: touch every byte once
+uint32_t decode(const uint8_t* data, size_t size) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < size; ++i) sum = sum * 31 + data[i];
+    return sum;
+}
+
+class Client {
+public:
+    Client(Mode mode, uint16_t port) : mode_(mode), socket_(io_), timeTimer_(io_), endTimer_(io_) {
+        socket_.connect({boost::asio::ip::address_v4::loopback(), port});
+        socket_.set_option(tcp::no_delay(true));
+    }
+
+    RunResult run(std::chrono::seconds duration) {
+        RunResult r;
+        std::vector<double> rtts;
+        auto onChunk = [this, &r](const wire::Header& h, const uint8_t* payload) {
+            r.chunks++;
+            checksum_ += decode(payload, h.size);
+            double hold = static_cast<double>((wire::now() - wire::fromTimeval(h.sent)).count()) / 1000.0;
+            r.max_hold_ms = std::max(r.max_hold_ms, hold);
+        };
+        auto onTime = [&rtts](const wire::Header& h, const uint8_t* payload, microseconds received) {
+            microseconds latency;
+            if (!wire::decodeTime(payload, h.size, latency)) return;
+            rtts.push_back(static_cast<double>(wire::timeSample(latency, wire::fromTimeval(h.sent), received).rtt.count()));
+        };
+
+        std::shared_ptr<net::BatchReceiver> batch;
+        if (mode_ == Mode::PerMessage) {
+            readHeader([&r, onChunk, onTime](const wire::Header& h, const uint8_t* payload) {
+                r.handlerCalls++;
+                if (h.type == wire::kWireChunk) onChunk(h, payload);
+                else if (h.type == wire::kTime) onTime(h, payload, wire::now());
+            });
+        } else {
+            net::BatchOptions options;
+            options.lowPower = mode_ == Mode::LowPower;
+            options.latencyBudget = net::latencyBudget(BUFFER_DEPTH);
+            options.bitsPerSecond = STREAM_BITRATE;
+            batch = std::make_shared<net::BatchReceiver>(socket_, options);
+            batch->start(
+                [&r, onChunk, onTime](const std::vector<net::BatchReceiver::Message>& messages) {
+                    r.handlerCalls++;
+                    for (const auto& m : messages) {
+                        if (m.header.type == wire::kWireChunk) onChunk(m.header, m.payload);
+                        else if (m.header.type == wire::kTime) onTime(m.header, m.payload, m.received);
+                    }
+                },
+                [](const boost::system::error_code& ec) { log("   ⚠️  receive error: " + ec.message()); });
+        }
+        sendTime(batch.get());
+
+        Usage before;
+        auto start = Clock::now();
+        std::thread worker([&]() {
+            before = threadUsage();
+            io_.run();
+            auto after = threadUsage();
+            r.cpu_ms_per_s = (after.cpu_us - before.cpu_us) / 1000.0;
+            r.wakeups_per_s = static_cast<double>(after.wakeups - before.wakeups);
+        });
+        endTimer_.expires_after(duration);
+        endTimer_.async_wait([this, batch](auto) {
+            if (batch) batch->stop();
+            timeTimer_.cancel();
+            boost::system::error_code ec;
+            socket_.close(ec);
+        });
+        worker.join();
+
+        r.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        r.cpu_ms_per_s /= r.seconds;
+        r.wakeups_per_s /= r.seconds;
+        r.replies = static_cast<int>(rtts.size());
+        if (!rtts.empty()) {
+            std::sort(rtts.begin(), rtts.end());
+            r.p50_rtt_us = rtts[rtts.size() / 2];
+            r.max_rtt_us = rtts.back();
+        }
+        return r;
+    }
+
+private:
+    using Handler = std::function<void(const wire::Header&, const uint8_t*)>;
+
+    void readHeader(Handler handler) {
+        boost::asio::async_read(socket_, boost::asio::buffer(header_), [this, handler](auto ec, size_t) {
+            if (ec) return;
+            auto h = wire::decodeHeader(header_.data());
+            payload_.resize(h.size);
+            boost::asio::async_read(socket_, boost::asio::buffer(payload_), [this, handler, h](auto ec, size_t) {
+                if (ec) return;
+                handler(h, payload_.data());
+                readHeader(handler);
+            });
+        });
+    }
+
+    void sendTime(net::BatchReceiver* batch) {
+        if (batch) batch->expectReply();
+        auto request = std::make_shared<std::vector<uint8_t>>(wire::encodeTime(++timeId_, wire::now()));
+        boost::asio::async_write(socket_, boost::asio::buffer(*request), [request](auto, size_t) {});
+        timeTimer_.expires_after(std::chrono::seconds(1));
+        timeTimer_.async_wait([this, batch](auto ec) {
+            if (!ec) sendTime(batch);
+        });
+    }
+
+    Mode mode_;
+    boost::asio::io_context io_;
+    tcp::socket socket_;
+    boost::asio::steady_timer timeTimer_;
+    boost::asio::steady_timer endTimer_;
+    std::array<uint8_t, wire::HEADER_SIZE> header_{};
+    std::vector<uint8_t> payload_;
+    uint16_t timeId_{0};
+    uint32_t checksum_{0};
+};
+
+RunResult measure(Mode mode, milliseconds interval) {
+    MockStreamServer server(interval);
+    Client client(mode, server.port());
+    return client.run(std::chrono::duration_cast<std::chrono::seconds>(RUN_TIME));
+}
+
+void report(Mode mode, const RunResult& r) {
+    log("   - " + toString(mode) + ": " + fmt(r.wakeups_per_s, 1) + " wakeups/s, " + fmt(r.cpu_ms_per_s, 2) +
+        " ms CPU/s, " + fmt(static_cast<double>(r.handlerCalls) / r.seconds, 1) + " handler calls/s, " +
+        std::to_string(r.chunks) + " chunks, max hold " + fmt(r.max_hold_ms, 1) + " ms, Time rtt p50 " +
+        fmt(r.p50_rtt_us) + " µs (max " + fmt(r.max_rtt_us) + ", " + std::to_string(r.replies) + " replies)");
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+TestResult test_budget() {
+    const std::string name = "LatencyBudget";
+    log("🧪 [" + name + "] budget from playout buffer depth");
+    auto start = Clock::now();
+
+    struct Case {
+        int depth_ms;
+        int budget_ms;
+    };
+    const Case cases[] = {{40, 20}, {200, 50}, {400, 100}, {1000, 250}, {4000, 250}};
+    bool passed = true;
+    for (const auto& c : cases) {
+        auto budget = net::latencyBudget(milliseconds(c.depth_ms));
+        log("   - " + std::to_string(c.depth_ms) + " ms buffer -> " + std::to_string(budget.count()) + " ms");
+        passed = passed && budget.count() == c.budget_ms;
+    }
+
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return {name, passed, passed ? "A quarter of the buffer, 20 - 250 ms" : "Unexpected budget", duration_ms};
+}
+
+TestResult test_wakeups() {
+    const std::string name = "Wakeups";
+    log("🧪 [" + name + "] 48 kHz/16/2 in 20 ms chunks, " + std::to_string(RUN_TIME.count()) + " s per mode, budget " +
+        std::to_string(net::latencyBudget(BUFFER_DEPTH).count()) + " ms");
+    auto start = Clock::now();
+
+    auto perMessage = measure(Mode::PerMessage, CHUNK_DURATION);
+    report(Mode::PerMessage, perMessage);
+    auto batched = measure(Mode::Batched, CHUNK_DURATION);
+    report(Mode::Batched, batched);
+    auto lowPower = measure(Mode::LowPower, CHUNK_DURATION);
+    report(Mode::LowPower, lowPower);
+
+    // Up to a budget's worth of chunks is still in the kernel when the run ends
+    auto budget = net::latencyBudget(BUFFER_DEPTH);
+    auto budget_ms = static_cast<double>(budget.count());
+    auto expected = static_cast<uint64_t>(RUN_TIME / CHUNK_DURATION);
+    auto held = static_cast<uint64_t>(budget / CHUNK_DURATION);
+    bool complete = lowPower.chunks + held + 2 >= expected && batched.chunks + 2 >= expected;
+    bool fewer = lowPower.wakeups_per_s * 4 < perMessage.wakeups_per_s && lowPower.cpu_ms_per_s < perMessage.cpu_ms_per_s;
+    bool bounded = lowPower.max_hold_ms <= budget_ms + 30;
+    bool replies = lowPower.replies >= perMessage.replies - 1 && lowPower.p50_rtt_us < 2000;
+    if (perMessage.wakeups_per_s > 0)
+        log("   - Low power: " + fmt(perMessage.wakeups_per_s / std::max(lowPower.wakeups_per_s, 0.1), 1) +
+            "× fewer wakeups, " + fmt(perMessage.cpu_ms_per_s / std::max(lowPower.cpu_ms_per_s, 0.001), 1) + "× less CPU");
+    if (!complete) log("   ❌ chunks missing (expected ~" + std::to_string(expected) + ")");
+    if (!bounded) log("   ❌ a chunk waited longer than the budget");
+    if (!replies) log("   ❌ Time replies held back");
+
+    bool passed = complete && fewer && bounded && replies;
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return {name, passed,
+            passed ? "Low-power mode coalesces wakeups within the budget, Time replies unaffected"
+                   : "Low-power mode did not cut wakeups and CPU within the budget",
+            duration_ms};
+}
+
+TestResult test_slow_stream() {
+    const std::string name = "SlowStream";
+    log("🧪 [" + name + "] stream at half the bitrate the low-water mark assumes");
+    auto start = Clock::now();
+
+    auto r = measure(Mode::LowPower, CHUNK_DURATION * 2);
+    report(Mode::LowPower, r);
+
+    auto budget = net::latencyBudget(BUFFER_DEPTH);
+    auto budget_ms = static_cast<double>(budget.count());
+    auto expected = static_cast<uint64_t>(RUN_TIME / (CHUNK_DURATION * 2));
+    auto held = static_cast<uint64_t>(budget / (CHUNK_DURATION * 2));
+    bool passed = r.chunks + held + 2 >= expected && r.max_hold_ms <= budget_ms + 30;
+
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return {name, passed,
+            passed ? "Budget timer bounds the hold when the mark is not reached"
+                   : "Chunks held past the budget or lost",
+            duration_ms};
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int run_all_tests() {
+    std::cout << "\n";
+    std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║       Batched / Low-Power Receive Benchmark                  ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════════════╝\n";
+    std::cout << "\n";
+
+    g_results.push_back(test_budget());
+    std::cout << "\n";
+    g_results.push_back(test_wakeups());
+    std::cout << "\n";
+    g_results.push_back(test_slow_stream());
+    std::cout << "\n";
+
+    int failed = 0;
+    for (const auto& result : g_results) {
+        std::string status = result.passed ? "✅ PASS" : "❌ FAIL";
+        std::cout << "  " << status << "  " << result.name << "\n";
+        std::cout << "         " << result.message << " (" << result.duration_ms << " ms)\n";
+        if (!result.passed) failed++;
+    }
+    std::cout << "\n";
+    return failed;
+}
+
+} // namespace batch_bench
+
+int main() {
+    return batch_bench::run_all_tests() == 0 ? 0 : 1;
+}
@@ -0,0 +1,298 @@
+/***
+    ChannelMixerBenchmark.cpp
+
+    Measures dsp::ChannelMixer, the channel mapping stage in front of the
+    AudioQueue (5.1 -> stereo, stereo -> mono, one side of a stereo pair),
+    against a scalar reference: the textbook loop over frames, outputs and
+    inputs with the channel counts as runtime values.
+
+    - Matrices: the ITU downmix and channel selections give the expected
+      gains per speaker.
+    - Accuracy: every specialized shape and the generic kernel match the
+      reference for random matrices and odd buffer sizes.
+    - Cost: ns per frame per shape over the player's 100 ms buffers (4800
+      frames at 48 kHz), and the AudioQueue bytes the mapping saves. The
+      specialized kernels must beat the reference; the generic fallback
+      for unusual layouts only has to stay close to it.
+
+    Build & run: ./scripts/run-linux-benchmarks.sh ChannelMixer
+
+    Copyright (C) 2025 SnapForge contributors
+    License: GPL-3.0
+***/
+
+#include "dsp/channel_mixer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace channel_mixer_bench {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t FRAMES = 4800;  // 100 ms at 48 kHz
+constexpr size_t TOTAL_FRAMES = 10'000'000;
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+    double duration_ms;
+};
+
+std::vector<TestResult> g_results;
+
+void log(const std::string& msg) {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::cout << "[" << std::put_time(std::localtime(&time), "%H:%M:%S") << "] " << msg << std::endl;
+}
+
+std::string fmt(double v, int precision = 1) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(precision) << v;
+    return out.str();
+}
+
+std::vector<float> noise(uint16_t channels, uint32_t frames, uint32_t seed) {
+    std::vector<float> pcm(static_cast<size_t>(frames) * channels);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    for (auto& s : pcm) s = dist(rng);
+    return pcm;
+}
+
+dsp::ChannelMatrix randomMatrix(uint16_t inputs, uint16_t outputs, uint32_t seed) {
+    dsp::ChannelMatrix matrix;
+    matrix.inputs = inputs;
+    matrix.outputs = outputs;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+    for (uint16_t o = 0; o < outputs; ++o)
+        for (uint16_t i = 0; i < inputs; ++i) matrix.gain[o][i] = (i % 3 == 2) ? 0.f : dist(rng);
+    return matrix;
+}
+
+// ============================================================================
+// Scalar reference
+// ============================================================================
+
+void reference(const dsp::ChannelMatrix& matrix, const float* in, float* out, uint32_t frames) {
+    for (uint32_t f = 0; f < frames; ++f) {
+        for (uint16_t o = 0; o < matrix.outputs; ++o) {
+            float sum = 0.f;
+            for (uint16_t i = 0; i < matrix.inputs; ++i) sum += matrix.gain[o][i] * in[f * matrix.inputs + i];
+            out[f * matrix.outputs + o] = sum;
+        }
+    }
+}
+
+// ============================================================================
+// Test 1: matrices
+// ============================================================================
+
+/// Output of @p mode for one frame of @p channels with only @p channel at 1
+std::vector<float> unitResponse(dsp::ChannelMode mode, uint16_t channels, uint16_t channel) {
+    auto matrix = dsp::downmixMatrix(mode, channels);
+    dsp::ChannelMixer mixer(matrix);
+    std::vector<float> in(channels, 0.f);
+    in[channel] = 1.f;
+    std::vector<float> out(std::max<uint16_t>(matrix.outputs, 1), 0.f);
+    mixer.process(in.data(), out.data(), 1);
+    return out;
+}
+
+TestResult test_matrices() {
+    TestResult result{"Downmix and selection matrices", true, "", 0};
+    auto start = Clock::now();
+
+    const float k = 0.70710678f;
+    struct Check {
+        const char* what;
+        dsp::ChannelMode mode;
+        uint16_t channels;
+        uint16_t channel;
+        std::vector<float> expected;
+    };
+    const Check checks[] = {
+        {"5.1 FL -> stereo", dsp::ChannelMode::Stereo, 6, 0, {1.f, 0.f}},
+        {"5.1 FC -> stereo", dsp::ChannelMode::Stereo, 6, 2, {k, k}},
+        {"5.1 LFE -> stereo", dsp::ChannelMode::Stereo, 6, 3, {0.f, 0.f}},
+        {"5.1 BL -> stereo", dsp::ChannelMode::Stereo, 6, 4, {k, 0.f}},
+        {"5.1 BR -> stereo", dsp::ChannelMode::Stereo, 6, 5, {0.f, k}},
+        {"7.1 SR -> stereo", dsp::ChannelMode::Stereo, 8, 7, {0.f, k}},
+        {"mono -> stereo", dsp::ChannelMode::Stereo, 1, 0, {1.f, 1.f}},
+        {"stereo FL -> mono", dsp::ChannelMode::Mono, 2, 0, {0.5f}},
+        {"5.1 FC -> mono", dsp::ChannelMode::Mono, 6, 2, {k}},
+        {"stereo FL -> left", dsp::ChannelMode::Left, 2, 0, {1.f}},
+        {"stereo FR -> left", dsp::ChannelMode::Left, 2, 1, {0.f}},
+        {"stereo FR -> right", dsp::ChannelMode::Right, 2, 1, {1.f}},
+        {"5.1 FC -> right", dsp::ChannelMode::Right, 6, 2, {k}},
+    };
+    int passed = 0;
+    for (const auto& check : checks) {
+        auto out = unitResponse(check.mode, check.channels, check.channel);
+        bool ok = (out.size() == check.expected.size());
+        for (size_t o = 0; ok && o < out.size(); ++o) ok = std::fabs(out[o] - check.expected[o]) < 1e-6f;
+        if (ok) {
+            ++passed;
+        } else {
+            result.passed = false;
+            result.message = std::string(check.what) + " gives " + fmt(out[0], 3) + (out.size() > 1 ? ", " + fmt(out[1], 3) : "");
+        }
+    }
+    log("  " + std::to_string(passed) + " of " + std::to_string(std::size(checks)) + " speaker gains as expected");
+
+    // No-ops and unsupported requests
+    if (!dsp::downmixMatrix(dsp::ChannelMode::Stereo, 2).identity() || dsp::downmixMatrix(dsp::ChannelMode::Native, 6).valid() ||
+        dsp::downmixMatrix(dsp::ChannelMode::Stereo, 9).valid()) {
+        result.passed = false;
+        result.message = "stereo -> stereo isn't an identity, or native / 9 channels gave a matrix";
+    }
+    if (result.passed) result.message = std::to_string(passed) + " speaker gains, identity and invalid cases as expected";
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Test 2: accuracy
+// ============================================================================
+
+struct Shape {
+    uint16_t inputs;
+    uint16_t outputs;
+};
+const Shape SHAPES[] = {{6, 2}, {6, 1}, {8, 2}, {2, 1}, {1, 2}, {2, 2}, {3, 2}, {8, 6}, {4, 1}};
+
+TestResult test_accuracy() {
+    TestResult result{"Kernels match scalar reference", true, "", 0};
+    auto start = Clock::now();
+
+    double worst = 0;
+    int specialized = 0;
+    for (const auto& shape : SHAPES) {
+        auto matrix = randomMatrix(shape.inputs, shape.outputs, shape.inputs * 10u + shape.outputs);
+        dsp::ChannelMixer mixer(matrix);
+        specialized += mixer.specialized() ? 1 : 0;
+        for (uint32_t frames : {1u, 31u, 33u, 997u}) {
+            auto in = noise(shape.inputs, frames, frames);
+            std::vector<float> out(static_cast<size_t>(frames) * shape.outputs, -9.f);
+            std::vector<float> expected(out.size());
+            mixer.process(in.data(), out.data(), frames);
+            reference(matrix, in.data(), expected.data(), frames);
+            for (size_t i = 0; i < out.size(); ++i) worst = std::max(worst, std::fabs(static_cast<double>(out[i] - expected[i])));
+        }
+    }
+    log("  " + std::to_string(std::size(SHAPES)) + " shapes (" + std::to_string(specialized) +
+        " specialized), largest difference to the reference " + fmt(worst * 1e9, 2) + "e-9");
+
+    if (worst > 1e-6) {
+        result.passed = false;
+        result.message = "difference to the reference " + fmt(worst * 1e6, 2) + "e-6";
+    } else {
+        result.message = "within " + fmt(worst * 1e9, 1) + "e-9 of the reference";
+    }
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Test 3: ns/frame
+// ============================================================================
+
+template <typename F>
+double nsPerFrame(F&& run) {
+    const size_t buffers = TOTAL_FRAMES / FRAMES;
+    run();  // warm-up
+    auto t0 = Clock::now();
+    for (size_t b = 0; b < buffers; ++b) run();
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / static_cast<double>(buffers * FRAMES);
+}
+
+TestResult test_speed() {
+    TestResult result{"Mapping cost per frame", true, "", 0};
+    auto start = Clock::now();
+
+    log("Shape    kernel        scalar   ChannelMixer   speedup   (ns/frame)");
+    double worstSpeedup = 1e9;
+    double worstGeneric = 1e9;
+    for (const auto& shape : SHAPES) {
+        // Real downmixes where there is one, a dense matrix otherwise
+        dsp::ChannelMatrix matrix = (shape.outputs == 2) ? dsp::downmixMatrix(dsp::ChannelMode::Stereo, shape.inputs)
+                                                         : dsp::downmixMatrix(dsp::ChannelMode::Mono, shape.inputs);
+        if (!matrix.valid() || matrix.outputs != shape.outputs) matrix = randomMatrix(shape.inputs, shape.outputs, 1);
+        dsp::ChannelMixer mixer(matrix);
+
+        auto in = noise(shape.inputs, FRAMES, 2);
+        std::vector<float> out(static_cast<size_t>(FRAMES) * shape.outputs);
+        double scalarNs = nsPerFrame([&] { reference(matrix, in.data(), out.data(), FRAMES); });
+        double ns = nsPerFrame([&] { mixer.process(in.data(), out.data(), FRAMES); });
+        double speedup = scalarNs / ns;
+        if (mixer.specialized())
+            worstSpeedup = std::min(worstSpeedup, speedup);
+        else
+            worstGeneric = std::min(worstGeneric, speedup);
+        log(std::to_string(shape.inputs) + " -> " + std::to_string(shape.outputs) + "   " + (mixer.specialized() ? "specialized" : "generic    ") +
+            "   " + fmt(scalarNs, 2) + "       " + fmt(ns, 2) + "          " + fmt(speedup, 1) + "x");
+    }
+
+    // What the AudioQueue no longer carries: 16-bit 5.1 on a stereo phone
+    const double kbIn = FRAMES * 6 * 2 / 1024.;
+    const double kbOut = FRAMES * 2 * 2 / 1024.;
+    log("  AudioQueue buffer, 16-bit 5.1 -> stereo: " + fmt(kbIn, 1) + " KiB -> " + fmt(kbOut, 1) + " KiB per 100 ms");
+
+    if (worstSpeedup < 1.0) {
+        result.passed = false;
+        result.message = "a specialized kernel is slower than the scalar reference (" + fmt(worstSpeedup, 2) + "x)";
+    } else if (worstGeneric < 0.7) {
+        result.passed = false;
+        result.message = "generic kernel at " + fmt(worstGeneric, 2) + "x the scalar reference";
+    } else {
+        result.message = "specialized at least " + fmt(worstSpeedup, 1) + "x the scalar reference, generic " + fmt(worstGeneric, 1) + "x";
+    }
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int run_all_tests() {
+    std::cout << "\n";
+    std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║       Channel Mixer Benchmark                                ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════════════╝\n";
+    std::cout << "\n";
+
+    g_results.push_back(test_matrices());
+    std::cout << "\n";
+    g_results.push_back(test_accuracy());
+    std::cout << "\n";
+    g_results.push_back(test_speed());
+    std::cout << "\n";
+
+    int failed = 0;
+    for (const auto& result : g_results) {
+        std::string status = result.passed ? "✅ PASS" : "❌ FAIL";
+        std::cout << "  " << status << "  " << result.name << "\n";
+        std::cout << "         " << result.message << " (" << result.duration_ms << " ms)\n";
+        if (!result.passed) failed++;
+    }
+    std::cout << "\n";
+    return failed;
+}
+
+} // namespace channel_mixer_bench
+
+int main() {
+    return channel_mixer_bench::run_all_tests() == 0 ? 0 : 1;
+}
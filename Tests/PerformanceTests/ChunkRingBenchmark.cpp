@@ -0,0 +1,367 @@
+/***
+    ChunkRingBenchmark.cpp
+
+    Compares playout::ChunkRing with a queue of individually allocated
+    chunks modelled on Snapcast's Stream (deque of shared PcmChunks, aged by
+    popping from the front, searched by walking it).
+
+    48 kHz/16-bit stereo, 20 ms chunks, 256-frame audio callbacks. For buffer
+    depths of 400 ms, 2 s and 10 s it measures:
+    - callback fill cost in steady state (read + trim, producer keeping the
+      buffer full), and heap allocations on that path;
+    - seek cost: filling a callback for an arbitrary playout time inside the
+      buffer, as after a resync or a latency change.
+
+    Also checks partial reads across chunk and ring boundaries, gaps,
+    overflow and out-of-order chunks against a reference.
+
+    Build & run: ./scripts/run-linux-benchmarks.sh ChunkRing
+
+    Copyright (C) 2025 SnapForge contributors
+    License: GPL-3.0
+***/
+
+#include "playout/chunk_ring.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Allocation counting
+// ============================================================================
+
+namespace {
+
+std::atomic<uint64_t> g_allocs{0};
+
+void* counted_alloc(size_t size) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+} // namespace
+
+void* operator new(size_t size) { return counted_alloc(size); }
+void* operator new[](size_t size) { return counted_alloc(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+
+namespace chunk_ring_bench {
+
+using Clock = std::chrono::steady_clock;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+constexpr uint32_t RATE = 48000;
+constexpr uint32_t FRAME_SIZE = 4;       // 16-bit stereo
+constexpr uint32_t CHUNK_FRAMES = 960;   // 20 ms
+constexpr int64_t CHUNK_US = 20000;
+constexpr uint32_t CALLBACK_FRAMES = 256;
+constexpr int SEEKS = 20000;
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+    double duration_ms;
+};
+
+std::vector<TestResult> g_results;
+
+void log(const std::string& msg) {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::cout << "[" << std::put_time(std::localtime(&time), "%H:%M:%S") << "] " << msg << std::endl;
+}
+
+std::string fmt(double v, int precision = 1) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(precision) << v;
+    return out.str();
+}
+
+/// Frame n of the test signal: unique per frame so misplaced reads show
+void fillChunk(std::vector<uint8_t>& pcm, int64_t firstFrame) {
+    for (uint32_t f = 0; f < CHUNK_FRAMES; ++f) {
+        auto v = static_cast<uint32_t>(firstFrame + f) | 0x80000000u;
+        std::memcpy(pcm.data() + f * FRAME_SIZE, &v, FRAME_SIZE);
+    }
+}
+
+// ============================================================================
+// Baseline: Stream-style queue of allocated chunks
+// ============================================================================
+
+struct PcmChunk {
+    int64_t start;
+    uint32_t frames;
+    std::vector<uint8_t> payload;
+    int64_t end() const { return start + static_cast<int64_t>(frames) * 1000000 / RATE; }
+};
+
+class ChunkQueue {
+public:
+    explicit ChunkQueue(milliseconds depth) : depthUs_(depth.count() * 1000) {}
+
+    void append(int64_t start, const uint8_t* pcm, uint32_t frames) {
+        auto chunk = std::make_shared<PcmChunk>();
+        chunk->start = start;
+        chunk->frames = frames;
+        chunk->payload.assign(pcm, pcm + frames * FRAME_SIZE);
+        chunks_.push_back(std::move(chunk));
+        while (chunks_.back()->end() - chunks_.front()->start > depthUs_)
+            chunks_.pop_front();
+    }
+
+    /// Age out chunks that ended, then copy from the front onwards
+    uint32_t readAndTrim(int64_t at, uint8_t* out, uint32_t frames) {
+        while (!chunks_.empty() && chunks_.front()->end() <= at)
+            chunks_.pop_front();
+        return copyFrom(chunks_.begin(), at, out, frames);
+    }
+
+    /// Locate the chunk for @p at by walking from the front
+    uint32_t seek(int64_t at, uint8_t* out, uint32_t frames) const {
+        auto it = chunks_.begin();
+        while (it != chunks_.end() && (*it)->end() <= at)
+            ++it;
+        return copyFrom(it, at, out, frames);
+    }
+
+private:
+    uint32_t copyFrom(std::deque<std::shared_ptr<PcmChunk>>::const_iterator it, int64_t at, uint8_t* out,
+                      uint32_t frames) const {
+        uint32_t produced = 0;
+        for (; it != chunks_.end() && produced < frames; ++it) {
+            const auto& c = **it;
+            int64_t t = at + static_cast<int64_t>(produced) * 1000000 / RATE;
+            auto offset = static_cast<uint32_t>(std::max<int64_t>(0, (t - c.start) * RATE / 1000000));
+            if (offset >= c.frames) continue;
+            uint32_t n = std::min(c.frames - offset, frames - produced);
+            std::memcpy(out + produced * FRAME_SIZE, c.payload.data() + offset * FRAME_SIZE, n * FRAME_SIZE);
+            produced += n;
+        }
+        std::memset(out + produced * FRAME_SIZE, 0, (frames - produced) * FRAME_SIZE);
+        return produced;
+    }
+
+    int64_t depthUs_;
+    std::deque<std::shared_ptr<PcmChunk>> chunks_;
+};
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+TestResult test_correctness() {
+    const std::string name = "Correctness";
+    log("🧪 [" + name + "] partial reads, wrap-around, gaps, overflow, order");
+    auto start = Clock::now();
+    std::vector<std::string> failures;
+    auto expect = [&failures](bool ok, const std::string& what) {
+        if (!ok) failures.push_back(what);
+    };
+
+    // 110 ms ring: five 20 ms chunks, the sixth wraps mid-chunk
+    playout::ChunkRing ring(RATE, FRAME_SIZE, milliseconds(110));
+    std::vector<uint8_t> pcm(CHUNK_FRAMES * FRAME_SIZE);
+    for (int i = 0; i < 5; ++i) {
+        fillChunk(pcm, i * CHUNK_FRAMES);
+        ring.append(microseconds(i * CHUNK_US), pcm.data(), CHUNK_FRAMES);
+    }
+    expect(ring.chunks() == 5 && ring.duration() == microseconds(100000), "fill to capacity");
+
+    // Read 1000 frames from 15 ms: crosses a chunk boundary mid-chunk
+    std::vector<uint32_t> out(1000);
+    uint32_t got = ring.read(microseconds(15000), out.data(), 1000);
+    bool seq = got == 1000;
+    for (uint32_t f = 0; f < 1000 && seq; ++f)
+        seq = (out[f] & 0x7fffffff) == 720 + f;
+    expect(seq, "partial read across chunks");
+
+    // Sixth chunk overflows: oldest dropped, data wraps in the byte ring
+    fillChunk(pcm, 5 * CHUNK_FRAMES);
+    ring.append(microseconds(5 * CHUNK_US), pcm.data(), CHUNK_FRAMES);
+    expect(ring.chunks() == 5 && ring.front() == microseconds(CHUNK_US) && ring.stats().dropped == 1, "overflow drops oldest");
+    got = ring.read(microseconds(90000), out.data(), 960);
+    seq = got == 960;
+    for (uint32_t f = 0; f < 960 && seq; ++f)
+        seq = (out[f] & 0x7fffffff) == 4320 + f;
+    expect(seq, "read across the ring's wrap point");
+
+    // Gap of 10 ms before the next chunk is zero-filled, then audio resumes
+    fillChunk(pcm, 6 * CHUNK_FRAMES);
+    ring.append(microseconds(130000), pcm.data(), CHUNK_FRAMES);
+    got = ring.read(microseconds(115000), out.data(), 960);
+    bool gap = got == 240 + 240;
+    for (uint32_t f = 240; f < 720 && gap; ++f)
+        gap = out[f] == 0;
+    gap = gap && (out[720] & 0x7fffffff) == 6 * CHUNK_FRAMES;
+    expect(gap, "gap zero-filled");
+
+    // Out-of-order chunk rejected
+    expect(!ring.append(microseconds(50000), pcm.data(), CHUNK_FRAMES) && ring.stats().rejected == 1, "out of order rejected");
+
+    // Trim keeps the chunk that covers the time
+    ring.trimBefore(microseconds(125000));
+    expect(ring.chunks() == 1 && ring.front() == microseconds(130000), "trim");
+
+    // Before the first chunk and after the last: silence, nothing from chunks
+    expect(ring.read(microseconds(0), out.data(), 100) == 0 && out[0] == 0, "read before front");
+    expect(ring.read(microseconds(200000), out.data(), 100) == 0, "read after back");
+
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    std::string message = "All cases match the reference";
+    if (!failures.empty()) {
+        message = "Failed:";
+        for (const auto& f : failures)
+            message += " " + f + ";";
+    }
+    return {name, failures.empty(), message, duration_ms};
+}
+
+struct Cost {
+    double fillNs;        // Per callback, steady state
+    double seekNs;        // Per callback at an arbitrary time
+    uint64_t allocs;      // During the steady-state run
+};
+
+template <typename Append, typename Fill, typename Seek>
+Cost measure(milliseconds depth, Append append, Fill fill, Seek seek) {
+    std::vector<uint8_t> pcm(CHUNK_FRAMES * FRAME_SIZE);
+    std::vector<uint8_t> out(CALLBACK_FRAMES * FRAME_SIZE);
+    const int64_t depthUs = depth.count() * 1000;
+
+    // Prefill the buffer depth
+    int64_t nextChunk = 0;
+    while (nextChunk * CHUNK_US + CHUNK_US <= depthUs) {
+        fillChunk(pcm, nextChunk * CHUNK_FRAMES);
+        append(nextChunk * CHUNK_US, pcm.data());
+        nextChunk++;
+    }
+
+    // Play 20 s: the callback reads from the front, the producer keeps it full
+    const int callbacks = static_cast<int>(20LL * RATE / CALLBACK_FRAMES);
+    int64_t playFrame = 0;
+    double fillTotal = 0;
+    uint64_t allocsBefore = g_allocs.load();
+    for (int i = 0; i < callbacks; ++i) {
+        int64_t at = playFrame * 1000000 / RATE;
+        while (nextChunk * CHUNK_US < at + depthUs - CHUNK_US) {
+            fillChunk(pcm, nextChunk * CHUNK_FRAMES);
+            append(nextChunk * CHUNK_US, pcm.data());
+            nextChunk++;
+        }
+        auto t = Clock::now();
+        fill(at, out.data());
+        fillTotal += std::chrono::duration<double, std::nano>(Clock::now() - t).count();
+        playFrame += CALLBACK_FRAMES;
+    }
+    uint64_t allocs = g_allocs.load() - allocsBefore;
+
+    // Seek anywhere in what is buffered
+    int64_t front = playFrame * 1000000 / RATE;
+    int64_t span = nextChunk * CHUNK_US - front - 10000;
+    // Best of three passes over the same positions: one preempted pass
+    // shouldn't decide the comparison
+    std::uniform_int_distribution<int64_t> pos(0, std::max<int64_t>(span, 1));
+    double seekNs = 0;
+    for (int pass = 0; pass < 3; ++pass) {
+        std::mt19937_64 rng(1);
+        auto t = Clock::now();
+        for (int i = 0; i < SEEKS; ++i)
+            seek(front + pos(rng), out.data());
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - t).count() / SEEKS;
+        seekNs = (pass == 0) ? ns : std::min(seekNs, ns);
+    }
+
+    return {fillTotal / callbacks, seekNs, allocs};
+}
+
+TestResult test_depths() {
+    const std::string name = "FillCost";
+    log("🧪 [" + name + "] 256-frame callbacks, 20 ms chunks, 20 s of playback");
+    auto start = Clock::now();
+    bool passed = true;
+
+    for (auto depth : {milliseconds(400), milliseconds(2000), milliseconds(10000)}) {
+        ChunkQueue queue(depth);
+        auto base = measure(
+            depth, [&](int64_t s, const uint8_t* pcm) { queue.append(s, pcm, CHUNK_FRAMES); },
+            [&](int64_t at, uint8_t* out) { queue.readAndTrim(at, out, CALLBACK_FRAMES); },
+            [&](int64_t at, uint8_t* out) { queue.seek(at, out, CALLBACK_FRAMES); });
+
+        playout::ChunkRing ring(RATE, FRAME_SIZE, depth);
+        auto fast = measure(
+            depth, [&](int64_t s, const uint8_t* pcm) { ring.append(microseconds(s), pcm, CHUNK_FRAMES); },
+            [&](int64_t at, uint8_t* out) {
+                ring.trimBefore(microseconds(at));
+                ring.read(microseconds(at), out, CALLBACK_FRAMES);
+            },
+            [&](int64_t at, uint8_t* out) { ring.read(microseconds(at), out, CALLBACK_FRAMES); });
+
+        log("   - " + std::to_string(depth.count()) + " ms (" + std::to_string(depth.count() / 20) + " chunks): fill " +
+            fmt(base.fillNs) + " → " + fmt(fast.fillNs) + " ns, seek " + fmt(base.seekNs) + " → " + fmt(fast.seekNs) +
+            " ns, allocations " + std::to_string(base.allocs) + " → " + std::to_string(fast.allocs));
+
+        // Steady-state fill is amortized O(1) for both; the ring must not
+        // allocate, and must beat the walk once the buffer is deep
+        passed = passed && fast.allocs == 0 && ring.stats().rejected == 0;
+        if (depth >= milliseconds(2000)) passed = passed && fast.seekNs < base.seekNs;
+    }
+
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return {name, passed,
+            passed ? "No allocations on the playout path; seek O(log n) instead of a walk"
+                   : "Ring allocated, rejected chunks, or seek not faster",
+            duration_ms};
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int run_all_tests() {
+    std::cout << "\n";
+    std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║       Chunk Ring Benchmark                                   ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════════════╝\n";
+    std::cout << "\n";
+
+    g_results.push_back(test_correctness());
+    std::cout << "\n";
+    g_results.push_back(test_depths());
+    std::cout << "\n";
+
+    int failed = 0;
+    for (const auto& result : g_results) {
+        std::string status = result.passed ? "✅ PASS" : "❌ FAIL";
+        std::cout << "  " << status << "  " << result.name << "\n";
+        std::cout << "         " << result.message << " (" << result.duration_ms << " ms)\n";
+        if (!result.passed) failed++;
+    }
+    std::cout << "\n";
+    return failed;
+}
+
+} // namespace chunk_ring_bench
+
+int main() {
+    return chunk_ring_bench::run_all_tests() == 0 ? 0 : 1;
+}
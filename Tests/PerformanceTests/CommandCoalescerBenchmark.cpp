@@ -0,0 +1,348 @@
+/***
+    CommandCoalescerBenchmark.cpp
+
+    Measures the control command coalescer against a loopback mock server
+    that answers each request after a fixed delay (network round trip plus
+    server processing), like a Snapcast server on Wi-Fi.
+
+    Part 1 drags a volume slider: one Client.SetVolume per UI event, sent
+    naively through request() vs. through setClientVolume(). It reports the
+    request volume and the settle time (last slider event until the server
+    and the local model both hold the final value).
+
+    Part 2 checks reconciliation: a stale notification arriving while a newer
+    command is queued is not applied, and the reply of the server (here:
+    clamping the volume) overrides the optimistic value.
+
+    Build & run: ./scripts/run-linux-benchmarks.sh CommandCoalescer
+
+    Copyright (C) 2025 SnapForge contributors
+    License: GPL-3.0
+***/
+
+#include "control/control_client.hpp"
+
+#include <boost/asio.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace coalescer_bench {
+
+using control::json;
+using boost::asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+
+constexpr auto SERVER_DELAY = std::chrono::milliseconds(20);
+constexpr auto SLIDER_PERIOD = std::chrono::milliseconds(8);  // ~120 Hz touch events
+constexpr int SLIDER_EVENTS = 120;
+const std::string CLIENT_ID = "00:11:22:33:44:55";
+const std::string GROUP_ID = "group-0";
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+    double duration_ms;
+};
+
+std::vector<TestResult> g_results;
+
+void log(const std::string& msg) {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::cout << "[" << std::put_time(std::localtime(&time), "%H:%M:%S") << "] " << msg << std::endl;
+}
+
+json makeServer() {
+    json client = {{"id", CLIENT_ID}, {"connected", true},
+                   {"config", {{"instance", 1}, {"latency", 0}, {"name", "Kitchen"},
+                               {"volume", {{"muted", false}, {"percent", 0}}}}},
+                   {"host", {{"ip", "192.168.1.10"}, {"name", "kitchen"}}}};
+    json group = {{"id", GROUP_ID}, {"name", ""}, {"muted", false}, {"stream_id", "default"}, {"clients", {client}}};
+    return {{"groups", {group}}, {"streams", json::array()}};
+}
+
+/// Serial mock server: one request at a time, each answered after SERVER_DELAY
+class MockServer {
+public:
+    /// Returns the reply result; may append notifications to push after it
+    using Handler = std::function<json(const std::string& method, const json& params, std::vector<json>& notify)>;
+
+    explicit MockServer(Handler handler)
+        : acceptor_(io_, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)), handler_(std::move(handler)) {
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    ~MockServer() { thread_.join(); }
+
+    uint16_t port() const { return acceptor_.local_endpoint().port(); }
+    int commands() const { return commands_.load(); }
+
+private:
+    void run() {
+        tcp::socket sock(io_);
+        acceptor_.accept(sock);
+        boost::asio::streambuf buf;
+        boost::system::error_code ec;
+        while (true) {
+            boost::asio::read_until(sock, buf, '\n', ec);
+            if (ec) return;
+            std::istream is(&buf);
+            std::string line;
+            std::getline(is, line);
+            json req = json::parse(line, nullptr, false);
+            if (req.is_discarded()) continue;
+
+            std::string method = req.at("method");
+            std::string out;
+            if (method == "Server.GetStatus") {
+                out = json({{"id", req.at("id")}, {"jsonrpc", "2.0"}, {"result", {{"server", makeServer()}}}}).dump() + "\r\n";
+            } else {
+                commands_.fetch_add(1);
+                std::this_thread::sleep_for(SERVER_DELAY);
+                std::vector<json> notify;
+                json result = handler_(method, req.value("params", json::object()), notify);
+                out = json({{"id", req.at("id")}, {"jsonrpc", "2.0"}, {"result", result}}).dump() + "\r\n";
+                for (const auto& n : notify)
+                    out += n.dump() + "\r\n";
+            }
+            boost::asio::write(sock, boost::asio::buffer(out), ec);
+            if (ec) return;
+        }
+    }
+
+    boost::asio::io_context io_;
+    tcp::acceptor acceptor_;
+    Handler handler_;
+    std::atomic<int> commands_{0};
+    std::thread thread_;
+};
+
+/// Runs a ControlClient on its own io thread
+struct ClientHarness {
+    boost::asio::io_context io;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work{io.get_executor()};
+    control::ControlClient client{io};
+    std::thread thread;
+    std::atomic<int> resets{0};
+    std::mutex volumesMutex;
+    std::vector<int> volumes;  ///< Every CLIENT_VOLUME value seen by the UI
+
+    explicit ClientHarness(uint16_t port) {
+        client.setChangeHandler([this](const control::Change& change) {
+            if (change.kind == control::ChangeKind::Reset) resets.fetch_add(1);
+            if (change.kind == control::ChangeKind::ClientVolume) {
+                std::lock_guard<std::mutex> lock(volumesMutex);
+                volumes.push_back(modelVolume());
+            }
+        });
+        client.connect("127.0.0.1", port);
+        thread = std::thread([this]() { io.run(); });
+        waitFor([this]() { return resets.load() > 0; }, std::chrono::seconds(5));
+    }
+
+    ~ClientHarness() {
+        client.disconnect();
+        work.reset();
+        thread.join();
+    }
+
+    int modelVolume() {
+        return client.withModel([](const control::ServerModel& model) {
+            const control::ClientState* c = model.client(CLIENT_ID);
+            return c ? c->volume : -1;
+        });
+    }
+
+    static bool waitFor(const std::function<bool()>& done, std::chrono::milliseconds timeout) {
+        auto deadline = Clock::now() + timeout;
+        while (!done()) {
+            if (Clock::now() > deadline) return false;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        return true;
+    }
+};
+
+// ============================================================================
+// Part 1: Slider drag, naive vs. coalesced
+// ============================================================================
+
+struct DragResult {
+    int requests;
+    double settle_ms;
+    bool settled;
+};
+
+DragResult runDrag(bool coalesced) {
+    std::atomic<int> server_volume{0};
+    MockServer server([&](const std::string& method, const json& params, std::vector<json>&) {
+        if (method != "Client.SetVolume") return json::object();
+        server_volume = params.at("volume").at("percent").get<int>();
+        return json{{"volume", params.at("volume")}};
+    });
+    ClientHarness harness(server.port());
+
+    int final_volume = 0;
+    for (int i = 1; i <= SLIDER_EVENTS; ++i) {
+        final_volume = (i * 100) / SLIDER_EVENTS;
+        if (coalesced) {
+            harness.client.setClientVolume(CLIENT_ID, final_volume, false);
+        } else {
+            json params = {{"id", CLIENT_ID}, {"volume", {{"muted", false}, {"percent", final_volume}}}};
+            harness.client.request("Client.SetVolume", params);
+        }
+        std::this_thread::sleep_for(SLIDER_PERIOD);
+    }
+    auto last_event = Clock::now();
+
+    bool settled = ClientHarness::waitFor([&]() {
+        // The naive path has no optimistic model update, only the server counts
+        return server_volume.load() == final_volume && (!coalesced || harness.modelVolume() == final_volume);
+    }, std::chrono::seconds(10));
+    double settle_ms = std::chrono::duration<double, std::milli>(Clock::now() - last_event).count();
+
+    return {server.commands(), settle_ms, settled};
+}
+
+TestResult test_slider_drag() {
+    const std::string name = "SliderDrag";
+    log("🧪 [" + name + "] " + std::to_string(SLIDER_EVENTS) + " volume events every " +
+        std::to_string(SLIDER_PERIOD.count()) + " ms, server answers after " + std::to_string(SERVER_DELAY.count()) + " ms");
+
+    auto start = Clock::now();
+    DragResult naive = runDrag(false);
+    DragResult coalesced = runDrag(true);
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    log("✅ [" + name + "] Complete:");
+    log("   - Naive:     " + std::to_string(naive.requests) + " requests, settled " +
+        std::to_string(naive.settle_ms) + " ms after the last event");
+    log("   - Coalesced: " + std::to_string(coalesced.requests) + " requests, settled " +
+        std::to_string(coalesced.settle_ms) + " ms after the last event");
+
+    // One request per round trip at most, and settling within about two of them
+    int max_requests = static_cast<int>(SLIDER_EVENTS * SLIDER_PERIOD / SERVER_DELAY) + 2;
+    bool passed = naive.settled && coalesced.settled && coalesced.requests <= max_requests &&
+                  coalesced.settle_ms < naive.settle_ms && coalesced.settle_ms < 3 * SERVER_DELAY.count();
+    return {name, passed,
+            passed ? "Fewer requests, final value reached within two round trips" : "Coalescing did not reduce load or settle time",
+            duration_ms};
+}
+
+// ============================================================================
+// Part 2: Reconciliation
+// ============================================================================
+
+TestResult test_stale_notification() {
+    const std::string name = "StaleNotification";
+    log("🧪 [" + name + "] notification from another controller while a newer command is queued");
+    auto start = Clock::now();
+
+    std::atomic<int> server_volume{0};
+    MockServer server([&](const std::string&, const json& params, std::vector<json>& notify) {
+        server_volume = params.at("volume").at("percent").get<int>();
+        // Another controller moved the volume right after our first command
+        if (server_volume == 20)
+            notify.push_back({{"jsonrpc", "2.0"}, {"method", "Client.OnVolumeChanged"},
+                              {"params", {{"id", CLIENT_ID}, {"volume", {{"muted", false}, {"percent", 55}}}}}});
+        return json{{"volume", params.at("volume")}};
+    });
+    ClientHarness harness(server.port());
+    harness.client.setCommandInterval(std::chrono::milliseconds(100));
+
+    harness.client.setClientVolume(CLIENT_ID, 20, false);  // Sent at once
+    harness.client.setClientVolume(CLIENT_ID, 30, false);  // Waits for the interval
+    bool settled = ClientHarness::waitFor([&]() { return server.commands() == 2 && harness.modelVolume() == 30; },
+                                          std::chrono::seconds(5));
+    std::this_thread::sleep_for(SERVER_DELAY * 2);
+
+    std::vector<int> seen;
+    {
+        std::lock_guard<std::mutex> lock(harness.volumesMutex);
+        seen = harness.volumes;
+    }
+    bool jumped = false;
+    for (int v : seen)
+        jumped |= (v == 55);
+    auto stats = harness.client.stats();
+
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    log("✅ [" + name + "] Complete:");
+    log("   - UI volume events: " + std::to_string(seen.size()) + ", commands sent: " + std::to_string(stats.commandsSent) +
+        ", final model: " + std::to_string(harness.modelVolume()) + ", server: " + std::to_string(server_volume.load()) +
+        ", stale notifications: " + std::to_string(stats.stale) + ", applied: " + std::to_string(stats.incremental));
+
+    // The ignored notification is stale, not applied
+    bool passed = settled && !jumped && server_volume == 30 && harness.modelVolume() == 30 && stats.stale == 1 &&
+                  stats.incremental == 0;
+    return {name, passed, passed ? "Stale notification ignored, latest value kept" : "UI jumped back or final value lost",
+            duration_ms};
+}
+
+TestResult test_server_clamp() {
+    const std::string name = "ServerReconcile";
+    log("🧪 [" + name + "] server applies a different value than requested");
+    auto start = Clock::now();
+
+    MockServer server([&](const std::string&, const json& params, std::vector<json>&) {
+        json volume = params.at("volume");
+        volume["percent"] = std::min(80, volume.at("percent").get<int>());  // Volume limit on the server
+        return json{{"volume", volume}};
+    });
+    ClientHarness harness(server.port());
+
+    harness.client.setClientVolume(CLIENT_ID, 95, false);
+    bool optimistic = ClientHarness::waitFor([&]() { return harness.modelVolume() == 95; }, std::chrono::seconds(1));
+    bool reconciled = ClientHarness::waitFor([&]() { return harness.modelVolume() == 80; }, std::chrono::seconds(5));
+
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    log("✅ [" + name + "] Complete: optimistic 95 → server 80");
+
+    bool passed = optimistic && reconciled;
+    return {name, passed, passed ? "Optimistic value replaced by the server's" : "Model not reconciled with the reply",
+            duration_ms};
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int run_all_tests() {
+    std::cout << "\n";
+    std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║       Command Coalescer Benchmark                            ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════════════╝\n";
+    std::cout << "\n";
+
+    g_results.push_back(test_slider_drag());
+    std::cout << "\n";
+    g_results.push_back(test_stale_notification());
+    std::cout << "\n";
+    g_results.push_back(test_server_clamp());
+    std::cout << "\n";
+
+    int failed = 0;
+    for (const auto& result : g_results) {
+        std::string status = result.passed ? "✅ PASS" : "❌ FAIL";
+        std::cout << "  " << status << "  " << result.name << "\n";
+        std::cout << "         " << result.message << " (" << result.duration_ms << " ms)\n";
+        if (!result.passed) failed++;
+    }
+    std::cout << "\n";
+    return failed;
+}
+
+} // namespace coalescer_bench
+
+int main() {
+    return coalescer_bench::run_all_tests() == 0 ? 0 : 1;
+}
@@ -0,0 +1,331 @@
+/***
+    DeadlineSchedulerBenchmark.cpp
+
+    Checks realtime::policyFor() and DeadlineScheduler against the buffer
+    geometries the player uses, and measures deadline misses of a periodic
+    audio-style thread under CPU load with each scheduling backend.
+
+    The audio thread wakes every 256 frames at 48 kHz (5.3 ms), does 0.5 ms
+    of work and must be done within the derived constraint (half a period).
+    Three spinner threads at default priority compete for the CPUs. Runs
+    with default scheduling, SCHED_FIFO and SCHED_DEADLINE; a backend the
+    host refuses (no CAP_SYS_NICE, containers) is reported and skipped.
+
+    Also checks DeadlineMonitor on synthetic timestamps: on-time fills,
+    late wakeups, long fills and re-anchoring after a pause.
+
+    Build & run: ./scripts/run-linux-benchmarks.sh DeadlineScheduler
+
+    Copyright (C) 2025 SnapForge contributors
+    License: GPL-3.0
+***/
+
+#include "realtime/deadline_scheduler.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace deadline_bench {
+
+using Clock = std::chrono::steady_clock;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+
+constexpr uint32_t RATE = 48000;
+constexpr uint32_t FRAMES = 256;
+constexpr int PERIODS = 600;
+constexpr auto WORK = microseconds(500);
+constexpr int SPINNERS = 3;
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+    double duration_ms;
+};
+
+std::vector<TestResult> g_results;
+
+void log(const std::string& msg) {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::cout << "[" << std::put_time(std::localtime(&time), "%H:%M:%S") << "] " << msg << std::endl;
+}
+
+std::string fmt(double v, int precision = 1) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(precision) << v;
+    return out.str();
+}
+
+double us(nanoseconds ns) {
+    return static_cast<double>(ns.count()) / 1000.0;
+}
+
+// ============================================================================
+// Test 1: policy derivation and re-apply on geometry change
+// ============================================================================
+
+TestResult test_policy() {
+    TestResult result{"Policy from buffer geometry", true, "", 0};
+    auto start = Clock::now();
+
+    log("Geometry                     period  computation   constraint (us)");
+    const realtime::BufferGeometry geometries[] = {
+        {48000, 4800, 4},   // the player's 100 ms buffers
+        {44100, 4410, 4},
+        {48000, 256, 4},    // low-latency
+        {96000, 128, 3},
+        {192000, 19200, 4},
+    };
+    for (const auto& g : geometries) {
+        auto p = realtime::policyFor(g);
+        std::ostringstream row;
+        row << "  " << std::left << std::setw(24)
+            << (std::to_string(g.framesPerBuffer) + " @ " + std::to_string(g.sampleRate) + " Hz x " + std::to_string(g.buffers)) << std::right
+            << std::setw(10) << fmt(us(p.period)) << std::setw(13) << fmt(us(p.computation)) << std::setw(13) << fmt(us(p.constraint));
+        log(row.str());
+        auto expected = nanoseconds(static_cast<int64_t>(g.framesPerBuffer) * 1'000'000'000 / g.sampleRate);
+        if (p.period != expected || p.computation.count() <= 0 || p.computation > p.constraint || p.constraint > p.period) {
+            result.passed = false;
+            result.message = "invalid policy for " + std::to_string(g.framesPerBuffer) + " frames";
+        }
+    }
+    // The old fixed policy: 20 ms constraint, longer than a low-latency
+    // period, so a late fill could never count as late
+    log("  fixed policy: constraint 20000.0 us = " + fmt(20000.0 / us(realtime::policyFor(geometries[2]).period), 2) + " periods of 256 frames");
+
+    if (realtime::policyFor({0, 256, 4}).period.count() != 0) {
+        result.passed = false;
+        result.message = "invalid geometry produced a policy";
+    }
+
+    // Re-apply only on change (the backend may be None without privileges,
+    // in which case every update retries). On a thread of its own: a
+    // SCHED_DEADLINE thread may not create threads.
+    std::thread([&result] {
+        realtime::DeadlineScheduler scheduler;
+        bool first = scheduler.update({48000, 4800, 4});
+        if (scheduler.backend() == realtime::Backend::None) {
+            log("  update: no real-time backend available, re-apply check skipped");
+            return;
+        }
+        bool same = scheduler.update({48000, 4800, 4});
+        bool changed = scheduler.update({44100, 4410, 4});
+        log("  update: first " + std::string(first ? "applied" : "not applied") + ", same geometry " + (same ? "applied" : "skipped") +
+            ", new geometry " + (changed ? "applied" : "skipped") + " via " + realtime::toString(scheduler.backend()));
+        if (same || !changed || scheduler.policy().period != realtime::policyFor({44100, 4410, 4}).period) {
+            result.passed = false;
+            result.message = "policy not re-applied on geometry change only";
+        }
+    }).join();
+
+    if (result.passed)
+        result.message = "period = buffer duration, computation <= constraint <= period, re-applied on change";
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Test 2: DeadlineMonitor on synthetic timestamps
+// ============================================================================
+
+TestResult test_monitor() {
+    TestResult result{"Deadline monitor", true, "", 0};
+    auto start = Clock::now();
+
+    realtime::DeadlineMonitor monitor;
+    monitor.setPolicy({milliseconds(10), milliseconds(1), milliseconds(5)});
+    const Clock::time_point t0 = Clock::now();
+    auto at = [&](double ms) { return t0 + microseconds(static_cast<int64_t>(ms * 1000)); };
+
+    // 10 on-time fills of 1 ms
+    for (int i = 0; i < 10; ++i) {
+        monitor.begin(at(i * 10.0));
+        monitor.end(at(i * 10.0 + 1));
+    }
+    uint64_t onTime = monitor.misses();
+    // Woken 4.5 ms late, 1 ms of work: 5.5 ms after release
+    monitor.begin(at(104.5));
+    monitor.end(at(105.5));
+    // Back on the grid, long fill of 6 ms
+    monitor.begin(at(110));
+    monitor.end(at(116));
+    // On time again, the late wakeup didn't shift the grid
+    monitor.begin(at(120));
+    monitor.end(at(121));
+    uint64_t late = monitor.misses();
+    // Pause of 200 ms: re-anchored, not 20 periods late
+    monitor.begin(at(321));
+    monitor.end(at(322));
+    uint64_t afterPause = monitor.misses();
+
+    log("  on time: " + std::to_string(onTime) + " misses, late wakeup + long fill: " + std::to_string(late - onTime) +
+        ", after pause: " + std::to_string(afterPause - late) + ", worst response " + std::to_string(monitor.worstResponseUs()) + " us");
+    if (onTime != 0 || late != 2 || afterPause != late || monitor.fills() != 14 || monitor.worstResponseUs() != 6000) {
+        result.passed = false;
+        result.message = "unexpected miss count";
+    } else {
+        result.message = "late wakeup and long fill counted, pause re-anchors the grid";
+    }
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Test 3: misses under load per backend
+// ============================================================================
+
+enum class Mode { Default, Fifo, Deadline };
+
+const char* modeName(Mode mode) {
+    switch (mode) {
+        case Mode::Default: return "default";
+        case Mode::Fifo: return "SCHED_FIFO";
+        case Mode::Deadline: return "SCHED_DEADLINE";
+    }
+    return "?";
+}
+
+struct LoadRun {
+    bool applied{false};
+    uint64_t fills{0};
+    uint64_t misses{0};
+    int64_t worstUs{0};
+};
+
+void spin(nanoseconds duration) {
+    auto end = Clock::now() + duration;
+    while (Clock::now() < end) {
+    }
+}
+
+LoadRun runUnderLoad(Mode mode) {
+    LoadRun run;
+    std::atomic<bool> done{false};
+    std::vector<std::thread> spinners;
+    for (int i = 0; i < SPINNERS; ++i) {
+        spinners.emplace_back([&done] {
+            while (!done.load(std::memory_order_relaxed))
+                spin(microseconds(100));
+        });
+    }
+
+    std::thread audio([&] {
+        const realtime::BufferGeometry geometry{RATE, FRAMES, 4};
+        const auto policy = realtime::policyFor(geometry);
+        realtime::DeadlineMonitor monitor;
+        monitor.setPolicy(policy);
+        if (mode == Mode::Default) {
+            run.applied = true;
+        } else {
+            auto backend = realtime::applyToCurrentThread(policy, mode == Mode::Deadline);
+            run.applied = (mode == Mode::Deadline) ? (backend == realtime::Backend::Deadline) : (backend == realtime::Backend::Fifo);
+        }
+        if (!run.applied)
+            return;
+
+        // Periodic release on an absolute grid, as the audio device pulls
+        timespec next;
+        clock_gettime(CLOCK_MONOTONIC, &next);
+        for (int i = 0; i < PERIODS; ++i) {
+            next.tv_nsec += policy.period.count();
+            while (next.tv_nsec >= 1'000'000'000) {
+                next.tv_nsec -= 1'000'000'000;
+                next.tv_sec++;
+            }
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+            realtime::DeadlineMonitor::Scope scope(monitor);
+            spin(WORK);
+        }
+        run.fills = monitor.fills();
+        run.misses = monitor.misses();
+        run.worstUs = monitor.worstResponseUs();
+    });
+    audio.join();
+
+    done = true;
+    for (auto& t : spinners)
+        t.join();
+    return run;
+}
+
+TestResult test_load() {
+    TestResult result{"Deadline misses under load", true, "", 0};
+    auto start = Clock::now();
+
+    const auto policy = realtime::policyFor({RATE, FRAMES, 4});
+    log("Period " + fmt(us(policy.period)) + " us, work " + std::to_string(WORK.count()) + " us, constraint " + fmt(us(policy.constraint)) +
+        " us, " + std::to_string(SPINNERS) + " spinners, " + std::to_string(std::thread::hardware_concurrency()) + " CPUs");
+
+    LoadRun runs[3];
+    const Mode modes[] = {Mode::Default, Mode::Fifo, Mode::Deadline};
+    for (int m = 0; m < 3; ++m) {
+        runs[m] = runUnderLoad(modes[m]);
+        if (!runs[m].applied) {
+            log("  " + std::string(modeName(modes[m])) + ": not permitted here, skipped");
+            continue;
+        }
+        log("  " + std::string(modeName(modes[m])) + ": " + std::to_string(runs[m].misses) + " / " + std::to_string(runs[m].fills) +
+            " missed (" + fmt(100.0 * static_cast<double>(runs[m].misses) / static_cast<double>(runs[m].fills), 2) + "%), worst response " +
+            std::to_string(runs[m].worstUs) + " us");
+    }
+
+    // A real-time backend must keep misses at or below the default policy's
+    // and under 1% of the fills
+    std::string summary = "default " + std::to_string(runs[0].misses);
+    for (int m = 1; m < 3; ++m) {
+        if (!runs[m].applied)
+            continue;
+        summary += std::string(", ") + modeName(modes[m]) + " " + std::to_string(runs[m].misses);
+        if (runs[m].misses > runs[0].misses || runs[m].misses * 100 > runs[m].fills) {
+            result.passed = false;
+        }
+    }
+    result.message = summary + " misses of " + std::to_string(PERIODS) + " fills";
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int run_all_tests() {
+    std::cout << "\n";
+    std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║       Deadline Scheduler Benchmark                           ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════════════╝\n";
+    std::cout << "\n";
+
+    g_results.push_back(test_policy());
+    std::cout << "\n";
+    g_results.push_back(test_monitor());
+    std::cout << "\n";
+    g_results.push_back(test_load());
+    std::cout << "\n";
+
+    int failed = 0;
+    for (const auto& result : g_results) {
+        std::string status = result.passed ? "✅ PASS" : "❌ FAIL";
+        std::cout << "  " << status << "  " << result.name << "\n";
+        std::cout << "         " << result.message << " (" << result.duration_ms << " ms)\n";
+        if (!result.passed) failed++;
+    }
+    std::cout << "\n";
+    return failed;
+}
+
+} // namespace deadline_bench
+
+int main() {
+    return deadline_bench::run_all_tests() == 0 ? 0 : 1;
+}
@@ -0,0 +1,385 @@
+/***
+    DitherBenchmark.cpp
+
+    Measures dsp::Dither, the TPDF dither (optionally noise shaped) used
+    when the AudioQueue opens with fewer bits than the stream, against plain
+    quantization (playout::toNative) and a scalar dither loop.
+
+    - Linearity: with TPDF dither a level between two steps comes out as
+      that level on average, and the error power doesn't depend on the
+      signal (no noise modulation), at 16 and 24 bits.
+    - Spectrum: a 1 kHz tone of 2 LSB (about -87 dBFS, a quiet passage at
+      low volume). The spectrum of the quantization error must show no
+      harmonics above its floor, the floor must be at the TPDF level
+      (1/4 LSB^2), and noise shaping must lower it below 4 kHz.
+    - Cost: ns per sample over the player's 100 ms stereo buffers (9600
+      samples at 48 kHz), dithered against the plain conversion and the
+      scalar loop.
+
+    Build & run: ./scripts/run-linux-benchmarks.sh Dither
+
+    Copyright (C) 2025 SnapForge contributors
+    License: GPL-3.0
+***/
+
+#include "dsp/dither.hpp"
+#include "playout/render_kernels.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace dither_bench {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t RATE = 48000;
+constexpr uint32_t FRAMES = 4800;  // 100 ms at 48 kHz
+constexpr size_t TOTAL_SAMPLES = 20'000'000;
+constexpr double LSB16 = 1. / 32768.;
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+    double duration_ms;
+};
+
+std::vector<TestResult> g_results;
+
+void log(const std::string& msg) {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::cout << "[" << std::put_time(std::localtime(&time), "%H:%M:%S") << "] " << msg << std::endl;
+}
+
+std::string fmt(double v, int precision = 1) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(precision) << v;
+    return out.str();
+}
+
+double dB(double power) {
+    return 10. * std::log10(std::max(power, 1e-30));
+}
+
+// ============================================================================
+// Scalar reference: one generator, lrint and clamp per sample
+// ============================================================================
+
+void reference(const float* in, int16_t* out, size_t samples, uint32_t& state) {
+    for (size_t i = 0; i < samples; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        float d = static_cast<float>(static_cast<int32_t>((state & 0xFFFF) + (state >> 16)) - 65535) / 65536.f;
+        long q = std::lrint(in[i] * 32768.f + d);
+        out[i] = static_cast<int16_t>(std::clamp(q, -32768L, 32767L));
+    }
+}
+
+// ============================================================================
+// Test 1: linearity
+// ============================================================================
+
+struct ErrorStats {
+    double mean;      // LSB
+    double variance;  // LSB^2
+};
+
+/// Quantize a constant @p level (in LSB of @p bits) and measure the error
+ErrorStats constantError(uint16_t bits, double level) {
+    const double scale = (bits == 16) ? 32768. : 8388608.;
+    const size_t samples = 200'000;
+    std::vector<float> in(samples, static_cast<float>(level / scale));
+    std::vector<int32_t> out32(samples);
+    std::vector<int16_t> out16(samples);
+    dsp::Dither dither(1, bits);
+    dither.process(in.data(), (bits == 16) ? static_cast<void*>(out16.data()) : static_cast<void*>(out32.data()),
+                   static_cast<uint32_t>(samples));
+
+    double sum = 0, sum2 = 0;
+    for (size_t i = 0; i < samples; ++i) {
+        // The input as the float actually holds it
+        double e = ((bits == 16) ? out16[i] : out32[i]) - static_cast<double>(in[i]) * scale;
+        sum += e;
+        sum2 += e * e;
+    }
+    double mean = sum / samples;
+    return {mean, sum2 / samples - mean * mean};
+}
+
+TestResult test_linearity() {
+    TestResult result{"Dither linearizes the quantizer", true, "", 0};
+    auto start = Clock::now();
+
+    // Undithered, 0.3 LSB is lost entirely
+    std::vector<float> dc(1000, static_cast<float>(0.3 * LSB16));
+    std::vector<int16_t> plain(dc.size());
+    playout::toNative(dc.data(), plain.data(), dc.size(), 16);
+    log("  0.3 LSB undithered: " + std::to_string(plain[0]) + " LSB");
+
+    log("bits   level (LSB)   mean out - in   error power (LSB^2)");
+    double worstBias = 0;
+    double minPower = 1e9, maxPower = 0;
+    for (uint16_t bits : {uint16_t(16), uint16_t(24)}) {
+        for (double level : {0.0, 0.25, 0.3, 0.5, -1.7, 1000.75}) {
+            auto stats = constantError(bits, level);
+            worstBias = std::max(worstBias, std::fabs(stats.mean));
+            minPower = std::min(minPower, stats.variance);
+            maxPower = std::max(maxPower, stats.variance);
+            log(std::to_string(bits) + "     " + fmt(level, 2) + "          " + fmt(stats.mean, 4) + "          " +
+                fmt(stats.variance, 4));
+        }
+    }
+
+    // TPDF: 1/12 of quantization plus 1/6 of dither, whatever the level
+    if (worstBias > 0.01) {
+        result.passed = false;
+        result.message = "mean error " + fmt(worstBias, 4) + " LSB: the quantizer is biased";
+    } else if (minPower < 0.24 || maxPower > 0.26) {
+        result.passed = false;
+        result.message = "error power " + fmt(minPower, 3) + " .. " + fmt(maxPower, 3) + " LSB^2, expected 0.25 at every level";
+    } else {
+        result.message = "mean error within " + fmt(worstBias, 4) + " LSB, power " + fmt(minPower, 3) + " .. " + fmt(maxPower, 3) +
+                         " LSB^2 at every level";
+    }
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Test 2: spectrum of the quantization error
+// ============================================================================
+
+constexpr size_t FFT_SIZE = 65536;
+constexpr size_t TONE_BIN = 1365;  // 999.8 Hz, exactly periodic over the FFT
+
+void fft(std::vector<std::complex<double>>& x) {
+    const size_t n = x.size();
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) std::swap(x[i], x[j]);
+    }
+    for (size_t len = 2; len <= n; len <<= 1) {
+        const double angle = -2. * M_PI / static_cast<double>(len);
+        const std::complex<double> step(std::cos(angle), std::sin(angle));
+        for (size_t i = 0; i < n; i += len) {
+            std::complex<double> w(1.);
+            for (size_t k = 0; k < len / 2; ++k) {
+                auto u = x[i + k];
+                auto v = x[i + k + len / 2] * w;
+                x[i + k] = u + v;
+                x[i + k + len / 2] = u - v;
+                w *= step;
+            }
+        }
+    }
+}
+
+struct Spectrum {
+    double total;      // error power, LSB^2
+    double harmonics;  // power in the bins of harmonics 2..10 over the floor there, dB
+    double lowBand;    // error power below 4 kHz, LSB^2
+};
+
+/// @p out is the quantized tone, @p in the float it came from
+Spectrum errorSpectrum(const std::vector<float>& in, const std::vector<int16_t>& out) {
+    std::vector<std::complex<double>> e(FFT_SIZE);
+    double total = 0;
+    for (size_t i = 0; i < FFT_SIZE; ++i) {
+        double err = out[i] - static_cast<double>(in[i]) * 32768.;
+        e[i] = err;
+        total += err * err;
+    }
+    fft(e);
+
+    // Power per bin, normalized so the bins sum to the mean square
+    const size_t half = FFT_SIZE / 2;
+    std::vector<double> power(half);
+    for (size_t k = 1; k < half; ++k) power[k] = 2. * std::norm(e[k]) / (static_cast<double>(FFT_SIZE) * FFT_SIZE);
+
+    std::vector<bool> harmonic(half, false);
+    double harmonicPower = 0;
+    for (size_t m = 2; m <= 10; ++m) {
+        size_t bin = (m * TONE_BIN) % FFT_SIZE;
+        if (bin >= half) bin = FFT_SIZE - bin;
+        harmonic[bin] = true;
+        harmonicPower += power[bin];
+    }
+    // Floor: the other bins around the harmonics (2 .. 14 kHz)
+    double floor = 0;
+    size_t floorBins = 0;
+    for (size_t k = TONE_BIN + 1; k < 10 * TONE_BIN; ++k) {
+        if (harmonic[k]) continue;
+        floor += power[k];
+        ++floorBins;
+    }
+    floor /= static_cast<double>(floorBins);
+
+    const size_t lowBins = static_cast<size_t>(4000. * FFT_SIZE / RATE);
+    double low = 0;
+    for (size_t k = 1; k < lowBins; ++k) low += power[k];
+    return {total / FFT_SIZE, dB(harmonicPower / (9. * floor)), low};
+}
+
+TestResult test_spectrum() {
+    TestResult result{"Error spectrum of a quiet tone", true, "", 0};
+    auto start = Clock::now();
+
+    std::vector<float> tone(FFT_SIZE);
+    for (size_t i = 0; i < FFT_SIZE; ++i)
+        tone[i] = static_cast<float>(2. * LSB16 * std::sin(2. * M_PI * TONE_BIN * static_cast<double>(i) / FFT_SIZE));
+    log("  Tone: " + fmt(TONE_BIN * static_cast<double>(RATE) / FFT_SIZE, 1) + " Hz at 2 LSB (" + fmt(dB(2. * LSB16 * 2. * LSB16 / 2.), 1) +
+        " dBFS)");
+
+    std::vector<int16_t> out(FFT_SIZE);
+    playout::toNative(tone.data(), out.data(), FFT_SIZE, 16);
+    auto plain = errorSpectrum(tone, out);
+
+    dsp::Dither flat(1, 16);
+    flat.process(tone.data(), out.data(), FFT_SIZE);
+    auto tpdf = errorSpectrum(tone, out);
+
+    dsp::DitherOptions options;
+    options.noiseShaping = true;
+    dsp::Dither shapedDither(1, 16, options);
+    shapedDither.process(tone.data(), out.data(), FFT_SIZE);
+    auto shaped = errorSpectrum(tone, out);
+
+    log("Quantizer      error power      harmonics over floor   below 4 kHz");
+    auto row = [](const char* name, const Spectrum& s) {
+        log(std::string(name) + fmt(dB(s.total), 1) + " dB LSB^2      " + fmt(s.harmonics, 1) + " dB                " + fmt(dB(s.lowBand), 1) +
+            " dB LSB^2");
+    };
+    row("plain          ", plain);
+    row("TPDF           ", tpdf);
+    row("TPDF + shaping ", shaped);
+    const double shapingGain = dB(tpdf.lowBand) - dB(shaped.lowBand);
+    log("  Noise shaping: " + fmt(shapingGain, 1) + " dB less noise below 4 kHz, " + fmt(dB(shaped.total) - dB(tpdf.total), 1) +
+        " dB more in total");
+
+    if (plain.harmonics < 10.) {
+        result.passed = false;
+        result.message = "plain quantization shows no distortion (" + fmt(plain.harmonics, 1) + " dB): the test tone is wrong";
+    } else if (tpdf.harmonics > 3. || shaped.harmonics > 3.) {
+        result.passed = false;
+        result.message = "harmonics " + fmt(std::max(tpdf.harmonics, shaped.harmonics), 1) + " dB over the dithered noise floor";
+    } else if (std::fabs(dB(tpdf.total) - dB(0.25)) > 0.3) {
+        result.passed = false;
+        result.message = "TPDF noise floor " + fmt(dB(tpdf.total), 2) + " dB LSB^2, expected " + fmt(dB(0.25), 2);
+    } else if (shapingGain < 10.) {
+        result.passed = false;
+        result.message = "noise shaping lowers the noise below 4 kHz by " + fmt(shapingGain, 1) + " dB only";
+    } else {
+        result.message = "distortion " + fmt(plain.harmonics, 0) + " dB over the floor undithered, none dithered; floor " + fmt(dB(tpdf.total), 1) +
+                         " dB LSB^2, shaped " + fmt(shapingGain, 1) + " dB lower below 4 kHz";
+    }
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Test 3: ns/sample
+// ============================================================================
+
+template <typename F>
+double nsPerSample(F&& run, size_t samples) {
+    const size_t buffers = TOTAL_SAMPLES / samples;
+    run();  // warm-up
+    auto t0 = Clock::now();
+    for (size_t b = 0; b < buffers; ++b) run();
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / static_cast<double>(buffers * samples);
+}
+
+TestResult test_speed() {
+    TestResult result{"Dither cost per sample", true, "", 0};
+    auto start = Clock::now();
+
+    const size_t samples = FRAMES * 2;
+    std::vector<float> in(samples);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    for (auto& s : in) s = dist(rng);
+    std::vector<int16_t> out(samples);
+    std::vector<int32_t> out24(samples);
+
+    uint32_t state = 0x12345678;
+    double plainNs = nsPerSample([&] { playout::toNative(in.data(), out.data(), samples, 16); }, samples);
+    double scalarNs = nsPerSample([&] { reference(in.data(), out.data(), samples, state); }, samples);
+    dsp::Dither flat(2, 16);
+    double flatNs = nsPerSample([&] { flat.process(in.data(), out.data(), FRAMES); }, samples);
+    dsp::DitherOptions options;
+    options.noiseShaping = true;
+    dsp::Dither shaped(2, 16, options);
+    double shapedNs = nsPerSample([&] { shaped.process(in.data(), out.data(), FRAMES); }, samples);
+    dsp::Dither flat24(2, 24);
+    double flat24Ns = nsPerSample([&] { flat24.process(in.data(), out24.data(), FRAMES); }, samples);
+
+    log("Conversion                ns/sample   us per 100 ms stereo buffer");
+    auto row = [&](const char* name, double ns) { log(std::string(name) + fmt(ns, 2) + "        " + fmt(ns * samples / 1000., 1)); };
+    row("plain (toNative)          ", plainNs);
+    row("scalar TPDF               ", scalarNs);
+    row("Dither TPDF               ", flatNs);
+    row("Dither TPDF + shaping     ", shapedNs);
+    row("Dither TPDF, 24 bit       ", flat24Ns);
+
+    const double speedup = scalarNs / flatNs;
+    if (speedup < 1.5) {
+        result.passed = false;
+        result.message = "TPDF at " + fmt(speedup, 2) + "x the scalar loop, expected vectorized";
+    } else if (shapedNs * samples > 1e6) {
+        result.passed = false;
+        result.message = "noise shaping takes " + fmt(shapedNs * samples / 1000., 0) + " us of a 100 ms buffer";
+    } else {
+        result.message = "TPDF " + fmt(speedup, 1) + "x the scalar loop (" + fmt(flatNs, 2) + " ns/sample), shaped " + fmt(shapedNs, 2) +
+                         " ns/sample";
+    }
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int run_all_tests() {
+    std::cout << "\n";
+    std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║       Dither Benchmark                                       ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════════════╝\n";
+    std::cout << "\n";
+
+    g_results.push_back(test_linearity());
+    std::cout << "\n";
+    g_results.push_back(test_spectrum());
+    std::cout << "\n";
+    g_results.push_back(test_speed());
+    std::cout << "\n";
+
+    int failed = 0;
+    for (const auto& result : g_results) {
+        std::string status = result.passed ? "✅ PASS" : "❌ FAIL";
+        std::cout << "  " << status << "  " << result.name << "\n";
+        std::cout << "         " << result.message << " (" << result.duration_ms << " ms)\n";
+        if (!result.passed) failed++;
+    }
+    std::cout << "\n";
+    return failed;
+}
+
+} // namespace dither_bench
+
+int main() {
+    return dither_bench::run_all_tests() == 0 ? 0 : 1;
+}
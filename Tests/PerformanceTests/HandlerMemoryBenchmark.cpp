@@ -0,0 +1,516 @@
+/***
+    HandlerMemoryBenchmark.cpp
+
+    Counts heap allocations on the client's io thread over an accelerated
+    one-hour stream session: 3600 Time exchanges and 180000 20 ms chunks,
+    1000× faster than real time (a Time request every millisecond, the
+    chunks written in bursts of 50 per millisecond).
+
+    Two clients on the same loopback mock server:
+    - callback-style: the shape of Snapcast's ClientConnection - header and
+      payload async_reads per message, make_shared request message and
+      encoded buffer per Time request, a pending-request map entry with its
+      own reply timer and std::function callback;
+    - recycled: net::BatchReceiver + timesync::TimeRequester, operations
+      allocated from net::HandlerMemory, requests from a net::RequestPool,
+      the request encoded in place.
+
+    Allocations are counted by replacing global operator new, only on the
+    client thread. The first simulated minute is warm-up (buffers growing
+    to the largest message); the recycled client must do no allocation at
+    all after it, and no operation may fall back from HandlerMemory to the
+    heap. The recycled client starts reading only after a stall, so its
+    first wakeup fills the whole read buffer and the batch vectors reach
+    their largest size during warm-up rather than on whichever later
+    wakeup the scheduler happens to delay.
+
+    Build & run: ./scripts/run-linux-benchmarks.sh HandlerMemory
+
+    Copyright (C) 2025 SnapForge contributors
+    License: GPL-3.0
+***/
+
+#include "net/batch_receiver.hpp"
+#include "net/handler_memory.hpp"
+#include "net/request_pool.hpp"
+#include "probe/stream_wire.hpp"
+#include "timesync/time_requester.hpp"
+
+#include <boost/asio.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ============================================================================
+// Allocation counting (client thread only)
+// ============================================================================
+
+namespace {
+thread_local bool t_counting = false;
+thread_local uint64_t t_allocations = 0;
+thread_local uint64_t t_bytes = 0;
+}  // namespace
+
+// Out of line, or GCC pairs the inlined malloc/free with new/delete and warns
+[[gnu::noinline]] void* operator new(std::size_t size) {
+    if (t_counting) {
+        t_allocations++;
+        t_bytes += size;
+    }
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace handler_bench {
+
+using boost::asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+namespace wire = probe::wire;
+
+constexpr size_t CHUNK_BYTES = 48000 * 4 / 50;  // 20 ms of 48 kHz/16/2
+constexpr int CHUNKS_PER_EXCHANGE = 50;          // 1 s of audio per Time exchange
+constexpr int EXCHANGES = 3600;                  // one hour
+constexpr int WARMUP_EXCHANGES = 60;             // one minute
+constexpr auto TICK = milliseconds(1);           // one simulated second
+constexpr auto WARMUP_STALL = milliseconds(10);  // ~1.9 MB queued, more than one read
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+    double duration_ms;
+};
+
+std::vector<TestResult> g_results;
+
+void log(const std::string& msg) {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::cout << "[" << std::put_time(std::localtime(&time), "%H:%M:%S") << "] " << msg << std::endl;
+}
+
+std::string fmt(double v, int precision = 0) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(precision) << v;
+    return out.str();
+}
+
+// ============================================================================
+// Accelerated mock server
+// ============================================================================
+
+class MockStreamServer {
+public:
+    MockStreamServer() : acceptor_(io_, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)) {
+        accept();
+        thread_ = std::thread([this]() { io_.run(); });
+    }
+
+    ~MockStreamServer() {
+        io_.stop();
+        thread_.join();
+    }
+
+    uint16_t port() const { return acceptor_.local_endpoint().port(); }
+
+private:
+    struct Session : std::enable_shared_from_this<Session> {
+        Session(boost::asio::io_context& io, tcp::socket s) : socket(std::move(s)), timer(io) {
+            wire::Header h;
+            h.type = wire::kWireChunk;
+            h.size = static_cast<uint32_t>(8 + 4 + CHUNK_BYTES);
+            chunk.assign(wire::HEADER_SIZE + h.size, 0x5a);
+            wire::encodeHeader(h, chunk.data());
+            for (int i = 0; i < CHUNKS_PER_EXCHANGE; ++i) burst.insert(burst.end(), chunk.begin(), chunk.end());
+        }
+
+        void start() {
+            next = Clock::now();
+            tick();
+            read();
+        }
+
+        void read() {
+            boost::asio::async_read(socket, boost::asio::buffer(header), [self = shared_from_this()](auto ec, size_t) {
+                if (ec) return;
+                auto h = wire::decodeHeader(self->header.data());
+                auto received = wire::now();
+                self->payload.resize(h.size);
+                boost::asio::async_read(self->socket, boost::asio::buffer(self->payload), [self, h, received](auto ec, size_t) {
+                    if (ec) return;
+                    if (h.type == wire::kTime) {
+                        auto latency = received - wire::fromTimeval(h.sent);
+                        self->send(wire::encodeTimeReply(0, h.id, latency, wire::now()));
+                    }
+                    self->read();
+                });
+            });
+        }
+
+        void tick() {
+            next += TICK;
+            timer.expires_at(next);
+            timer.async_wait([self = shared_from_this()](auto ec) {
+                if (ec) return;
+                self->send(self->burst);
+                self->tick();
+            });
+        }
+
+        void send(const std::vector<uint8_t>& data) {
+            boost::system::error_code ec;
+            boost::asio::write(socket, boost::asio::buffer(data), ec);
+            if (ec) timer.cancel();
+        }
+
+        tcp::socket socket;
+        boost::asio::steady_timer timer;
+        Clock::time_point next;
+        std::vector<uint8_t> chunk, burst;
+        std::array<uint8_t, wire::HEADER_SIZE> header{};
+        std::vector<uint8_t> payload;
+    };
+
+    void accept() {
+        acceptor_.async_accept([this](auto ec, tcp::socket socket) {
+            if (ec) return;
+            socket.set_option(tcp::no_delay(true), ec);
+            auto session = std::make_shared<Session>(io_, std::move(socket));
+            session->start();
+            sessions_.push_back(session);
+            accept();
+        });
+    }
+
+    boost::asio::io_context io_;
+    tcp::acceptor acceptor_;
+    std::vector<std::shared_ptr<Session>> sessions_;
+    std::thread thread_;
+};
+
+uint32_t decode(const uint8_t* data, size_t size) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < size; i += 64) sum = sum * 31 + data[i];
+    return sum;
+}
+
+struct SessionResult {
+    int exchanges{0};
+    uint64_t chunks{0};
+    uint64_t warmupAllocations{0};
+    uint64_t steadyAllocations{0};
+    uint64_t steadyBytes{0};
+    uint64_t fallbacks{0};
+    double seconds{0};
+};
+
+/// Runs @p body on a client thread with allocation counting; @p warmedUp is
+/// called by the client once warm-up is over
+template <typename Body>
+SessionResult runCounted(Body body) {
+    SessionResult r;
+    auto start = Clock::now();
+    std::thread client([&]() {
+        t_counting = true;
+        body(r, [&r]() {
+            r.warmupAllocations = t_allocations;
+            t_allocations = 0;
+            t_bytes = 0;
+        });
+        r.steadyAllocations = t_allocations;
+        r.steadyBytes = t_bytes;
+        t_counting = false;
+    });
+    client.join();
+    r.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return r;
+}
+
+// ============================================================================
+// Callback-style client (ClientConnection shape)
+// ============================================================================
+
+class CallbackClient : public std::enable_shared_from_this<CallbackClient> {
+public:
+    using ReplyHandler = std::function<void(const wire::Header&, const std::vector<uint8_t>&, microseconds)>;
+
+    CallbackClient(boost::asio::io_context& io, tcp::socket& socket) : io_(io), socket_(socket), timer_(io) {}
+
+    void start(std::function<void(const wire::TimeSample&)> onSample, std::function<void()> onChunk) {
+        onSample_ = std::move(onSample);
+        onChunk_ = std::move(onChunk);
+        next_ = Clock::now();
+        read();
+        tick();
+    }
+
+    void stop() {
+        stopped_ = true;
+        timer_.cancel();
+        for (auto& p : pending_) p.second->timer->cancel();
+        pending_.clear();
+    }
+
+private:
+    struct PendingRequest {
+        std::shared_ptr<boost::asio::steady_timer> timer;
+        ReplyHandler handler;
+    };
+
+    void read() {
+        boost::asio::async_read(socket_, boost::asio::buffer(header_), [self = shared_from_this()](auto ec, size_t) {
+            if (ec || self->stopped_) return;
+            auto h = wire::decodeHeader(self->header_.data());
+            self->payload_.resize(h.size);
+            boost::asio::async_read(self->socket_, boost::asio::buffer(self->payload_), [self, h](auto ec, size_t) {
+                if (ec || self->stopped_) return;
+                auto received = wire::now();
+                if (h.type == wire::kTime) {
+                    auto it = self->pending_.find(h.refersTo);
+                    if (it != self->pending_.end()) {
+                        auto request = it->second;
+                        self->pending_.erase(it);
+                        request->timer->cancel();
+                        request->handler(h, self->payload_, received);
+                    }
+                } else if (h.type == wire::kWireChunk) {
+                    self->checksum_ += decode(self->payload_.data(), self->payload_.size());
+                    self->onChunk_();
+                }
+                self->read();
+            });
+        });
+    }
+
+    void tick() {
+        next_ += TICK;
+        timer_.expires_at(next_);
+        timer_.async_wait([self = shared_from_this()](auto ec) {
+            if (ec || self->stopped_) return;
+            self->sendTime();
+            self->tick();
+        });
+    }
+
+    void sendTime() {
+        auto id = nextId_++;
+        auto message = std::make_shared<std::vector<uint8_t>>(wire::encodeTime(id, wire::now()));
+        auto request = std::make_shared<PendingRequest>();
+        request->timer = std::make_shared<boost::asio::steady_timer>(io_);
+        request->handler = [self = shared_from_this()](const wire::Header& h, const std::vector<uint8_t>& payload, microseconds received) {
+            microseconds latency;
+            if (wire::decodeTime(payload.data(), payload.size(), latency))
+                self->onSample_(wire::timeSample(latency, wire::fromTimeval(h.sent), received));
+        };
+        request->timer->expires_after(milliseconds(50));
+        request->timer->async_wait([self = shared_from_this(), id](auto ec) {
+            if (!ec) self->pending_.erase(id);
+        });
+        pending_.emplace(id, request);
+        boost::asio::async_write(socket_, boost::asio::buffer(*message), [message](auto, size_t) {});
+    }
+
+    boost::asio::io_context& io_;
+    tcp::socket& socket_;
+    boost::asio::steady_timer timer_;
+    Clock::time_point next_;
+    std::array<uint8_t, wire::HEADER_SIZE> header_{};
+    std::vector<uint8_t> payload_;
+    std::map<uint16_t, std::shared_ptr<PendingRequest>> pending_;
+    std::function<void(const wire::TimeSample&)> onSample_;
+    std::function<void()> onChunk_;
+    uint16_t nextId_{1};
+    uint32_t checksum_{0};
+    bool stopped_{false};
+};
+
+SessionResult runCallbackSession(uint16_t port) {
+    return runCounted([port](SessionResult& r, auto warmedUp) {
+        boost::asio::io_context io;
+        tcp::socket socket(io);
+        socket.connect({boost::asio::ip::address_v4::loopback(), port});
+        socket.set_option(tcp::no_delay(true));
+        auto client = std::make_shared<CallbackClient>(io, socket);
+        client->start(
+            [&r, &client, &socket, warmedUp](const wire::TimeSample&) {
+                if (++r.exchanges == WARMUP_EXCHANGES) warmedUp();
+                if (r.exchanges == EXCHANGES) {
+                    client->stop();
+                    boost::system::error_code ec;
+                    socket.close(ec);
+                }
+            },
+            [&r]() { r.chunks++; });
+        io.run();
+    });
+}
+
+// ============================================================================
+// Recycled client (BatchReceiver + TimeRequester)
+// ============================================================================
+
+SessionResult runRecycledSession(uint16_t port) {
+    return runCounted([port](SessionResult& r, auto warmedUp) {
+        boost::asio::io_context io;
+        tcp::socket socket(io);
+        socket.connect({boost::asio::ip::address_v4::loopback(), port});
+        socket.set_option(tcp::no_delay(true));
+
+        timesync::TimeRequesterOptions timeOptions;
+        timeOptions.interval = TICK;
+        timeOptions.replyTimeout = milliseconds(50);
+        auto receiver = std::make_shared<net::BatchReceiver>(socket, net::BatchOptions{});
+        auto requester = std::make_shared<timesync::TimeRequester>(socket, timeOptions);
+        uint32_t checksum = 0;
+
+        // Let a full read's worth queue up: the largest batch of the session
+        std::this_thread::sleep_for(WARMUP_STALL);
+        receiver->start(
+            [&r, &requester, &checksum](const std::vector<net::BatchReceiver::Message>& batch) {
+                for (const auto& m : batch) {
+                    if (m.header.type == wire::kTime) {
+                        requester->onReply(m.header, m.payload, m.received);
+                    } else if (m.header.type == wire::kWireChunk) {
+                        checksum += decode(m.payload, m.header.size);
+                        r.chunks++;
+                    }
+                }
+            },
+            [](const boost::system::error_code&) {});
+        requester->start(
+            [&r, &receiver, &requester, &socket, warmedUp](const wire::TimeSample&) {
+                if (++r.exchanges == WARMUP_EXCHANGES) warmedUp();
+                if (r.exchanges == EXCHANGES) {
+                    requester->stop();
+                    receiver->stop();
+                    boost::system::error_code ec;
+                    socket.close(ec);
+                }
+            },
+            [&receiver]() { receiver->expectReply(); });
+        io.run();
+        r.fallbacks = receiver->memory().stats().fallbacks + requester->memory().stats().fallbacks;
+        (void)checksum;
+    });
+}
+
+void report(const std::string& label, const SessionResult& r) {
+    double perHour = static_cast<double>(r.steadyAllocations) * EXCHANGES / (EXCHANGES - WARMUP_EXCHANGES);
+    log("   - " + label + ": " + std::to_string(r.exchanges) + " exchanges, " + std::to_string(r.chunks) + " chunks in " +
+        fmt(r.seconds, 1) + " s; warm-up " + std::to_string(r.warmupAllocations) + " allocations, steady state " +
+        std::to_string(r.steadyAllocations) + " (" + fmt(static_cast<double>(r.steadyBytes) / 1024.0) + " KiB, ~" +
+        fmt(perHour) + " per hour)");
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+TestResult test_handler_memory() {
+    const std::string name = "HandlerMemory";
+    log("🧪 [" + name + "] slot reuse and heap fallback");
+    auto start = Clock::now();
+
+    net::HandlerMemory memory;
+    std::vector<void*> held;
+    for (size_t i = 0; i < net::HandlerMemory::SLOTS + 2; ++i) held.push_back(memory.allocate(64));
+    void* large = memory.allocate(net::HandlerMemory::SLOT_SIZE + 1);
+    bool counted = memory.stats().recycled == net::HandlerMemory::SLOTS && memory.stats().fallbacks == 3;
+    for (void* p : held) memory.deallocate(p);
+    memory.deallocate(large);
+    void* again = memory.allocate(128);
+    bool reused = again == held.front();
+    memory.deallocate(again);
+
+    net::RequestPool<int, 4> pool;
+    std::array<int*, 4> items{};
+    for (auto& item : items) item = pool.acquire();
+    bool exhausted = pool.acquire() == nullptr && pool.inUse() == 4;
+    pool.release(items[2]);
+    bool recycledItem = pool.acquire() == items[2];
+
+    log("   - " + std::to_string(memory.stats().recycled) + " recycled, " + std::to_string(memory.stats().fallbacks) +
+        " fallbacks; pool exhausts at capacity and hands released items back");
+    bool passed = counted && reused && exhausted && recycledItem;
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return {name, passed, passed ? "Slots recycled, overflow and oversize go to the heap" : "Unexpected slot accounting",
+            duration_ms};
+}
+
+TestResult test_session() {
+    const std::string name = "SteadyState";
+    log("🧪 [" + name + "] accelerated 1 h session: " + std::to_string(EXCHANGES) + " Time exchanges, " +
+        std::to_string(EXCHANGES * CHUNKS_PER_EXCHANGE) + " chunks, warm-up " + std::to_string(WARMUP_EXCHANGES));
+    auto start = Clock::now();
+
+    SessionResult callback, recycled;
+    {
+        MockStreamServer server;
+        callback = runCallbackSession(server.port());
+    }
+    report("callback-style", callback);
+    {
+        MockStreamServer server;
+        recycled = runRecycledSession(server.port());
+    }
+    report("recycled", recycled);
+    log("   - HandlerMemory heap fallbacks: " + std::to_string(recycled.fallbacks));
+
+    bool complete = recycled.exchanges == EXCHANGES && callback.exchanges == EXCHANGES &&
+                    recycled.chunks + CHUNKS_PER_EXCHANGE * 2 >= static_cast<uint64_t>(EXCHANGES * CHUNKS_PER_EXCHANGE);
+    bool passed = complete && recycled.steadyAllocations == 0 && recycled.fallbacks == 0;
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return {name, passed,
+            passed ? "No heap allocation on the io thread after warm-up"
+                   : "Steady-state allocations on the recycled path",
+            duration_ms};
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int run_all_tests() {
+    std::cout << "\n";
+    std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║       Recycling Handler Allocator Benchmark                  ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════════════╝\n";
+    std::cout << "\n";
+
+    g_results.push_back(test_handler_memory());
+    std::cout << "\n";
+    g_results.push_back(test_session());
+    std::cout << "\n";
+
+    int failed = 0;
+    for (const auto& result : g_results) {
+        std::string status = result.passed ? "✅ PASS" : "❌ FAIL";
+        std::cout << "  " << status << "  " << result.name << "\n";
+        std::cout << "         " << result.message << " (" << result.duration_ms << " ms)\n";
+        if (!result.passed) failed++;
+    }
+    std::cout << "\n";
+    return failed;
+}
+
+}  // namespace handler_bench
+
+int main() {
+    return handler_bench::run_all_tests() == 0 ? 0 : 1;
+}
@@ -0,0 +1,428 @@
+/***
+    HolFilterBenchmark.cpp
+
+    Measures how much head-of-line filtering of Time samples reduces the
+    clock offset error while the server streams in bursts.
+
+    A loopback mock Snapcast server (clock 5 s ahead of ours) answers the
+    Hello with its 1 s buffer, then sends its audio in bursts: N chunks of
+    20 ms every N × 20 ms, like a server whose encoder or source delivers in
+    blocks. Every message goes through a modelled link (one-way delay and a
+    bandwidth limit), so a Time reply written during a burst waits behind
+    it. The link is symmetric, so an undelayed sample has no offset error.
+
+    LinkProbe measures the offset both ways over 4 s: the plain median of all
+    samples and the HOL-filtered estimate. The error of each against the
+    true 5 s is compared per load pattern. The median shrugs off a minority
+    of queued replies; it is biased once they are the majority, which is
+    what happens while the 1 s buffer drains through a busy link.
+
+    Also checks the filter's verdicts on synthetic exchanges (a queued reply
+    is discarded, a reply delayed with no traffic around it is only weighted
+    down) and the cost of add() + offset() on a full window.
+
+    Build & run: ./scripts/run-linux-benchmarks.sh HolFilter
+
+    Copyright (C) 2025 SnapForge contributors
+    License: GPL-3.0
+***/
+
+#include "probe/link_probe.hpp"
+#include "probe/stream_wire.hpp"
+#include "timesync/hol_filter.hpp"
+
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hol_bench {
+
+using boost::asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+constexpr auto SERVER_CLOCK_OFFSET = std::chrono::seconds(5);
+constexpr auto CHUNK_DURATION = milliseconds(20);
+constexpr size_t CHUNK_BYTES = 48000 * 4 / 50;  // 20 ms of 48 kHz/16/2
+constexpr int BUFFER_CHUNKS = 50;               // 1 s server buffer
+constexpr int RUNS = 3;
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+    double duration_ms;
+};
+
+std::vector<TestResult> g_results;
+
+void log(const std::string& msg) {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::cout << "[" << std::put_time(std::localtime(&time), "%H:%M:%S") << "] " << msg << std::endl;
+}
+
+double ms(microseconds v) {
+    return static_cast<double>(v.count()) / 1000.0;
+}
+
+std::string fmt(double v, int precision = 2) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(precision) << v;
+    return out.str();
+}
+
+// ============================================================================
+// Mock streaming server behind a modelled link
+// ============================================================================
+
+struct Load {
+    const char* name;
+    microseconds delay;  // One way
+    double mbps;         // Bandwidth server -> client
+    int burstChunks;     // Chunks sent together; 1 = steady stream
+};
+
+std::vector<uint8_t> message(uint16_t type, const std::vector<uint8_t>& payload, microseconds sent) {
+    probe::wire::Header h;
+    h.type = type;
+    h.sent = probe::wire::toTimeval(sent);
+    h.size = static_cast<uint32_t>(payload.size());
+    std::vector<uint8_t> out(probe::wire::HEADER_SIZE);
+    probe::wire::encodeHeader(h, out.data());
+    out.insert(out.end(), payload.begin(), payload.end());
+    return out;
+}
+
+std::vector<uint8_t> codecHeader(microseconds sent) {
+    const std::string codec = "pcm";
+    std::vector<uint8_t> payload = {static_cast<uint8_t>(codec.size()), 0, 0, 0};
+    payload.insert(payload.end(), codec.begin(), codec.end());
+    payload.insert(payload.end(), {44, 0, 0, 0});
+    payload.resize(payload.size() + 44, 0);
+    return message(probe::wire::kCodecHeader, payload, sent);
+}
+
+std::vector<uint8_t> wireChunk(microseconds sent) {
+    std::vector<uint8_t> payload(8 + 4 + CHUNK_BYTES, 0);
+    payload[8] = CHUNK_BYTES & 0xff;
+    payload[9] = (CHUNK_BYTES >> 8) & 0xff;
+    return message(probe::wire::kWireChunk, payload, sent);
+}
+
+class MockStreamServer {
+public:
+    explicit MockStreamServer(Load load)
+        : acceptor_(io_, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)), load_(load) {
+        accept();
+        thread_ = std::thread([this]() { io_.run(); });
+    }
+
+    ~MockStreamServer() {
+        io_.stop();
+        thread_.join();
+    }
+
+    uint16_t port() const { return acceptor_.local_endpoint().port(); }
+
+private:
+    struct Session : std::enable_shared_from_this<Session> {
+        Session(boost::asio::io_context& io, tcp::socket s, Load load)
+            : socket(std::move(s)), io(io), burstTimer(io), linkTimer(io), load(load) {}
+
+        microseconds serverNow() const { return probe::wire::now() + SERVER_CLOCK_OFFSET; }
+
+        void read() {
+            boost::asio::async_read(socket, boost::asio::buffer(header), [self = shared_from_this()](auto ec, size_t) {
+                if (ec) return;
+                self->incoming = probe::wire::decodeHeader(self->header.data());
+                self->payload.resize(self->incoming.size);
+                boost::asio::async_read(self->socket, boost::asio::buffer(self->payload), [self](auto ec, size_t) {
+                    if (ec) return;
+                    // Upstream half of the link
+                    auto timer = std::make_shared<boost::asio::steady_timer>(self->io, self->load.delay);
+                    auto h = self->incoming;
+                    timer->async_wait([self, timer, h](auto ec) {
+                        if (!ec) self->onMessage(h);
+                    });
+                    self->read();
+                });
+            });
+        }
+
+        void onMessage(const probe::wire::Header& h) {
+            if (h.type == probe::wire::kHello) {
+                auto now = serverNow();
+                send(codecHeader(now));
+                for (int i = 0; i < BUFFER_CHUNKS; ++i)
+                    send(wireChunk(now));
+                streamStart = Clock::now();
+                scheduleBurst(1);
+            } else if (h.type == probe::wire::kTime) {
+                auto received = serverNow();
+                auto latency = received - probe::wire::fromTimeval(h.sent);
+                send(probe::wire::encodeTimeReply(0, h.id, latency, received));
+            }
+        }
+
+        void scheduleBurst(int n) {
+            auto period = CHUNK_DURATION * load.burstChunks;
+            burstTimer.expires_at(streamStart + period * n);
+            burstTimer.async_wait([self = shared_from_this(), period](auto ec) {
+                if (ec) return;
+                auto now = self->serverNow();
+                for (int i = 0; i < self->load.burstChunks; ++i)
+                    self->send(wireChunk(now));
+                self->scheduleBurst(static_cast<int>((Clock::now() - self->streamStart) / period) + 1);
+            });
+        }
+
+        /// Queue behind earlier messages at the link's bandwidth, then the delay
+        void send(std::vector<uint8_t> data) {
+            auto now = Clock::now();
+            auto serialize = microseconds(static_cast<int64_t>(data.size() * 8 / load.mbps));
+            linkFree = std::max(linkFree, now) + serialize;
+            inFlight.push_back({linkFree + load.delay, std::move(data)});
+            if (inFlight.size() == 1) armLink();
+        }
+
+        void armLink() {
+            linkTimer.expires_at(inFlight.front().first);
+            linkTimer.async_wait([self = shared_from_this()](auto ec) {
+                if (ec) return;
+                auto now = Clock::now();
+                while (!self->inFlight.empty() && self->inFlight.front().first <= now) {
+                    self->writes.push_back(std::move(self->inFlight.front().second));
+                    self->inFlight.pop_front();
+                    if (self->writes.size() == 1) self->writeNext();
+                }
+                if (!self->inFlight.empty()) self->armLink();
+            });
+        }
+
+        void writeNext() {
+            boost::asio::async_write(socket, boost::asio::buffer(writes.front()), [self = shared_from_this()](auto ec, size_t) {
+                if (ec) {
+                    self->burstTimer.cancel();
+                    self->linkTimer.cancel();
+                    return;
+                }
+                self->writes.pop_front();
+                if (!self->writes.empty()) self->writeNext();
+            });
+        }
+
+        tcp::socket socket;
+        boost::asio::io_context& io;
+        boost::asio::steady_timer burstTimer;
+        boost::asio::steady_timer linkTimer;
+        Load load;
+        Clock::time_point streamStart;
+        Clock::time_point linkFree;
+        std::array<uint8_t, probe::wire::HEADER_SIZE> header{};
+        std::vector<uint8_t> payload;
+        probe::wire::Header incoming;
+        std::deque<std::pair<Clock::time_point, std::vector<uint8_t>>> inFlight;
+        std::deque<std::vector<uint8_t>> writes;
+    };
+
+    void accept() {
+        acceptor_.async_accept([this](auto ec, tcp::socket socket) {
+            if (ec) return;
+            socket.set_option(tcp::no_delay(true), ec);
+            auto session = std::make_shared<Session>(io_, std::move(socket), load_);
+            session->read();
+            sessions_.push_back(session);
+            accept();
+        });
+    }
+
+    boost::asio::io_context io_;
+    tcp::acceptor acceptor_;
+    Load load_;
+    std::vector<std::shared_ptr<Session>> sessions_;
+    std::thread thread_;
+};
+
+probe::LinkQuality probe_link(uint16_t port) {
+    probe::LinkProbeOptions options;
+    options.hello.id = "00:11:22:33:44:55";
+    options.timeSamples = 80;
+    options.timeInterval = milliseconds(15);
+    options.receiveWindow = milliseconds(4000);
+
+    boost::asio::io_context io;
+    probe::LinkProbe link(io);
+    probe::LinkQuality q;
+    link.run({"127.0.0.1", port}, options, [&q](const probe::LinkQuality& result) { q = result; });
+    io.run();
+    return q;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+timesync::Exchange exchange(int64_t rttUs, int64_t offsetUs, uint64_t bytes, int64_t quietUs) {
+    timesync::Exchange e;
+    e.rtt = microseconds(rttUs);
+    e.offset = microseconds(offsetUs);
+    e.bytesInFlight = bytes;
+    e.quietBefore = microseconds(quietUs);
+    return e;
+}
+
+TestResult test_verdicts() {
+    const std::string name = "Verdicts";
+    log("🧪 [" + name + "] synthetic exchanges, true offset 5000 µs");
+    auto start = Clock::now();
+    using Verdict = timesync::HolFilter::Verdict;
+    timesync::HolFilter filter;
+
+    // Clean: 4 ms RTT, a chunk in flight but the reply not late
+    bool clean = filter.add(exchange(4000, 5000, 3900, 200)) == Verdict::Clean &&
+                 filter.add(exchange(4300, 4900, 0, 15000)) == Verdict::Clean;
+    // Queued: 30 ms late, audio arriving until 100 µs before it
+    bool queued = filter.add(exchange(34000, 5000 - 15000, 60000, 100)) == Verdict::Discarded &&
+                  filter.add(exchange(12000, 5000 - 4000, 8000, 50)) == Verdict::Discarded;
+    // Radio delay: 6 ms late after 10 ms without traffic
+    bool radio = filter.add(exchange(10000, 5000 - 3000, 3900, 10000)) == Verdict::Weighted;
+    // Late and with audio in flight, but the audio came before the wait
+    bool early = filter.add(exchange(9000, 5000 - 2500, 3900, 7000)) == Verdict::Weighted;
+    filter.add(exchange(4100, 5100, 0, 20000));
+
+    auto offset = filter.offset();
+    bool estimate = offset && std::abs(offset->count() - 5000) <= 100;
+    auto stats = filter.stats();
+
+    // Cost on a full window, as TimeProvider would pay per sync
+    timesync::HolFilter full;
+    constexpr int ADDS = 20000;
+    int64_t sink = 0;
+    auto t = Clock::now();
+    for (int i = 0; i < ADDS; ++i) {
+        bool late = (i % 5) == 0;
+        full.add(exchange(late ? 30000 : 4000 + (i % 7) * 100, late ? -10000 : 5000 + (i % 11) * 10, late ? 40000 : 0,
+                          late ? 100 : 20000));
+        sink += full.offset()->count();
+    }
+    double perSampleUs = std::chrono::duration<double, std::micro>(Clock::now() - t).count() / ADDS;
+
+    bool passed = clean && queued && radio && early && estimate;
+    log("   - " + std::to_string(stats.clean) + " clean, " + std::to_string(stats.weighted) + " weighted, " +
+        std::to_string(stats.discarded) + " discarded; estimate " + (offset ? std::to_string(offset->count()) : "-") +
+        " µs");
+    log("   - add + offset on a " + std::to_string(full.size()) + "-sample window: " + fmt(perSampleUs) + " µs" +
+        (sink == 0 ? " " : ""));
+
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return {name, passed,
+            passed ? "Queued replies discarded, radio-delayed ones weighted, estimate on the clean samples"
+                   : "Wrong verdict (clean=" + std::to_string(clean) + " queued=" + std::to_string(queued) +
+                         " radio=" + std::to_string(radio) + " early=" + std::to_string(early) +
+                         " estimate=" + std::to_string(estimate) + ")",
+            duration_ms};
+}
+
+struct Errors {
+    double plain_ms{0};
+    double filtered_ms{0};
+    int samples{0};
+    int discarded{0};
+};
+
+/// Median over RUNS probes of the absolute offset errors
+Errors measure(const Load& load) {
+    MockStreamServer server(load);
+    std::vector<double> plain, filtered;
+    Errors e;
+    for (int i = 0; i < RUNS; ++i) {
+        auto q = probe_link(server.port());
+        if (q.status != probe::ProbeStatus::Ok) return {-1, -1, 0, 0};
+        plain.push_back(std::abs(ms(q.offsetMedian - SERVER_CLOCK_OFFSET)));
+        filtered.push_back(std::abs(ms(q.offsetFiltered - SERVER_CLOCK_OFFSET)));
+        e.samples += q.samples;
+        e.discarded += q.holDiscarded;
+    }
+    std::sort(plain.begin(), plain.end());
+    std::sort(filtered.begin(), filtered.end());
+    e.plain_ms = plain[RUNS / 2];
+    e.filtered_ms = filtered[RUNS / 2];
+    return e;
+}
+
+TestResult test_bursty_load() {
+    const std::string name = "BurstyLoad";
+    log("🧪 [" + name + "] offset error, plain median vs HOL-filtered (median of " + std::to_string(RUNS) + " probes)");
+    auto start = Clock::now();
+
+    const Load loads[] = {
+        {"Steady 20 ms chunks, 30 Mbps", microseconds(2000), 30, 1},
+        {"Bursts of 10 chunks, 3 Mbps (51% busy)", microseconds(2000), 3, 10},
+        {"Bursts of 5 chunks, 2.5 Mbps (61% busy)", microseconds(2000), 2.5, 5},
+    };
+
+    bool passed = true;
+    for (const auto& load : loads) {
+        auto e = measure(load);
+        bool ok = e.samples > 0 && e.filtered_ms <= 1.0 && e.filtered_ms <= e.plain_ms + 0.25;
+        // Where queued replies biased the median, the filter must remove most of it
+        if (e.plain_ms > 1.0) ok = ok && (e.filtered_ms * 2 < e.plain_ms);
+        passed = passed && ok;
+        std::string reduction = e.plain_ms > 0 ? fmt(100.0 * (1.0 - e.filtered_ms / e.plain_ms), 0) + "% lower" : "-";
+        log(std::string("   - ") + load.name + ": plain " + fmt(e.plain_ms) + " ms, filtered " + fmt(e.filtered_ms) +
+            " ms (" + reduction + "), " + std::to_string(e.discarded) + "/" + std::to_string(e.samples) +
+            " discarded" + (ok ? "" : "  ⚠️"));
+    }
+
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return {name, passed,
+            passed ? "Filtered offset within 1 ms under every load, never worse than the median"
+                   : "Filtered offset off by more than 1 ms, or worse than the plain median",
+            duration_ms};
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int run_all_tests() {
+    std::cout << "\n";
+    std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║       Head-of-Line Time Sample Filter Benchmark              ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════════════╝\n";
+    std::cout << "\n";
+
+    g_results.push_back(test_verdicts());
+    std::cout << "\n";
+    g_results.push_back(test_bursty_load());
+    std::cout << "\n";
+
+    int failed = 0;
+    for (const auto& result : g_results) {
+        std::string status = result.passed ? "✅ PASS" : "❌ FAIL";
+        std::cout << "  " << status << "  " << result.name << "\n";
+        std::cout << "         " << result.message << " (" << result.duration_ms << " ms)\n";
+        if (!result.passed) failed++;
+    }
+    std::cout << "\n";
+    return failed;
+}
+
+} // namespace hol_bench
+
+int main() {
+    return hol_bench::run_all_tests() == 0 ? 0 : 1;
+}
@@ -0,0 +1,316 @@
+/***
+    LinkProbeBenchmark.cpp
+
+    Runs LinkProbe against a loopback mock Snapcast server that streams
+    48 kHz/16-bit stereo PCM (1536 kbps) after the Hello: first a 1 s buffer
+    burst, then one 20 ms chunk every 20 ms. The server's clock runs 5 s
+    ahead of ours, and its Time replies can be delayed by a random amount to
+    emulate a jittery Wi-Fi link.
+
+    Checks that RTT, jitter, clock offset and throughput are reported
+    plausibly for a clean link, that a jittery link is told apart from it,
+    and that a silent server is reported as such.
+
+    Build & run: ./scripts/run-linux-benchmarks.sh LinkProbe
+
+    Copyright (C) 2025 SnapForge contributors
+    License: GPL-3.0
+***/
+
+#include "probe/link_probe.hpp"
+#include "probe/stream_wire.hpp"
+
+#include <boost/asio.hpp>
+
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace link_bench {
+
+using boost::asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+constexpr auto SERVER_CLOCK_OFFSET = std::chrono::seconds(5);
+constexpr auto CHUNK_DURATION = milliseconds(20);
+constexpr size_t CHUNK_BYTES = 48000 * 4 / 50;  // 20 ms of 48 kHz/16/2
+constexpr int BUFFER_CHUNKS = 50;               // 1 s server buffer
+constexpr double STREAM_KBPS = 48000.0 * 32 / 1000;
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+    double duration_ms;
+};
+
+std::vector<TestResult> g_results;
+
+void log(const std::string& msg) {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::cout << "[" << std::put_time(std::localtime(&time), "%H:%M:%S") << "] " << msg << std::endl;
+}
+
+// ============================================================================
+// Mock streaming server
+// ============================================================================
+
+std::vector<uint8_t> message(uint16_t type, const std::vector<uint8_t>& payload) {
+    probe::wire::Header h;
+    h.type = type;
+    h.size = static_cast<uint32_t>(payload.size());
+    std::vector<uint8_t> out(probe::wire::HEADER_SIZE);
+    probe::wire::encodeHeader(h, out.data());
+    out.insert(out.end(), payload.begin(), payload.end());
+    return out;
+}
+
+std::vector<uint8_t> codecHeader() {
+    const std::string codec = "pcm";
+    std::vector<uint8_t> payload = {static_cast<uint8_t>(codec.size()), 0, 0, 0};
+    payload.insert(payload.end(), codec.begin(), codec.end());
+    payload.insert(payload.end(), {44, 0, 0, 0});  // RIFF header size + dummy bytes
+    payload.resize(payload.size() + 44, 0);
+    return message(probe::wire::kCodecHeader, payload);
+}
+
+std::vector<uint8_t> wireChunk() {
+    std::vector<uint8_t> payload(8 + 4 + CHUNK_BYTES, 0);
+    payload[8] = CHUNK_BYTES & 0xff;
+    payload[9] = (CHUNK_BYTES >> 8) & 0xff;
+    return message(probe::wire::kWireChunk, payload);
+}
+
+class MockStreamServer {
+public:
+    MockStreamServer(milliseconds max_time_delay, bool silent)
+        : acceptor_(io_, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)), maxDelay_(max_time_delay),
+          silent_(silent) {
+        accept();
+        thread_ = std::thread([this]() { io_.run(); });
+    }
+
+    ~MockStreamServer() {
+        io_.stop();
+        thread_.join();
+    }
+
+    uint16_t port() const { return acceptor_.local_endpoint().port(); }
+
+private:
+    struct Session : std::enable_shared_from_this<Session> {
+        Session(boost::asio::io_context& io, tcp::socket s, milliseconds max_delay)
+            : socket(std::move(s)), chunkTimer(io), io(io), maxDelay(max_delay), rng(42) {}
+
+        void read() {
+            boost::asio::async_read(socket, boost::asio::buffer(header), [self = shared_from_this()](auto ec, size_t) {
+                if (ec) return;
+                self->incoming = probe::wire::decodeHeader(self->header.data());
+                self->payload.resize(self->incoming.size);
+                boost::asio::async_read(self->socket, boost::asio::buffer(self->payload), [self](auto ec, size_t) {
+                    if (ec) return;
+                    self->onMessage();
+                    self->read();
+                });
+            });
+        }
+
+        void onMessage() {
+            if (incoming.type == probe::wire::kHello) {
+                send(codecHeader());
+                for (int i = 0; i < BUFFER_CHUNKS; ++i)
+                    send(wireChunk());
+                streamStart = Clock::now();
+                scheduleChunk(1);
+            } else if (incoming.type == probe::wire::kTime) {
+                // Stamped on receipt with the server clock, delivered after a
+                // random network delay
+                auto received = probe::wire::now() + SERVER_CLOCK_OFFSET;
+                auto latency = received - probe::wire::fromTimeval(incoming.sent);
+                auto reply = std::make_shared<std::vector<uint8_t>>(
+                    probe::wire::encodeTimeReply(0, incoming.id, latency, received));
+                std::uniform_int_distribution<int> delay(0, static_cast<int>(maxDelay.count() * 1000));
+                auto timer = std::make_shared<boost::asio::steady_timer>(io, microseconds(delay(rng)));
+                timer->async_wait([self = shared_from_this(), timer, reply](auto ec) {
+                    if (!ec) self->send(std::move(*reply));
+                });
+            }
+        }
+
+        void scheduleChunk(int n) {
+            chunkTimer.expires_at(streamStart + CHUNK_DURATION * n);
+            chunkTimer.async_wait([self = shared_from_this(), n](auto ec) {
+                if (ec) return;
+                self->send(wireChunk());
+                self->scheduleChunk(n + 1);
+            });
+        }
+
+        void send(std::vector<uint8_t> data) {
+            queue.push_back(std::move(data));
+            if (queue.size() == 1) writeNext();
+        }
+
+        void writeNext() {
+            boost::asio::async_write(socket, boost::asio::buffer(queue.front()), [self = shared_from_this()](auto ec, size_t) {
+                if (ec) {
+                    self->chunkTimer.cancel();
+                    return;
+                }
+                self->queue.pop_front();
+                if (!self->queue.empty()) self->writeNext();
+            });
+        }
+
+        tcp::socket socket;
+        boost::asio::steady_timer chunkTimer;
+        boost::asio::io_context& io;
+        milliseconds maxDelay;
+        std::mt19937 rng;
+        Clock::time_point streamStart;
+        std::array<uint8_t, probe::wire::HEADER_SIZE> header{};
+        std::vector<uint8_t> payload;
+        probe::wire::Header incoming;
+        std::deque<std::vector<uint8_t>> queue;
+    };
+
+    void accept() {
+        acceptor_.async_accept([this](auto ec, tcp::socket socket) {
+            if (ec) return;
+            socket.set_option(tcp::no_delay(true), ec);  // As snapserver does
+            auto session = std::make_shared<Session>(io_, std::move(socket), maxDelay_);
+            if (!silent_) session->read();
+            sessions_.push_back(session);
+            accept();
+        });
+    }
+
+    boost::asio::io_context io_;
+    tcp::acceptor acceptor_;
+    milliseconds maxDelay_;
+    bool silent_;
+    std::vector<std::shared_ptr<Session>> sessions_;
+    std::thread thread_;
+};
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+probe::LinkQuality runProbe(uint16_t port, double& duration_ms) {
+    boost::asio::io_context io;
+    probe::LinkProbe link(io);
+    probe::LinkProbeOptions options;
+    options.hello.id = "00:11:22:33:44:55";
+    probe::LinkQuality quality;
+
+    auto start = Clock::now();
+    link.run({"127.0.0.1", port}, options, [&](const probe::LinkQuality& q) { quality = q; });
+    io.run();
+    duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return quality;
+}
+
+std::string us(microseconds v) {
+    return std::to_string(v.count()) + " µs";
+}
+
+void report(const probe::LinkQuality& q) {
+    log("   - Status: " + std::string(probe::toString(q.status)) + ", codec: " + q.codec + ", chunks: " + std::to_string(q.chunks));
+    log("   - RTT (" + std::to_string(q.samples) + " samples): min " + us(q.rttMin) + ", median " + us(q.rttMedian) +
+        ", p95 " + us(q.rttP95) + ", max " + us(q.rttMax) + ", jitter " + us(q.jitter));
+    log("   - Offset: " + std::to_string(q.offsetMedian.count() / 1000.0) + " ms ± " + us(q.offsetStdDev));
+    log("   - Throughput: " + std::to_string(static_cast<int>(q.throughputKbps)) + " kbps, peak " +
+        std::to_string(static_cast<int>(q.peakThroughputKbps)) + " kbps (stream: " +
+        std::to_string(static_cast<int>(STREAM_KBPS)) + " kbps)");
+}
+
+TestResult test_clean_link(probe::LinkQuality& out) {
+    const std::string name = "CleanLink";
+    log("🧪 [" + name + "] streaming server, no added delay");
+    MockStreamServer server(milliseconds(0), false);
+    double duration_ms = 0;
+    out = runProbe(server.port(), duration_ms);
+    log("✅ [" + name + "] Complete in " + std::to_string(duration_ms) + " ms:");
+    report(out);
+
+    auto offset_error = out.offsetMedian - SERVER_CLOCK_OFFSET;
+    bool passed = out.status == probe::ProbeStatus::Ok && out.samples == probe::LinkProbeOptions().timeSamples &&
+                  std::abs(offset_error.count()) < 2000 && out.offsetStdDev < milliseconds(1) && out.codec == "pcm" &&
+                  out.chunks >= BUFFER_CHUNKS && out.throughputKbps > STREAM_KBPS &&
+                  out.peakThroughputKbps > out.throughputKbps;
+    return {name, passed, passed ? "Offset within 2 ms, stable; throughput above stream rate" : "Implausible link metrics",
+            duration_ms};
+}
+
+TestResult test_jittery_link(const probe::LinkQuality& clean) {
+    const std::string name = "JitteryLink";
+    log("🧪 [" + name + "] Time replies delayed by 0-20 ms");
+    MockStreamServer server(milliseconds(20), false);
+    double duration_ms = 0;
+    auto q = runProbe(server.port(), duration_ms);
+    log("✅ [" + name + "] Complete in " + std::to_string(duration_ms) + " ms:");
+    report(q);
+
+    bool passed = q.status == probe::ProbeStatus::Ok && q.jitter > milliseconds(3) && q.jitter > clean.jitter * 10 &&
+                  q.rttP95 > milliseconds(10) && q.offsetStdDev > clean.offsetStdDev;
+    return {name, passed, passed ? "Jitter and offset spread flagged" : "Jittery link not told apart from a clean one",
+            duration_ms};
+}
+
+TestResult test_silent_server() {
+    const std::string name = "SilentServer";
+    log("🧪 [" + name + "] server accepts but never answers");
+    MockStreamServer server(milliseconds(0), true);
+    double duration_ms = 0;
+    auto q = runProbe(server.port(), duration_ms);
+    log("✅ [" + name + "] Complete in " + std::to_string(duration_ms) + " ms: " + probe::toString(q.status));
+
+    bool passed = q.status == probe::ProbeStatus::NoReply && q.samples == 0 && q.bytes == 0;
+    return {name, passed, passed ? "Reported as no reply" : "Silent server reported as usable", duration_ms};
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int run_all_tests() {
+    std::cout << "\n";
+    std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║       Link Quality Probe Benchmark                           ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════════════╝\n";
+    std::cout << "\n";
+
+    probe::LinkQuality clean;
+    g_results.push_back(test_clean_link(clean));
+    std::cout << "\n";
+    g_results.push_back(test_jittery_link(clean));
+    std::cout << "\n";
+    g_results.push_back(test_silent_server());
+    std::cout << "\n";
+
+    int failed = 0;
+    for (const auto& result : g_results) {
+        std::string status = result.passed ? "✅ PASS" : "❌ FAIL";
+        std::cout << "  " << status << "  " << result.name << "\n";
+        std::cout << "         " << result.message << " (" << result.duration_ms << " ms)\n";
+        if (!result.passed) failed++;
+    }
+    std::cout << "\n";
+    return failed;
+}
+
+} // namespace link_bench
+
+int main() {
+    return link_bench::run_all_tests() == 0 ? 0 : 1;
+}
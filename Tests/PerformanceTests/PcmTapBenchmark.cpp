@@ -0,0 +1,347 @@
+/***
+    PcmTapBenchmark.cpp
+
+    Measures playout::PcmTap, the ring of played PCM that consumers outside
+    the player (recording, re-output, analysis) read in place.
+
+    - Real-time side: ns per push() of the player's 100 ms buffers with no,
+      one and four consumers; the audio thread copies once, whatever the
+      number of consumers.
+    - Consistency: two consumers read while a writer pushes as fast as it
+      can; every block released as intact holds exactly the frames pushed,
+      and received plus reported lost frames add up to what was pushed.
+    - Slow consumer: a consumer that sleeps on every block never slows the
+      writer; it is lapped, and its overruns and lost frames are reported.
+    - Wrap and time: a block across the end of the ring comes in two parts,
+      with the playout time of its first frame.
+
+    Build & run: ./scripts/run-linux-benchmarks.sh PcmTap
+
+    Copyright (C) 2025 SnapForge contributors
+    License: GPL-3.0
+***/
+
+#include "playout/pcm_tap.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pcm_tap_bench {
+
+using Clock = std::chrono::steady_clock;
+using playout::PcmTap;
+
+constexpr uint32_t RATE = 48000;
+constexpr uint32_t FRAMES = 4800;  // 100 ms at 48 kHz
+constexpr size_t PUSHES = 100'000;
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+    double duration_ms;
+};
+
+std::vector<TestResult> g_results;
+
+void log(const std::string& msg) {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::cout << "[" << std::put_time(std::localtime(&time), "%H:%M:%S") << "] " << msg << std::endl;
+}
+
+std::string fmt(double v, int precision = 1) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(precision) << v;
+    return out.str();
+}
+
+/// Time of frame @p frame when frame 0 plays at @p base
+Clock::time_point frameTime(Clock::time_point base, uint64_t frame) {
+    return base + std::chrono::nanoseconds(static_cast<int64_t>(frame) * 1000000000 / RATE);
+}
+
+/// Mono 32-bit frames numbered from @p first
+void number(std::vector<int32_t>& pcm, uint64_t first) {
+    for (size_t i = 0; i < pcm.size(); ++i) pcm[i] = static_cast<int32_t>(first + i);
+}
+
+/// The frames of @p block hold their numbers
+bool numbered(const PcmTap::Block& block) {
+    uint64_t frame = block.firstFrame;
+    for (int part = 0; part < 2; ++part) {
+        const auto* pcm = static_cast<const int32_t*>(block.data[part]);
+        for (uint32_t i = 0; i < block.frames[part]; ++i, ++frame)
+            if (pcm[i] != static_cast<int32_t>(frame)) return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Test 1: real-time side
+// ============================================================================
+
+struct PushCost {
+    double median;
+    double p99;
+};
+
+PushCost measurePush(size_t readers) {
+    PcmTap tap({RATE, 2, 16});
+    std::vector<std::unique_ptr<PcmTap::Reader>> attached;
+    for (size_t i = 0; i < readers; ++i) attached.push_back(std::make_unique<PcmTap::Reader>(tap));
+    std::vector<int16_t> buffer(static_cast<size_t>(FRAMES) * 2, 1);
+    std::vector<double> ns(PUSHES);
+    const auto playAt = Clock::now();
+    for (size_t i = 0; i < 1000; ++i) tap.push(buffer.data(), FRAMES, playAt);  // warm-up
+    for (size_t i = 0; i < PUSHES; ++i) {
+        auto t0 = Clock::now();
+        tap.push(buffer.data(), FRAMES, playAt);
+        ns[i] = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+    }
+    std::sort(ns.begin(), ns.end());
+    return {ns[PUSHES / 2], ns[PUSHES * 99 / 100]};
+}
+
+TestResult test_push_cost() {
+    TestResult result{"One copy per buffer, whatever the consumers", true, "", 0};
+    auto start = Clock::now();
+
+    log("16-bit stereo, 100 ms buffers (18.8 KiB)   median    p99   (ns per push)");
+    const size_t counts[] = {0, 1, 4};
+    PushCost cost[3];
+    for (size_t i = 0; i < 3; ++i) {
+        cost[i] = measurePush(counts[i]);
+        log("  " + std::to_string(counts[i]) + " consumers                               " + fmt(cost[i].median, 0) + "     " +
+            fmt(cost[i].p99, 0));
+    }
+
+    result.passed = cost[0].median < 50 && cost[2].median < cost[1].median * 1.5 + 100;
+    result.message = "idle " + fmt(cost[0].median, 0) + " ns, 1 consumer " + fmt(cost[1].median, 0) + " ns, 4 consumers " +
+                     fmt(cost[2].median, 0) + " ns median per 100 ms buffer";
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Test 2: consistency under a concurrent writer
+// ============================================================================
+
+struct Tally {
+    uint64_t blocks{0};
+    uint64_t frames{0};
+    uint64_t discarded{0};
+    uint64_t corrupt{0};
+    uint64_t late{0};
+    uint64_t firstFrame{~uint64_t(0)};
+    uint64_t endFrame{0};
+    uint64_t overruns{0};
+    uint64_t lost{0};
+};
+
+/// Read @p tap until @p done and drained, checking every block
+void consume(PcmTap& tap, const std::atomic<bool>& done, Clock::time_point base, std::chrono::microseconds pause, Tally& tally) {
+    PcmTap::Reader reader(tap);
+    PcmTap::Block block;
+    for (;;) {
+        const bool finished = done.load(std::memory_order_acquire);
+        if (!reader.acquire(block)) {
+            if (finished) break;
+            std::this_thread::yield();
+            continue;
+        }
+        tally.firstFrame = std::min(tally.firstFrame, block.firstFrame);
+        const bool content = numbered(block);
+        const bool time = block.playAt == frameTime(base, block.firstFrame);
+        if (pause.count() > 0) std::this_thread::sleep_for(pause);
+        if (!reader.release(block)) {
+            ++tally.discarded;
+            continue;
+        }
+        if (!content) ++tally.corrupt;
+        if (!time) ++tally.late;
+        ++tally.blocks;
+        tally.frames += block.totalFrames();
+        tally.endFrame = block.firstFrame + block.totalFrames();
+    }
+    tally.overruns = reader.overruns();
+    tally.lost = reader.lostFrames();
+}
+
+/// Push @p blocks numbered mono blocks of @p frames; yielding every
+/// @p yieldEvery blocks lets consumers in on a machine with few cores
+std::vector<double> produce(PcmTap& tap, size_t blocks, uint32_t frames, Clock::time_point base, size_t yieldEvery = 0) {
+    std::vector<int32_t> pcm(frames);
+    std::vector<double> ns(blocks);
+    uint64_t first = 0;
+    for (size_t b = 0; b < blocks; ++b, first += frames) {
+        number(pcm, first);
+        auto t0 = Clock::now();
+        tap.push(pcm.data(), frames, frameTime(base, first));
+        ns[b] = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+        if (yieldEvery != 0 && b % yieldEvery == 0) std::this_thread::yield();
+    }
+    std::sort(ns.begin(), ns.end());
+    return ns;
+}
+
+/// Every frame from the first block on was either received or reported lost
+bool accounted(const Tally& tally) {
+    return tally.frames > 0 && tally.frames + tally.lost == tally.endFrame - tally.firstFrame;
+}
+
+TestResult test_consistency() {
+    TestResult result{"Intact blocks hold what was pushed", true, "", 0};
+    auto start = Clock::now();
+
+    // 100 ms ring, 10 ms blocks, 13 pushed per turn: consumers keep up at
+    // times and are lapped at others
+    PcmTap tap({RATE, 1, 32}, std::chrono::milliseconds(100));
+    std::atomic<bool> done{false};
+    const auto base = Clock::now();
+    Tally tally[2];
+    std::thread readers[2];
+    for (int i = 0; i < 2; ++i)
+        readers[i] = std::thread(consume, std::ref(tap), std::cref(done), base, std::chrono::microseconds(0), std::ref(tally[i]));
+    while (tap.readers() < 2) std::this_thread::yield();
+    produce(tap, 200'000, 480, base, 13);
+    done.store(true, std::memory_order_release);
+    for (auto& reader : readers) reader.join();
+
+    for (int i = 0; i < 2; ++i) {
+        const auto& t = tally[i];
+        log("  consumer " + std::to_string(i + 1) + ": " + std::to_string(t.blocks) + " blocks intact, " + std::to_string(t.discarded) +
+            " overwritten while held, " + std::to_string(t.overruns) + " overruns, " + std::to_string(t.lost) + " frames lost, " +
+            std::to_string(t.corrupt) + " corrupt, " + std::to_string(t.late) + " mistimed");
+        if (t.corrupt != 0 || t.late != 0 || !accounted(t)) result.passed = false;
+    }
+    result.message = std::to_string(tally[0].blocks + tally[1].blocks) + " blocks read in place, none corrupt; received + lost = pushed";
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Test 3: a slow consumer does not hold up playback
+// ============================================================================
+
+TestResult test_slow_consumer() {
+    TestResult result{"Slow consumer is lapped, not waited for", true, "", 0};
+    auto start = Clock::now();
+
+    constexpr size_t BLOCKS = 20'000;
+    const auto base = Clock::now();
+
+    PcmTap idle({RATE, 1, 32}, std::chrono::milliseconds(200));
+    auto alone = produce(idle, BLOCKS, 480, base);  // no consumer: push returns at once
+    PcmTap tap({RATE, 1, 32}, std::chrono::milliseconds(200));
+    std::atomic<bool> done{false};
+    Tally fast;
+    std::thread fastReader(consume, std::ref(tap), std::cref(done), base, std::chrono::microseconds(0), std::ref(fast));
+    while (tap.readers() < 1) std::this_thread::yield();
+    auto fastOnly = produce(tap, BLOCKS, 480, base);
+    done.store(true, std::memory_order_release);
+    fastReader.join();
+
+    PcmTap slowTap({RATE, 1, 32}, std::chrono::milliseconds(200));
+    std::atomic<bool> slowDone{false};
+    Tally slow;
+    std::thread slowReader(consume, std::ref(slowTap), std::cref(slowDone), base, std::chrono::microseconds(1000), std::ref(slow));
+    while (slowTap.readers() < 1) std::this_thread::yield();
+    auto withSlow = produce(slowTap, BLOCKS, 480, base);
+    slowDone.store(true, std::memory_order_release);
+    slowReader.join();
+
+    log("  push of 10 ms blocks: " + fmt(fastOnly[BLOCKS / 2], 0) + " ns median, " + fmt(fastOnly[BLOCKS * 99 / 100], 0) +
+        " ns p99 with a fast consumer; " + fmt(withSlow[BLOCKS / 2], 0) + " / " + fmt(withSlow[BLOCKS * 99 / 100], 0) +
+        " ns with one sleeping 1 ms per block (" + fmt(alone[BLOCKS / 2], 0) + " ns without any)");
+    log("  slow consumer: " + std::to_string(slow.blocks) + " of " + std::to_string(BLOCKS) + " blocks, " + std::to_string(slow.overruns) +
+        " overruns, " + std::to_string(slow.lost) + " frames lost, " + std::to_string(slow.corrupt) + " corrupt");
+
+    result.passed = slow.overruns > 0 && slow.corrupt == 0 && accounted(slow) && withSlow[BLOCKS / 2] < fastOnly[BLOCKS / 2] * 2 + 100;
+    result.message = "writer at " + fmt(withSlow[BLOCKS / 2], 0) + " ns median either way; " + std::to_string(slow.overruns) +
+                     " overruns reported, " + std::to_string(slow.lost) + " frames lost";
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Test 4: wrap and playout time
+// ============================================================================
+
+TestResult test_wrap() {
+    TestResult result{"Blocks across the ring's end, with their time", true, "", 0};
+    auto start = Clock::now();
+
+    // 10 ms ring of 480 frames, blocks of 300: the second wraps at 180
+    PcmTap tap({RATE, 1, 32}, std::chrono::milliseconds(10));
+    PcmTap::Reader reader(tap);
+    const auto base = Clock::now();
+    std::vector<int32_t> pcm(300);
+    size_t wrapped = 0;
+    size_t checked = 0;
+    for (uint64_t b = 0; b < 8; ++b) {
+        number(pcm, b * 300);
+        tap.push(pcm.data(), 300, frameTime(base, b * 300));
+        PcmTap::Block block;
+        if (!reader.acquire(block)) {
+            result.passed = false;
+            continue;
+        }
+        if (block.frames[1] > 0) ++wrapped;
+        if (!numbered(block) || block.playAt != frameTime(base, b * 300) || block.sequence != b || !reader.release(block))
+            result.passed = false;
+        ++checked;
+    }
+    // Nothing more, nothing lost
+    PcmTap::Block none;
+    if (reader.acquire(none) || reader.overruns() != 0) result.passed = false;
+    log("  " + std::to_string(checked) + " blocks, " + std::to_string(wrapped) + " in two parts");
+
+    result.passed = result.passed && wrapped > 0;
+    result.message = std::to_string(wrapped) + " of " + std::to_string(checked) + " blocks wrapped, all in order with their playout time";
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+int run_all_tests() {
+    std::cout << "\n";
+    std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║       PCM Tap Benchmark                                      ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════════════╝\n";
+    std::cout << "\n";
+
+    g_results.push_back(test_push_cost());
+    std::cout << "\n";
+    g_results.push_back(test_consistency());
+    std::cout << "\n";
+    g_results.push_back(test_slow_consumer());
+    std::cout << "\n";
+    g_results.push_back(test_wrap());
+    std::cout << "\n";
+
+    int failed = 0;
+    for (const auto& result : g_results) {
+        std::string status = result.passed ? "✅ PASS" : "❌ FAIL";
+        std::cout << "  " << status << "  " << result.name << "\n";
+        std::cout << "         " << result.message << " (" << result.duration_ms << " ms)\n";
+        if (!result.passed) failed++;
+    }
+    std::cout << "\n";
+    return failed;
+}
+
+} // namespace pcm_tap_bench
+
+int main() {
+    return pcm_tap_bench::run_all_tests() == 0 ? 0 : 1;
+}
@@ -0,0 +1,353 @@
+/***
+    PeakLimiterBenchmark.cpp
+
+    Measures dsp::PeakLimiter, the look-ahead limiter that runs last before
+    the AudioQueue buffer, against a reference that follows its definition
+    literally: for every frame, scan the look-ahead window for the smallest
+    needed gain and re-average the held gains.
+
+    - Full scale: hot material (noise and sines up to +12 dBFS, impulses,
+      a +12 dB bass shelf on a 0 dBFS tone) never leaves [-1, 1] after the
+      limiter, for 1-8 channels and odd buffer sizes; the samples a plain
+      clamp would have clipped are counted for comparison.
+    - Transparency: below the ceiling the output is the input delayed by
+      exactly latency(), and gain recovers after a burst.
+    - Cost: ns per frame, stereo and 5.1, quiet (pure delay) and limiting,
+      over the player's 100 ms buffers (4800 frames at 48 kHz).
+
+    Build & run: ./scripts/run-linux-benchmarks.sh PeakLimiter
+
+    Copyright (C) 2025 SnapForge contributors
+    License: GPL-3.0
+***/
+
+#include "dsp/parametric_eq.hpp"
+#include "dsp/peak_limiter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace peak_limiter_bench {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t RATE = 48000;
+constexpr uint32_t FRAMES = 4800;  // 100 ms
+constexpr size_t TOTAL_FRAMES = 5'000'000;
+constexpr double PI = 3.14159265358979323846;
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+    double duration_ms;
+};
+
+std::vector<TestResult> g_results;
+
+void log(const std::string& msg) {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::cout << "[" << std::put_time(std::localtime(&time), "%H:%M:%S") << "] " << msg << std::endl;
+}
+
+std::string fmt(double v, int precision = 1) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(precision) << v;
+    return out.str();
+}
+
+std::vector<float> noise(uint16_t channels, uint32_t frames, float amplitude, uint32_t seed) {
+    std::vector<float> pcm(static_cast<size_t>(frames) * channels);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-amplitude, amplitude);
+    for (auto& s : pcm) s = dist(rng);
+    return pcm;
+}
+
+// ============================================================================
+// Reference: the definition, O(look-ahead) per frame
+// ============================================================================
+
+struct Reference {
+    uint16_t channels;
+    uint32_t lookahead;
+    float mul;
+    std::vector<float> history;  // input, lookahead frames
+    std::vector<float> need;     // lookahead + 1 frames
+    std::vector<float> held;     // lookahead frames
+    float last = 1.f;
+
+    Reference(uint16_t ch, const dsp::LimiterOptions& options) : channels(ch) {
+        lookahead = std::max<uint32_t>(static_cast<uint32_t>(options.lookahead.count() * RATE / 1000), 1);
+        mul = static_cast<float>(std::exp(-1. / (static_cast<double>(options.release.count()) * RATE / 1000.)));
+        history.assign(static_cast<size_t>(lookahead) * channels, 0.f);
+        need.assign(lookahead + 1, 1.f);
+        held.assign(lookahead, 1.f);
+    }
+
+    void process(float* pcm, uint32_t frames) {
+        for (uint32_t f = 0; f < frames; ++f) {
+            float peak = 0.f;
+            for (uint16_t c = 0; c < channels; ++c) peak = std::max(peak, std::fabs(pcm[f * channels + c]));
+            need.erase(need.begin());
+            need.push_back(1.f / std::max(peak, 1.f));
+            float m = *std::min_element(need.begin(), need.end());
+            float h = std::min(m, 1.f - (1.f - last) * mul);
+            if (h > 1.f - 1e-4f) h = 1.f;
+            last = h;
+            held.erase(held.begin());
+            held.push_back(h);
+            double sum = 0;
+            for (float v : held) sum += v;
+            float g = static_cast<float>(sum / lookahead);
+
+            history.insert(history.end(), pcm + f * channels, pcm + (f + 1) * channels);
+            for (uint16_t c = 0; c < channels; ++c) pcm[f * channels + c] = std::min(std::max(history[c] * g, -1.f), 1.f);
+            history.erase(history.begin(), history.begin() + channels);
+        }
+    }
+};
+
+// ============================================================================
+// Test 1: nothing above full scale
+// ============================================================================
+
+/// Hot test material, @p channels interleaved
+std::vector<std::pair<std::string, std::vector<float>>> material(uint16_t channels) {
+    std::vector<std::pair<std::string, std::vector<float>>> out;
+    const uint32_t frames = RATE;
+
+    out.emplace_back("noise +12 dBFS", noise(channels, frames, 4.f, 7));
+
+    std::vector<float> burst(static_cast<size_t>(frames) * channels);
+    for (uint32_t f = 0; f < frames; ++f) {
+        // Quiet, then a step to 3x full scale, then back
+        double a = (f > frames / 3 && f < 2 * frames / 3) ? 3. : 0.5;
+        for (uint16_t c = 0; c < channels; ++c) burst[f * channels + c] = static_cast<float>(a * std::sin(2 * PI * (440 + 110 * c) * f / RATE));
+    }
+    out.emplace_back("sine burst 3x", std::move(burst));
+
+    std::vector<float> clicks(static_cast<size_t>(frames) * channels, 0.f);
+    for (uint32_t f = 1000; f < frames; f += 4801) clicks[f * channels + (f / 4801) % channels] = (f % 2) ? 8.f : -8.f;
+    out.emplace_back("impulses 8x", std::move(clicks));
+
+    // The case the limiter is for: a boost on a mastered-to-0 dBFS track
+    std::vector<float> bass(static_cast<size_t>(frames) * channels);
+    for (uint32_t f = 0; f < frames; ++f)
+        for (uint16_t c = 0; c < channels; ++c) bass[f * channels + c] = static_cast<float>(0.99 * std::sin(2 * PI * 60 * f / RATE));
+    dsp::ParametricEq eq(RATE, channels, std::chrono::milliseconds(0));
+    eq.configure({{dsp::FilterType::LowShelf, 150, 12, 0.707f}});
+    eq.process(bass.data(), frames);
+    out.emplace_back("0 dBFS bass + 12 dB shelf", std::move(bass));
+    return out;
+}
+
+TestResult test_full_scale() {
+    TestResult result{"No sample above full scale", true, "", 0};
+    auto start = Clock::now();
+
+    size_t clamped = 0;
+    size_t total = 0;
+    double worstRef = 0;
+    for (uint16_t channels : {1, 2, 3, 6, 8}) {
+        for (auto& [name, pcm] : material(channels)) {
+            for (float s : pcm) clamped += (std::fabs(s) > 1.f) ? 1 : 0;
+            total += pcm.size();
+
+            dsp::PeakLimiter limiter(RATE, channels);
+            Reference reference(channels, {});
+            auto expected = pcm;
+            reference.process(expected.data(), static_cast<uint32_t>(expected.size() / channels));
+            // Odd buffer sizes: blocks and the look-ahead don't line up
+            const uint32_t frames = static_cast<uint32_t>(pcm.size() / channels);
+            for (uint32_t done = 0; done < frames;) {
+                uint32_t len = std::min<uint32_t>(997, frames - done);
+                limiter.process(pcm.data() + static_cast<size_t>(done) * channels, len);
+                done += len;
+            }
+
+            float peak = 0;
+            for (size_t i = 0; i < pcm.size(); ++i) {
+                peak = std::max(peak, std::fabs(pcm[i]));
+                worstRef = std::max(worstRef, std::fabs(static_cast<double>(pcm[i] - expected[i])));
+            }
+            if (channels == 2)
+                log("  " + name + ": peak out " + fmt(peak, 4) + ", min gain " + fmt(limiter.stats().minGain, 3) + ", " +
+                    std::to_string(limiter.stats().limitedFrames) + " of " + std::to_string(limiter.stats().frames) + " frames limited");
+            if (peak > 1.f) {
+                result.passed = false;
+                result.message = name + ", " + std::to_string(channels) + " ch: peak " + fmt(peak, 6);
+            }
+        }
+    }
+    log("  samples a clamp would clip: " + std::to_string(clamped) + " of " + std::to_string(total) +
+        ", after the limiter: 0; largest difference to the reference " + fmt(worstRef * 1e6, 2) + "e-6");
+
+    if (worstRef > 1e-5) {
+        result.passed = false;
+        result.message = "differs from the reference by " + fmt(worstRef * 1e6, 1) + "e-6";
+    }
+    if (result.passed) result.message = std::to_string(clamped) + " samples over full scale in, none out; matches the reference";
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Test 2: transparency and latency
+// ============================================================================
+
+TestResult test_transparency() {
+    TestResult result{"Delay-only below the ceiling", true, "", 0};
+    auto start = Clock::now();
+
+    dsp::PeakLimiter limiter(RATE, 2);
+    const uint32_t lag = limiter.latencyFrames();
+    log("  look-ahead " + std::to_string(lag) + " frames, latency() " + std::to_string(limiter.latency().count()) + " us");
+    if (limiter.latency() != std::chrono::microseconds(2000)) {
+        result.passed = false;
+        result.message = "latency " + std::to_string(limiter.latency().count()) + " us, expected 2000";
+    }
+
+    // Quiet, a burst, then quiet again: the tail must be an exact delay
+    const uint32_t frames = RATE * 2;
+    auto input = noise(2, frames, 0.9f, 11);
+    for (uint32_t f = RATE / 4; f < RATE / 4 + 2400; ++f) {
+        input[f * 2] *= 2.5f;
+        input[f * 2 + 1] *= 2.5f;
+    }
+    auto pcm = input;
+    limiter.process(pcm.data(), frames);
+
+    auto exactFrom = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t f = begin; f < end; ++f)
+            for (int c = 0; c < 2; ++c)
+                if (pcm[f * 2 + c] != input[(f - lag) * 2 + c]) return false;
+        return true;
+    };
+    // Before the burst's look-ahead, and 10 release times after it
+    bool before = exactFrom(lag, RATE / 4 - 2);
+    bool after = exactFrom(RATE / 4 + 2400 + RATE / 2, frames);
+    log(std::string("  exact delay before the burst: ") + (before ? "yes" : "no") + ", after recovery: " + (after ? "yes" : "no"));
+    if (!before || !after) {
+        result.passed = false;
+        result.message = before ? "gain didn't recover to 1 after the burst" : "input below the ceiling was altered";
+    }
+
+    // A steady 2x sine settles at half gain: limited, not squashed
+    dsp::PeakLimiter steady(RATE, 1);
+    std::vector<float> sine(RATE);
+    for (uint32_t f = 0; f < RATE; ++f) sine[f] = static_cast<float>(2 * std::sin(2 * PI * 1000 * f / RATE));
+    steady.process(sine.data(), RATE);
+    float settledPeak = 0;
+    for (uint32_t f = RATE / 2; f < RATE; ++f) settledPeak = std::max(settledPeak, std::fabs(sine[f]));
+    log("  2x sine: settled peak " + fmt(settledPeak, 4));
+    if (settledPeak < 0.97f) {
+        result.passed = false;
+        result.message = "over-limits a steady 2x sine to " + fmt(settledPeak, 3);
+    }
+
+    if (result.passed) result.message = "exact " + std::to_string(lag) + "-frame delay, recovers after a burst, settles at " + fmt(settledPeak, 3);
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Test 3: ns/frame
+// ============================================================================
+
+template <typename F>
+double nsPerFrame(F&& run) {
+    const size_t buffers = TOTAL_FRAMES / FRAMES;
+    run();  // warm-up
+    auto t0 = Clock::now();
+    for (size_t b = 0; b < buffers; ++b) run();
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / static_cast<double>(buffers * FRAMES);
+}
+
+TestResult test_speed() {
+    TestResult result{"Cost per frame", true, "", 0};
+    auto start = Clock::now();
+
+    log("Content   channels   reference   PeakLimiter   speedup   (ns/frame)");
+    double worstSpeedup = 1e9;
+    double worstNs = 0;
+    for (bool hot : {false, true}) {
+        for (uint16_t channels : {2, 6}) {
+            const auto source = noise(channels, FRAMES, hot ? 2.f : 0.5f, 5);
+            auto pcm = source;
+
+            Reference reference(channels, {});
+            double refNs = nsPerFrame([&] {
+                std::copy(source.begin(), source.end(), pcm.begin());
+                reference.process(pcm.data(), FRAMES);
+            });
+            dsp::PeakLimiter limiter(RATE, channels);
+            double ns = nsPerFrame([&] {
+                std::copy(source.begin(), source.end(), pcm.begin());
+                limiter.process(pcm.data(), FRAMES);
+            });
+            double speedup = refNs / ns;
+            worstSpeedup = std::min(worstSpeedup, speedup);
+            worstNs = std::max(worstNs, ns);
+            log(std::string(hot ? "limiting" : "quiet   ") + "  " + std::string(8, ' ') + std::to_string(channels) + "   " + fmt(refNs, 2) +
+                "        " + fmt(ns, 2) + "      " + fmt(speedup, 1) + "x");
+        }
+    }
+
+    // 1% of a 48 kHz frame period (20.8 us) is 208 ns
+    if (worstNs > 208) {
+        result.passed = false;
+        result.message = "worst " + fmt(worstNs, 1) + " ns/frame, more than 1% of real time";
+    } else if (worstSpeedup < 1.0) {
+        result.passed = false;
+        result.message = "slower than the reference (" + fmt(worstSpeedup, 2) + "x)";
+    } else {
+        result.message = "at most " + fmt(worstNs, 1) + " ns/frame, at least " + fmt(worstSpeedup, 1) + "x faster than the reference";
+    }
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int run_all_tests() {
+    std::cout << "\n";
+    std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║       Peak Limiter Benchmark                                 ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════════════╝\n";
+    std::cout << "\n";
+
+    g_results.push_back(test_full_scale());
+    std::cout << "\n";
+    g_results.push_back(test_transparency());
+    std::cout << "\n";
+    g_results.push_back(test_speed());
+    std::cout << "\n";
+
+    int failed = 0;
+    for (const auto& result : g_results) {
+        std::string status = result.passed ? "✅ PASS" : "❌ FAIL";
+        std::cout << "  " << status << "  " << result.name << "\n";
+        std::cout << "         " << result.message << " (" << result.duration_ms << " ms)\n";
+        if (!result.passed) failed++;
+    }
+    std::cout << "\n";
+    return failed;
+}
+
+} // namespace peak_limiter_bench
+
+int main() {
+    return peak_limiter_bench::run_all_tests() == 0 ? 0 : 1;
+}
@@ -0,0 +1,364 @@
+/***
+    ReachabilityBenchmark.cpp
+
+    Measures startup-to-first-server-choice for 10 saved servers on loopback:
+    5 mock Snapcast servers whose Time replies arrive 1-12 ms late, 3
+    blackholed ones (TCP accepted by the kernel, never answered) and 2
+    refusing connections.
+
+    Baseline: probing one server after another with a blocking connect, a
+    Time request and a 2 s receive timeout (what snapclient_test_tcp does for
+    a single host). Then ReachabilityProber with the default grace period,
+    with no grace (first answer wins), and with the full deadline to check
+    the reported status of every endpoint.
+
+    Build & run: ./scripts/run-linux-benchmarks.sh Reachability
+
+    Copyright (C) 2025 SnapForge contributors
+    License: GPL-3.0
+***/
+
+#include "probe/reachability_prober.hpp"
+#include "probe/stream_wire.hpp"
+
+#include <boost/asio.hpp>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace reachability_bench {
+
+using boost::asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+
+constexpr auto BLOCKING_TIMEOUT = std::chrono::seconds(2);
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+    double duration_ms;
+};
+
+std::vector<TestResult> g_results;
+
+void log(const std::string& msg) {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::cout << "[" << std::put_time(std::localtime(&time), "%H:%M:%S") << "] " << msg << std::endl;
+}
+
+double ms(Clock::duration d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+// ============================================================================
+// Mock servers
+// ============================================================================
+
+/// Answers every Time request, the reply reaching the client after a fixed delay
+class MockSnapserver {
+public:
+    MockSnapserver(boost::asio::io_context& io, std::chrono::milliseconds delay)
+        : io_(io), acceptor_(io, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)), delay_(delay) {
+        accept();
+    }
+
+    uint16_t port() const { return acceptor_.local_endpoint().port(); }
+
+private:
+    struct Session : std::enable_shared_from_this<Session> {
+        Session(boost::asio::io_context& io, tcp::socket s, std::chrono::milliseconds d)
+            : socket(std::move(s)), timer(io), delay(d) {}
+
+        void read() {
+            boost::asio::async_read(socket, boost::asio::buffer(header), [self = shared_from_this()](auto ec, size_t) {
+                if (ec) return;
+                self->incoming = probe::wire::decodeHeader(self->header.data());
+                self->payload.resize(self->incoming.size);
+                boost::asio::async_read(self->socket, boost::asio::buffer(self->payload), [self](auto ec, size_t) {
+                    if (ec) return;
+                    if (self->incoming.type != probe::wire::kTime) {
+                        self->read();
+                        return;
+                    }
+                    // Stamped on receipt, delivered after the delay: the delay
+                    // stands for the network path, not server processing
+                    auto received = probe::wire::now();
+                    auto latency = received - probe::wire::fromTimeval(self->incoming.sent);
+                    self->reply = probe::wire::encodeTimeReply(1, self->incoming.id, latency, received);
+                    self->timer.expires_after(self->delay);
+                    self->timer.async_wait([self](auto ec) {
+                        if (ec) return;
+                        boost::asio::async_write(self->socket, boost::asio::buffer(self->reply),
+                                                 [self](auto ec, size_t) { if (!ec) self->read(); });
+                    });
+                });
+            });
+        }
+
+        tcp::socket socket;
+        boost::asio::steady_timer timer;
+        std::chrono::milliseconds delay;
+        std::array<uint8_t, probe::wire::HEADER_SIZE> header{};
+        std::vector<uint8_t> payload;
+        std::vector<uint8_t> reply;
+        probe::wire::Header incoming;
+    };
+
+    void accept() {
+        acceptor_.async_accept([this](auto ec, tcp::socket socket) {
+            if (ec) return;
+            std::make_shared<Session>(io_, std::move(socket), delay_)->read();
+            accept();
+        });
+    }
+
+    boost::asio::io_context& io_;
+    tcp::acceptor acceptor_;
+    std::chrono::milliseconds delay_;
+};
+
+/// Listening socket that never accepts: the kernel completes the handshake
+/// (backlog), then nothing ever answers
+class Blackhole {
+public:
+    explicit Blackhole(boost::asio::io_context& io) : acceptor_(io, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)) {}
+    uint16_t port() const { return acceptor_.local_endpoint().port(); }
+
+private:
+    tcp::acceptor acceptor_;
+};
+
+/// A port nobody listens on
+uint16_t refusedPort(boost::asio::io_context& io) {
+    tcp::acceptor acceptor(io, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+    return acceptor.local_endpoint().port();
+}
+
+struct Fixture {
+    boost::asio::io_context server_io;
+    std::vector<std::unique_ptr<MockSnapserver>> servers;
+    std::vector<std::unique_ptr<Blackhole>> blackholes;
+    std::vector<probe::Endpoint> endpoints;
+    std::vector<std::string> kinds;
+    size_t best{0};
+    std::thread thread;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work{server_io.get_executor()};
+
+    Fixture() {
+        // Interleaved so that the sequential probe hits blackholes early
+        auto live = [&](int delay_ms) {
+            servers.push_back(std::make_unique<MockSnapserver>(server_io, std::chrono::milliseconds(delay_ms)));
+            if (delay_ms == 1) best = endpoints.size();
+            endpoints.push_back({"127.0.0.1", servers.back()->port()});
+            kinds.push_back("live " + std::to_string(delay_ms) + " ms");
+        };
+        auto hole = [&]() {
+            blackholes.push_back(std::make_unique<Blackhole>(server_io));
+            endpoints.push_back({"127.0.0.1", blackholes.back()->port()});
+            kinds.push_back("blackhole");
+        };
+        auto refused = [&]() {
+            endpoints.push_back({"127.0.0.1", refusedPort(server_io)});
+            kinds.push_back("refused");
+        };
+        live(8);
+        hole();
+        live(3);
+        refused();
+        hole();
+        live(12);
+        live(1);
+        hole();
+        refused();
+        live(5);
+        thread = std::thread([this]() { server_io.run(); });
+    }
+
+    ~Fixture() {
+        work.reset();
+        server_io.stop();
+        thread.join();
+    }
+};
+
+// ============================================================================
+// Baseline: blocking probes, one endpoint after the other
+// ============================================================================
+
+/// @return RTT in µs, or -1 if unreachable
+long blockingProbe(const probe::Endpoint& ep) {
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) return -1;
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(ep.port);
+    inet_pton(AF_INET, ep.host.c_str(), &addr.sin_addr);
+
+    long rtt = -1;
+    if (connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+        timeval tv{static_cast<time_t>(BLOCKING_TIMEOUT.count()), 0};
+        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        auto sent = probe::wire::now();
+        auto request = probe::wire::encodeTime(2, sent);
+        if (send(sock, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size())) {
+            uint8_t buf[probe::wire::HEADER_SIZE + 8];
+            size_t got = 0;
+            while (got < sizeof(buf)) {
+                ssize_t n = recv(sock, buf + got, sizeof(buf) - got, 0);
+                if (n <= 0) break;
+                got += static_cast<size_t>(n);
+            }
+            if (got == sizeof(buf)) {
+                auto header = probe::wire::decodeHeader(buf);
+                std::chrono::microseconds latency;
+                probe::wire::decodeTime(buf + probe::wire::HEADER_SIZE, 8, latency);
+                rtt = probe::wire::timeSample(latency, probe::wire::fromTimeval(header.sent), probe::wire::now()).rtt.count();
+            }
+        }
+    }
+    close(sock);
+    return rtt;
+}
+
+TestResult test_sequential(Fixture& f, double& choice_ms) {
+    const std::string name = "Sequential";
+    log("🧪 [" + name + "] blocking probe of " + std::to_string(f.endpoints.size()) + " endpoints, " +
+        std::to_string(BLOCKING_TIMEOUT.count()) + " s receive timeout");
+
+    auto start = Clock::now();
+    size_t best = 0;
+    long best_rtt = -1;
+    for (size_t i = 0; i < f.endpoints.size(); ++i) {
+        long rtt = blockingProbe(f.endpoints[i]);
+        if (rtt >= 0 && (best_rtt < 0 || rtt < best_rtt)) {
+            best = i;
+            best_rtt = rtt;
+        }
+    }
+    choice_ms = ms(Clock::now() - start);
+
+    log("✅ [" + name + "] Complete: chose #" + std::to_string(best) + " (" + f.kinds[best] + ") after " +
+        std::to_string(choice_ms) + " ms");
+    bool passed = best == f.best;
+    return {name, passed, passed ? "Chose the fastest server" : "Chose the wrong server", choice_ms};
+}
+
+// ============================================================================
+// Concurrent prober
+// ============================================================================
+
+std::vector<probe::ReachabilityResult> runProber(Fixture& f, probe::ReachabilityOptions options, double& choice_ms) {
+    boost::asio::io_context io;
+    probe::ReachabilityProber prober(io);
+    std::vector<probe::ReachabilityResult> ranked;
+
+    auto start = Clock::now();
+    prober.probe(f.endpoints, options, [&](std::vector<probe::ReachabilityResult> r) {
+        choice_ms = ms(Clock::now() - start);
+        ranked = std::move(r);
+    });
+    io.run();
+    return ranked;
+}
+
+TestResult test_concurrent(Fixture& f, const std::string& name, std::chrono::milliseconds grace, double& choice_ms) {
+    log("🧪 [" + name + "] concurrent probe, grace " + std::to_string(grace.count()) + " ms");
+    probe::ReachabilityOptions options;
+    options.grace = grace;
+
+    auto ranked = runProber(f, options, choice_ms);
+    bool passed = !ranked.empty() && ranked.front().reachable() && ranked.front().index == f.best;
+
+    log("✅ [" + name + "] Complete: chose #" + std::to_string(ranked.front().index) + " (" + f.kinds[ranked.front().index] +
+        ") after " + std::to_string(choice_ms) + " ms");
+    for (const auto& r : ranked) {
+        if (!r.reachable()) continue;
+        log("   - #" + std::to_string(r.index) + " " + f.kinds[r.index] + ": rtt " + std::to_string(r.rtt.count()) +
+            " µs, connect " + std::to_string(r.connectTime.count()) + " µs");
+    }
+    return {name, passed, passed ? "Chose the fastest server" : "Chose the wrong server", choice_ms};
+}
+
+TestResult test_statuses(Fixture& f) {
+    const std::string name = "Statuses";
+    log("🧪 [" + name + "] full 500 ms deadline, every endpoint reported");
+    probe::ReachabilityOptions options;
+    options.deadline = std::chrono::milliseconds(500);
+    options.grace = options.deadline;
+
+    double choice_ms = 0;
+    auto ranked = runProber(f, options, choice_ms);
+
+    bool passed = ranked.size() == f.endpoints.size();
+    long previous_rtt = 0;
+    for (const auto& r : ranked) {
+        const std::string& kind = f.kinds[r.index];
+        log("   - #" + std::to_string(r.index) + " " + kind + ": " + probe::toString(r.status));
+        if (kind == "blackhole") passed &= r.status == probe::ProbeStatus::NoReply;
+        else if (kind == "refused") passed &= r.status == probe::ProbeStatus::ConnectFailed;
+        else {
+            passed &= r.reachable() && r.rtt.count() >= previous_rtt;
+            previous_rtt = r.rtt.count();
+        }
+    }
+    passed &= choice_ms >= 500 && choice_ms < 700;
+    return {name, passed, passed ? "Live ranked by RTT, blackholes no reply, refused failed" : "Unexpected status or order",
+            choice_ms};
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int run_all_tests() {
+    std::cout << "\n";
+    std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║       Reachability Prober Benchmark                          ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════════════╝\n";
+    std::cout << "\n";
+
+    Fixture fixture;
+    double sequential_ms = 0, concurrent_ms = 0, first_ms = 0;
+    g_results.push_back(test_sequential(fixture, sequential_ms));
+    std::cout << "\n";
+    g_results.push_back(test_concurrent(fixture, "Concurrent", probe::ReachabilityOptions().grace, concurrent_ms));
+    std::cout << "\n";
+    g_results.push_back(test_concurrent(fixture, "FirstAnswer", std::chrono::milliseconds(0), first_ms));
+    std::cout << "\n";
+    g_results.push_back(test_statuses(fixture));
+    std::cout << "\n";
+
+    log("📊 Time to first server choice: sequential " + std::to_string(sequential_ms) + " ms, concurrent " +
+        std::to_string(concurrent_ms) + " ms, first answer " + std::to_string(first_ms) + " ms");
+    g_results.push_back({"Speedup", concurrent_ms * 10 < sequential_ms,
+                         std::to_string(sequential_ms / concurrent_ms) + "x faster than sequential", concurrent_ms});
+    std::cout << "\n";
+
+    int failed = 0;
+    for (const auto& result : g_results) {
+        std::string status = result.passed ? "✅ PASS" : "❌ FAIL";
+        std::cout << "  " << status << "  " << result.name << "\n";
+        std::cout << "         " << result.message << " (" << result.duration_ms << " ms)\n";
+        if (!result.passed) failed++;
+    }
+    std::cout << "\n";
+    return failed;
+}
+
+} // namespace reachability_bench
+
+int main() {
+    return reachability_bench::run_all_tests() == 0 ? 0 : 1;
+}
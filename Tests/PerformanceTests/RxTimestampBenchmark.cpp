@@ -0,0 +1,392 @@
+/***
+    RxTimestampBenchmark.cpp
+
+    Measures the clock offset noise of LinkProbe's Time samples with receive
+    times taken in user space (after the read) and by the kernel
+    (SO_TIMESTAMPNS / SO_TIMESTAMP), on an idle machine and under CPU load.
+
+    A loopback mock Snapcast server (clock 5 s ahead of ours) streams 20 ms
+    chunks and answers Time requests. It takes its own receive times from
+    the kernel and stamps replies as it writes them, so the noise left in
+    the samples is the client's. CPU load is two spinning threads per core
+    at the same priority as the probe, plus other work on the probe's io
+    thread (0-3 ms every 4 ms, like decoding in the real client): a read
+    handler waits behind it after the packet arrived.
+
+    Also checks that the stamps are usable at all: a kernel receive time is
+    never after the user-space one, and the age conversion to the steady
+    clock stays within a millisecond of it when idle.
+
+    Build & run: ./scripts/run-linux-benchmarks.sh RxTimestamp
+
+    Copyright (C) 2025 SnapForge contributors
+    License: GPL-3.0
+***/
+
+#include "probe/link_probe.hpp"
+#include "probe/stream_wire.hpp"
+#include "timesync/rx_timestamp.hpp"
+
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rxts_bench {
+
+using boost::asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+constexpr auto SERVER_CLOCK_OFFSET = std::chrono::seconds(5);
+constexpr auto CHUNK_DURATION = milliseconds(20);
+constexpr size_t CHUNK_BYTES = 48000 * 4 / 50;  // 20 ms of 48 kHz/16/2
+constexpr int RUNS = 3;
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+    double duration_ms;
+};
+
+std::vector<TestResult> g_results;
+
+void log(const std::string& msg) {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::cout << "[" << std::put_time(std::localtime(&time), "%H:%M:%S") << "] " << msg << std::endl;
+}
+
+std::string fmt(double v, int precision = 0) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(precision) << v;
+    return out.str();
+}
+
+// ============================================================================
+// Mock streaming server, kernel-stamped on its side
+// ============================================================================
+
+std::vector<uint8_t> wireChunk(microseconds sent) {
+    probe::wire::Header h;
+    h.type = probe::wire::kWireChunk;
+    h.sent = probe::wire::toTimeval(sent);
+    h.size = static_cast<uint32_t>(8 + 4 + CHUNK_BYTES);
+    std::vector<uint8_t> out(probe::wire::HEADER_SIZE + h.size, 0);
+    probe::wire::encodeHeader(h, out.data());
+    return out;
+}
+
+class MockStreamServer {
+public:
+    MockStreamServer() : acceptor_(io_, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)) {
+        accept();
+        thread_ = std::thread([this]() { io_.run(); });
+    }
+
+    ~MockStreamServer() {
+        io_.stop();
+        thread_.join();
+    }
+
+    uint16_t port() const { return acceptor_.local_endpoint().port(); }
+
+private:
+    struct Session : std::enable_shared_from_this<Session> {
+        Session(boost::asio::io_context& io, tcp::socket s) : socket(std::move(s)), chunkTimer(io) {
+            timesync::enableRxTimestamps(socket.native_handle());
+        }
+
+        microseconds serverNow() const { return probe::wire::now() + SERVER_CLOCK_OFFSET; }
+
+        void read() {
+            socket.async_wait(tcp::socket::wait_read, [self = shared_from_this()](auto ec) {
+                if (ec) return;
+                for (;;) {
+                    size_t used = self->rx.size();
+                    self->rx.resize(used + 4096);
+                    boost::system::error_code rec;
+                    auto r = timesync::receive(self->socket.native_handle(), self->rx.data() + used, 4096, rec);
+                    self->rx.resize(used + r.bytes);
+                    if (rec == boost::asio::error::would_block) break;
+                    if (rec) return;
+                    self->parse(r.stamp.value_or(probe::wire::now()) + SERVER_CLOCK_OFFSET);
+                }
+                self->read();
+            });
+        }
+
+        void parse(microseconds received) {
+            size_t pos = 0;
+            while (rx.size() - pos >= probe::wire::HEADER_SIZE) {
+                auto h = probe::wire::decodeHeader(rx.data() + pos);
+                if (rx.size() - pos < probe::wire::HEADER_SIZE + h.size) break;
+                pos += probe::wire::HEADER_SIZE + h.size;
+                if (h.type == probe::wire::kHello) {
+                    scheduleChunk();
+                } else if (h.type == probe::wire::kTime) {
+                    // Like the real server: latency from the receive time, sent stamped at write
+                    auto latency = received - probe::wire::fromTimeval(h.sent);
+                    send(probe::wire::encodeTimeReply(0, h.id, latency, serverNow()));
+                }
+            }
+            rx.erase(rx.begin(), rx.begin() + static_cast<std::ptrdiff_t>(pos));
+        }
+
+        void scheduleChunk() {
+            chunkTimer.expires_after(CHUNK_DURATION);
+            chunkTimer.async_wait([self = shared_from_this()](auto ec) {
+                if (ec) return;
+                self->send(wireChunk(self->serverNow()));
+                self->scheduleChunk();
+            });
+        }
+
+        void send(std::vector<uint8_t> data) {
+            boost::system::error_code ec;
+            boost::asio::write(socket, boost::asio::buffer(data), ec);
+            if (ec) chunkTimer.cancel();
+        }
+
+        tcp::socket socket;
+        boost::asio::steady_timer chunkTimer;
+        std::vector<uint8_t> rx;
+    };
+
+    void accept() {
+        acceptor_.async_accept([this](auto ec, tcp::socket socket) {
+            if (ec) return;
+            socket.set_option(tcp::no_delay(true), ec);
+            auto session = std::make_shared<Session>(io_, std::move(socket));
+            session->read();
+            sessions_.push_back(session);
+            accept();
+        });
+    }
+
+    boost::asio::io_context io_;
+    tcp::acceptor acceptor_;
+    std::vector<std::shared_ptr<Session>> sessions_;
+    std::thread thread_;
+};
+
+/// Spinning threads at normal priority, two per core
+class CpuLoad {
+public:
+    CpuLoad() {
+        unsigned n = std::max(1u, std::thread::hardware_concurrency()) * 2;
+        for (unsigned i = 0; i < n; ++i)
+            threads_.emplace_back([this]() {
+                volatile uint64_t x = 0;
+                while (!stop_.load(std::memory_order_relaxed)) x = x + 1;
+            });
+    }
+    ~CpuLoad() {
+        stop_ = true;
+        for (auto& t : threads_) t.join();
+    }
+    size_t threads() const { return threads_.size(); }
+
+private:
+    std::atomic<bool> stop_{false};
+    std::vector<std::thread> threads_;
+};
+
+/// Other handlers on the probe's io thread (decoding, in the real client):
+/// every 4 ms, 0-3 ms of CPU work
+class IoThreadWork {
+public:
+    explicit IoThreadWork(boost::asio::io_context& io) : timer_(io), rng_(11) { arm(); }
+    void stop() {
+        stopped_ = true;
+        timer_.cancel();
+    }
+
+private:
+    void arm() {
+        timer_.expires_after(milliseconds(4));
+        timer_.async_wait([this](auto ec) {
+            if (ec || stopped_) return;
+            std::uniform_int_distribution<int> us(0, 3000);
+            auto until = Clock::now() + microseconds(us(rng_));
+            while (Clock::now() < until) {
+            }
+            arm();
+        });
+    }
+
+    boost::asio::steady_timer timer_;
+    std::mt19937 rng_;
+    bool stopped_{false};
+};
+
+probe::LinkQuality probe_link(uint16_t port, bool kernel, bool busy) {
+    probe::LinkProbeOptions options;
+    options.hello.id = "00:11:22:33:44:55";
+    options.timeSamples = 60;
+    options.timeInterval = milliseconds(10);
+    options.receiveWindow = milliseconds(2000);
+    options.kernelTimestamps = kernel;
+
+    boost::asio::io_context io;
+    probe::LinkProbe link(io);
+    probe::LinkQuality q;
+    std::unique_ptr<IoThreadWork> work;
+    if (busy) work = std::make_unique<IoThreadWork>(io);
+    link.run({"127.0.0.1", port}, options, [&q, &work](const probe::LinkQuality& result) {
+        q = result;
+        if (work) work->stop();
+    });
+    io.run();
+    return q;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+TestResult test_stamp_sanity() {
+    const std::string name = "StampSanity";
+    log("🧪 [" + name + "] kernel vs user-space receive time, idle");
+    auto start = Clock::now();
+
+    boost::asio::io_context io;
+    tcp::acceptor acceptor(io, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+    tcp::socket client(io), server(io);
+    client.connect(acceptor.local_endpoint());
+    acceptor.accept(server);
+    bool enabled = timesync::enableRxTimestamps(client.native_handle());
+
+    constexpr int ROUNDS = 200;
+    int stamped = 0, ordered = 0, close = 0;
+    std::vector<uint8_t> buf(64);
+    for (int i = 0; i < ROUNDS; ++i) {
+        boost::asio::write(server, boost::asio::buffer(buf));
+        client.wait(tcp::socket::wait_read);
+        auto user = probe::wire::now();
+        boost::system::error_code ec;
+        auto r = timesync::receive(client.native_handle(), buf.data(), buf.size(), ec);
+        if (ec || !r.stamp) continue;
+        stamped++;
+        if (*r.stamp <= user + microseconds(1)) ordered++;
+        if (user - *r.stamp < milliseconds(1)) close++;
+    }
+
+    bool passed = !enabled || (stamped == ROUNDS && ordered == ROUNDS && close >= ROUNDS * 9 / 10);
+    log("   - Kernel stamps " + std::string(enabled ? "enabled" : "unsupported") + ": " + std::to_string(stamped) + "/" +
+        std::to_string(ROUNDS) + " stamped, " + std::to_string(ordered) + " not after the read, " +
+        std::to_string(close) + " within 1 ms of it");
+
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return {name, passed,
+            passed ? (enabled ? "Every read stamped, stamps precede the read" : "Unsupported here, user-space fallback")
+                   : "Kernel stamps missing or inconsistent",
+            duration_ms};
+}
+
+struct Noise {
+    double sd_us{0};
+    double jitter_us{0};
+    bool kernel{false};
+};
+
+Noise measure(uint16_t port, bool kernel, bool busy) {
+    std::vector<double> sds, jitters;
+    Noise n;
+    for (int i = 0; i < RUNS; ++i) {
+        auto q = probe_link(port, kernel, busy);
+        if (q.status != probe::ProbeStatus::Ok) return {-1, -1, false};
+        sds.push_back(static_cast<double>(q.offsetStdDev.count()));
+        jitters.push_back(static_cast<double>(q.jitter.count()));
+        n.kernel = q.kernelTimestamps;
+    }
+    std::sort(sds.begin(), sds.end());
+    std::sort(jitters.begin(), jitters.end());
+    n.sd_us = sds[RUNS / 2];
+    n.jitter_us = jitters[RUNS / 2];
+    return n;
+}
+
+TestResult test_offset_noise() {
+    const std::string name = "OffsetNoise";
+    log("🧪 [" + name + "] offset standard deviation, user-space vs kernel receive times (median of " +
+        std::to_string(RUNS) + " probes)");
+    auto start = Clock::now();
+    MockStreamServer server;
+
+    auto idleUser = measure(server.port(), false, false);
+    auto idleKernel = measure(server.port(), true, false);
+    log("   - Idle:     user " + fmt(idleUser.sd_us) + " µs (jitter " + fmt(idleUser.jitter_us) + "), kernel " +
+        fmt(idleKernel.sd_us) + " µs (jitter " + fmt(idleKernel.jitter_us) + ")");
+
+    Noise loadUser, loadKernel;
+    size_t spinners = 0;
+    {
+        CpuLoad load;
+        spinners = load.threads();
+        loadUser = measure(server.port(), false, true);
+        loadKernel = measure(server.port(), true, true);
+    }
+    log("   - Loaded (" + std::to_string(spinners) + " spinning threads, io thread busy): user " + fmt(loadUser.sd_us) + " µs (jitter " +
+        fmt(loadUser.jitter_us) + "), kernel " + fmt(loadKernel.sd_us) + " µs (jitter " + fmt(loadKernel.jitter_us) + ")");
+    if (loadKernel.sd_us > 0)
+        log("   - Under load the kernel stamps cut the offset deviation " + fmt(loadUser.sd_us / loadKernel.sd_us, 1) + "×");
+
+    bool measured = idleUser.sd_us >= 0 && idleKernel.sd_us >= 0 && loadUser.sd_us >= 0 && loadKernel.sd_us >= 0;
+    bool passed = measured;
+    if (measured && loadKernel.kernel)
+        passed = loadKernel.sd_us * 2 < loadUser.sd_us && idleKernel.sd_us <= idleUser.sd_us + 50;
+    else if (measured)
+        log("   - No kernel stamps on this platform: both runs used user-space receive times");
+
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return {name, passed,
+            passed ? "Kernel receive times remove the io thread's scheduling delay from the samples"
+                   : "Kernel receive times not less noisy under load",
+            duration_ms};
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int run_all_tests() {
+    std::cout << "\n";
+    std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║       Kernel Receive Timestamp Benchmark                     ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════════════╝\n";
+    std::cout << "\n";
+
+    g_results.push_back(test_stamp_sanity());
+    std::cout << "\n";
+    g_results.push_back(test_offset_noise());
+    std::cout << "\n";
+
+    int failed = 0;
+    for (const auto& result : g_results) {
+        std::string status = result.passed ? "✅ PASS" : "❌ FAIL";
+        std::cout << "  " << status << "  " << result.name << "\n";
+        std::cout << "         " << result.message << " (" << result.duration_ms << " ms)\n";
+        if (!result.passed) failed++;
+    }
+    std::cout << "\n";
+    return failed;
+}
+
+} // namespace rxts_bench
+
+int main() {
+    return rxts_bench::run_all_tests() == 0 ? 0 : 1;
+}
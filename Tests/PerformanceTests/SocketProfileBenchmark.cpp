@@ -0,0 +1,315 @@
+/***
+    SocketProfileBenchmark.cpp
+
+    Measures the stream socket profile (net::profileFor / net::apply)
+    against default socket options on loopback:
+
+    - Profile: the options derived from the defaults, applied to a
+      connected socket as net::StreamReader does.
+    - Dead peer: mid-stream the link disappears (loopback taken down in a
+      private network namespace, so nothing answers and nothing resets).
+      With default options the socket never errors: the kernel keeps
+      retrying for many minutes. The profile, applied after connect() as
+      net::StreamReader does, errors it at the 10 s time sync timeout, and
+      not before: a connection stalled for less stays up.
+
+    The dead-peer test needs an unprivileged user + network namespace
+    (Linux); it is skipped where that is not available.
+
+    Build & run: ./scripts/run-linux-benchmarks.sh SocketProfile
+
+    Copyright (C) 2025 SnapForge contributors
+    License: GPL-3.0
+***/
+
+#include "net/socket_profile.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace sockprof_bench {
+
+using Clock = std::chrono::steady_clock;
+using std::chrono::milliseconds;
+
+constexpr auto CHUNK_DURATION = milliseconds(20);
+constexpr size_t HEADER_BYTES = 26;
+constexpr auto DEAD_PEER_TIMEOUT = milliseconds(10000);  // Time sync timeout, ProfileOptions default
+constexpr auto GIVE_UP = std::chrono::seconds(15);         // Dead-peer test: stop waiting for an error
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+    double duration_ms;
+};
+
+std::vector<TestResult> g_results;
+
+void log(const std::string& msg) {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::cout << "[" << std::put_time(std::localtime(&time), "%H:%M:%S") << "] " << msg << std::endl;
+}
+
+std::string fmt(double v, int precision = 1) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(precision) << v;
+    return out.str();
+}
+
+bool g_netns = false;  // Running in a private network namespace
+
+/// Own user + network namespace, so loopback can be taken down. Must run
+/// before any thread is started.
+bool enter_private_netns() {
+#ifdef CLONE_NEWNET
+    uid_t uid = getuid();
+    gid_t gid = getgid();
+    if (unshare(CLONE_NEWUSER | CLONE_NEWNET) != 0) return false;
+    std::ofstream("/proc/self/setgroups") << "deny";
+    std::ofstream("/proc/self/uid_map") << "0 " << uid << " 1";
+    std::ofstream("/proc/self/gid_map") << "0 " << gid << " 1";
+    return std::system("ip link set lo up 2>/dev/null") == 0;
+#else
+    return false;
+#endif
+}
+
+// ============================================================================
+// Loopback connection and live server
+// ============================================================================
+
+struct Pair {
+    int client{-1};
+    int server{-1};
+    ~Pair() {
+        if (client >= 0) close(client);
+        if (server >= 0) close(server);
+    }
+};
+
+/// Connected pair
+bool connect_pair(Pair& p) {
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(listener, 1) != 0 ||
+        getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+        close(listener);
+        return false;
+    }
+    p.client = socket(AF_INET, SOCK_STREAM, 0);
+    bool ok = connect(p.client, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+    p.server = ok ? accept(listener, nullptr, nullptr) : -1;
+    close(listener);
+    if (p.server < 0) return false;
+    // A server with a modest send buffer, so data backs up on the client side
+    int sndbuf = 32 * 1024;
+    setsockopt(p.server, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+    return true;
+}
+
+/// Streams chunks of @p chunkBytes every 20 ms, non-blocking, dropping a
+/// chunk when two are still waiting
+class LiveServer {
+public:
+    LiveServer(int fd, size_t chunkBytes) : fd_(fd), chunkBytes_(chunkBytes) {
+        fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) | O_NONBLOCK);
+        thread_ = std::thread([this]() { run(); });
+    }
+    ~LiveServer() { stop(); }
+    void stop() {
+        stop_ = true;
+        if (thread_.joinable()) thread_.join();
+    }
+    int sent() const { return sent_; }
+    int dropped() const { return dropped_; }
+
+private:
+    void run() {
+        std::vector<uint8_t> chunk(HEADER_BYTES + chunkBytes_, 0x55);
+        std::vector<uint8_t> queue;
+        auto next = Clock::now();
+        while (!stop_) {
+            auto now = Clock::now();
+            if (now >= next) {
+                next += CHUNK_DURATION;
+                if (queue.size() >= 2 * chunk.size()) {
+                    dropped_++;
+                } else {
+                    queue.insert(queue.end(), chunk.begin(), chunk.end());
+                    sent_++;
+                }
+            }
+            if (!queue.empty()) {
+                ssize_t n = send(fd_, queue.data(), queue.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+                if (n > 0) queue.erase(queue.begin(), queue.begin() + n);
+                else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) break;
+            }
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+    }
+
+    int fd_;
+    size_t chunkBytes_;
+    std::atomic<bool> stop_{false};
+    std::atomic<int> sent_{0};
+    std::atomic<int> dropped_{0};
+    std::thread thread_;
+};
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+TestResult test_profile() {
+    const std::string name = "Profile";
+    log("🧪 [" + name + "] default profile, applied after connect()");
+    auto start = Clock::now();
+
+    // Keepalive and user timeout give up together, at the time sync timeout
+    auto profile = net::profileFor();
+    auto probing = profile.keepIdle + profile.keepInterval * profile.keepCount;
+    bool consistent = profile.userTimeout == DEAD_PEER_TIMEOUT && probing >= DEAD_PEER_TIMEOUT &&
+                      probing < DEAD_PEER_TIMEOUT + profile.keepInterval;
+    Pair p;
+    bool connected = connect_pair(p);
+    net::Applied applied;
+    if (connected) applied = net::apply(p.client, profile);
+    bool passed = consistent && connected && applied.noDelay && applied.keepAlive;
+    log("   - Keepalive " + std::to_string(profile.keepIdle.count()) + " s + " + std::to_string(profile.keepCount) + " × " +
+        std::to_string(profile.keepInterval.count()) + " s, user timeout " + std::to_string(profile.userTimeout.count()) +
+        " ms" + (applied.userTimeout ? "" : " (unsupported)") + ", nodelay " + (applied.noDelay ? "on" : "off") +
+        (passed ? "" : "  ⚠️"));
+
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return {name, passed,
+            passed ? "Timeouts at the time sync timeout, applied to a connected socket"
+                   : "Profile not derived or not applied",
+            duration_ms};
+}
+
+/// Seconds from the link going away to the client noticing, and how
+std::pair<double, std::string> dead_peer_run(bool profiled) {
+    constexpr size_t CHUNK_BYTES = 48000 * 4 / 50;
+    Pair p;
+    bool connected = connect_pair(p);
+    if (!connected) return {-1, "no connection"};
+    if (profiled) net::apply(p.client, net::profileFor());
+
+    LiveServer server(p.server, CHUNK_BYTES);
+    std::this_thread::sleep_for(milliseconds(500));
+    if (std::system("ip link set lo down 2>/dev/null") != 0) return {-1, "cannot take loopback down"};
+    auto gone = Clock::now();
+
+    // Client loop: read audio, a Time request every second, until the
+    // socket errors or GIVE_UP
+    std::vector<uint8_t> buf(64 * 1024);
+    std::vector<uint8_t> timeRequest(HEADER_BYTES + 8, 0);
+    auto nextTime = Clock::now();
+    std::string how = "no error";
+    for (;;) {
+        auto now = Clock::now();
+        if (now - gone >= GIVE_UP) break;
+        if (now >= nextTime) {
+            send(p.client, timeRequest.data(), timeRequest.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+            nextTime += std::chrono::seconds(1);
+        }
+        pollfd pfd{p.client, POLLIN, 0};
+        if (poll(&pfd, 1, 20) > 0) {
+            ssize_t n = recv(p.client, buf.data(), buf.size(), MSG_DONTWAIT);
+            if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+                how = n == 0 ? "EOF" : std::string("socket error: ") + std::strerror(errno);
+                break;
+            }
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - gone).count();
+    server.stop();
+    std::system("ip link set lo up 2>/dev/null");
+    return {seconds, how};
+}
+
+TestResult test_dead_peer() {
+    const std::string name = "DeadPeer";
+    if (!g_netns) {
+        log("⏭  [" + name + "] skipped: no private network namespace");
+        return {name, true, "Skipped (needs unprivileged user + network namespaces)", 0};
+    }
+    log("🧪 [" + name + "] link disappears mid-stream, time until the client notices");
+    auto start = Clock::now();
+
+    auto defaults = dead_peer_run(false);
+    auto profiled = dead_peer_run(true);
+    log("   - Default options: " + fmt(defaults.first) + " s (" + defaults.second + ")");
+    log("   - Profile:         " + fmt(profiled.first) + " s (" + profiled.second + ")");
+
+    const double timeout = std::chrono::duration<double>(DEAD_PEER_TIMEOUT).count();
+    bool passed = defaults.first > 0 && profiled.first > 0 && defaults.second == "no error" &&
+                  profiled.second != "no error" && profiled.first >= timeout - 1.0 && profiled.first < timeout + 2.0;
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return {name, passed,
+            passed ? "Keepalive / user timeout error the socket at the time sync timeout"
+                   : "Dead peer not detected at the time sync timeout",
+            duration_ms};
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int run_all_tests() {
+    g_netns = enter_private_netns();
+
+    std::cout << "\n";
+    std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║       Stream Socket Profile Benchmark                        ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════════════╝\n";
+    std::cout << "\n";
+
+    g_results.push_back(test_profile());
+    std::cout << "\n";
+    g_results.push_back(test_dead_peer());
+    std::cout << "\n";
+
+    int failed = 0;
+    for (const auto& result : g_results) {
+        std::string status = result.passed ? "✅ PASS" : "❌ FAIL";
+        std::cout << "  " << status << "  " << result.name << "\n";
+        std::cout << "         " << result.message << " (" << result.duration_ms << " ms)\n";
+        if (!result.passed) failed++;
+    }
+    std::cout << "\n";
+    return failed;
+}
+
+} // namespace sockprof_bench
+
+int main() {
+    return sockprof_bench::run_all_tests() == 0 ? 0 : 1;
+}
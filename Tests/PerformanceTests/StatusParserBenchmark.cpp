@@ -0,0 +1,339 @@
+/***
+    StatusParserBenchmark.cpp
+
+    Benchmarks loading a Server.GetStatus response into the control model:
+    the streaming parser (JsonReader + parseStatusMessage, no DOM) against
+    nlohmann::json::parse + loadServerStatus.
+
+    For 10, 100 and 1000 clients it reports the parse time and the peak heap
+    usage of one load (counted by a replacement global operator new), and
+    checks that both paths produce identical models.
+
+    Build & run: ./scripts/run-linux-benchmarks.sh StatusParser
+
+    Copyright (C) 2025 SnapForge contributors
+    License: GPL-3.0
+***/
+
+#include "control/model_update.hpp"
+#include "control/server_model.hpp"
+#include "control/status_parser.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Heap accounting: every allocation carries its size in a 16-byte header
+// ============================================================================
+
+namespace {
+
+std::atomic<size_t> g_heap_current{0};
+std::atomic<size_t> g_heap_peak{0};
+constexpr size_t HEADER = 16;
+
+void* counted_alloc(size_t size) {
+    auto* p = static_cast<unsigned char*>(std::malloc(size + HEADER));
+    if (!p) throw std::bad_alloc();
+    *reinterpret_cast<size_t*>(p) = size;
+    size_t now = g_heap_current.fetch_add(size, std::memory_order_relaxed) + size;
+    size_t peak = g_heap_peak.load(std::memory_order_relaxed);
+    while (now > peak && !g_heap_peak.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+    return p + HEADER;
+}
+
+void counted_free(void* ptr) {
+    if (!ptr) return;
+    auto* p = static_cast<unsigned char*>(ptr) - HEADER;
+    g_heap_current.fetch_sub(*reinterpret_cast<size_t*>(p), std::memory_order_relaxed);
+    std::free(p);
+}
+
+} // namespace
+
+void* operator new(size_t size) { return counted_alloc(size); }
+void* operator new[](size_t size) { return counted_alloc(size); }
+void operator delete(void* ptr) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr) noexcept { counted_free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { counted_free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { counted_free(ptr); }
+
+namespace status_parser_bench {
+
+using control::json;
+
+constexpr int CLIENTS_PER_GROUP = 4;
+constexpr int STREAM_COUNT = 8;
+constexpr size_t ART_DATA_BYTES = 64 * 1024;
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+    double duration_ms;
+};
+
+std::vector<TestResult> g_results;
+
+void log(const std::string& msg) {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::cout << "[" << std::put_time(std::localtime(&time), "%H:%M:%S") << "] " << msg << std::endl;
+}
+
+std::string clientId(int i) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "00:11:22:33:%02x:%02x", (i >> 8) & 0xff, i & 0xff);
+    return buf;
+}
+
+/// Build a Server.GetStatus response with the given number of clients.
+/// Stream 0 carries embedded cover art, as a Spotify/AirPlay stream does.
+std::string makeStatusResponse(int clients) {
+    json groups = json::array();
+    for (int g = 0; g * CLIENTS_PER_GROUP < clients; ++g) {
+        json members = json::array();
+        for (int c = g * CLIENTS_PER_GROUP; c < std::min(clients, (g + 1) * CLIENTS_PER_GROUP); ++c) {
+            members.push_back({
+                {"id", clientId(c)},
+                {"connected", c % 7 != 0},
+                {"config", {{"instance", 1 + c % 2}, {"latency", c % 50}, {"name", "Room \"" + std::to_string(c) + "\" café"},
+                            {"volume", {{"muted", c % 5 == 0}, {"percent", c % 101}}}}},
+                {"host", {{"arch", "aarch64"}, {"ip", "192.168.1." + std::to_string(c % 250)},
+                          {"mac", clientId(c)}, {"name", "snapclient-" + std::to_string(c)}, {"os", "Linux"}}},
+                {"lastSeen", {{"sec", 1700000000}, {"usec", 123456}}},
+                {"snapclient", {{"name", "Snapclient"}, {"protocolVersion", 2}, {"version", "0.34.0"}}},
+            });
+        }
+        groups.push_back({{"id", "group-" + std::to_string(g)}, {"name", "Zone " + std::to_string(g)}, {"muted", g % 3 == 0},
+                          {"stream_id", "stream " + std::to_string(g % STREAM_COUNT)}, {"clients", members}});
+    }
+
+    json streams = json::array();
+    for (int s = 0; s < STREAM_COUNT; ++s) {
+        json metadata = {{"artist", {"Artist A", "Artist B"}}, {"title", "Title " + std::to_string(s)},
+                         {"album", "Album"}, {"artUrl", "http://snapserver/art/" + std::to_string(s) + ".jpg"}};
+        if (s == 0)
+            metadata["artData"] = {{"data", std::string(ART_DATA_BYTES, 'A')}, {"extension", "jpg"}};
+        streams.push_back({
+            {"id", "stream " + std::to_string(s)},
+            {"status", s % 2 ? "idle" : "playing"},
+            {"uri", {{"raw", "pipe:///tmp/snapfifo?name=stream " + std::to_string(s)}, {"scheme", "pipe"}}},
+            {"properties", {{"canPlay", true}, {"metadata", metadata}}},
+        });
+    }
+    json server = {{"groups", groups}, {"streams", streams},
+                   {"server", {{"host", {{"name", "snapserver"}}}, {"snapserver", {{"version", "0.34.0"}}}}}};
+    return json({{"id", 1}, {"jsonrpc", "2.0"}, {"result", {{"server", server}}}}).dump();
+}
+
+bool sameModel(const control::ServerModel& a, const control::ServerModel& b) {
+    if (a.clients().size() != b.clients().size() || a.groups().size() != b.groups().size() ||
+        a.streams().size() != b.streams().size())
+        return false;
+    for (size_t i = 0; i < a.clients().size(); ++i) {
+        const auto& x = a.clients()[i];
+        const auto& y = b.clients()[i];
+        if (a.str(x.id) != b.str(y.id) || x.group != y.group || x.name != y.name || x.hostName != y.hostName ||
+            x.ip != y.ip || x.volume != y.volume || x.muted != y.muted || x.latency != y.latency ||
+            x.instance != y.instance || x.connected != y.connected)
+            return false;
+    }
+    for (size_t i = 0; i < a.groups().size(); ++i) {
+        const auto& x = a.groups()[i];
+        const auto& y = b.groups()[i];
+        if (a.str(x.id) != b.str(y.id) || a.str(x.stream) != b.str(y.stream) || x.name != y.name ||
+            x.muted != y.muted || x.firstClient != y.firstClient || x.clientCount != y.clientCount)
+            return false;
+    }
+    for (size_t i = 0; i < a.streams().size(); ++i) {
+        const auto& x = a.streams()[i];
+        const auto& y = b.streams()[i];
+        if (a.str(x.id) != b.str(y.id) || a.str(x.status) != b.str(y.status) || x.artist != y.artist ||
+            x.title != y.title || x.album != y.album || x.artUrl != y.artUrl)
+            return false;
+    }
+    // Lookups by ID must resolve through the interned index
+    for (const auto& c : a.clients())
+        if (b.client(a.str(c.id)) == nullptr) return false;
+    return true;
+}
+
+/// Peak heap bytes above the current level while running @p f
+template <typename F>
+size_t peakHeap(F&& f) {
+    size_t base = g_heap_current.load();
+    g_heap_peak.store(base);
+    f();
+    return g_heap_peak.load() - base;
+}
+
+template <typename F>
+double averageUs(int iterations, F&& f) {
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i)
+        f();
+    auto t1 = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::micro>(t1 - t0).count() / iterations;
+}
+
+std::string kb(size_t bytes) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.1f KB", bytes / 1024.0);
+    return buf;
+}
+
+// ============================================================================
+// Streaming vs. DOM status load
+// ============================================================================
+
+TestResult test_status_load(int clients) {
+    const std::string name = "StatusLoad/" + std::to_string(clients);
+    const std::string text = makeStatusResponse(clients);
+    const int iterations = std::max(20, 20000 / clients);
+    log("🧪 [" + name + "] " + kb(text.size()) + " response, " + std::to_string(iterations) + " iterations");
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    auto loadDom = [&](control::ServerModel& model) {
+        json reply = json::parse(text);
+        control::loadServerStatus(model, reply.at("result").at("server"));
+    };
+    bool sax_ok = true;
+    auto loadSax = [&](control::ServerModel& model) {
+        int id = -1;
+        sax_ok &= control::parseStatusMessage(text, model, id) && id == 1;
+    };
+
+    // Correctness first: both paths must agree
+    control::ServerModel dom_model;
+    control::ServerModel sax_model;
+    loadDom(dom_model);
+    loadSax(sax_model);
+    bool identical = sax_ok && sameModel(dom_model, sax_model) &&
+                     sax_model.clients().size() == static_cast<size_t>(clients);
+
+    // Peak memory of one load into a fresh model (first status after connect)
+    size_t dom_peak = peakHeap([&] { control::ServerModel m; loadDom(m); });
+    size_t sax_peak = peakHeap([&] { control::ServerModel m; loadSax(m); });
+    // Steady state: reloading into a model that already has capacity
+    size_t sax_reload_peak = peakHeap([&] { loadSax(sax_model); });
+
+    double dom_us = averageUs(iterations, [&] { loadDom(dom_model); });
+    double sax_us = averageUs(iterations, [&] { loadSax(sax_model); });
+
+    double duration_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    log("✅ [" + name + "] Complete:");
+    log("   - DOM (nlohmann + loadServerStatus): " + std::to_string(dom_us) + " µs, peak " + kb(dom_peak));
+    log("   - Streaming (parseStatusMessage):    " + std::to_string(sax_us) + " µs, peak " + kb(sax_peak) +
+        " (reload: " + kb(sax_reload_peak) + ")");
+    log("   - Speedup: " + std::to_string(dom_us / sax_us) + "x, memory: " +
+        std::to_string(static_cast<double>(dom_peak) / std::max<size_t>(sax_peak, 1)) + "x less");
+
+    bool passed = identical && sax_us < dom_us && sax_peak < dom_peak;
+    std::string message = !identical ? "Streaming model differs from DOM model"
+                        : passed     ? "Identical models, faster and smaller than DOM"
+                                     : "Streaming parser not faster/smaller than DOM";
+    return {name, passed, message, duration_ms};
+}
+
+// ============================================================================
+// Robustness: malformed and non-status messages
+// ============================================================================
+
+TestResult test_rejects() {
+    const std::string name = "Rejects";
+    log("🧪 [" + name + "] non-status and malformed messages");
+    auto start = std::chrono::high_resolution_clock::now();
+
+    const std::string full = makeStatusResponse(10);
+    const std::vector<std::string> inputs = {
+        R"({"jsonrpc":"2.0","method":"Client.OnVolumeChanged","params":{"id":"x","volume":{"muted":false,"percent":5}}})",
+        R"({"id":3,"jsonrpc":"2.0","result":{"volume":{"muted":false,"percent":5}}})",
+        R"({"error":{"code":-32603,"message":"Internal error"},"id":4,"jsonrpc":"2.0"})",
+        full.substr(0, full.size() / 2),  // Truncated
+        "not json",
+        "",
+    };
+
+    bool passed = true;
+    for (const auto& input : inputs) {
+        control::ServerModel model;
+        int id = -1;
+        passed &= !control::parseStatusMessage(input, model, id);
+    }
+
+    // Server.OnUpdate carries the same status as a notification
+    const std::string onUpdate = R"({"jsonrpc":"2.0","method":"Server.OnUpdate","params":{"server":{"groups":[{"clients":[)"
+                                 R"({"config":{"name":"A","volume":{"muted":true,"percent":7}},"connected":true,"id":"c1"}],)"
+                                 R"("id":"g1","muted":false,"name":"","stream_id":"s1"}],"streams":[{"id":"s1","status":"idle"}]}}})";
+    control::ServerModel model;
+    int id = -1;
+    bool loaded = control::parseStatusMessage(onUpdate, model, id);
+    const control::ClientState* c = model.client("c1");
+    const control::GroupState* g = model.group("g1");
+    passed &= loaded && id == -1 && c && c->volume == 7 && c->muted && g && model.str(g->stream) == "s1" &&
+              g->clientCount == 1 && model.str(model.stream("s1")->status) == "idle";
+
+    // Malformed variants of it are rejected, as nlohmann rejects them
+    const std::vector<std::pair<std::string, std::string>> breakages = {
+        {R"("name":"A")", R"("name":"A",)"},                         // Trailing comma
+        {R"("connected":true,)", R"("connected":true,,)"},           // Duplicate comma
+        {R"("name":"A")", R"("name":"\ud83d\u0041")"},               // High surrogate without low half
+        {R"("name":"A")", R"("name":"\ude00")"},                     // Lone low surrogate
+        {R"("connected":true)", R"("connected":tru)"},               // Broken literal
+    };
+    for (const auto& [from, to] : breakages) {
+        std::string broken = onUpdate;
+        broken.replace(broken.find(from), from.size(), to);
+        control::ServerModel rejected;
+        passed &= !control::parseStatusMessage(broken, rejected, id);
+    }
+
+    double duration_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    log(passed ? "✅ [" + name + "] Complete" : "❌ [" + name + "] Failed");
+    return {name, passed, passed ? "Only status messages are loaded" : "Accepted a non-status message or missed OnUpdate",
+            duration_ms};
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int run_all_tests() {
+    std::cout << "\n";
+    std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║       Status Parser Benchmark                                ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════════════╝\n";
+    std::cout << "\n";
+
+    for (int clients : {10, 100, 1000}) {
+        g_results.push_back(test_status_load(clients));
+        std::cout << "\n";
+    }
+    g_results.push_back(test_rejects());
+    std::cout << "\n";
+
+    int failed = 0;
+    for (const auto& result : g_results) {
+        std::string status = result.passed ? "✅ PASS" : "❌ FAIL";
+        std::cout << "  " << status << "  " << result.name << "\n";
+        std::cout << "         " << result.message << " (" << result.duration_ms << " ms)\n";
+        if (!result.passed) failed++;
+    }
+    std::cout << "\n";
+    return failed;
+}
+
+} // namespace status_parser_bench
+
+int main() {
+    return status_parser_bench::run_all_tests() == 0 ? 0 : 1;
+}
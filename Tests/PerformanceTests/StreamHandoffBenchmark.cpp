@@ -0,0 +1,443 @@
+/***
+    StreamHandoffBenchmark.cpp
+
+    Simulates a server switching a group's stream mid-session and reports
+    the audible gap, with and without playout::StreamHandoff.
+
+    The server sends chunks 1000 ms ahead, so when the new CodecHeader
+    arrives the old stream still holds a second of audio and the new one
+    starts where it ends. Snapcast's Controller then destroys Stream and
+    Player; the new player's queue is modelled as the iOS one: 100 ms
+    buffers, three queued ahead of the one playing (discarded on teardown),
+    300 ms playout delay. Time is simulated, the output is the sequence of
+    buffers as the device would play them.
+
+    - Teardown: the old stream is dropped with its player (current flow).
+    - Handoff: the new player plays out the old stream, converting its
+      sample size / channels, and crossfades into the new one. A rate
+      change can't be bridged and falls back to teardown.
+
+    Also checks the crossfade against a hard cut at the stream boundary,
+    the format conversion, and that passthrough matches a plain read.
+
+    Build & run: ./scripts/run-linux-benchmarks.sh StreamHandoff
+
+    Copyright (C) 2025 SnapForge contributors
+    License: GPL-3.0
+***/
+
+#include "playout/stream_handoff.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace stream_handoff_bench {
+
+using Clock = std::chrono::steady_clock;
+using std::chrono::microseconds;
+
+constexpr int64_t BUFFER_US = 100'000;
+constexpr size_t QUEUED_BUFFERS = 3;         // NUM_BUFFERS - 1 ahead of the playing one
+constexpr int64_t DELAY_US = 300'000;
+constexpr int64_t SERVER_BUFFER_US = 1'000'000;
+constexpr int64_t SWITCH_US = 5'000'000;     // first sample of the new stream
+constexpr int64_t END_US = SWITCH_US + 1'500'000;
+constexpr double PI = 3.14159265358979323846;
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+    double duration_ms;
+};
+
+std::vector<TestResult> g_results;
+
+void log(const std::string& msg) {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::cout << "[" << std::put_time(std::localtime(&time), "%H:%M:%S") << "] " << msg << std::endl;
+}
+
+std::string fmt(double v, int precision = 1) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(precision) << v;
+    return out.str();
+}
+
+std::string toString(const playout::PcmFormat& f) {
+    return std::to_string(f.rate) + ":" + std::to_string(f.bits) + ":" + std::to_string(f.channels);
+}
+
+double fullScale(uint16_t bits) {
+    return bits == 16 ? 32768. : (bits == 24 ? 8388608. : 2147483648.);
+}
+
+void writeSample(uint8_t* out, uint16_t bits, double v) {
+    double s = std::clamp(v * fullScale(bits), -fullScale(bits), fullScale(bits) - 1);
+    if (bits == 16) {
+        auto x = static_cast<int16_t>(s);
+        std::memcpy(out, &x, 2);
+    } else {
+        auto x = static_cast<int32_t>(s);
+        std::memcpy(out, &x, 4);
+    }
+}
+
+double readSample(const uint8_t* in, uint16_t bits) {
+    if (bits == 16) {
+        int16_t x;
+        std::memcpy(&x, in, 2);
+        return x / fullScale(bits);
+    }
+    int32_t x;
+    std::memcpy(&x, in, 4);
+    return x / fullScale(bits);
+}
+
+// ============================================================================
+// Simulated server streams
+// ============================================================================
+
+struct SimClock {
+    int64_t nowUs{0};
+};
+
+/// A tone with audio for server times [from, to), like a Stream holding the
+/// chunks of one codec
+class ToneSource : public playout::PcmSource {
+public:
+    ToneSource(playout::PcmFormat format, const SimClock& clock, int64_t fromUs, int64_t toUs, double hz, double phase)
+        : format_(format), clock_(clock), fromUs_(fromUs), toUs_(toUs), hz_(hz), phase_(phase) {}
+
+    playout::PcmFormat format() const override { return format_; }
+
+    bool read(void* out, uint32_t frames, microseconds delay) override {
+        auto* dst = static_cast<uint8_t*>(out);
+        const size_t sampleBytes = format_.bits == 16 ? 2 : 4;
+        const int64_t t0 = clock_.nowUs + delay.count();
+        bool any = false;
+        for (uint32_t f = 0; f < frames; ++f) {
+            double t = static_cast<double>(t0) + f * 1e6 / format_.rate;
+            double v = 0;
+            if (t >= static_cast<double>(fromUs_) && t < static_cast<double>(toUs_)) {
+                v = 0.5 * std::sin(2 * PI * hz_ * t / 1e6 + phase_);
+                any = true;
+            }
+            for (uint16_t c = 0; c < format_.channels; ++c)
+                writeSample(dst + (f * format_.channels + c) * sampleBytes, format_.bits, v);
+        }
+        return any;
+    }
+
+private:
+    playout::PcmFormat format_;
+    const SimClock& clock_;
+    int64_t fromUs_;
+    int64_t toUs_;
+    double hz_;
+    double phase_;
+};
+
+// ============================================================================
+// Simulated session
+// ============================================================================
+
+struct Heard {
+    std::vector<double> samples;  // first channel, as played
+    std::vector<int64_t> playout;  // playout time of each sample's buffer start
+};
+
+struct SessionResult {
+    double gapMs{0};
+    double carriedMs{0};
+    double boundaryStep{0};  // largest sample step within 50 ms of the switch
+    bool handedOff{false};
+    playout::Conversion conversion{playout::Conversion::Unsupported};
+};
+
+/// One player's queue: rendered buffers wait behind the playing one
+struct Queue {
+    std::deque<std::vector<double>> pending;
+    std::deque<int64_t> pendingPlayout;
+
+    void push(Heard& heard, std::vector<double> buffer, int64_t playout) {
+        pending.push_back(std::move(buffer));
+        pendingPlayout.push_back(playout);
+        if (pending.size() > QUEUED_BUFFERS) play(heard);
+    }
+    void play(Heard& heard) {
+        for (double s : pending.front()) {
+            heard.samples.push_back(s);
+            heard.playout.push_back(pendingPlayout.front());
+        }
+        pending.pop_front();
+        pendingPlayout.pop_front();
+    }
+    void drain(Heard& heard) {
+        while (!pending.empty()) play(heard);
+    }
+};
+
+std::vector<double> firstChannel(const std::vector<uint8_t>& pcm, const playout::PcmFormat& format, uint32_t frames) {
+    std::vector<double> out(frames);
+    const size_t sampleBytes = format.bits == 16 ? 2 : 4;
+    for (uint32_t f = 0; f < frames; ++f) out[f] = readSample(pcm.data() + f * format.channels * sampleBytes, format.bits);
+    return out;
+}
+
+SessionResult runSession(const playout::PcmFormat& from, const playout::PcmFormat& to, bool handoff, std::chrono::milliseconds crossfade) {
+    SessionResult result;
+    SimClock clock;
+    Heard heard;
+    // Different programs on either side; the new one starts at its peak
+    auto oldStream = std::make_shared<ToneSource>(from, clock, 0, SWITCH_US, 440, 0);
+    auto newStream = std::make_shared<ToneSource>(to, clock, SWITCH_US, END_US + SERVER_BUFFER_US, 660, PI / 2 - 2 * PI * 660 * SWITCH_US / 1e6);
+
+    // Old player, until the new CodecHeader arrives
+    {
+        const auto frames = static_cast<uint32_t>(from.rate * BUFFER_US / 1'000'000);
+        playout::StreamHandoff out(from, frames);
+        out.setIncoming(oldStream);
+        Queue queue;
+        std::vector<uint8_t> pcm(frames * from.frameBytes());
+        for (; clock.nowUs < SWITCH_US - SERVER_BUFFER_US; clock.nowUs += BUFFER_US) {
+            out.render(pcm.data(), frames, microseconds(DELAY_US), 1.f);
+            queue.push(heard, firstChannel(pcm, from, frames), clock.nowUs + DELAY_US);
+        }
+        // Teardown: AudioQueueStop(immediate) discards what is queued
+    }
+
+    // New player
+    const auto frames = static_cast<uint32_t>(to.rate * BUFFER_US / 1'000'000);
+    playout::StreamHandoff out(to, frames, playout::HandoffOptions{crossfade});
+    result.conversion = playout::conversionFor(from, to);
+    if (handoff) result.handedOff = out.setOutgoing(oldStream);
+    out.setIncoming(newStream);
+    Queue queue;
+    std::vector<uint8_t> pcm(frames * to.frameBytes());
+    for (; clock.nowUs < END_US; clock.nowUs += BUFFER_US) {
+        out.render(pcm.data(), frames, microseconds(DELAY_US), 1.f);
+        queue.push(heard, firstChannel(pcm, to, frames), clock.nowUs + DELAY_US);
+    }
+    queue.drain(heard);
+    result.carriedMs = static_cast<double>(out.stats().outgoingFrames) * 1000. / to.rate;
+
+    // Longest silence after the first audio
+    size_t first = 0;
+    while (first < heard.samples.size() && heard.samples[first] == 0) ++first;
+    size_t run = 0;
+    size_t longest = 0;
+    for (size_t i = first; i < heard.samples.size(); ++i) {
+        run = (heard.samples[i] == 0) ? run + 1 : 0;
+        longest = std::max(longest, run);
+    }
+    // A zero crossing may land on a sample: one frame isn't a gap
+    result.gapMs = longest > 1 ? static_cast<double>(longest) * 1000. / to.rate : 0;
+
+    for (size_t i = first + 1; i < heard.samples.size(); ++i) {
+        int64_t t = heard.playout[i];
+        if (t + BUFFER_US > SWITCH_US - 50'000 && t < SWITCH_US + 50'000)
+            result.boundaryStep = std::max(result.boundaryStep, std::fabs(heard.samples[i] - heard.samples[i - 1]));
+    }
+    return result;
+}
+
+// ============================================================================
+// Test 1: switch gap per codec change
+// ============================================================================
+
+TestResult test_switch_gap() {
+    TestResult result{"Switch gap on codec change", true, "", 0};
+    auto start = Clock::now();
+
+    struct Switch {
+        const char* label;
+        playout::PcmFormat from;
+        playout::PcmFormat to;
+    };
+    const Switch switches[] = {
+        {"flac -> opus   ", {48000, 16, 2}, {48000, 16, 2}},
+        {"flac -> pcm24  ", {48000, 16, 2}, {48000, 24, 2}},
+        {"pcm24 -> flac  ", {48000, 24, 2}, {48000, 16, 2}},
+        {"mono -> stereo ", {48000, 16, 1}, {48000, 16, 2}},
+        {"44.1k -> 48k   ", {44100, 16, 2}, {48000, 16, 2}},
+    };
+
+    log("Server buffer " + std::to_string(SERVER_BUFFER_US / 1000) + " ms, " + std::to_string(BUFFER_US / 1000) + " ms buffers, " +
+        std::to_string(QUEUED_BUFFERS) + " queued, crossfade 20 ms");
+    log("Switch           formats                   conversion   teardown gap   handoff gap   carried over");
+    double worst = 0;
+    for (const auto& sw : switches) {
+        auto teardown = runSession(sw.from, sw.to, false, std::chrono::milliseconds(20));
+        auto handoff = runSession(sw.from, sw.to, true, std::chrono::milliseconds(20));
+        std::ostringstream row;
+        row << "  " << sw.label << std::left << std::setw(26) << (toString(sw.from) + " -> " + toString(sw.to)) << std::setw(13)
+            << playout::toString(handoff.conversion) << std::right << std::setw(9) << fmt(teardown.gapMs) << " ms" << std::setw(11)
+            << fmt(handoff.gapMs) << " ms" << std::setw(12) << fmt(handoff.carriedMs) << " ms";
+        log(row.str());
+
+        if (handoff.conversion == playout::Conversion::Unsupported) {
+            // Refused, same as teardown
+            if (handoff.handedOff || std::fabs(handoff.gapMs - teardown.gapMs) > 1) {
+                result.passed = false;
+                result.message = std::string("rate change was not refused: ") + sw.label;
+            }
+            continue;
+        }
+        worst = std::max(worst, handoff.gapMs);
+        if (!handoff.handedOff || handoff.gapMs > 0 || teardown.gapMs < 500) {
+            result.passed = false;
+            result.message = std::string("unexpected gap for ") + sw.label + ": teardown " + fmt(teardown.gapMs) + " ms, handoff " +
+                             fmt(handoff.gapMs) + " ms";
+        }
+    }
+    if (result.passed) result.message = "no silence across same-rate switches (teardown ~" + fmt(SERVER_BUFFER_US / 1000. - DELAY_US / 1000.) + " ms)";
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Test 2: crossfade vs hard cut at the stream boundary
+// ============================================================================
+
+TestResult test_crossfade() {
+    TestResult result{"Crossfade at the stream boundary", true, "", 0};
+    auto start = Clock::now();
+
+    const playout::PcmFormat from{48000, 16, 2};
+    const playout::PcmFormat to{48000, 24, 2};
+    auto cut = runSession(from, to, true, std::chrono::milliseconds(0));
+    auto fade = runSession(from, to, true, std::chrono::milliseconds(20));
+    // Largest step of the 660 Hz tone itself
+    const double toneStep = 0.5 * 2 * PI * 660 / 48000;
+    log("  largest step within 50 ms of the switch: hard cut " + fmt(cut.boundaryStep, 4) + ", 20 ms crossfade " +
+        fmt(fade.boundaryStep, 4) + " (tone " + fmt(toneStep, 4) + ")");
+
+    if (cut.boundaryStep < 0.4 || fade.boundaryStep > toneStep * 1.1) {
+        result.passed = false;
+        result.message = "crossfade step " + fmt(fade.boundaryStep, 4) + ", hard cut " + fmt(cut.boundaryStep, 4);
+    } else {
+        result.message = "boundary step " + fmt(cut.boundaryStep, 3) + " -> " + fmt(fade.boundaryStep, 3) + " of full scale";
+    }
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Test 3: conversion and passthrough
+// ============================================================================
+
+/// Fixed PCM, always present
+class ConstSource : public playout::PcmSource {
+public:
+    ConstSource(playout::PcmFormat format, std::vector<uint8_t> pcm) : format_(format), pcm_(std::move(pcm)) {}
+    playout::PcmFormat format() const override { return format_; }
+    bool read(void* out, uint32_t frames, microseconds) override {
+        std::memcpy(out, pcm_.data(), std::min(pcm_.size(), frames * format_.frameBytes()));
+        return true;
+    }
+
+private:
+    playout::PcmFormat format_;
+    std::vector<uint8_t> pcm_;
+};
+
+TestResult test_conversion() {
+    TestResult result{"Conversion and passthrough", true, "", 0};
+    auto start = Clock::now();
+
+    constexpr uint32_t frames = 480;
+    // 16-bit mono into 24-bit stereo: exact, on both channels
+    std::vector<uint8_t> mono(frames * 2);
+    for (uint32_t f = 0; f < frames; ++f) {
+        auto s = static_cast<int16_t>(f * 131 - 30000);
+        std::memcpy(mono.data() + f * 2, &s, 2);
+    }
+    playout::StreamHandoff convert({48000, 24, 2}, frames);
+    convert.setIncoming(std::make_shared<ConstSource>(playout::PcmFormat{48000, 16, 1}, mono));
+    std::vector<int32_t> out(frames * 2);
+    convert.render(out.data(), frames, microseconds(0), 1.f);
+    for (uint32_t f = 0; f < frames && result.passed; ++f) {
+        int16_t s;
+        std::memcpy(&s, mono.data() + f * 2, 2);
+        if (out[f * 2] != s * 256 || out[f * 2 + 1] != s * 256) {
+            result.passed = false;
+            result.message = "16-bit mono -> 24-bit stereo frame " + std::to_string(f) + ": " + std::to_string(out[f * 2]) + " vs " +
+                             std::to_string(s * 256);
+        }
+    }
+
+    // Same format: passthrough, a plain read plus gain
+    playout::StreamHandoff same({48000, 16, 1}, frames);
+    same.setIncoming(std::make_shared<ConstSource>(playout::PcmFormat{48000, 16, 1}, mono));
+    std::vector<int16_t> pass(frames);
+    same.render(pass.data(), frames, microseconds(0), 0.5f);
+    if (!same.passthrough()) {
+        result.passed = false;
+        result.message = "same format is not passthrough";
+    }
+    for (uint32_t f = 0; f < frames && result.passed; ++f) {
+        int16_t s;
+        std::memcpy(&s, mono.data() + f * 2, 2);
+        if (std::abs(pass[f] - s / 2) > 1) {
+            result.passed = false;
+            result.message = "passthrough frame " + std::to_string(f) + ": " + std::to_string(pass[f]) + " vs " + std::to_string(s / 2);
+        }
+    }
+
+    playout::StreamHandoff rate({48000, 16, 2}, frames);
+    if (rate.setOutgoing(std::make_shared<ConstSource>(playout::PcmFormat{44100, 16, 2}, std::vector<uint8_t>(frames * 4)))) {
+        result.passed = false;
+        result.message = "accepted a 44.1 kHz source on a 48 kHz output";
+    }
+
+    if (result.passed) result.message = "16-bit mono -> 24-bit stereo exact, passthrough within 1 LSB, rate change refused";
+    result.duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int run_all_tests() {
+    std::cout << "\n";
+    std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║       Stream Handoff Benchmark                               ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════════════╝\n";
+    std::cout << "\n";
+
+    g_results.push_back(test_switch_gap());
+    std::cout << "\n";
+    g_results.push_back(test_crossfade());
+    std::cout << "\n";
+    g_results.push_back(test_conversion());
+    std::cout << "\n";
+
+    int failed = 0;
+    for (const auto& result : g_results) {
+        std::string status = result.passed ? "✅ PASS" : "❌ FAIL";
+        std::cout << "  " << status << "  " << result.name << "\n";
+        std::cout << "         " << result.message << " (" << result.duration_ms << " ms)\n";
+        if (!result.passed) failed++;
+    }
+    std::cout << "\n";
+    return failed;
+}
+
+} // namespace stream_handoff_bench
+
+int main() {
+    return stream_handoff_bench::run_all_tests() == 0 ? 0 : 1;
+}
@@ -0,0 +1,588 @@
+/***
+    StreamReaderBenchmark.cpp
+
+    Checks net::StreamReader, the read side the patched ClientConnectionTcp
+    uses (patches/ios-stream-reader.patch), against a loopback mock server.
+
+    - Delivery: a burst of chunks of varying size, then chunks every 20 ms;
+      every message arrives once, in order, intact, with a steady-clock
+      receive time, in fewer reads than messages; the socket profile is
+      applied on start.
+    - StopInHandler: the connection stops the reader from a message handler
+      (as disconnect() does); nothing is delivered after it.
+    - ConnectionLoss: the server drops the connection; one error, no
+      message after it.
+    - TimeSync: the reader's Time requests, written through the
+      connection's writer, come back as clock samples with their inbound
+      traffic (quick burst, then the steady interval) and never as
+      messages.
+    - SyncTimeout: a server that stops answering Time requests fails the
+      connection after syncTimeout.
+    - Tap: a tap set mid-stream on the reader's io_context (as the bridge's
+      relay does) first gets the CodecHeader replayed, then every batch
+      from the next one on; none after it is removed, and a tap on another
+      io_context gets nothing.
+
+    Build & run: ./scripts/run-linux-benchmarks.sh StreamReader
+
+    Copyright (C) 2025 SnapForge contributors
+    License: GPL-3.0
+***/
+
+#include "net/stream_reader.hpp"
+#include "probe/stream_wire.hpp"
+
+#include <boost/asio.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace reader_bench {
+
+using boost::asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+namespace wire = probe::wire;
+
+constexpr auto CHUNK_DURATION = milliseconds(20);
+constexpr int BURST = 500;
+/// Kernel stamps are converted from the wall clock, reading both clocks: a
+/// few µs of jitter against wire::now()
+constexpr auto STAMP_TOLERANCE = microseconds(50);
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+    double duration_ms;
+};
+
+std::vector<TestResult> g_results;
+
+void log(const std::string& msg) {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::cout << "[" << std::put_time(std::localtime(&time), "%H:%M:%S") << "] " << msg << std::endl;
+}
+
+std::string fmt(double v, int precision = 0) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(precision) << v;
+    return out.str();
+}
+
+/// Payload size of chunk @p seq: varied, so message boundaries fall anywhere in a read
+uint32_t chunkSize(uint16_t seq) { return 100 + (seq % 7) * 700; }
+
+// ============================================================================
+// Mock streaming server
+// ============================================================================
+
+/// Payload size of the CodecHeader, when the server sends one
+constexpr uint32_t CODEC_HEADER_SIZE = 64;
+
+/// Sends a burst of numbered chunks on connect (after a CodecHeader if told
+/// to), then one every 20 ms, and answers Time requests unless told not to
+class MockStreamServer {
+public:
+    explicit MockStreamServer(bool answerTime = true, bool codecHeader = false)
+        : acceptor_(io_, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)), answerTime_(answerTime),
+          codecHeader_(codecHeader) {
+        accept();
+        thread_ = std::thread([this]() { io_.run(); });
+    }
+
+    ~MockStreamServer() {
+        io_.stop();
+        thread_.join();
+    }
+
+    uint16_t port() const { return acceptor_.local_endpoint().port(); }
+
+    void dropAll() {
+        boost::asio::post(io_, [this]() {
+            for (auto& s : sessions_) s->close();
+            sessions_.clear();
+        });
+    }
+
+private:
+    struct Session : std::enable_shared_from_this<Session> {
+        Session(boost::asio::io_context& io, tcp::socket s, bool answer, bool header)
+            : socket(std::move(s)), timer(io), answerTime(answer), codecHeader(header) {}
+
+        void start() {
+            if (codecHeader) {
+                wire::Header h;
+                h.type = wire::kCodecHeader;
+                h.sent = wire::toTimeval(wire::now());
+                h.size = CODEC_HEADER_SIZE;
+                std::vector<uint8_t> out(wire::HEADER_SIZE + h.size, 0xCC);
+                wire::encodeHeader(h, out.data());
+                send(out);
+            }
+            for (int i = 0; i < BURST; ++i) sendChunk();
+            next = Clock::now();
+            scheduleChunk();
+            read();
+        }
+
+        void close() {
+            boost::system::error_code ec;
+            timer.cancel();
+            socket.close(ec);
+        }
+
+        void read() {
+            boost::asio::async_read(socket, boost::asio::buffer(header), [self = shared_from_this()](auto ec, size_t) {
+                if (ec) return;
+                auto h = wire::decodeHeader(self->header.data());
+                auto received = wire::now();
+                self->payload.resize(h.size);
+                boost::asio::async_read(self->socket, boost::asio::buffer(self->payload), [self, h, received](auto ec, size_t) {
+                    if (ec) return;
+                    if (h.type == wire::kTime && self->answerTime) {
+                        auto latency = received - wire::fromTimeval(h.sent);
+                        self->send(wire::encodeTimeReply(0, h.id, latency, wire::now()));
+                    }
+                    self->read();
+                });
+            });
+        }
+
+        void scheduleChunk() {
+            next += CHUNK_DURATION;
+            timer.expires_at(next);
+            timer.async_wait([self = shared_from_this()](auto ec) {
+                if (ec) return;
+                self->sendChunk();
+                self->scheduleChunk();
+            });
+        }
+
+        void sendChunk() {
+            wire::Header h;
+            h.type = wire::kWireChunk;
+            h.id = ++seq;
+            h.sent = wire::toTimeval(wire::now());
+            h.size = chunkSize(h.id);
+            std::vector<uint8_t> out(wire::HEADER_SIZE + h.size, static_cast<uint8_t>(h.id));
+            wire::encodeHeader(h, out.data());
+            send(out);
+        }
+
+        void send(const std::vector<uint8_t>& data) {
+            boost::system::error_code ec;
+            boost::asio::write(socket, boost::asio::buffer(data), ec);
+            if (ec) timer.cancel();
+        }
+
+        tcp::socket socket;
+        boost::asio::steady_timer timer;
+        bool answerTime;
+        bool codecHeader;
+        Clock::time_point next;
+        uint16_t seq{0};
+        std::array<uint8_t, wire::HEADER_SIZE> header{};
+        std::vector<uint8_t> payload;
+    };
+
+    void accept() {
+        acceptor_.async_accept([this](auto ec, tcp::socket socket) {
+            if (ec) return;
+            socket.set_option(tcp::no_delay(true), ec);
+            auto session = std::make_shared<Session>(io_, std::move(socket), answerTime_, codecHeader_);
+            session->start();
+            sessions_.push_back(session);
+            accept();
+        });
+    }
+
+    boost::asio::io_context io_;
+    tcp::acceptor acceptor_;
+    bool answerTime_;
+    bool codecHeader_;
+    std::vector<std::shared_ptr<Session>> sessions_;
+    std::thread thread_;
+};
+
+// ============================================================================
+// Client harness
+// ============================================================================
+
+/// A connected socket and a reader on it, run on the test thread
+struct Client {
+    explicit Client(uint16_t port, net::ReaderOptions options = {}) : socket(io), deadline(io) {
+        socket.connect(tcp::endpoint(boost::asio::ip::address_v4::loopback(), port));
+        reader = std::make_shared<net::StreamReader>(socket, options);
+    }
+
+    /// Run until io.stop() or @p timeout
+    void run(milliseconds timeout) {
+        deadline.expires_after(timeout);
+        deadline.async_wait([this](auto ec) {
+            if (!ec) io.stop();
+        });
+        io.run();
+        io.restart();
+    }
+
+    boost::asio::io_context io;
+    tcp::socket socket;
+    boost::asio::steady_timer deadline;
+    std::shared_ptr<net::StreamReader> reader;
+};
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+TestResult test_delivery() {
+    const std::string name = "Delivery";
+    log("🧪 [" + name + "] burst of " + std::to_string(BURST) + " chunks, then 20 ms chunks");
+    auto start = Clock::now();
+
+    MockStreamServer server;
+    Client client(server.port());
+
+    const int wanted = BURST + 20;
+    int count = 0;
+    bool ordered = true;
+    bool intact = true;
+    bool error = false;
+    bool stamped = true;
+    microseconds lastReceived{0};
+    net::StreamReader::Callbacks callbacks;
+    callbacks.onMessage = [&](const net::BatchReceiver::Message& message) {
+        ++count;
+        // Receive times (kernel stamps where available) on the steady clock
+        stamped &= (message.received + STAMP_TOLERANCE >= lastReceived) &&
+                   (message.received <= wire::now() + STAMP_TOLERANCE) &&
+                   (message.received + STAMP_TOLERANCE >= wire::fromTimeval(message.header.sent));
+        lastReceived = message.received;
+        ordered &= (message.header.type == wire::kWireChunk) && (message.header.id == count);
+        intact &= (message.header.size == chunkSize(message.header.id)) &&
+                  (message.payload[0] == static_cast<uint8_t>(message.header.id)) &&
+                  (message.payload[message.header.size - 1] == static_cast<uint8_t>(message.header.id));
+        if (count == wanted) {
+            client.reader->stop();
+            client.io.stop();
+        }
+    };
+    callbacks.onError = [&](const boost::system::error_code&) { error = true; };
+    client.reader->start(std::move(callbacks));
+    client.run(milliseconds(5000));
+
+    const auto& stats = client.reader->stats();
+    const auto& profile = client.reader->socketProfile();
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    log("✅ [" + name + "] Complete:");
+    log("   - Messages: " + std::to_string(count) + ", reads: " + std::to_string(stats.reads) +
+        ", wakeups: " + std::to_string(stats.wakeups) + ", batches: " + std::to_string(stats.batches));
+    log("   - Socket profile: nodelay " + std::to_string(profile.noDelay) + ", keepalive " +
+        std::to_string(profile.keepAlive) + ", user timeout " + std::to_string(profile.userTimeout));
+
+    bool passed = (count == wanted) && ordered && intact && stamped && !error && (stats.reads < static_cast<uint64_t>(count)) &&
+                  profile.noDelay && profile.keepAlive;
+    return {name, passed, passed ? "Every message once, in order, in fewer reads than messages" : "Lost, reordered or corrupt messages",
+            duration_ms};
+}
+
+TestResult test_stop_in_handler() {
+    const std::string name = "StopInHandler";
+    log("🧪 [" + name + "] reader stopped from the 10th message's handler");
+    auto start = Clock::now();
+
+    MockStreamServer server;
+    Client client(server.port());
+
+    int count = 0;
+    bool error = false;
+    net::StreamReader::Callbacks callbacks;
+    callbacks.onMessage = [&](const net::BatchReceiver::Message&) {
+        if (++count == 10) {
+            // As disconnect() does: stop, drop the reader, close the socket
+            client.reader->stop();
+            client.reader.reset();
+            boost::system::error_code ec;
+            client.socket.close(ec);
+        }
+    };
+    callbacks.onError = [&](const boost::system::error_code&) { error = true; };
+    client.reader->start(std::move(callbacks));
+    // The rest of the burst was in the same batch
+    client.run(milliseconds(200));
+
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    log("✅ [" + name + "] Complete: " + std::to_string(count) + " messages delivered");
+
+    bool passed = (count == 10) && !error;
+    return {name, passed, passed ? "Nothing delivered after stop()" : "Delivered after stop() or reported an error",
+            duration_ms};
+}
+
+TestResult test_connection_loss() {
+    const std::string name = "ConnectionLoss";
+    log("🧪 [" + name + "] server drops the connection mid-stream");
+    auto start = Clock::now();
+
+    MockStreamServer server;
+    Client client(server.port());
+
+    int count = 0;
+    int errors = 0;
+    int afterError = 0;
+    boost::system::error_code reported;
+    Clock::time_point dropped;
+    Clock::time_point noticed;
+    net::StreamReader::Callbacks callbacks;
+    callbacks.onMessage = [&](const net::BatchReceiver::Message&) {
+        afterError += (errors > 0) ? 1 : 0;
+        if (++count == BURST + 5) {
+            dropped = Clock::now();
+            server.dropAll();
+        }
+    };
+    callbacks.onError = [&](const boost::system::error_code& ec) {
+        if (errors++ == 0) {
+            noticed = Clock::now();
+            reported = ec;
+        }
+        client.io.stop();
+    };
+    client.reader->start(std::move(callbacks));
+    client.run(milliseconds(5000));
+
+    double noticeMs = std::chrono::duration<double, std::milli>(noticed - dropped).count();
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    log("✅ [" + name + "] Complete: " + std::to_string(errors) + " error (" + reported.message() + ") after " +
+        fmt(noticeMs, 2) + " ms, " + std::to_string(afterError) + " messages after it");
+
+    bool passed = (errors == 1) && (afterError == 0) && reported && (noticeMs < 100);
+    return {name, passed, passed ? "One error, reported as soon as the socket closed" : "Error missing, repeated or late",
+            duration_ms};
+}
+
+/// Time sync at a test pace: 5 quick requests 5 ms apart, then every 25 ms
+net::ReaderOptions timeSyncOptions() {
+    net::ReaderOptions options;
+    options.quickSyncs = 5;
+    options.quickInterval = milliseconds(5);
+    options.time.interval = milliseconds(25);
+    options.time.replyTimeout = milliseconds(100);
+    options.syncTimeout = milliseconds(150);
+    return options;
+}
+
+TestResult test_time_sync() {
+    const std::string name = "TimeSync";
+    log("🧪 [" + name + "] 5 quick Time requests, then every 25 ms, through the connection's writer");
+    auto start = Clock::now();
+
+    MockStreamServer server;
+    Client client(server.port(), timeSyncOptions());
+
+    const int wanted = 15;
+    int samples = 0;
+    int written = 0;
+    int timeMessages = 0;
+    bool plausible = true;
+    bool error = false;
+    Clock::time_point quickDone;
+    net::StreamReader::Callbacks callbacks;
+    callbacks.onMessage = [&](const net::BatchReceiver::Message& message) {
+        timeMessages += (message.header.type == wire::kTime) ? 1 : 0;
+    };
+    callbacks.onError = [&](const boost::system::error_code&) { error = true; };
+    // Same clock on both ends: the offset is the asymmetry of the loopback.
+    // Every reply follows chunks (the burst, then one per 20 ms).
+    callbacks.onExchange = [&](const timesync::Exchange& sample) {
+        plausible &= (sample.rtt >= microseconds(0)) && (sample.rtt < milliseconds(20)) &&
+                     (std::abs(sample.offset.count()) < 10000) && (sample.quietBefore != microseconds::max());
+        if (++samples == 5) quickDone = Clock::now();
+        if (samples == wanted) {
+            client.reader->stop();
+            client.io.stop();
+        }
+    };
+    // As the patched connection does: queue the request behind its other writes
+    callbacks.writeRequest = [&](const uint8_t* data, size_t size) {
+        ++written;
+        boost::asio::write(client.socket, boost::asio::buffer(data, size));
+    };
+    client.reader->start(std::move(callbacks));
+    client.run(milliseconds(5000));
+
+    double quickMs = std::chrono::duration<double, std::milli>(quickDone - start).count();
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    log("✅ [" + name + "] Complete: " + std::to_string(samples) + " samples from " + std::to_string(written) +
+        " requests, quick burst done after " + fmt(quickMs, 1) + " ms, " + std::to_string(timeMessages) +
+        " Time messages delivered");
+
+    const auto* requester = client.reader->requester();
+    bool recycled = requester != nullptr && requester->memory().stats().fallbacks == 0;
+    // 10 steady requests at 25 ms take 250 ms: the burst must have been quicker
+    bool passed = (samples == wanted) && plausible && !error && (timeMessages == 0) && (written >= wanted) &&
+                  recycled && (quickMs < duration_ms - 150);
+    return {name, passed, passed ? "Replies became samples, burst then steady interval" : "Missing, implausible or misrouted samples",
+            duration_ms};
+}
+
+TestResult test_sync_timeout() {
+    const std::string name = "SyncTimeout";
+    log("🧪 [" + name + "] server never answers Time requests, syncTimeout 150 ms");
+    auto start = Clock::now();
+
+    MockStreamServer server(false);
+    Client client(server.port(), timeSyncOptions());
+
+    int errors = 0;
+    int samples = 0;
+    boost::system::error_code reported;
+    Clock::time_point failed;
+    net::StreamReader::Callbacks callbacks;
+    callbacks.onMessage = [](const net::BatchReceiver::Message&) {};
+    callbacks.onError = [&](const boost::system::error_code& ec) {
+        if (errors++ == 0) {
+            failed = Clock::now();
+            reported = ec;
+        }
+    };
+    callbacks.onExchange = [&](const timesync::Exchange&) { ++samples; };
+    client.reader->start(std::move(callbacks));
+    // Keep running past the error: it must not repeat
+    client.run(milliseconds(500));
+
+    double failedMs = std::chrono::duration<double, std::milli>(failed - start).count();
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    log("✅ [" + name + "] Complete: " + std::to_string(errors) + " error (" + reported.message() + ") after " +
+        fmt(failedMs, 1) + " ms");
+
+    bool passed = (errors == 1) && (samples == 0) && (reported == boost::asio::error::timed_out) && (failedMs >= 150) &&
+                  (failedMs < 300);
+    return {name, passed, passed ? "One timed_out error, a request interval after syncTimeout" : "Timeout missing, early or repeated",
+            duration_ms};
+}
+
+TestResult test_tap() {
+    const std::string name = "Tap";
+    log("🧪 [" + name + "] tap set after 30 chunks, removed after 100 more");
+    auto start = Clock::now();
+
+    MockStreamServer server(true, true);
+    Client client(server.port());
+    boost::asio::io_context other;
+
+    int chunks = 0;
+    int tapCalls = 0;
+    int tapChunks = 0;
+    int afterRemoval = 0;
+    int otherCalls = 0;
+    bool removed = false;
+    bool replayed = false;
+    bool consecutive = true;
+    uint16_t firstTapped = 0;
+    uint16_t lastTapped = 0;
+    net::StreamReader::setTap(other, [&](const std::vector<net::BatchReceiver::Message>&) { ++otherCalls; });
+    auto tap = [&](const std::vector<net::BatchReceiver::Message>& batch) {
+        afterRemoval += removed ? 1 : 0;
+        if (tapCalls++ == 0) {
+            // Only the stream's header, intact
+            replayed = (batch.size() == 1) && (batch[0].header.type == wire::kCodecHeader) &&
+                       (batch[0].header.size == CODEC_HEADER_SIZE) && (batch[0].payload[0] == 0xCC) &&
+                       (batch[0].payload[CODEC_HEADER_SIZE - 1] == 0xCC);
+            return;
+        }
+        for (const auto& message : batch) {
+            if (message.header.type != wire::kWireChunk) continue;
+            consecutive &= (lastTapped == 0) || (message.header.id == lastTapped + 1);
+            if (firstTapped == 0) firstTapped = message.header.id;
+            lastTapped = message.header.id;
+            ++tapChunks;
+        }
+    };
+
+    bool error = false;
+    net::StreamReader::Callbacks callbacks;
+    callbacks.onMessage = [&](const net::BatchReceiver::Message& message) {
+        if (message.header.type != wire::kWireChunk) return;
+        ++chunks;
+        if (chunks == 30) net::StreamReader::setTap(client.io, tap);
+        if (!removed && tapChunks >= 100) {
+            net::StreamReader::setTap(client.io, nullptr);
+            removed = true;
+        }
+        if (chunks == BURST + 10) {
+            client.reader->stop();
+            client.io.stop();
+        }
+    };
+    callbacks.onError = [&](const boost::system::error_code&) { error = true; };
+    client.reader->start(std::move(callbacks));
+    client.run(milliseconds(5000));
+    net::StreamReader::setTap(client.io, nullptr);
+    net::StreamReader::setTap(other, nullptr);
+
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    log("✅ [" + name + "] Complete:");
+    log("   - Tap: " + std::to_string(tapCalls) + " calls, CodecHeader replayed " + std::to_string(replayed) + ", chunks " +
+        std::to_string(firstTapped) + "-" + std::to_string(lastTapped) + (consecutive ? " consecutive" : " with gaps"));
+    log("   - Calls after removal: " + std::to_string(afterRemoval) + ", other io_context: " + std::to_string(otherCalls));
+
+    bool passed = replayed && consecutive && (firstTapped > 30) && (tapChunks >= 100) && removed && (afterRemoval == 0) &&
+                  (otherCalls == 0) && !error && (chunks == BURST + 10);
+    return {name, passed,
+            passed ? "Header replayed, then every batch until removed, nothing for another io_context"
+                   : "Header not replayed, batches missed or tapped after removal",
+            duration_ms};
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int run_all_tests() {
+    std::cout << "\n";
+    std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║       Stream Reader Benchmark                                ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════════════╝\n";
+    std::cout << "\n";
+
+    g_results.push_back(test_delivery());
+    std::cout << "\n";
+    g_results.push_back(test_stop_in_handler());
+    std::cout << "\n";
+    g_results.push_back(test_connection_loss());
+    std::cout << "\n";
+    g_results.push_back(test_time_sync());
+    std::cout << "\n";
+    g_results.push_back(test_sync_timeout());
+    std::cout << "\n";
+    g_results.push_back(test_tap());
+    std::cout << "\n";
+
+    int failed = 0;
+    for (const auto& result : g_results) {
+        std::string status = result.passed ? "✅ PASS" : "❌ FAIL";
+        std::cout << "  " << status << "  " << result.name << "\n";
+        std::cout << "         " << result.message << " (" << result.duration_ms << " ms)\n";
+        if (!result.passed) failed++;
+    }
+    std::cout << "\n";
+    return failed;
+}
+
+}  // namespace reader_bench
+
+int main() {
+    return reader_bench::run_all_tests() == 0 ? 0 : 1;
+}
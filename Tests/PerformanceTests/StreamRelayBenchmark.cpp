@@ -0,0 +1,757 @@
+/***
+    StreamRelayBenchmark.cpp
+
+    net::StreamRelay re-serving a stream to 8 loopback downstream clients,
+    each on its own thread reading with blocking sockets as a Snapcast
+    client would.
+
+    - FanOut: 3000 48 kHz/16/2 20 ms chunks published in bursts, 40× real
+      time. The relay (one copy per message into a shared frame, gather
+      writes) against the straightforward relay that copies each message
+      for every client and writes them one by one: io thread CPU per chunk
+      and heap allocations on the io thread after warm-up (global operator
+      new replaced, counted on the io thread only). Every client must get
+      every chunk intact and in order.
+    - Latency: real-time 20 ms chunks for 3 s; publish -> arrival at each
+      client.
+    - TimeSync: the relay's clock offset is set to 3 s 217 µs; each client
+      syncs with Time requests while chunks stream and must measure the
+      offset within 0.5 ms.
+    - JoinAndDrop: a client that stops reading is dropped once it falls
+      256 KB behind while the others get everything; a late joiner gets
+      ServerSettings and CodecHeader before the chunks; a connection beyond
+      maxClients is refused.
+
+    Build & run: ./scripts/run-linux-benchmarks.sh StreamRelay
+
+    Copyright (C) 2025 SnapForge contributors
+    License: GPL-3.0
+***/
+
+#include "net/batch_receiver.hpp"
+#include "net/stream_relay.hpp"
+#include "probe/stream_wire.hpp"
+
+#include <boost/asio.hpp>
+
+#include <poll.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ============================================================================
+// Allocation counting (io thread only)
+// ============================================================================
+
+namespace {
+thread_local bool t_counting = false;
+thread_local uint64_t t_allocations = 0;
+}  // namespace
+
+// Out of line, or GCC pairs the inlined malloc/free with new/delete and warns
+[[gnu::noinline]] void* operator new(std::size_t size) {
+    if (t_counting) t_allocations++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace relay_bench {
+
+using boost::asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+namespace wire = probe::wire;
+
+constexpr size_t CHUNK_BYTES = 48000 * 4 / 50;  // 20 ms of 48 kHz/16/2
+constexpr int CLIENTS = 8;
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+    double duration_ms;
+};
+
+std::vector<TestResult> g_results;
+
+void log(const std::string& msg) {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::cout << "[" << std::put_time(std::localtime(&time), "%H:%M:%S") << "] " << msg << std::endl;
+}
+
+std::string fmt(double v, int precision = 0) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(precision) << v;
+    return out.str();
+}
+
+double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return -1;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, static_cast<size_t>(p * static_cast<double>(v.size())))];
+}
+
+double threadCpuUs() {
+    rusage ru{};
+    getrusage(RUSAGE_THREAD, &ru);
+    return static_cast<double>(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1e6 +
+           static_cast<double>(ru.ru_utime.tv_usec + ru.ru_stime.tv_usec);
+}
+
+// ============================================================================
+// Upstream: the messages a StreamReader tap hands over
+// ============================================================================
+
+/// Chunk payload: sequence, publish time, then a pattern from the sequence
+void fillChunk(uint8_t* payload, uint32_t seq) {
+    const int64_t published = wire::now().count();
+    std::memcpy(payload, &seq, 4);
+    std::memcpy(payload + 4, &published, 8);
+    for (size_t i = 12; i < CHUNK_BYTES; ++i) payload[i] = static_cast<uint8_t>(seq + i);
+}
+
+bool chunkIntact(const uint8_t* payload, size_t size, uint32_t& seq, int64_t& published) {
+    if (size != CHUNK_BYTES) return false;
+    std::memcpy(&seq, payload, 4);
+    std::memcpy(&published, payload + 4, 8);
+    for (size_t i = 12; i < CHUNK_BYTES; ++i)
+        if (payload[i] != static_cast<uint8_t>(seq + i)) return false;
+    return true;
+}
+
+/// Builds batches of upstream messages in buffers it owns
+class Upstream {
+public:
+    /// ServerSettings and CodecHeader, as the server sends them after Hello
+    const std::vector<net::BatchReceiver::Message>& headers() {
+        settings_.assign(64, 's');
+        codec_.assign(48, 'c');
+        batch_.clear();
+        batch_.push_back(message(wire::kServerSettings, settings_.data(), settings_.size()));
+        batch_.push_back(message(wire::kCodecHeader, codec_.data(), codec_.size()));
+        return batch_;
+    }
+
+    /// @p count chunks from sequence @p first
+    const std::vector<net::BatchReceiver::Message>& chunks(uint32_t first, size_t count) {
+        if (chunks_.size() < count * CHUNK_BYTES) chunks_.resize(count * CHUNK_BYTES);
+        batch_.clear();
+        for (size_t i = 0; i < count; ++i) {
+            uint8_t* payload = chunks_.data() + i * CHUNK_BYTES;
+            fillChunk(payload, first + static_cast<uint32_t>(i));
+            batch_.push_back(message(wire::kWireChunk, payload, CHUNK_BYTES));
+        }
+        return batch_;
+    }
+
+private:
+    static net::BatchReceiver::Message message(uint16_t type, const uint8_t* payload, size_t size) {
+        wire::Header h;
+        h.type = type;
+        h.sent = wire::toTimeval(wire::now());
+        h.size = static_cast<uint32_t>(size);
+        return {h, payload, wire::now()};
+    }
+
+    std::vector<uint8_t> settings_;
+    std::vector<uint8_t> codec_;
+    std::vector<uint8_t> chunks_;
+    std::vector<net::BatchReceiver::Message> batch_;
+};
+
+// ============================================================================
+// Baseline: a copy of each message per client, one write per message
+// ============================================================================
+
+class CopyRelay : public std::enable_shared_from_this<CopyRelay> {
+public:
+    explicit CopyRelay(boost::asio::io_context& io) : acceptor_(io) {}
+
+    bool start(boost::system::error_code& ec) {
+        tcp::endpoint endpoint(boost::asio::ip::address_v4::loopback(), 0);
+        acceptor_.open(endpoint.protocol(), ec);
+        if (!ec) acceptor_.bind(endpoint, ec);
+        if (!ec) acceptor_.listen(boost::asio::socket_base::max_listen_connections, ec);
+        if (ec) return false;
+        accept();
+        return true;
+    }
+
+    void stop() {
+        boost::system::error_code ignored;
+        acceptor_.close(ignored);
+        for (auto& c : conns_) c->socket.close(ignored);
+        conns_.clear();
+    }
+
+    uint16_t port() const { return acceptor_.local_endpoint().port(); }
+
+    void publish(const std::vector<net::BatchReceiver::Message>& batch) {
+        for (const auto& m : batch) {
+            for (auto& c : conns_) {
+                std::vector<uint8_t> out(wire::HEADER_SIZE + m.header.size);
+                wire::encodeHeader(m.header, out.data());
+                std::memcpy(out.data() + wire::HEADER_SIZE, m.payload, m.header.size);
+                c->queue.push_back(std::move(out));
+                if (!c->writing) write(c);
+            }
+        }
+    }
+
+private:
+    struct Conn {
+        explicit Conn(tcp::socket s) : socket(std::move(s)) {}
+        tcp::socket socket;
+        std::deque<std::vector<uint8_t>> queue;
+        bool writing{false};
+    };
+
+    void accept() {
+        acceptor_.async_accept([self = shared_from_this()](auto ec, tcp::socket socket) {
+            if (ec) return;
+            socket.set_option(tcp::no_delay(true), ec);
+            self->conns_.push_back(std::make_shared<Conn>(std::move(socket)));
+            self->accept();
+        });
+    }
+
+    void write(const std::shared_ptr<Conn>& c) {
+        c->writing = true;
+        boost::asio::async_write(c->socket, boost::asio::buffer(c->queue.front()), [self = shared_from_this(), c](auto ec, size_t) {
+            c->writing = false;
+            if (ec) return;
+            c->queue.pop_front();
+            if (!c->queue.empty()) self->write(c);
+        });
+    }
+
+    tcp::acceptor acceptor_;
+    std::vector<std::shared_ptr<Conn>> conns_;
+};
+
+// ============================================================================
+// Downstream client
+// ============================================================================
+
+class Downstream {
+public:
+    struct Options {
+        bool read{true};
+        int timeRequests{0};
+        milliseconds timeInterval{10};
+    };
+
+    Downstream(uint16_t port, Options options) : options_(options), socket_(io_) {
+        socket_.open(tcp::v4());
+        if (!options_.read) socket_.set_option(boost::asio::socket_base::receive_buffer_size(4096));
+        socket_.connect(tcp::endpoint(boost::asio::ip::address_v4::loopback(), port));
+        socket_.set_option(tcp::no_delay(true));
+        wire::HelloInfo info;
+        info.id = "relay-bench";
+        auto hello = wire::encodeHello(0, info, wire::now());
+        boost::asio::write(socket_, boost::asio::buffer(hello));
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    ~Downstream() { stop(); }
+
+    void stop() {
+        stop_ = true;
+        if (thread_.joinable()) thread_.join();
+    }
+
+    uint32_t chunks() const { return chunks_; }
+    bool closedByPeer() const { return closed_; }
+
+    // After stop()
+    uint32_t errors{0};
+    std::vector<uint16_t> types;  ///< First messages' types
+    std::vector<double> latencyMs;
+    std::vector<double> offsetUs;
+
+private:
+    void run() {
+        std::array<uint8_t, wire::HEADER_SIZE> header{};
+        std::vector<uint8_t> payload;
+        std::map<uint16_t, microseconds> pending;
+        uint16_t nextId = 1;
+        int sent = 0;
+        auto nextTime = Clock::now() + options_.timeInterval;
+        uint32_t expected = 0;
+        bool first = true;
+
+        while (!stop_) {
+            if ((sent < options_.timeRequests) && (Clock::now() >= nextTime)) {
+                std::array<uint8_t, wire::TIME_MESSAGE_SIZE> request{};
+                auto now = wire::now();
+                wire::encodeTime(nextId, now, request.data());
+                pending[nextId++] = now;
+                boost::system::error_code ec;
+                boost::asio::write(socket_, boost::asio::buffer(request), ec);
+                ++sent;
+                nextTime += options_.timeInterval;
+            }
+            if (!options_.read) {
+                std::this_thread::sleep_for(milliseconds(2));
+                continue;
+            }
+            pollfd pfd{socket_.native_handle(), POLLIN, 0};
+            if (::poll(&pfd, 1, 2) <= 0) continue;
+
+            boost::system::error_code ec;
+            boost::asio::read(socket_, boost::asio::buffer(header), ec);
+            if (!ec) {
+                auto h = wire::decodeHeader(header.data());
+                payload.resize(h.size);
+                boost::asio::read(socket_, boost::asio::buffer(payload), ec);
+                if (!ec) {
+                    auto received = wire::now();
+                    if (types.size() < 3) types.push_back(h.type);
+                    if (h.type == wire::kWireChunk) {
+                        uint32_t seq = 0;
+                        int64_t published = 0;
+                        bool intact = chunkIntact(payload.data(), payload.size(), seq, published);
+                        if (first) {
+                            expected = seq;  // a late joiner starts anywhere
+                            first = false;
+                        }
+                        if (!intact || seq != expected) errors++;
+                        expected = seq + 1;
+                        latencyMs.push_back(static_cast<double>(received.count() - published) / 1000.0);
+                        chunks_++;
+                    } else if (h.type == wire::kTime) {
+                        microseconds latency{0};
+                        auto it = pending.find(h.refersTo);
+                        if (it != pending.end() && wire::decodeTime(payload.data(), payload.size(), latency)) {
+                            auto sample = wire::timeSample(latency, wire::fromTimeval(h.sent), received);
+                            offsetUs.push_back(static_cast<double>(sample.offset.count()));
+                            pending.erase(it);
+                        }
+                    }
+                }
+            }
+            if (ec) {
+                closed_ = true;
+                break;
+            }
+        }
+    }
+
+    Options options_;
+    boost::asio::io_context io_;
+    tcp::socket socket_;
+    std::thread thread_;
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> closed_{false};
+    std::atomic<uint32_t> chunks_{0};
+};
+
+// ============================================================================
+// io thread harness
+// ============================================================================
+
+class IoThread {
+public:
+    IoThread() : guard_(io_.get_executor()) {
+        thread_ = std::thread([this]() { io_.run(); });
+    }
+
+    ~IoThread() {
+        guard_.reset();
+        io_.stop();
+        thread_.join();
+    }
+
+    boost::asio::io_context& io() { return io_; }
+
+    /// Run @p f on the io thread and wait for its result
+    template <typename F>
+    auto call(F f) -> decltype(f()) {
+        std::packaged_task<decltype(f())()> task(std::move(f));
+        auto result = task.get_future();
+        boost::asio::post(io_, [&task]() { task(); });
+        return result.get();
+    }
+
+private:
+    boost::asio::io_context io_;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> guard_;
+    std::thread thread_;
+};
+
+bool waitUntil(const std::function<bool()>& done, milliseconds timeout) {
+    auto deadline = Clock::now() + timeout;
+    while (!done()) {
+        if (Clock::now() >= deadline) return false;
+        std::this_thread::sleep_for(milliseconds(2));
+    }
+    return true;
+}
+
+std::shared_ptr<net::StreamRelay> startRelay(IoThread& t, size_t maxQueuedBytes = 1024 * 1024) {
+    net::RelayOptions options;
+    options.address = "127.0.0.1";
+    options.port = 0;
+    options.maxQueuedBytes = maxQueuedBytes;
+    auto relay = std::make_shared<net::StreamRelay>(t.io(), options);
+    bool started = t.call([&relay]() {
+        boost::system::error_code ec;
+        return relay->start(ec);
+    });
+    return started ? relay : nullptr;
+}
+
+std::vector<std::unique_ptr<Downstream>> connect(uint16_t port, int n, Downstream::Options options = {}) {
+    std::vector<std::unique_ptr<Downstream>> clients;
+    for (int i = 0; i < n; ++i) clients.push_back(std::make_unique<Downstream>(port, options));
+    // Let the relay take the Hellos before anything is published
+    std::this_thread::sleep_for(milliseconds(100));
+    return clients;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+struct FanOutResult {
+    bool delivered{false};
+    uint32_t errors{0};
+    double cpuUsPerChunk{0};
+    uint64_t allocations{0};
+};
+
+/// Publish @p total chunks in bursts on the io thread, until every client
+/// has them all
+template <typename Relay>
+FanOutResult fanOut(IoThread& t, Relay& relay, std::vector<std::unique_ptr<Downstream>>& clients, uint32_t total) {
+    constexpr uint32_t BURST = 20;
+    constexpr uint32_t WARMUP = 500;
+    Upstream upstream;
+    FanOutResult r;
+
+    double cpuStart = t.call([&]() {
+        relay.publish(upstream.headers());
+        return threadCpuUs();
+    });
+    for (uint32_t seq = 0; seq < total; seq += BURST) {
+        t.call([&]() {
+            if (seq == WARMUP) {
+                t_allocations = 0;
+                t_counting = true;
+            }
+            relay.publish(upstream.chunks(seq, std::min(BURST, total - seq)));
+            return 0;
+        });
+        std::this_thread::sleep_for(milliseconds(10));
+    }
+    r.delivered = waitUntil([&]() {
+        for (auto& c : clients)
+            if (c->chunks() < total) return false;
+        return true;
+    }, milliseconds(20000));
+    double cpuEnd = t.call([&]() {
+        t_counting = false;
+        r.allocations = t_allocations;
+        return threadCpuUs();
+    });
+    r.cpuUsPerChunk = (cpuEnd - cpuStart) / total;
+    for (auto& c : clients) {
+        c->stop();
+        r.errors += c->errors;
+    }
+    return r;
+}
+
+TestResult test_fan_out() {
+    const std::string name = "FanOut";
+    constexpr uint32_t TOTAL = 3000;
+    log("🧪 [" + name + "] " + std::to_string(TOTAL) + " chunks to " + std::to_string(CLIENTS) +
+        " loopback clients, bursts of 20 every 10 ms");
+    auto start = Clock::now();
+
+    FanOutResult shared, copied;
+    net::StreamRelay::Stats stats;
+    {
+        IoThread t;
+        auto relay = startRelay(t);
+        if (relay) {
+            auto clients = connect(relay->port(), CLIENTS);
+            shared = fanOut(t, *relay, clients, TOTAL);
+            stats = t.call([&]() { return relay->stats(); });
+            relay->stop();
+        }
+    }
+    {
+        IoThread t;
+        auto relay = std::make_shared<CopyRelay>(t.io());
+        bool started = t.call([&]() {
+            boost::system::error_code ec;
+            return relay->start(ec);
+        });
+        if (started) {
+            auto clients = connect(relay->port(), CLIENTS);
+            copied = fanOut(t, *relay, clients, TOTAL);
+            t.call([&]() {
+                relay->stop();
+                return 0;
+            });
+        }
+    }
+
+    log("   - copy per client, a write per message: " + fmt(copied.cpuUsPerChunk, 1) + " µs io CPU per chunk, " +
+        std::to_string(copied.allocations) + " allocations after warm-up" + (copied.delivered ? "" : " (incomplete)"));
+    log("   - StreamRelay, shared frames + gather writes: " + fmt(shared.cpuUsPerChunk, 1) + " µs io CPU per chunk, " +
+        std::to_string(shared.allocations) + " allocations after warm-up" + (shared.delivered ? "" : " (incomplete)"));
+    log("   - " + std::to_string(stats.writes) + " writes for " + std::to_string(TOTAL * CLIENTS) + " chunk deliveries, " +
+        std::to_string(stats.framesAllocated) + " frames allocated for " + std::to_string(stats.published) +
+        " messages, " + std::to_string(shared.errors) + " corrupt or out of order");
+
+    bool passed = shared.delivered && shared.errors == 0 && stats.dropped == 0 && shared.allocations == 0 && copied.allocations > 0 &&
+                  stats.writes < static_cast<uint64_t>(TOTAL) * CLIENTS && shared.cpuUsPerChunk < copied.cpuUsPerChunk;
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return {name, passed,
+            passed ? "Every client gets every chunk, one copy per message and no allocation on the io thread"
+                   : "Fan-out incomplete, corrupt, allocating or not cheaper than copying",
+            duration_ms};
+}
+
+TestResult test_latency() {
+    const std::string name = "Latency";
+    constexpr uint32_t TOTAL = 150;
+    log("🧪 [" + name + "] real-time 20 ms chunks for 3 s to " + std::to_string(CLIENTS) + " clients");
+    auto start = Clock::now();
+
+    std::vector<double> latency;
+    uint32_t errors = 0;
+    bool delivered = false;
+    {
+        IoThread t;
+        auto relay = startRelay(t);
+        if (relay) {
+            auto clients = connect(relay->port(), CLIENTS);
+            Upstream upstream;
+            t.call([&]() {
+                relay->publish(upstream.headers());
+                return 0;
+            });
+            auto next = Clock::now();
+            for (uint32_t seq = 0; seq < TOTAL; ++seq) {
+                next += milliseconds(20);
+                std::this_thread::sleep_until(next);
+                t.call([&]() {
+                    relay->publish(upstream.chunks(seq, 1));
+                    return 0;
+                });
+            }
+            delivered = waitUntil([&]() {
+                for (auto& c : clients)
+                    if (c->chunks() < TOTAL) return false;
+                return true;
+            }, milliseconds(2000));
+            for (auto& c : clients) {
+                c->stop();
+                errors += c->errors;
+                latency.insert(latency.end(), c->latencyMs.begin(), c->latencyMs.end());
+            }
+            relay->stop();
+        }
+    }
+
+    log("   - publish -> client: median " + fmt(percentile(latency, 0.5), 3) + " ms, p99 " + fmt(percentile(latency, 0.99), 3) +
+        " ms, max " + fmt(percentile(latency, 1.0), 3) + " ms over " + std::to_string(latency.size()) + " deliveries");
+
+    bool passed = delivered && errors == 0 && percentile(latency, 0.5) < 2.0 && percentile(latency, 0.99) < 10.0;
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return {name, passed, passed ? "Chunks reach every client within a fraction of a chunk" : "Relay adds delay", duration_ms};
+}
+
+TestResult test_time_sync() {
+    const std::string name = "TimeSync";
+    const microseconds offset = std::chrono::seconds(3) + microseconds(217);
+    log("🧪 [" + name + "] relay offset " + std::to_string(offset.count()) + " µs, 30 Time requests per client while streaming");
+    auto start = Clock::now();
+
+    std::vector<double> errors;
+    uint64_t replies = 0;
+    {
+        IoThread t;
+        auto relay = startRelay(t);
+        if (relay) {
+            t.call([&]() {
+                relay->setClockOffset(offset);
+                return 0;
+            });
+            Downstream::Options options;
+            options.timeRequests = 30;
+            auto clients = connect(relay->port(), CLIENTS, options);
+            Upstream upstream;
+            t.call([&]() {
+                relay->publish(upstream.headers());
+                return 0;
+            });
+            auto next = Clock::now();
+            for (uint32_t seq = 0; seq < 30; ++seq) {
+                next += milliseconds(20);
+                std::this_thread::sleep_until(next);
+                t.call([&]() {
+                    relay->publish(upstream.chunks(seq, 1));
+                    return 0;
+                });
+            }
+            std::this_thread::sleep_for(milliseconds(100));
+            for (auto& c : clients) {
+                c->stop();
+                double measured = percentile(c->offsetUs, 0.5);
+                errors.push_back(c->offsetUs.empty() ? 1e9 : std::abs(measured - static_cast<double>(offset.count())));
+            }
+            replies = t.call([&]() { return relay->stats().timeReplies; });
+            relay->stop();
+        }
+    }
+
+    log("   - " + std::to_string(replies) + " replies, median offset error per client: best " + fmt(percentile(errors, 0.0), 0) +
+        " µs, worst " + fmt(percentile(errors, 1.0), 0) + " µs");
+
+    bool passed = errors.size() == CLIENTS && replies == 30u * CLIENTS && percentile(errors, 1.0) < 500.0;
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return {name, passed,
+            passed ? "Downstream clients sync to the upstream server's clock through the relay"
+                   : "Offset through the relay off or replies missing",
+            duration_ms};
+}
+
+TestResult test_join_and_drop() {
+    const std::string name = "JoinAndDrop";
+    constexpr uint32_t TOTAL = 2000;
+    log("🧪 [" + name + "] 7 clients + 1 stalled, 256 KB limit; then a late joiner and one too many");
+    auto start = Clock::now();
+
+    bool delivered = false, lateHeaders = false, lateChunks = false, refused = false;
+    uint32_t errors = 0;
+    net::StreamRelay::Stats stats;
+    {
+        IoThread t;
+        auto relay = startRelay(t, 256 * 1024);
+        if (relay) {
+            auto clients = connect(relay->port(), CLIENTS - 1);
+            Downstream::Options stalledOptions;
+            stalledOptions.read = false;
+            auto stalled = std::make_unique<Downstream>(relay->port(), stalledOptions);
+            std::this_thread::sleep_for(milliseconds(50));
+
+            Upstream upstream;
+            t.call([&]() {
+                relay->publish(upstream.headers());
+                return 0;
+            });
+            for (uint32_t seq = 0; seq < TOTAL; seq += 20) {
+                t.call([&]() {
+                    relay->publish(upstream.chunks(seq, 20));
+                    return 0;
+                });
+                std::this_thread::sleep_for(milliseconds(10));
+            }
+            delivered = waitUntil([&]() {
+                for (auto& c : clients)
+                    if (c->chunks() < TOTAL) return false;
+                return true;
+            }, milliseconds(10000));
+            stalled->stop();
+
+            // The stalled client's slot is free again
+            auto late = std::make_unique<Downstream>(relay->port(), Downstream::Options{});
+            std::this_thread::sleep_for(milliseconds(100));
+            auto extra = std::make_unique<Downstream>(relay->port(), Downstream::Options{});
+            for (uint32_t seq = TOTAL; seq < TOTAL + 10; ++seq) {
+                t.call([&]() {
+                    relay->publish(upstream.chunks(seq, 1));
+                    return 0;
+                });
+                std::this_thread::sleep_for(milliseconds(20));
+            }
+            lateChunks = waitUntil([&]() { return late->chunks() >= 10; }, milliseconds(2000));
+            refused = waitUntil([&]() { return extra->closedByPeer(); }, milliseconds(2000));
+            late->stop();
+            extra->stop();
+            lateHeaders = late->types.size() >= 3 && late->types[0] == wire::kServerSettings &&
+                          late->types[1] == wire::kCodecHeader && late->types[2] == wire::kWireChunk;
+            for (auto& c : clients) {
+                c->stop();
+                errors += c->errors;
+            }
+            errors += late->errors;
+            stats = t.call([&]() { return relay->stats(); });
+            relay->stop();
+        }
+    }
+
+    log("   - readers: " + std::string(delivered ? "all " : "not all ") + std::to_string(TOTAL) + " chunks, " +
+        std::to_string(errors) + " corrupt or out of order; stalled client dropped: " + (stats.dropped == 1 ? "yes" : "no"));
+    log("   - late joiner: " + std::string(lateHeaders ? "ServerSettings, CodecHeader, then chunks" : "headers missing") +
+        "; connection beyond 8: " + (refused && stats.rejected == 1 ? "refused" : "not refused"));
+
+    bool passed = delivered && errors == 0 && stats.dropped == 1 && lateHeaders && lateChunks && refused && stats.rejected == 1;
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return {name, passed,
+            passed ? "A stalled client is cut off without holding the others; joiners start with the stream headers"
+                   : "Slow client, late join or client limit mishandled",
+            duration_ms};
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int run_all_tests() {
+    std::cout << "\n";
+    std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║       Stream Relay Fan-Out Benchmark                         ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════════════╝\n";
+    std::cout << "\n";
+
+    g_results.push_back(test_fan_out());
+    std::cout << "\n";
+    g_results.push_back(test_latency());
+    std::cout << "\n";
+    g_results.push_back(test_time_sync());
+    std::cout << "\n";
+    g_results.push_back(test_join_and_drop());
+    std::cout << "\n";
+
+    int failed = 0;
+    for (const auto& result : g_results) {
+        std::string status = result.passed ? "✅ PASS" : "❌ FAIL";
+        std::cout << "  " << status << "  " << result.name << "\n";
+        std::cout << "         " << result.message << " (" << result.duration_ms << " ms)\n";
+        if (!result.passed) failed++;
+    }
+    std::cout << "\n";
+    return failed;
+}
+
+}  // namespace relay_bench
+
+int main() {
+    return relay_bench::run_all_tests() == 0 ? 0 : 1;
+}
@@ -0,0 +1,607 @@
+/***
+    WarmStartBenchmark.cpp
+
+    Measures launch-to-audio with and without the warm-start cache.
+
+    A loopback mock Snapcast server (clock 5 s ahead of ours) answers the
+    Hello with a codec header and its 1 s buffer (50 chunks of 20 ms PCM),
+    then streams live. Every message goes through a modelled link: one-way
+    delay, jitter and a bandwidth limit, so a Time reply queues behind the
+    buffer burst like it does on a real network.
+
+    The client model follows the iOS client's start gate: audio can play
+    once the codec header and a chunk are in and the clock is synced. Cold,
+    "synced" means the first Time reply (TimeProvider plays silence until
+    then); warm, it means the seed from the cache, checked against the
+    median of the first live syncs.
+
+    Also checks persistence (round trip, corrupt and foreign files), seed
+    prediction across sleep and reboot, drift estimation, and that a server
+    whose clock changed is caught by the check.
+
+    Build & run: ./scripts/run-linux-benchmarks.sh WarmStart
+
+    Copyright (C) 2025 SnapForge contributors
+    License: GPL-3.0
+***/
+
+#include "cache/warm_start_cache.hpp"
+#include "probe/stream_wire.hpp"
+
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace warm_bench {
+
+using boost::asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+constexpr auto SERVER_CLOCK_OFFSET = std::chrono::seconds(5);
+constexpr auto CHUNK_DURATION = milliseconds(20);
+constexpr size_t CHUNK_BYTES = 48000 * 4 / 50;  // 20 ms of 48 kHz/16/2
+constexpr int BUFFER_CHUNKS = 50;               // 1 s server buffer
+constexpr int LIVE_SYNCS = 5;                   // Syncs the seed is checked against
+constexpr int RUNS = 5;
+
+struct TestResult {
+    std::string name;
+    bool passed;
+    std::string message;
+    double duration_ms;
+};
+
+std::vector<TestResult> g_results;
+
+void log(const std::string& msg) {
+    auto now = std::chrono::system_clock::now();
+    auto time = std::chrono::system_clock::to_time_t(now);
+    std::cout << "[" << std::put_time(std::localtime(&time), "%H:%M:%S") << "] " << msg << std::endl;
+}
+
+double ms(microseconds v) {
+    return static_cast<double>(v.count()) / 1000.0;
+}
+
+std::string fmt(double v, int precision = 1) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(precision) << v;
+    return out.str();
+}
+
+/// Scratch directory, removed with its files
+struct TempDir {
+    TempDir() {
+        char pattern[] = "/tmp/warmstart-XXXXXX";
+        path = mkdtemp(pattern) ? pattern : "";
+    }
+    ~TempDir() {
+        std::error_code ec;
+        if (!path.empty()) std::filesystem::remove_all(path, ec);
+    }
+    std::string path;
+};
+
+// ============================================================================
+// Mock streaming server behind a modelled link
+// ============================================================================
+
+struct Link {
+    const char* name;
+    microseconds delay;    // One way
+    microseconds jitter;   // Added to each message, order preserved
+    double mbps;           // Bandwidth server -> client
+};
+
+std::vector<uint8_t> message(uint16_t type, const std::vector<uint8_t>& payload, microseconds sent) {
+    probe::wire::Header h;
+    h.type = type;
+    h.sent = probe::wire::toTimeval(sent);
+    h.size = static_cast<uint32_t>(payload.size());
+    std::vector<uint8_t> out(probe::wire::HEADER_SIZE);
+    probe::wire::encodeHeader(h, out.data());
+    out.insert(out.end(), payload.begin(), payload.end());
+    return out;
+}
+
+std::vector<uint8_t> codecHeader(microseconds sent) {
+    const std::string codec = "pcm";
+    std::vector<uint8_t> payload = {static_cast<uint8_t>(codec.size()), 0, 0, 0};
+    payload.insert(payload.end(), codec.begin(), codec.end());
+    payload.insert(payload.end(), {44, 0, 0, 0});
+    payload.resize(payload.size() + 44, 0);
+    return message(probe::wire::kCodecHeader, payload, sent);
+}
+
+/// Wire chunk stamped with its capture time (server clock)
+std::vector<uint8_t> wireChunk(microseconds timestamp, microseconds sent) {
+    std::vector<uint8_t> payload(8 + 4 + CHUNK_BYTES, 0);
+    auto tv = probe::wire::toTimeval(timestamp);
+    for (int i = 0; i < 4; ++i) {
+        payload[i] = static_cast<uint8_t>(static_cast<uint32_t>(tv.sec) >> (8 * i));
+        payload[4 + i] = static_cast<uint8_t>(static_cast<uint32_t>(tv.usec) >> (8 * i));
+    }
+    payload[8] = CHUNK_BYTES & 0xff;
+    payload[9] = (CHUNK_BYTES >> 8) & 0xff;
+    return message(probe::wire::kWireChunk, payload, sent);
+}
+
+class MockStreamServer {
+public:
+    MockStreamServer(Link link, std::chrono::seconds clock_offset)
+        : acceptor_(io_, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)), link_(link), offset_(clock_offset) {
+        accept();
+        thread_ = std::thread([this]() { io_.run(); });
+    }
+
+    ~MockStreamServer() {
+        io_.stop();
+        thread_.join();
+    }
+
+    uint16_t port() const { return acceptor_.local_endpoint().port(); }
+
+private:
+    struct Session : std::enable_shared_from_this<Session> {
+        Session(boost::asio::io_context& io, tcp::socket s, Link link, microseconds offset)
+            : socket(std::move(s)), io(io), chunkTimer(io), linkTimer(io), link(link), offset(offset), rng(7) {}
+
+        microseconds serverNow() const { return probe::wire::now() + offset; }
+
+        void read() {
+            boost::asio::async_read(socket, boost::asio::buffer(header), [self = shared_from_this()](auto ec, size_t) {
+                if (ec) return;
+                self->incoming = probe::wire::decodeHeader(self->header.data());
+                self->payload.resize(self->incoming.size);
+                boost::asio::async_read(self->socket, boost::asio::buffer(self->payload), [self](auto ec, size_t) {
+                    if (ec) return;
+                    // Upstream half of the link
+                    auto timer = std::make_shared<boost::asio::steady_timer>(self->io, self->link.delay);
+                    auto h = self->incoming;
+                    timer->async_wait([self, timer, h](auto ec) {
+                        if (!ec) self->onMessage(h);
+                    });
+                    self->read();
+                });
+            });
+        }
+
+        void onMessage(const probe::wire::Header& h) {
+            if (h.type == probe::wire::kHello) {
+                auto now = serverNow();
+                send(codecHeader(now));
+                for (int i = 0; i < BUFFER_CHUNKS; ++i)
+                    send(wireChunk(now - CHUNK_DURATION * (BUFFER_CHUNKS - i), now));
+                streamStart = Clock::now();
+                scheduleChunk(1);
+            } else if (h.type == probe::wire::kTime) {
+                auto received = serverNow();
+                auto latency = received - probe::wire::fromTimeval(h.sent);
+                send(probe::wire::encodeTimeReply(0, h.id, latency, received));
+            }
+        }
+
+        void scheduleChunk(int n) {
+            chunkTimer.expires_at(streamStart + CHUNK_DURATION * n);
+            chunkTimer.async_wait([self = shared_from_this()](auto ec) {
+                if (ec) return;
+                auto now = self->serverNow();
+                self->send(wireChunk(now, now));
+                self->scheduleChunk(static_cast<int>((Clock::now() - self->streamStart) / CHUNK_DURATION) + 1);
+            });
+        }
+
+        /// Queue behind earlier messages at the link's bandwidth, then the delay
+        void send(std::vector<uint8_t> data) {
+            auto now = Clock::now();
+            auto serialize = microseconds(static_cast<int64_t>(data.size() * 8 / link.mbps));
+            linkFree = std::max(linkFree, now) + serialize;
+            std::uniform_int_distribution<int64_t> jitter(0, link.jitter.count());
+            auto at = std::max(linkFree + link.delay + microseconds(jitter(rng)), lastDelivery);
+            lastDelivery = at;
+            inFlight.push_back({at, std::move(data)});
+            if (inFlight.size() == 1) armLink();
+        }
+
+        void armLink() {
+            linkTimer.expires_at(inFlight.front().first);
+            linkTimer.async_wait([self = shared_from_this()](auto ec) {
+                if (ec) return;
+                auto now = Clock::now();
+                while (!self->inFlight.empty() && self->inFlight.front().first <= now) {
+                    self->writes.push_back(std::move(self->inFlight.front().second));
+                    self->inFlight.pop_front();
+                    if (self->writes.size() == 1) self->writeNext();
+                }
+                if (!self->inFlight.empty()) self->armLink();
+            });
+        }
+
+        void writeNext() {
+            boost::asio::async_write(socket, boost::asio::buffer(writes.front()), [self = shared_from_this()](auto ec, size_t) {
+                if (ec) {
+                    self->chunkTimer.cancel();
+                    self->linkTimer.cancel();
+                    return;
+                }
+                self->writes.pop_front();
+                if (!self->writes.empty()) self->writeNext();
+            });
+        }
+
+        tcp::socket socket;
+        boost::asio::io_context& io;
+        boost::asio::steady_timer chunkTimer;
+        boost::asio::steady_timer linkTimer;
+        Link link;
+        microseconds offset;
+        std::mt19937 rng;
+        Clock::time_point streamStart;
+        Clock::time_point linkFree;
+        Clock::time_point lastDelivery;
+        std::array<uint8_t, probe::wire::HEADER_SIZE> header{};
+        std::vector<uint8_t> payload;
+        probe::wire::Header incoming;
+        std::deque<std::pair<Clock::time_point, std::vector<uint8_t>>> inFlight;
+        std::deque<std::vector<uint8_t>> writes;
+    };
+
+    void accept() {
+        acceptor_.async_accept([this](auto ec, tcp::socket socket) {
+            if (ec) return;
+            socket.set_option(tcp::no_delay(true), ec);
+            auto session = std::make_shared<Session>(io_, std::move(socket), link_, offset_);
+            session->read();
+            sessions_.push_back(session);
+            accept();
+        });
+    }
+
+    boost::asio::io_context io_;
+    tcp::acceptor acceptor_;
+    Link link_;
+    microseconds offset_;
+    std::vector<std::shared_ptr<Session>> sessions_;
+    std::thread thread_;
+};
+
+// ============================================================================
+// Client start model
+// ============================================================================
+
+struct Launch {
+    microseconds headerAt{0};
+    microseconds firstChunkAt{0};
+    microseconds syncAt{0};        // First Time reply
+    microseconds audioAt{0};       // Header, chunk and clock all ready
+    microseconds liveDiff{0};      // Median of the first LIVE_SYNCS samples
+    microseconds rttP95{0};
+    bool complete{false};
+};
+
+microseconds median(std::vector<microseconds> v) {
+    std::sort(v.begin(), v.end());
+    return v.empty() ? microseconds(0) : v[v.size() / 2];
+}
+
+/// Connect, Hello, Time syncs; times are relative to the launch
+Launch launch(uint16_t port, const std::optional<cache::Seed>& seed) {
+    Launch l;
+    boost::asio::io_context io;
+    tcp::socket socket(io);
+    auto t0 = probe::wire::now();
+    socket.connect(tcp::endpoint(boost::asio::ip::address_v4::loopback(), port));
+    socket.set_option(tcp::no_delay(true));
+
+    probe::wire::HelloInfo hello;
+    hello.id = "00:11:22:33:44:55";
+    boost::asio::write(socket, boost::asio::buffer(probe::wire::encodeHello(1, hello, probe::wire::now())));
+    uint16_t nextId = 2;
+    boost::asio::write(socket, boost::asio::buffer(probe::wire::encodeTime(nextId++, probe::wire::now())));
+
+    std::vector<microseconds> diffs, rtts;
+    std::array<uint8_t, probe::wire::HEADER_SIZE> header{};
+    std::vector<uint8_t> payload;
+    auto deadline = t0 + std::chrono::seconds(5);
+    while (probe::wire::now() < deadline) {
+        boost::asio::read(socket, boost::asio::buffer(header));
+        auto h = probe::wire::decodeHeader(header.data());
+        payload.resize(h.size);
+        boost::asio::read(socket, boost::asio::buffer(payload));
+        auto now = probe::wire::now();
+
+        if (h.type == probe::wire::kCodecHeader && l.headerAt.count() == 0) {
+            l.headerAt = now - t0;
+        } else if (h.type == probe::wire::kWireChunk && l.firstChunkAt.count() == 0) {
+            l.firstChunkAt = now - t0;
+        } else if (h.type == probe::wire::kTime) {
+            microseconds latency;
+            if (!probe::wire::decodeTime(payload.data(), payload.size(), latency)) break;
+            auto sample = probe::wire::timeSample(latency, probe::wire::fromTimeval(h.sent), now);
+            if (diffs.empty()) l.syncAt = now - t0;
+            diffs.push_back(sample.offset);
+            rtts.push_back(sample.rtt);
+            if (diffs.size() < LIVE_SYNCS)
+                boost::asio::write(socket, boost::asio::buffer(probe::wire::encodeTime(nextId++, probe::wire::now())));
+        }
+
+        bool clockReady = seed.has_value() || !diffs.empty();
+        if (l.audioAt.count() == 0 && clockReady && l.headerAt.count() != 0 && l.firstChunkAt.count() != 0)
+            l.audioAt = now - t0;
+        if (l.audioAt.count() != 0 && diffs.size() >= LIVE_SYNCS) {
+            l.complete = true;
+            break;
+        }
+    }
+
+    l.liveDiff = median(diffs);
+    std::sort(rtts.begin(), rtts.end());
+    if (!rtts.empty()) l.rttP95 = rtts[std::min(rtts.size() - 1, rtts.size() * 95 / 100)];
+    return l;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+TestResult test_persistence() {
+    const std::string name = "Persistence";
+    log("🧪 [" + name + "] store, load, corrupt and foreign files");
+    auto start = Clock::now();
+    TempDir dir;
+    cache::WarmStartCache store(dir.path);
+
+    cache::WarmStartEntry e;
+    e.server = "192.168.1.10:1704";
+    e.diffToServerUs = 5'000'123;
+    e.measured = cache::ClockReading::now();
+    e.driftPpm = 12.5;
+    e.rttMedianUs = 2100;
+    e.rttP95Us = 9800;
+    e.sampleRate = 48000;
+    e.bits = 16;
+    e.channels = 2;
+    e.codec = "flac";
+    e.confirmed = 3;
+
+    bool stored = store.store(e);
+    auto back = store.load(e.server);
+    bool roundTrip = stored && back && back->server == e.server && back->diffToServerUs == e.diffToServerUs &&
+                     back->measured.steadyUs == e.measured.steadyUs && back->driftPpm == e.driftPpm &&
+                     back->rttP95Us == e.rttP95Us && back->sampleRate == 48000 && back->bits == 16 &&
+                     back->channels == 2 && back->codec == "flac" && back->confirmed == 3;
+
+    // Flip one byte in the middle of the file
+    auto blob = cache::encode(e);
+    auto corrupt = blob;
+    corrupt[corrupt.size() / 2] ^= 0x40;
+    bool rejectsCorrupt = !cache::decode(corrupt.data(), corrupt.size());
+    bool rejectsTruncated = !cache::decode(blob.data(), blob.size() - 5);
+
+    // Entry for another server copied under this server's name
+    cache::WarmStartEntry other = e;
+    other.server = "10.0.0.2:1704";
+    store.store(other);
+    std::rename(store.path(other.server).c_str(), store.path("10.0.0.3:1704").c_str());
+    bool rejectsForeign = !store.load("10.0.0.3:1704");
+    bool missing = !store.load("10.9.9.9:1704");
+
+    // Cost of the warm-start path at launch: load + predict
+    constexpr int LOADS = 2000;
+    auto t = Clock::now();
+    int seeds = 0;
+    for (int i = 0; i < LOADS; ++i) {
+        auto entry = store.load(e.server);
+        if (entry && cache::predictSeed(*entry, cache::ClockReading::now())) seeds++;
+    }
+    double perLoadUs = std::chrono::duration<double, std::micro>(Clock::now() - t).count() / LOADS;
+
+    bool passed = roundTrip && rejectsCorrupt && rejectsTruncated && rejectsForeign && missing && seeds == LOADS;
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    log("✅ [" + name + "] " + std::to_string(blob.size()) + " bytes per entry, load + predict " + fmt(perLoadUs) + " µs");
+    return {name, passed,
+            passed ? "Round trip exact; corrupt, truncated and foreign files rejected"
+                   : "Persistence broken (roundtrip=" + std::to_string(roundTrip) + ")",
+            duration_ms};
+}
+
+TestResult test_seed_prediction() {
+    const std::string name = "SeedPrediction";
+    log("🧪 [" + name + "] drift, sleep, reboot and age");
+    auto start = Clock::now();
+    constexpr int64_t S = 1'000'000;
+    constexpr int64_t H = 3600 * S;
+
+    cache::WarmStartEntry e;
+    e.server = "host:1704";
+    cache::ClockReading t0{1'700'000'000 * S, 500 * S};
+
+    // Two syncs an hour apart, server clock 20 ppm fast
+    cache::recordDiff(e, microseconds(5 * S), t0);
+    cache::recordDiff(e, microseconds(5 * S + 72'000), {t0.systemUs + H, t0.steadyUs + H});
+    bool drift = std::abs(e.driftPpm - 20.0) < 0.01;
+
+    // One more hour awake: the seed carries the drift forward
+    auto awake = cache::predictSeed(e, {t0.systemUs + 2 * H, t0.steadyUs + 2 * H});
+    bool awakeOk = awake && std::abs(awake->diff.count() - (5 * S + 144'000)) < 10;
+
+    // Slept 3 h out of 5: our steady clock missed 3 h the server did not
+    auto slept = cache::predictSeed(e, {t0.systemUs + 6 * H, t0.steadyUs + 3 * H});
+    bool sleptOk = slept && std::abs(slept->diff.count() - (5 * S + 3 * H + 72'000 + 360'000)) < 10 &&
+                   slept->tolerance > awake->tolerance;
+
+    // Rebooted: steady clock below the recorded reading
+    bool rebootRejected = !cache::predictSeed(e, {t0.systemUs + 2 * H, 60 * S});
+    // Wall clock stepped back an hour
+    bool stepRejected = !cache::predictSeed(e, {t0.systemUs, t0.steadyUs + 2 * H});
+    // Two weeks old
+    bool ageRejected = !cache::predictSeed(e, {t0.systemUs + 14 * 24 * H, t0.steadyUs + 14 * 24 * H});
+    // Syncs minutes apart, or across a sleep, leave the drift alone
+    cache::recordDiff(e, microseconds(5 * S + 90'000), {t0.systemUs + 4 * H, t0.steadyUs + 3 * H});
+    bool driftKept = std::abs(e.driftPpm - 20.0) < 0.01;
+
+    log("   - Drift " + fmt(e.driftPpm, 2) + " ppm; awake +1 h: " + (awake ? fmt(ms(awake->diff - microseconds(5 * S))) : "-") +
+        " ms ± " + (awake ? fmt(ms(awake->tolerance)) : "-") + " ms; after 3 h sleep: tolerance " +
+        (slept ? fmt(ms(slept->tolerance)) : "-") + " ms");
+
+    bool passed = drift && awakeOk && sleptOk && rebootRejected && stepRejected && ageRejected && driftKept;
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return {name, passed,
+            passed ? "Drift and sleep compensated; reboot, clock step and stale entries rejected"
+                   : "Prediction wrong (drift=" + std::to_string(drift) + " awake=" + std::to_string(awakeOk) +
+                         " slept=" + std::to_string(sleptOk) + " reboot=" + std::to_string(rebootRejected) +
+                         " step=" + std::to_string(stepRejected) + " age=" + std::to_string(ageRejected) + ")",
+            duration_ms};
+}
+
+struct Measured {
+    double cold_ms;
+    double warm_ms;
+    int confirmed;
+};
+
+/// Cold launches, one of them fills the cache, then warm launches from it
+Measured measure_link(const Link& link, TempDir& dir) {
+    MockStreamServer server(link, std::chrono::duration_cast<std::chrono::seconds>(SERVER_CLOCK_OFFSET));
+    cache::WarmStartCache store(dir.path);
+    std::string key = std::string("127.0.0.1:") + std::to_string(server.port());
+
+    std::vector<double> cold, warm;
+    for (int i = 0; i < RUNS; ++i) {
+        auto l = launch(server.port(), std::nullopt);
+        if (!l.complete) return {0, 0, -1};
+        cold.push_back(ms(l.audioAt));
+        if (i == RUNS - 1) {
+            // What the bridge stores at stop (live diff) and the link probe (RTT)
+            cache::WarmStartEntry entry;
+            entry.server = key;
+            entry.rttP95Us = l.rttP95.count();
+            cache::recordDiff(entry, l.liveDiff, cache::ClockReading::now());
+            store.store(entry);
+        }
+    }
+
+    int confirmed = 0;
+    for (int i = 0; i < RUNS; ++i) {
+        auto entry = store.load(key);
+        auto seed = entry ? cache::predictSeed(*entry, cache::ClockReading::now()) : std::nullopt;
+        if (!seed) return {0, 0, -1};
+        auto l = launch(server.port(), seed);
+        if (!l.complete) return {0, 0, -1};
+        warm.push_back(ms(l.audioAt));
+        if (cache::checkSeed(*seed, l.liveDiff) == cache::SeedCheck::Confirmed) confirmed++;
+    }
+    std::sort(cold.begin(), cold.end());
+    std::sort(warm.begin(), warm.end());
+    return {cold[RUNS / 2], warm[RUNS / 2], confirmed};
+}
+
+TestResult test_launch_to_audio() {
+    const std::string name = "LaunchToAudio";
+    log("🧪 [" + name + "] median of " + std::to_string(RUNS) + " launches, cold vs warm");
+    auto start = Clock::now();
+    TempDir dir;
+
+    const Link links[] = {
+        {"LAN (0.5 ms, 100 Mbps)", microseconds(500), microseconds(200), 100},
+        {"Wi-Fi (4 ms ±3, 30 Mbps)", microseconds(4000), microseconds(3000), 30},
+        {"Busy Wi-Fi (25 ms ±15, 4 Mbps)", microseconds(25000), microseconds(15000), 4},
+    };
+
+    bool passed = true;
+    for (const auto& link : links) {
+        auto m = measure_link(link, dir);
+        bool ok = m.confirmed == RUNS && m.warm_ms < m.cold_ms;
+        passed = passed && ok;
+        log(std::string("   - ") + link.name + ": cold " + fmt(m.cold_ms) + " ms → warm " + fmt(m.warm_ms) +
+            " ms, seed confirmed " + std::to_string(std::max(m.confirmed, 0)) + "/" + std::to_string(RUNS) +
+            (ok ? "" : "  ⚠️"));
+    }
+
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return {name, passed,
+            passed ? "Warm start plays before the first Time reply; every seed confirmed"
+                   : "Warm start not faster, or a seed was rejected",
+            duration_ms};
+}
+
+TestResult test_server_clock_changed() {
+    const std::string name = "ServerClockChanged";
+    log("🧪 [" + name + "] cache says +5 s, restarted server is at +9 s");
+    auto start = Clock::now();
+    const Link link{"LAN", microseconds(500), microseconds(200), 100};
+
+    cache::WarmStartEntry entry;
+    entry.server = "server";
+    entry.rttP95Us = 2000;
+    {
+        MockStreamServer before(link, std::chrono::seconds(5));
+        auto l = launch(before.port(), std::nullopt);
+        cache::recordDiff(entry, l.liveDiff, cache::ClockReading::now());
+    }
+    MockStreamServer after(link, std::chrono::seconds(9));
+    auto seed = cache::predictSeed(entry, cache::ClockReading::now());
+    auto l = seed ? launch(after.port(), seed) : Launch{};
+    bool rejected = seed && l.complete && cache::checkSeed(*seed, l.liveDiff) == cache::SeedCheck::Rejected;
+    if (seed) log("   - Seed " + fmt(ms(seed->diff)) + " ms, live " + fmt(ms(l.liveDiff)) + " ms");
+
+    double duration_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return {name, rejected, rejected ? "Stale seed rejected by the first live syncs" : "Stale seed accepted",
+            duration_ms};
+}
+
+// ============================================================================
+// Main Test Runner
+// ============================================================================
+
+int run_all_tests() {
+    std::cout << "\n";
+    std::cout << "╔══════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║       Warm-Start Cache Benchmark                             ║\n";
+    std::cout << "╚══════════════════════════════════════════════════════════════╝\n";
+    std::cout << "\n";
+
+    g_results.push_back(test_persistence());
+    std::cout << "\n";
+    g_results.push_back(test_seed_prediction());
+    std::cout << "\n";
+    g_results.push_back(test_launch_to_audio());
+    std::cout << "\n";
+    g_results.push_back(test_server_clock_changed());
+    std::cout << "\n";
+
+    int failed = 0;
+    for (const auto& result : g_results) {
+        std::string status = result.passed ? "✅ PASS" : "❌ FAIL";
+        std::cout << "  " << status << "  " << result.name << "\n";
+        std::cout << "         " << result.message << " (" << result.duration_ms << " ms)\n";
+        if (!result.passed) failed++;
+    }
+    std::cout << "\n";
+    return failed;
+}
+
+} // namespace warm_bench
+
+int main() {
+    return warm_bench::run_all_tests() == 0 ? 0 : 1;
+}
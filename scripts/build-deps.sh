@@ -204,44 +204,52 @@ build_opus() {
 }
 
 # ── 5. Snapcast source ──────────────────────────────────────────────
-apply_ios_patches() {
+# Apply one patch to the Snapcast tree in $1. A patch already in the tree is
+# skipped; one that does not apply stops the build, since later patches
+# build on earlier ones (ios-time-seed.patch edits ios-time-sync-wait.patch,
+# ios-time-filter.patch both, ios-chunk-ring.patch the stream.cpp hunk of
+# ios-time-sync-wait.patch).
+apply_patch() {
     local dest="$1"
-    local patch_dir="$ROOT_DIR/patches"
+    local patch_file="$2"
+    local name
+    name="$(basename "$patch_file")"
 
-    if [ -f "$patch_dir/ios-time-fix.patch" ]; then
-        info "Applying iOS time fix patch..."
-        cd "$dest"
-        # Apply patch (ignore if already applied)
-        patch -p1 -N < "$patch_dir/ios-time-fix.patch" || true
-        cd "$ROOT_DIR"
+    if patch -d "$dest" -p1 -R -f -s --dry-run < "$patch_file" > /dev/null 2>&1; then
+        info "$name already applied"
+        return
     fi
-
-    if [ -f "$patch_dir/ios-controller.patch" ]; then
-        info "Applying iOS controller patch..."
-        cd "$dest"
-        patch -p1 -N < "$patch_dir/ios-controller.patch" || true
-        cd "$ROOT_DIR"
-    fi
-
-    if [ -f "$patch_dir/ios-time-sync-wait.patch" ]; then
-        info "Applying iOS time sync wait patch..."
-        cd "$dest"
-        patch -p1 -N < "$patch_dir/ios-time-sync-wait.patch" || true
-        cd "$ROOT_DIR"
+    info "Applying $name..."
+    if ! patch -d "$dest" -p1 -N -f -s --dry-run < "$patch_file"; then
+        error "$name does not apply to Snapcast $SNAPCAST_TAG in $dest (see the failed hunks above); fix the patch or reset the checkout"
     fi
+    patch -d "$dest" -p1 -N -f -s < "$patch_file" || error "Applying $name failed"
+}
 
-    if [ -f "$patch_dir/ios-time-sync-timeout.patch" ]; then
-        info "Applying iOS time sync timeout patch..."
-        cd "$dest"
-        patch -p1 -N < "$patch_dir/ios-time-sync-timeout.patch" || true
-        cd "$ROOT_DIR"
-    fi
+apply_ios_patches() {
+    local dest="$1"
+    local patch_dir="$ROOT_DIR/patches"
 
+    # In order: each patch may depend on the ones before it
+    local patches=(
+        ios-time-fix.patch
+        ios-controller.patch
+        ios-time-sync-wait.patch
+        ios-time-sync-timeout.patch
+        ios-time-seed.patch
+        ios-time-filter.patch
+        ios-stream-reader.patch
+        ios-chunk-ring.patch
+    )
+    local p
+    for p in "${patches[@]}"; do
+        [ -f "$patch_dir/$p" ] || error "Missing patch: patches/$p"
+        apply_patch "$dest" "$patch_dir/$p"
+    done
+
+    # Optional, not shipped with every checkout
     if [ -f "$patch_dir/ios-time-provider-reset.patch" ]; then
-        info "Applying iOS time provider reset patch..."
-        cd "$dest"
-        patch -p1 -N < "$patch_dir/ios-time-provider-reset.patch" || true
-        cd "$ROOT_DIR"
+        apply_patch "$dest" "$patch_dir/ios-time-provider-reset.patch"
     fi
 }
 
@@ -0,0 +1,243 @@
+#!/usr/bin/env bash
+#
+# run-linux-benchmarks.sh — Build and run host-side benchmarks and tests
+#
+# The SnapClientCore modules that don't depend on AudioToolbox are portable,
+# so their benchmarks and correctness tests run on a Linux (or macOS) host.
+#
+# Requirements: a C++17 compiler, Boost headers (system or vendored), and for
+# benchmarks that use Snapcast headers (json.hpp, aixlog.hpp) the Snapcast
+# source cloned by ./scripts/build-deps.sh into SnapClientCore/vendor/snapcast.
+#
+# Usage:
+#   ./scripts/run-linux-benchmarks.sh                 # Build and run all
+#   ./scripts/run-linux-benchmarks.sh ControlModel    # Only matching names
+#
+set -euo pipefail
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+ROOT_DIR="$(dirname "$SCRIPT_DIR")"
+CORE_DIR="$ROOT_DIR/SnapClientCore"
+VENDOR_DIR="$CORE_DIR/vendor"
+SNAPCAST_DIR="${SNAPCAST_DIR:-$VENDOR_DIR/snapcast}"
+BUILD_DIR="$ROOT_DIR/build/benchmarks"
+
+CXX="${CXX:-c++}"
+CXXFLAGS="${CXXFLAGS:--O2 -g}"
+FILTER="${1:-}"
+
+# Colors
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+NC='\033[0m'
+
+INCLUDES=(-I"$CORE_DIR")
+if [ -d "$VENDOR_DIR/boost/boost" ]; then
+    INCLUDES+=(-isystem "$VENDOR_DIR/boost")
+fi
+HAVE_SNAPCAST=false
+if [ -f "$SNAPCAST_DIR/common/json.hpp" ]; then
+    HAVE_SNAPCAST=true
+    INCLUDES+=(-I"$SNAPCAST_DIR")
+fi
+
+mkdir -p "$BUILD_DIR"
+
+PASSED=0
+FAILED=0
+SKIPPED=0
+
+# bench NAME NEEDS_SNAPCAST SOURCE...
+bench() {
+    local name="$1" needs_snapcast="$2"
+    shift 2
+
+    if [ -n "$FILTER" ] && [[ "$name" != *"$FILTER"* ]]; then
+        return
+    fi
+    if [ "$needs_snapcast" = true ] && [ "$HAVE_SNAPCAST" = false ]; then
+        echo -e "${YELLOW}⏭  $name: skipped (Snapcast source not found, run ./scripts/build-deps.sh)${NC}"
+        SKIPPED=$((SKIPPED + 1))
+        return
+    fi
+
+    echo "==> Building $name"
+    local sources=()
+    for src in "$@"; do
+        sources+=("$ROOT_DIR/$src")
+    done
+    # shellcheck disable=SC2086
+    if ! "$CXX" -std=c++17 $CXXFLAGS -pthread "${INCLUDES[@]}" "${sources[@]}" -o "$BUILD_DIR/$name"; then
+        echo -e "${RED}❌ $name: build failed${NC}"
+        FAILED=$((FAILED + 1))
+        return
+    fi
+
+    echo "==> Running $name"
+    if "$BUILD_DIR/$name"; then
+        PASSED=$((PASSED + 1))
+    else
+        echo -e "${RED}❌ $name: failed${NC}"
+        FAILED=$((FAILED + 1))
+    fi
+}
+
+# ── Benchmarks ──────────────────────────────────────────────────────
+bench ControlModel true \
+    Tests/PerformanceTests/ControlModelBenchmark.cpp \
+    SnapClientCore/control/server_model.cpp \
+    SnapClientCore/control/model_update.cpp \
+    SnapClientCore/control/json_reader.cpp \
+    SnapClientCore/control/status_parser.cpp \
+    SnapClientCore/control/command_queue.cpp \
+    SnapClientCore/control/control_client.cpp
+
+bench CommandCoalescer true \
+    Tests/PerformanceTests/CommandCoalescerBenchmark.cpp \
+    SnapClientCore/control/server_model.cpp \
+    SnapClientCore/control/model_update.cpp \
+    SnapClientCore/control/json_reader.cpp \
+    SnapClientCore/control/status_parser.cpp \
+    SnapClientCore/control/command_queue.cpp \
+    SnapClientCore/control/control_client.cpp
+
+bench StatusParser true \
+    Tests/PerformanceTests/StatusParserBenchmark.cpp \
+    SnapClientCore/control/server_model.cpp \
+    SnapClientCore/control/model_update.cpp \
+    SnapClientCore/control/json_reader.cpp \
+    SnapClientCore/control/status_parser.cpp
+
+bench Reachability true \
+    Tests/PerformanceTests/ReachabilityBenchmark.cpp \
+    SnapClientCore/probe/stream_wire.cpp \
+    SnapClientCore/probe/reachability_prober.cpp
+
+bench LinkProbe true \
+    Tests/PerformanceTests/LinkProbeBenchmark.cpp \
+    SnapClientCore/probe/stream_wire.cpp \
+    SnapClientCore/probe/reachability_prober.cpp \
+    SnapClientCore/probe/link_probe.cpp \
+    SnapClientCore/timesync/hol_filter.cpp \
+    SnapClientCore/timesync/rx_timestamp.cpp
+
+bench WarmStart true \
+    Tests/PerformanceTests/WarmStartBenchmark.cpp \
+    SnapClientCore/probe/stream_wire.cpp \
+    SnapClientCore/cache/warm_start_cache.cpp
+
+bench HolFilter true \
+    Tests/PerformanceTests/HolFilterBenchmark.cpp \
+    SnapClientCore/probe/stream_wire.cpp \
+    SnapClientCore/probe/reachability_prober.cpp \
+    SnapClientCore/probe/link_probe.cpp \
+    SnapClientCore/timesync/hol_filter.cpp \
+    SnapClientCore/timesync/rx_timestamp.cpp
+
+bench RxTimestamp true \
+    Tests/PerformanceTests/RxTimestampBenchmark.cpp \
+    SnapClientCore/probe/stream_wire.cpp \
+    SnapClientCore/probe/reachability_prober.cpp \
+    SnapClientCore/probe/link_probe.cpp \
+    SnapClientCore/timesync/hol_filter.cpp \
+    SnapClientCore/timesync/rx_timestamp.cpp
+
+bench SocketProfile false \
+    Tests/PerformanceTests/SocketProfileBenchmark.cpp \
+    SnapClientCore/net/socket_profile.cpp
+
+bench BatchReceive true \
+    Tests/PerformanceTests/BatchReceiveBenchmark.cpp \
+    SnapClientCore/probe/stream_wire.cpp \
+    SnapClientCore/timesync/rx_timestamp.cpp \
+    SnapClientCore/net/handler_memory.cpp \
+    SnapClientCore/net/batch_receiver.cpp
+
+bench StreamReader true \
+    Tests/PerformanceTests/StreamReaderBenchmark.cpp \
+    SnapClientCore/probe/stream_wire.cpp \
+    SnapClientCore/timesync/rx_timestamp.cpp \
+    SnapClientCore/timesync/hol_filter.cpp \
+    SnapClientCore/timesync/time_requester.cpp \
+    SnapClientCore/net/handler_memory.cpp \
+    SnapClientCore/net/batch_receiver.cpp \
+    SnapClientCore/net/socket_profile.cpp \
+    SnapClientCore/net/stream_reader.cpp
+
+bench HandlerMemory true \
+    Tests/PerformanceTests/HandlerMemoryBenchmark.cpp \
+    SnapClientCore/probe/stream_wire.cpp \
+    SnapClientCore/timesync/rx_timestamp.cpp \
+    SnapClientCore/timesync/time_requester.cpp \
+    SnapClientCore/net/handler_memory.cpp \
+    SnapClientCore/net/batch_receiver.cpp
+
+bench StreamRelay true \
+    Tests/PerformanceTests/StreamRelayBenchmark.cpp \
+    SnapClientCore/probe/stream_wire.cpp \
+    SnapClientCore/timesync/rx_timestamp.cpp \
+    SnapClientCore/net/handler_memory.cpp \
+    SnapClientCore/net/batch_receiver.cpp \
+    SnapClientCore/net/stream_relay.cpp
+
+bench ChunkRing false \
+    Tests/PerformanceTests/ChunkRingBenchmark.cpp \
+    SnapClientCore/playout/chunk_ring.cpp
+
+bench RenderKernels false \
+    Tests/PerformanceTests/RenderKernelsBenchmark.cpp \
+    SnapClientCore/playout/render_kernels.cpp
+
+bench DeadlineScheduler true \
+    Tests/PerformanceTests/DeadlineSchedulerBenchmark.cpp \
+    SnapClientCore/realtime/deadline_scheduler.cpp
+
+bench ThreadTopology true \
+    Tests/PerformanceTests/ThreadTopologyBenchmark.cpp \
+    SnapClientCore/realtime/thread_topology.cpp
+
+bench StreamHandoff false \
+    Tests/PerformanceTests/StreamHandoffBenchmark.cpp \
+    SnapClientCore/playout/stream_handoff.cpp \
+    SnapClientCore/playout/render_kernels.cpp
+
+bench ParametricEq false \
+    Tests/PerformanceTests/ParametricEqBenchmark.cpp \
+    SnapClientCore/dsp/parametric_eq.cpp
+
+bench PeakLimiter false \
+    Tests/PerformanceTests/PeakLimiterBenchmark.cpp \
+    SnapClientCore/dsp/peak_limiter.cpp \
+    SnapClientCore/dsp/parametric_eq.cpp
+
+bench ChannelMixer false \
+    Tests/PerformanceTests/ChannelMixerBenchmark.cpp \
+    SnapClientCore/dsp/channel_mixer.cpp
+
+bench Dither false \
+    Tests/PerformanceTests/DitherBenchmark.cpp \
+    SnapClientCore/dsp/dither.cpp \
+    SnapClientCore/playout/render_kernels.cpp
+
+bench AnalysisTap false \
+    Tests/PerformanceTests/AnalysisTapBenchmark.cpp \
+    SnapClientCore/dsp/analysis_tap.cpp \
+    SnapClientCore/playout/render_kernels.cpp
+
+bench PcmTap false \
+    Tests/PerformanceTests/PcmTapBenchmark.cpp \
+    SnapClientCore/playout/pcm_tap.cpp
+
+bench SourceMixer false \
+    Tests/PerformanceTests/SourceMixerBenchmark.cpp \
+    SnapClientCore/playout/source_mixer.cpp
+
+# ── Summary ─────────────────────────────────────────────────────────
+echo ""
+echo "  Passed: $PASSED, failed: $FAILED, skipped: $SKIPPED"
+if [ "$FAILED" -ne 0 ]; then
+    echo -e "${RED}⚠️  Some benchmarks failed!${NC}"
+    exit 1
+fi
+echo -e "${GREEN}🎉 All benchmarks passed${NC}"